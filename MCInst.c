@@ -33,6 +33,8 @@ void MCInst_Init(MCInst *inst)
 	inst->ac_idx = 0;
 	inst->popcode_adjust = 0;
 	inst->assembly[0] = '\0';
+	inst->mapping = NULL;
+	inst->op_info = NULL;
 }
 
 void MCInst_clear(MCInst *inst)
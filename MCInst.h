@@ -107,6 +107,9 @@ struct MCInst {
 	uint8_t ac_idx;
 	uint8_t popcode_adjust;   // Pseudo X86 instruction adjust
 	char assembly[8];	// for special instruction, so that we dont need printer
+	// mapping of Opcode, resolved once after decode by the arch's insn_id()
+	const struct insn_map *mapping;	// row of the arch's insns[] table, or NULL
+	const void *op_info;	// matching row of the arch's insn_ops[] table, or NULL
 	unsigned char evm_data[32];	// for EVM PUSH operand
 };
 
@@ -25,31 +25,6 @@ typedef struct DiffListIterator {
 	const MCPhysReg *List;
 } DiffListIterator;
 
-void MCRegisterInfo_InitMCRegisterInfo(MCRegisterInfo *RI,
-		const MCRegisterDesc *D, unsigned NR,
-		unsigned RA, unsigned PC,
-		const MCRegisterClass *C, unsigned NC,
-		uint16_t (*RURoots)[2], unsigned NRU,
-		const MCPhysReg *DL,
-		const char *Strings,
-		const uint16_t *SubIndices, unsigned NumIndices,
-		const uint16_t *RET)
-{
-	RI->Desc = D;
-	RI->NumRegs = NR;
-	RI->RAReg = RA;
-	RI->PCReg = PC;
-	RI->Classes = C;
-	RI->DiffLists = DL;
-	RI->RegStrings = Strings;
-	RI->NumClasses = NC;
-	RI->RegUnitRoots = RURoots;
-	RI->NumRegUnits = NRU;
-	RI->SubRegIndices = SubIndices;
-	RI->NumSubRegIndices = NumIndices;
-	RI->RegEncodingTable = RET;
-}
-
 static void DiffListIterator_init(DiffListIterator *d, MCPhysReg InitVal, const MCPhysReg *DiffList)
 {
 	d->Val = InitVal;
@@ -141,3 +116,42 @@ bool MCRegisterClass_contains(const MCRegisterClass *c, unsigned Reg)
 
 	return (c->RegSet[Byte] & (1 << InByte)) != 0;
 }
+
+static void foldDiffList(const MCRegisterInfo *RI, unsigned Reg, uint32_t List,
+		uint64_t *Aliases, unsigned NumRegs)
+{
+	DiffListIterator iter;
+
+	DiffListIterator_init(&iter, (MCPhysReg)Reg, RI->DiffLists + List);
+	DiffListIterator_next(&iter);
+
+	while(DiffListIterator_isValid(&iter)) {
+		uint16_t val = DiffListIterator_getVal(&iter);
+		if (val < NumRegs)
+			Aliases[val >> 6] |= (uint64_t)1 << (val & 63);
+
+		DiffListIterator_next(&iter);
+	}
+}
+
+void MCRegisterInfo_foldAliases(const MCRegisterInfo *RI, const uint64_t *Regs,
+		uint64_t *Aliases, unsigned NumRegs)
+{
+	unsigned Reg;
+	uint64_t Word;
+
+	if (NumRegs > RI->NumRegs)
+		NumRegs = RI->NumRegs;
+
+	for (Reg = 0; Reg < NumRegs; Reg += 64) {
+		unsigned R = Reg;
+
+		for (Word = Regs[Reg >> 6]; Word; Word >>= 1, R++) {
+			if (!(Word & 1) || R >= NumRegs)
+				continue;
+
+			foldDiffList(RI, R, RI->Desc[R].SubRegs, Aliases, NumRegs);
+			foldDiffList(RI, R, RI->Desc[R].SuperRegs, Aliases, NumRegs);
+		}
+	}
+}
@@ -93,18 +93,6 @@ typedef struct MCRegisterInfo {
 	// encodings.
 } MCRegisterInfo;
 
-void MCRegisterInfo_InitMCRegisterInfo(MCRegisterInfo *RI,
-		const MCRegisterDesc *D, unsigned NR, unsigned RA,
-		unsigned PC,
-		const MCRegisterClass *C, unsigned NC,
-		uint16_t (*RURoots)[2],
-		unsigned NRU,
-		const MCPhysReg *DL,
-		const char *Strings,
-		const uint16_t *SubIndices,
-		unsigned NumIndices,
-		const uint16_t *RET);
-
 unsigned MCRegisterInfo_getMatchingSuperReg(const MCRegisterInfo *RI, unsigned Reg, unsigned SubIdx, const MCRegisterClass *RC);
 
 unsigned MCRegisterInfo_getSubReg(const MCRegisterInfo *RI, unsigned Reg, unsigned Idx);
@@ -113,4 +101,9 @@ const MCRegisterClass* MCRegisterInfo_getRegClass(const MCRegisterInfo *RI, unsi
 
 bool MCRegisterClass_contains(const MCRegisterClass *c, unsigned Reg);
 
+/// Set the bits of all sub-registers & super-registers of every register in
+/// bitmap @Regs into bitmap @Aliases, ignoring registers from @NumRegs up.
+void MCRegisterInfo_foldAliases(const MCRegisterInfo *RI, const uint64_t *Regs,
+		uint64_t *Aliases, unsigned NumRegs);
+
 #endif
@@ -26,16 +26,84 @@ void SStream_Init(SStream *ss)
 {
 	ss->index = 0;
 	ss->buffer[0] = '\0';
+	ss->mnemonic = NULL;
 }
 
-void SStream_concat0(SStream *ss, const char *s)
+void SStream_InitInsn(SStream *ss, char *mnemonic, char *op_str)
+{
+	SStream_Init(ss);
+	ss->mnemonic = mnemonic;
+	ss->op_str = op_str;
+	SStream_Clear(ss);
+}
+
+void SStream_Clear(SStream *ss)
 {
+	ss->index = 0;
+	ss->buffer[0] = '\0';
+	if (ss->mnemonic) {
+		ss->state = SS_MNEMONIC;
+		ss->mnem_len = 0;
+		ss->op_len = 0;
+		ss->mnemonic[0] = '\0';
+		ss->op_str[0] = '\0';
+	}
+}
+
 #ifndef CAPSTONE_DIET
-	unsigned int len = (unsigned int) strlen(s);
+// append @len chars of @s.
+// for an instruction stream, the mnemonic ends at the first space or tab
+// (a '|' after x86 lock/rep prefixes becomes a space), and the operands
+// start at the next non-blank char
+static void concat_n(SStream *ss, const char *s, size_t len)
+{
+	size_t room;
 
-	memcpy(ss->buffer + ss->index, s, len);
-	ss->index += len;
-	ss->buffer[ss->index] = '\0';
+	if (!ss->mnemonic) {
+		memcpy(ss->buffer + ss->index, s, len);
+		ss->index += (int)len;
+		ss->buffer[ss->index] = '\0';
+		return;
+	}
+
+	for (; len && ss->state != SS_OPERANDS; s++, len--) {
+		char c = *s;
+
+		if (ss->state == SS_MNEMONIC) {
+			if (c == ' ' || c == '\t') {
+				ss->state = SS_BLANK;
+				continue;
+			}
+
+			if (c == '|')
+				c = ' ';
+
+			if (ss->mnem_len < CS_MNEMONIC_SIZE - 1) {
+				ss->mnemonic[ss->mnem_len++] = c;
+				ss->mnemonic[ss->mnem_len] = '\0';
+			}
+		} else if (c != ' ' && c != '\t') {
+			ss->state = SS_OPERANDS;
+			break;
+		}
+	}
+
+	room = sizeof(((cs_insn *)NULL)->op_str) - 1 - ss->op_len;
+	if (len > room)
+		len = room;
+
+	if (len) {
+		memcpy(ss->op_str + ss->op_len, s, len);
+		ss->op_len += (uint8_t)len;
+		ss->op_str[ss->op_len] = '\0';
+	}
+}
+#endif
+
+void SStream_concat0(SStream *ss, const char *s)
+{
+#ifndef CAPSTONE_DIET
+	concat_n(ss, s, strlen(s));
 #endif
 }
 
@@ -45,6 +113,16 @@ void SStream_concat(SStream *ss, const char *fmt, ...)
 	va_list ap;
 	int ret;
 
+	if (ss->mnemonic) {
+		// format into the unused buffer, then split it
+		va_start(ap, fmt);
+		ret = cs_vsnprintf(ss->buffer, sizeof(ss->buffer), fmt, ap);
+		va_end(ap);
+		if (ret > 0)
+			concat_n(ss, ss->buffer, MIN((size_t)ret, sizeof(ss->buffer) - 1));
+		return;
+	}
+
 	va_start(ap, fmt);
 	ret = cs_vsnprintf(ss->buffer + ss->index, sizeof(ss->buffer) - (ss->index + 1), fmt, ap);
 	va_end(ap);
@@ -52,118 +130,185 @@ void SStream_concat(SStream *ss, const char *fmt, ...)
 #endif
 }
 
+#ifndef CAPSTONE_DIET
+// "00", "01", .. "99"
+static const char dec_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+// "00", "01", .. "ff"
+static const char hex_pairs[] =
+	"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+	"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+	"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+	"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+	"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+	"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+	"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+	"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+// format @val in decimal into the bytes right before @end,
+// and return the first digit
+static char *fmt_dec(char *end, uint64_t val)
+{
+	while (val >= 100) {
+		unsigned int r = (unsigned int)(val % 100);
+
+		val /= 100;
+		end -= 2;
+		memcpy(end, dec_pairs + r * 2, 2);
+	}
+
+	if (val >= 10) {
+		end -= 2;
+		memcpy(end, dec_pairs + val * 2, 2);
+	} else
+		*--end = (char)('0' + val);
+
+	return end;
+}
+
+// format @val in lowercase hexadecimal into the bytes right before @end,
+// and return the first digit
+static char *fmt_hex(char *end, uint64_t val)
+{
+	while (val >= 0x100) {
+		end -= 2;
+		memcpy(end, hex_pairs + (val & 0xff) * 2, 2);
+		val >>= 8;
+	}
+
+	if (val >= 0x10) {
+		end -= 2;
+		memcpy(end, hex_pairs + val * 2, 2);
+	} else
+		*--end = hex_pairs[val * 2 + 1];
+
+	return end;
+}
+
+#endif
+
+void SStream_concat1(SStream *ss, const char c)
+{
+#ifndef CAPSTONE_DIET
+	if (ss->mnemonic) {
+		concat_n(ss, &c, 1);
+		return;
+	}
+
+	ss->buffer[ss->index++] = c;
+	ss->buffer[ss->index] = '\0';
+#endif
+}
+
+void SStream_concatDec(SStream *ss, uint64_t val)
+{
+#ifndef CAPSTONE_DIET
+	char tmp[20];
+	char *p = fmt_dec(tmp + sizeof(tmp), val);
+
+	concat_n(ss, p, tmp + sizeof(tmp) - p);
+#endif
+}
+
+void SStream_concatHex(SStream *ss, const char *prefix, uint64_t val)
+{
+#ifndef CAPSTONE_DIET
+	char tmp[16];
+	char *p = fmt_hex(tmp + sizeof(tmp), val);
+
+	if (prefix)
+		SStream_concat0(ss, prefix);
+	concat_n(ss, p, tmp + sizeof(tmp) - p);
+#endif
+}
+
+void SStream_concatMasmHex(SStream *ss, uint64_t val)
+{
+#ifndef CAPSTONE_DIET
+	char tmp[18];
+	char *p = fmt_hex(tmp + sizeof(tmp) - 1, val);
+
+	// a leading letter digit needs a 0 in front of it
+	if (*p >= 'a')
+		*--p = '0';
+	tmp[sizeof(tmp) - 1] = 'h';
+	concat_n(ss, p, tmp + sizeof(tmp) - p);
+#endif
+}
+
 // print number with prefix #
 void printInt64Bang(SStream *O, int64_t val)
 {
-	if (val >= 0) {
-		if (val > HEX_THRESHOLD)
-			SStream_concat(O, "#0x%"PRIx64, val);
-		else
-			SStream_concat(O, "#%"PRIu64, val);
-	} else {
-		if (val <- HEX_THRESHOLD) {
-			if (val == LONG_MIN)
-				SStream_concat(O, "#-0x%"PRIx64, (uint64_t)val);
-			else
-				SStream_concat(O, "#-0x%"PRIx64, (uint64_t)-val);
-		}
-		else
-			SStream_concat(O, "#-%"PRIu64, -val);
-	}
+	SStream_concat1(O, '#');
+	printInt64(O, val);
 }
 
 void printUInt64Bang(SStream *O, uint64_t val)
 {
-	if (val > HEX_THRESHOLD)
-		SStream_concat(O, "#0x%"PRIx64, val);
-	else
-		SStream_concat(O, "#%"PRIu64, val);
+	SStream_concat1(O, '#');
+	printUInt64(O, val);
 }
 
 // print number
 void printInt64(SStream *O, int64_t val)
 {
-	if (val >= 0) {
-		if (val > HEX_THRESHOLD)
-			SStream_concat(O, "0x%"PRIx64, val);
-		else
-			SStream_concat(O, "%"PRIu64, val);
-	} else {
-		if (val <- HEX_THRESHOLD) {
-			if (val == LONG_MIN)
-				SStream_concat(O, "-0x%"PRIx64, (uint64_t)val);
-			else
-				SStream_concat(O, "-0x%"PRIx64, (uint64_t)-val);
-		}
-		else
-			SStream_concat(O, "-%"PRIu64, -val);
-	}
+	if (val < 0) {
+		SStream_concat1(O, '-');
+		// 0 - val does not overflow for INT64_MIN
+		printUInt64(O, 0 - (uint64_t)val);
+	} else
+		printUInt64(O, val);
+}
+
+void printUInt64(SStream *O, uint64_t val)
+{
+	if (val > HEX_THRESHOLD)
+		SStream_concatHex(O, "0x", val);
+	else
+		SStream_concatDec(O, val);
 }
 
 // print number in decimal mode
 void printInt32BangDec(SStream *O, int32_t val)
 {
-	if (val >= 0)
-		SStream_concat(O, "#%u", val);
-	else
-		if (val == INT_MIN)
-			SStream_concat(O, "#-%u", val);
-		else
-			SStream_concat(O, "#-%u", (uint32_t)-val);
+	SStream_concat1(O, '#');
+	printInt32Dec(O, val);
+}
+
+void printInt32Dec(SStream *O, int32_t val)
+{
+	if (val < 0) {
+		SStream_concat1(O, '-');
+		SStream_concatDec(O, 0 - (uint32_t)val);
+	} else
+		SStream_concatDec(O, val);
 }
 
 void printInt32Bang(SStream *O, int32_t val)
 {
-	if (val >= 0) {
-		if (val > HEX_THRESHOLD)
-			SStream_concat(O, "#0x%x", val);
-		else
-			SStream_concat(O, "#%u", val);
-	} else {
-		if (val <- HEX_THRESHOLD) {
-			if (val == INT_MIN)
-				SStream_concat(O, "#-0x%x", (uint32_t)val);
-			else
-				SStream_concat(O, "#-0x%x", (uint32_t)-val);
-		}
-		else
-			SStream_concat(O, "#-%u", -val);
-	}
+	SStream_concat1(O, '#');
+	printInt64(O, val);
 }
 
 void printInt32(SStream *O, int32_t val)
 {
-	if (val >= 0) {
-		if (val > HEX_THRESHOLD)
-			SStream_concat(O, "0x%x", val);
-		else
-			SStream_concat(O, "%u", val);
-	} else {
-		if (val <- HEX_THRESHOLD) {
-			if (val == INT_MIN)
-				SStream_concat(O, "-0x%x", (uint32_t)val);
-			else
-				SStream_concat(O, "-0x%x", (uint32_t)-val);
-			}
-		else
-			SStream_concat(O, "-%u", -val);
-	}
+	printInt64(O, val);
 }
 
 void printUInt32Bang(SStream *O, uint32_t val)
 {
-	if (val > HEX_THRESHOLD)
-		SStream_concat(O, "#0x%x", val);
-	else
-		SStream_concat(O, "#%u", val);
+	SStream_concat1(O, '#');
+	printUInt64(O, val);
 }
 
 void printUInt32(SStream *O, uint32_t val)
 {
-	if (val > HEX_THRESHOLD)
-		SStream_concat(O, "0x%x", val);
-	else
-		SStream_concat(O, "%u", val);
+	printUInt64(O, val);
 }
 
 /*
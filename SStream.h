@@ -6,23 +6,55 @@
 
 #include "include/capstone/platform.h"
 
+typedef enum SStream_State {
+	SS_MNEMONIC = 0,	// emitting the mnemonic
+	SS_BLANK,	// skipping blanks after the mnemonic
+	SS_OPERANDS,	// emitting the operands
+} SStream_State;
+
 typedef struct SStream {
 	char buffer[512];
 	int index;
+	// when @mnemonic is set, output goes straight into @mnemonic & @op_str
+	// (normally cs_insn's fields) instead of @buffer
+	char *mnemonic;
+	char *op_str;
+	uint8_t mnem_len;
+	uint8_t op_len;
+	uint8_t state;	// SStream_State
 } SStream;
 
 void SStream_Init(SStream *ss);
 
+// init a stream writing the mnemonic & operands of an instruction directly
+void SStream_InitInsn(SStream *ss, char *mnemonic, char *op_str);
+
+// drop everything printed so far, keeping the output target
+void SStream_Clear(SStream *ss);
+
 void SStream_concat(SStream *ss, const char *fmt, ...);
 
 void SStream_concat0(SStream *ss, const char *s);
 
+void SStream_concat1(SStream *ss, const char c);
+
+// print unsigned number in decimal, without going through vsnprintf
+void SStream_concatDec(SStream *ss, uint64_t val);
+
+// print @prefix (may be NULL), then unsigned number in lowercase hex
+void SStream_concatHex(SStream *ss, const char *prefix, uint64_t val);
+
+// print unsigned number in MASM hex form: 123h, 0a123h
+void SStream_concatMasmHex(SStream *ss, uint64_t val);
+
 void printInt64Bang(SStream *O, int64_t val);
 
 void printUInt64Bang(SStream *O, uint64_t val);
 
 void printInt64(SStream *O, int64_t val);
 
+void printUInt64(SStream *O, uint64_t val);
+
 void printInt32Bang(SStream *O, int32_t val);
 
 void printInt32(SStream *O, int32_t val);
@@ -34,4 +66,6 @@ void printUInt32(SStream *O, uint32_t val);
 // print number in decimal mode
 void printInt32BangDec(SStream *O, int32_t val);
 
+void printInt32Dec(SStream *O, int32_t val);
+
 #endif
@@ -1647,26 +1647,31 @@ static DecodeStatus DecodeTestAndBranch(MCInst *Inst, uint32_t insn,
 	return Success;
 }
 
-void AArch64_init(MCRegisterInfo *MRI)
+/*
+	InitMCRegisterInfo(AArch64RegDesc, 420,
+		RA, PC,
+		AArch64MCRegisterClasses, 43,
+		AArch64RegUnitRoots, 66, AArch64RegDiffLists,
+		AArch64RegStrings,
+		AArch64SubRegIdxLists, 53,
+		AArch64SubRegIdxRanges,
+		AArch64RegEncodingTable);
+*/
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo AArch64_MRI = {
+	AArch64RegDesc, 420,
+	0, 0,
+	AArch64MCRegisterClasses, 43,
+	0, 0,
+	AArch64RegDiffLists, 0,
+	AArch64SubRegIdxLists, 53,
+	0
+};
+
+const MCRegisterInfo *AArch64_getRegisterInfo(void)
 {
-	/*
-		InitMCRegisterInfo(AArch64RegDesc, 420,
-			RA, PC,
-			AArch64MCRegisterClasses, 43,
-			AArch64RegUnitRoots, 66, AArch64RegDiffLists,
-			AArch64RegStrings,
-			AArch64SubRegIdxLists, 53,
-			AArch64SubRegIdxRanges,
-			AArch64RegEncodingTable);
-	*/
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, AArch64RegDesc, 420,
-			0, 0, 
-			AArch64MCRegisterClasses, 43,
-			0, 0, AArch64RegDiffLists,
-			0, 
-			AArch64SubRegIdxLists, 53,
-			0);
+	return &AArch64_MRI;
 }
 
 #endif
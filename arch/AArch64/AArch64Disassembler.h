@@ -8,7 +8,7 @@
 #include "../../MCRegisterInfo.h"
 #include "../../MCInst.h"
 
-void AArch64_init(MCRegisterInfo *MRI);
+const MCRegisterInfo *AArch64_getRegisterInfo(void);
 
 bool AArch64_getInstruction(csh ud, const uint8_t *code, size_t code_len,
 		MCInst *instr, uint16_t *size, uint64_t address, void *info);
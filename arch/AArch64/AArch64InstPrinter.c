@@ -45,10 +45,10 @@ static char *printAliasInstr(MCInst *MI, SStream *OS, void *info);
 static void printInstruction(MCInst *MI, SStream *O, MCRegisterInfo *MRI);
 static void printShifter(MCInst *MI, unsigned OpNum, SStream *O);
 
-static cs_ac_type get_op_access(cs_struct *h, unsigned int id, unsigned int index)
+static cs_ac_type get_op_access(MCInst *MI, unsigned int index)
 {
 #ifndef CAPSTONE_DIET
-	uint8_t *arr = AArch64_get_op_access(h, id);
+	const uint8_t *arr = AArch64_get_op_access(MI);
 
 	if (arr[index] == CS_AC_IGNORE)
 		return 0;
@@ -69,7 +69,7 @@ static void set_mem_access(MCInst *MI, bool status)
 	if (status) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -138,7 +138,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 					uint8_t access;
-					access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+					access = get_op_access(MI, MI->ac_idx);
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 					MI->ac_idx++;
 #endif
@@ -146,7 +146,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op0);
 					MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-					access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+					access = get_op_access(MI, MI->ac_idx);
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 					MI->ac_idx++;
 #endif
@@ -203,7 +203,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 					uint8_t access;
-					access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+					access = get_op_access(MI, MI->ac_idx);
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 					MI->ac_idx++;
 #endif
@@ -211,7 +211,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op0);
 					MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-					access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+					access = get_op_access(MI, MI->ac_idx);
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 					MI->ac_idx++;
 #endif
@@ -219,7 +219,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op1);
 					MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-					access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+					access = get_op_access(MI, MI->ac_idx);
 					MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 					MI->ac_idx++;
 #endif
@@ -246,7 +246,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -254,7 +254,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op0);
 				MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -262,7 +262,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op1);
 				MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -270,7 +270,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].imm = (Is64Bit ? 64 : 32) - (int)MCOperand_getImm(Op2);
 				MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -295,7 +295,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -303,7 +303,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op0);
 			MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -311,7 +311,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op1);
 			MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -319,7 +319,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].imm = MCOperand_getImm(Op2);
 			MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -354,7 +354,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -362,7 +362,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op0);
 				MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -370,7 +370,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op2);
 				MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -378,7 +378,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].imm = LSB;
 				MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -404,7 +404,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -412,7 +412,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op0);
 			MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -420,7 +420,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].reg = MCOperand_getReg(Op2);
 			MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -428,7 +428,7 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].imm = LSB;
 			MI->flat_insn->detail->arm64.op_count++;
 #ifndef CAPSTONE_DIET
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -449,7 +449,9 @@ void AArch64_printInst(MCInst *MI, SStream *O, void *Info)
 	}
 }
 
-static bool printSysAlias(MCInst *MI, SStream *O)
+// return the asm string of the SYS alias of @MI, or NULL if there is none.
+// @insn_id & @sys_op receive the public instruction ID & the ARM64_OP_SYS value
+static const char *getSysAlias(MCInst *MI, unsigned *insn_id, unsigned *sys_op)
 {
 	// unsigned Opcode = MCInst_getOpcode(MI);
 	//assert(Opcode == AArch64_SYSxt && "Invalid opcode for SYS alias!");
@@ -464,9 +466,10 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 	unsigned CnVal = (unsigned)MCOperand_getImm(Cn);
 	unsigned CmVal = (unsigned)MCOperand_getImm(Cm);
 	unsigned Op2Val = (unsigned)MCOperand_getImm(Op2);
-	unsigned insn_id = ARM64_INS_INVALID;
 	unsigned op_ic = 0, op_dc = 0, op_at = 0, op_tlbi = 0;
 
+	*insn_id = ARM64_INS_INVALID;
+
 	if (CnVal == 7) {
 		switch (CmVal) {
 			default:
@@ -476,18 +479,18 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 			case 1:
 				if (Op1Val == 0 && Op2Val == 0) {
 					Asm = "ic\tialluis";
-					insn_id = ARM64_INS_IC;
+					*insn_id = ARM64_INS_IC;
 					op_ic = ARM64_IC_IALLUIS;
 				}
 				break;
 			case 5:
 				if (Op1Val == 0 && Op2Val == 0) {
 					Asm = "ic\tiallu";
-					insn_id = ARM64_INS_IC;
+					*insn_id = ARM64_INS_IC;
 					op_ic = ARM64_IC_IALLU;
 				} else if (Op1Val == 3 && Op2Val == 1) {
 					Asm = "ic\tivau";
-					insn_id = ARM64_INS_IC;
+					*insn_id = ARM64_INS_IC;
 					op_ic = ARM64_IC_IVAU;
 				}
 				break;
@@ -496,48 +499,48 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 			case 4:
 				if (Op1Val == 3 && Op2Val == 1) {
 					Asm = "dc\tzva";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_ZVA;
 				}
 				break;
 			case 6:
 				if (Op1Val == 0 && Op2Val == 1) {
 					Asm = "dc\tivac";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_IVAC;
 				}
 				if (Op1Val == 0 && Op2Val == 2) {
 					Asm = "dc\tisw";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_ISW;
 				}
 				break;
 			case 10:
 				if (Op1Val == 3 && Op2Val == 1) {
 					Asm = "dc\tcvac";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_CVAC;
 				} else if (Op1Val == 0 && Op2Val == 2) {
 					Asm = "dc\tcsw";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_CSW;
 				}
 				break;
 			case 11:
 				if (Op1Val == 3 && Op2Val == 1) {
 					Asm = "dc\tcvau";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_CVAU;
 				}
 				break;
 			case 14:
 				if (Op1Val == 3 && Op2Val == 1) {
 					Asm = "dc\tcivac";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_CIVAC;
 				} else if (Op1Val == 0 && Op2Val == 2) {
 					Asm = "dc\tcisw";
-					insn_id = ARM64_INS_DC;
+					*insn_id = ARM64_INS_DC;
 					op_dc = ARM64_DC_CISW;
 				}
 				break;
@@ -551,30 +554,30 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "at\ts1e1r"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1R; break;
-							case 1: Asm = "at\ts1e1w"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1W; break;
-							case 2: Asm = "at\ts1e0r"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0R; break;
-							case 3: Asm = "at\ts1e0w"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0W; break;
+							case 0: Asm = "at\ts1e1r"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1R; break;
+							case 1: Asm = "at\ts1e1w"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1W; break;
+							case 2: Asm = "at\ts1e0r"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0R; break;
+							case 3: Asm = "at\ts1e0w"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0W; break;
 						}
 						break;
 					case 4:
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "at\ts1e2r"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E2R; break;
-							case 1: Asm = "at\ts1e2w"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E2W; break;
-							case 4: Asm = "at\ts12e1r"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1R; break;
-							case 5: Asm = "at\ts12e1w"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1W; break;
-							case 6: Asm = "at\ts12e0r"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0R; break;
-							case 7: Asm = "at\ts12e0w"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0W; break;
+							case 0: Asm = "at\ts1e2r"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E2R; break;
+							case 1: Asm = "at\ts1e2w"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E2W; break;
+							case 4: Asm = "at\ts12e1r"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1R; break;
+							case 5: Asm = "at\ts12e1w"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E1W; break;
+							case 6: Asm = "at\ts12e0r"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0R; break;
+							case 7: Asm = "at\ts12e0w"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E0W; break;
 						}
 						break;
 					case 6:
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "at\ts1e3r"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E3R; break;
-							case 1: Asm = "at\ts1e3w"; insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E3W; break;
+							case 0: Asm = "at\ts1e3r"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E3R; break;
+							case 1: Asm = "at\ts1e3w"; *insn_id = ARM64_INS_AT; op_at = ARM64_AT_S1E3W; break;
 						}
 						break;
 				}
@@ -593,32 +596,32 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "tlbi\tvmalle1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLE1IS; break;
-							case 1: Asm = "tlbi\tvae1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE1IS; break;
-							case 2: Asm = "tlbi\taside1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ASIDE1IS; break;
-							case 3: Asm = "tlbi\tvaae1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAAE1IS; break;
-							case 5: Asm = "tlbi\tvale1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE1IS; break;
-							case 7: Asm = "tlbi\tvaale1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAALE1IS; break;
+							case 0: Asm = "tlbi\tvmalle1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLE1IS; break;
+							case 1: Asm = "tlbi\tvae1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE1IS; break;
+							case 2: Asm = "tlbi\taside1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ASIDE1IS; break;
+							case 3: Asm = "tlbi\tvaae1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAAE1IS; break;
+							case 5: Asm = "tlbi\tvale1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE1IS; break;
+							case 7: Asm = "tlbi\tvaale1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAALE1IS; break;
 						}
 						break;
 					case 4:
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "tlbi\talle2is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE2IS; break;
-							case 1: Asm = "tlbi\tvae2is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE2IS; break;
-							case 4: Asm = "tlbi\talle1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE1IS; break;
-							case 5: Asm = "tlbi\tvale2is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE2IS; break;
-							case 6: Asm = "tlbi\tvmalls12e1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLS12E1IS; break;
+							case 0: Asm = "tlbi\talle2is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE2IS; break;
+							case 1: Asm = "tlbi\tvae2is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE2IS; break;
+							case 4: Asm = "tlbi\talle1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE1IS; break;
+							case 5: Asm = "tlbi\tvale2is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE2IS; break;
+							case 6: Asm = "tlbi\tvmalls12e1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLS12E1IS; break;
 						}
 						break;
 					case 6:
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "tlbi\talle3is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE3IS; break;
-							case 1: Asm = "tlbi\tvae3is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE3IS; break;
-							case 5: Asm = "tlbi\tvale3is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE3IS; break;
+							case 0: Asm = "tlbi\talle3is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE3IS; break;
+							case 1: Asm = "tlbi\tvae3is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE3IS; break;
+							case 5: Asm = "tlbi\tvale3is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE3IS; break;
 						}
 						break;
 				}
@@ -631,8 +634,8 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 						switch (Op2Val) {
 							default:
 								break;
-							case 1: Asm = "tlbi\tipas2e1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2E1IS; break;
-							case 5: Asm = "tlbi\tipas2le1is"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2LE1IS; break;
+							case 1: Asm = "tlbi\tipas2e1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2E1IS; break;
+							case 5: Asm = "tlbi\tipas2le1is"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2LE1IS; break;
 						}
 						break;
 				}
@@ -645,8 +648,8 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 						switch (Op2Val) {
 							default:
 								break;
-							case 1: Asm = "tlbi\tipas2e1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2E1; break;
-							case 5: Asm = "tlbi\tipas2le1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2LE1; break;
+							case 1: Asm = "tlbi\tipas2e1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2E1; break;
+							case 5: Asm = "tlbi\tipas2le1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_IPAS2LE1; break;
 						}
 						break;
 				}
@@ -659,32 +662,32 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "tlbi\tvmalle1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLE1; break;
-							case 1: Asm = "tlbi\tvae1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE1; break;
-							case 2: Asm = "tlbi\taside1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ASIDE1; break;
-							case 3: Asm = "tlbi\tvaae1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAAE1; break;
-							case 5: Asm = "tlbi\tvale1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE1; break;
-							case 7: Asm = "tlbi\tvaale1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAALE1; break;
+							case 0: Asm = "tlbi\tvmalle1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLE1; break;
+							case 1: Asm = "tlbi\tvae1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE1; break;
+							case 2: Asm = "tlbi\taside1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ASIDE1; break;
+							case 3: Asm = "tlbi\tvaae1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAAE1; break;
+							case 5: Asm = "tlbi\tvale1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE1; break;
+							case 7: Asm = "tlbi\tvaale1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAALE1; break;
 						}
 						break;
 					case 4:
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "tlbi\talle2"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE2; break;
-							case 1: Asm = "tlbi\tvae2"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE2; break;
-							case 4: Asm = "tlbi\talle1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE1; break;
-							case 5: Asm = "tlbi\tvale2"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE2; break;
-							case 6: Asm = "tlbi\tvmalls12e1"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLS12E1; break;
+							case 0: Asm = "tlbi\talle2"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE2; break;
+							case 1: Asm = "tlbi\tvae2"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VAE2; break;
+							case 4: Asm = "tlbi\talle1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE1; break;
+							case 5: Asm = "tlbi\tvale2"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE2; break;
+							case 6: Asm = "tlbi\tvmalls12e1"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VMALLS12E1; break;
 						}
 						break;
 					case 6:
 						switch (Op2Val) {
 							default:
 								break;
-							case 0: Asm = "tlbi\talle3"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE3; break;
-							case 1: Asm = "tlbi\tvae3"; insn_id = ARM64_INS_TLBI;  op_tlbi = ARM64_TLBI_VAE3; break;
-							case 5: Asm = "tlbi\tvale3"; insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE3; break;
+							case 0: Asm = "tlbi\talle3"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_ALLE3; break;
+							case 1: Asm = "tlbi\tvae3"; *insn_id = ARM64_INS_TLBI;  op_tlbi = ARM64_TLBI_VAE3; break;
+							case 5: Asm = "tlbi\tvale3"; *insn_id = ARM64_INS_TLBI; op_tlbi = ARM64_TLBI_VALE3; break;
 						}
 						break;
 				}
@@ -692,28 +695,39 @@ static bool printSysAlias(MCInst *MI, SStream *O)
 		}
 	}
 
+	*sys_op = op_ic + op_dc + op_at + op_tlbi;
+
+	return Asm;
+}
+
+static bool printSysAlias(MCInst *MI, SStream *O)
+{
+	unsigned insn_id, sys_op;
+	const char *Asm = getSysAlias(MI, &insn_id, &sys_op);
+
 	if (Asm) {
 		MCInst_setOpcodePub(MI, insn_id);
 		SStream_concat0(O, Asm);
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].type = ARM64_OP_SYS;
-			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].sys = op_ic + op_dc + op_at + op_tlbi;
+			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].sys = sys_op;
 			MI->flat_insn->detail->arm64.op_count++;
 		}
 
 		if (!strstr(Asm, "all")) {
 			unsigned Reg = MCOperand_getReg(MCInst_getOperand(MI, 4));
-			SStream_concat(O, ", %s", getRegisterName(Reg, AArch64_NoRegAltName));
+			SStream_concat0(O, ", ");
+			SStream_concat0(O, getRegisterName(Reg, AArch64_NoRegAltName));
 			if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -745,7 +759,7 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 			} else {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -777,7 +791,7 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 			} else {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -792,11 +806,14 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 static void printHexImm(MCInst *MI, unsigned OpNo, SStream *O)
 {
 	MCOperand *Op = MCInst_getOperand(MI, OpNo);
-	SStream_concat(O, "#%#llx", MCOperand_getImm(Op));
+	if (MCOperand_getImm(Op))
+		SStream_concatHex(O, "#0x", MCOperand_getImm(Op));
+	else
+		SStream_concat0(O, "#0");
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -818,7 +835,7 @@ static void printPostIncOperand(MCInst *MI, unsigned OpNo,
 			if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -831,7 +848,7 @@ static void printPostIncOperand(MCInst *MI, unsigned OpNo,
 			if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -858,7 +875,7 @@ static void printVRegOperand(MCInst *MI, unsigned OpNo, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -872,11 +889,12 @@ static void printSysCROperand(MCInst *MI, unsigned OpNo, SStream *O)
 {
 	MCOperand *Op = MCInst_getOperand(MI, OpNo);
 	//assert(Op.isImm() && "System instruction C[nm] operands must be immediates!");
-	SStream_concat(O, "c%u", MCOperand_getImm(Op));
+	SStream_concat1(O, 'c');
+	SStream_concatDec(O, (unsigned int)MCOperand_getImm(Op));
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -899,7 +917,7 @@ static void printAddSubImm(MCInst *MI, unsigned OpNum, SStream *O)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -923,7 +941,7 @@ static void printLogicalImm32(MCInst *MI, unsigned OpNum, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -947,17 +965,18 @@ static void printLogicalImm64(MCInst *MI, unsigned OpNum, SStream *O)
 		case ARM64_INS_EOR:
 		case ARM64_INS_TST:
 			// do not print number in negative form
-			if (Val >= 0 && Val <= HEX_THRESHOLD)
-				SStream_concat(O, "#%u", (int)Val);
-			else
-				SStream_concat(O, "#0x%"PRIx64, Val);
+			if (Val >= 0 && Val <= HEX_THRESHOLD) {
+				SStream_concat1(O, '#');
+				SStream_concatDec(O, Val);
+			} else
+				SStream_concatHex(O, "#0x", Val);
 			break;
 	}
 
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -976,7 +995,9 @@ static void printShifter(MCInst *MI, unsigned OpNum, SStream *O)
 			AArch64_AM_getShiftValue(Val) == 0)
 		return;
 
-	SStream_concat(O, ", %s ", AArch64_AM_getShiftExtendName(AArch64_AM_getShiftType(Val)));
+	SStream_concat0(O, ", ");
+	SStream_concat0(O, AArch64_AM_getShiftExtendName(AArch64_AM_getShiftType(Val)));
+	SStream_concat1(O, ' ');
 	printInt32BangDec(O, AArch64_AM_getShiftValue(Val));
 	if (MI->csh->detail) {
 		arm64_shifter shifter = ARM64_SFT_INVALID;
@@ -1010,7 +1031,7 @@ static void printShiftedRegister(MCInst *MI, unsigned OpNum, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -1050,7 +1071,8 @@ static void printArithExtend(MCInst *MI, unsigned OpNum, SStream *O)
 		}
 	}
 
-	SStream_concat(O, ", %s", AArch64_AM_getShiftExtendName(ExtType));
+	SStream_concat0(O, ", ");
+	SStream_concat0(O, AArch64_AM_getShiftExtendName(ExtType));
 	if (MI->csh->detail) {
 		arm64_extender ext = ARM64_EXT_INVALID;
 		switch(ExtType) {
@@ -1102,7 +1124,7 @@ static void printExtendedRegister(MCInst *MI, unsigned OpNum, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -1127,7 +1149,9 @@ static void printMemExtend(MCInst *MI, unsigned OpNum, SStream *O, char SrcRegKi
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].shift.type = ARM64_SFT_LSL;
 		}
 	} else {
-		SStream_concat(O, "%cxt%c", (SignExtend ? 's' : 'u'), SrcRegKind);
+		SStream_concat1(O, SignExtend ? 's' : 'u');
+		SStream_concat0(O, "xt");
+		SStream_concat1(O, SrcRegKind);
 		if (MI->csh->detail) {
 			if (!SignExtend) {
 				switch(SrcRegKind) {
@@ -1163,7 +1187,8 @@ static void printMemExtend(MCInst *MI, unsigned OpNum, SStream *O, char SrcRegKi
 	}
 
 	if (DoShift || IsLSL) {
-		SStream_concat(O, " #%u", Log2_32(Width / 8));
+		SStream_concat0(O, " #");
+		SStream_concatDec(O, Log2_32(Width / 8));
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].shift.type = ARM64_SFT_LSL;
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].shift.value = Log2_32(Width / 8);
@@ -1202,7 +1227,7 @@ static void printImmScale(MCInst *MI, unsigned OpNum, SStream *O, int Scale)
 		} else {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1226,7 +1251,7 @@ static void printUImm12Offset(MCInst *MI, unsigned OpNum, unsigned Scale, SStrea
 			} else {
 #ifndef CAPSTONE_DIET
 				uint8_t access;
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -1262,7 +1287,7 @@ static void printPrefetchOp(MCInst *MI, unsigned OpNum, SStream *O)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1288,7 +1313,7 @@ static void printFPImmOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -1344,26 +1369,27 @@ static unsigned getNextVectorRegister(unsigned Reg, unsigned Stride)
 	return Reg;
 }
 
-static void printVectorList(MCInst *MI, unsigned OpNum, SStream *O, char *LayoutSuffix, MCRegisterInfo *MRI, arm64_vas vas, arm64_vess vess)
+// return the first register of the vector list in operand @OpNum, as a
+// Q-register, and the number of registers in the list in @NumRegs
+static unsigned getVectorListStart(MCInst *MI, unsigned OpNum, MCRegisterInfo *MRI, unsigned *NumRegs)
 {
 #define GETREGCLASS_CONTAIN0(_class, _reg) MCRegisterClass_contains(MCRegisterInfo_getRegClass(MRI, _class), _reg)
 
 	unsigned Reg = MCOperand_getReg(MCInst_getOperand(MI, OpNum));
-	unsigned NumRegs = 1, FirstReg, i;
-
-	SStream_concat0(O, "{");
+	unsigned FirstReg;
 
 	// Work out how many registers there are in the list (if there is an actual
 	// list).
+	*NumRegs = 1;
 	if (GETREGCLASS_CONTAIN0(AArch64_DDRegClassID , Reg) ||
 			GETREGCLASS_CONTAIN0(AArch64_QQRegClassID, Reg))
-		NumRegs = 2;
+		*NumRegs = 2;
 	else if (GETREGCLASS_CONTAIN0(AArch64_DDDRegClassID, Reg) ||
 			GETREGCLASS_CONTAIN0(AArch64_QQQRegClassID, Reg))
-		NumRegs = 3;
+		*NumRegs = 3;
 	else if (GETREGCLASS_CONTAIN0(AArch64_DDDDRegClassID, Reg) ||
 			GETREGCLASS_CONTAIN0(AArch64_QQQQRegClassID, Reg))
-		NumRegs = 4;
+		*NumRegs = 4;
 
 	// Now forget about the list and find out what the first register is.
 	if ((FirstReg = MCRegisterInfo_getSubReg(MRI, Reg, AArch64_dsub0)))
@@ -1378,14 +1404,25 @@ static void printVectorList(MCInst *MI, unsigned OpNum, SStream *O, char *Layout
 		Reg = MCRegisterInfo_getMatchingSuperReg(MRI, Reg, AArch64_dsub, FPR128RC);
 	}
 
+	return Reg;
+}
+
+static void printVectorList(MCInst *MI, unsigned OpNum, SStream *O, char *LayoutSuffix, MCRegisterInfo *MRI, arm64_vas vas, arm64_vess vess)
+{
+	unsigned NumRegs, i;
+	unsigned Reg = getVectorListStart(MI, OpNum, MRI, &NumRegs);
+
+	SStream_concat0(O, "{");
+
 	for (i = 0; i < NumRegs; ++i, Reg = getNextVectorRegister(Reg, 1)) {
-		SStream_concat(O, "%s%s", getRegisterName(Reg, AArch64_vreg), LayoutSuffix);
+		SStream_concat0(O, getRegisterName(Reg, AArch64_vreg));
+		SStream_concat0(O, LayoutSuffix);
 		if (i + 1 != NumRegs)
 			SStream_concat0(O, ", ");
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1402,12 +1439,15 @@ static void printVectorList(MCInst *MI, unsigned OpNum, SStream *O, char *Layout
 
 static void printTypedVectorList(MCInst *MI, unsigned OpNum, SStream *O, unsigned NumLanes, char LaneKind, MCRegisterInfo *MRI)
 {
-	char Suffix[32];
+	SStream Suffix;
 	arm64_vas vas = 0;
 	arm64_vess vess = 0;
 
+	SStream_Init(&Suffix);
+	SStream_concat1(&Suffix, '.');
 	if (NumLanes) {
-		cs_snprintf(Suffix, sizeof(Suffix), ".%u%c", NumLanes, LaneKind);
+		SStream_concatDec(&Suffix, NumLanes);
+		SStream_concat1(&Suffix, LaneKind);
 		switch(LaneKind) {
 			default: break;
 			case 'b':
@@ -1464,7 +1504,7 @@ static void printTypedVectorList(MCInst *MI, unsigned OpNum, SStream *O, unsigne
 				break;
 		}
 	} else {
-		cs_snprintf(Suffix, sizeof(Suffix), ".%c", LaneKind);
+		SStream_concat1(&Suffix, LaneKind);
 		switch(LaneKind) {
 			default: break;
 			case 'b':
@@ -1482,7 +1522,7 @@ static void printTypedVectorList(MCInst *MI, unsigned OpNum, SStream *O, unsigne
 		}
 	}
 
-	printVectorList(MI, OpNum, O, Suffix, MRI, vas, vess);
+	printVectorList(MI, OpNum, O, Suffix.buffer, MRI, vas, vess);
 }
 
 static void printVectorIndex(MCInst *MI, unsigned OpNum, SStream *O)
@@ -1507,7 +1547,7 @@ static void printAlignedLabel(MCInst *MI, unsigned OpNum, SStream *O)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1532,7 +1572,7 @@ static void printAdrpLabel(MCInst *MI, unsigned OpNum, SStream *O)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1561,7 +1601,7 @@ static void printBarrierOption(MCInst *MI, unsigned OpNo, SStream *O)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1574,7 +1614,7 @@ static void printBarrierOption(MCInst *MI, unsigned OpNo, SStream *O)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1596,7 +1636,7 @@ static void printMRSSystemRegister(MCInst *MI, unsigned OpNo, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -1617,7 +1657,7 @@ static void printMSRSystemRegister(MCInst *MI, unsigned OpNo, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		uint8_t access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -1639,7 +1679,7 @@ static void printSystemPStateField(MCInst *MI, unsigned OpNo, SStream *O)
 		if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 			uint8_t access;
-			access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+			access = get_op_access(MI, MI->ac_idx);
 			MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 			MI->ac_idx++;
 #endif
@@ -1653,7 +1693,7 @@ static void printSystemPStateField(MCInst *MI, unsigned OpNo, SStream *O)
 #endif
 		printInt32Bang(O, Val);
 #ifndef CAPSTONE_DIET
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -1671,7 +1711,7 @@ static void printSIMDType10Operand(MCInst *MI, unsigned OpNo, SStream *O)
 	if (MI->csh->detail) {
 #ifndef CAPSTONE_DIET
 		unsigned char access;
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -1685,7 +1725,7 @@ static void printSIMDType10Operand(MCInst *MI, unsigned OpNo, SStream *O)
 #define PRINT_ALIAS_INSTR
 #include "AArch64GenAsmWriter.inc"
 
-void AArch64_post_printer(csh handle, cs_insn *flat_insn, char *insn_asm, MCInst *mci)
+void AArch64_post_printer(csh handle, cs_insn *flat_insn, MCInst *mci)
 {
 	if (((cs_struct *)handle)->detail != CS_OPT_ON)
 		return;
@@ -1939,4 +1979,625 @@ void AArch64_post_printer(csh handle, cs_insn *flat_insn, char *insn_asm, MCInst
 	}
 }
 
+
+#ifndef CAPSTONE_DIET
+// steps of the operand programs in AArch64GenDetailOps.inc. Each step fills in
+// the same detail as the print function it is named after, but prints nothing.
+enum {
+	AArch64_DOP_END = 0,
+	AArch64_DOP_OPERAND,	// printOperand()
+	AArch64_DOP_HEXIMM,	// printHexImm()
+	AArch64_DOP_POSTINC,	// printPostIncOperand(), param: amount
+	AArch64_DOP_VREG,	// printVRegOperand()
+	AArch64_DOP_SYSCR,	// printSysCROperand()
+	AArch64_DOP_ADDSUBIMM,	// printAddSubImm()
+	AArch64_DOP_LOGICALIMM32,	// printLogicalImm32()
+	AArch64_DOP_LOGICALIMM64,	// printLogicalImm64()
+	AArch64_DOP_SHIFTER,	// printShifter()
+	AArch64_DOP_SHIFTEDREG,	// printShiftedRegister()
+	AArch64_DOP_ARITHEXTEND,	// printArithExtend()
+	AArch64_DOP_EXTENDEDREG,	// printExtendedRegister()
+	AArch64_DOP_MEMEXTEND_W,	// printMemExtend() of a W register, param: width
+	AArch64_DOP_MEMEXTEND_X,	// printMemExtend() of a X register, param: width
+	AArch64_DOP_CONDCODE,	// printCondCode()
+	AArch64_DOP_INVCONDCODE,	// printInverseCondCode()
+	AArch64_DOP_IMMSCALE,	// printImmScale(), param: scale
+	AArch64_DOP_UIMM12OFFSET,	// printUImm12Offset(), param: scale
+	AArch64_DOP_PREFETCH,	// printPrefetchOp()
+	AArch64_DOP_FPIMM,	// printFPImmOperand()
+	AArch64_DOP_VLIST_VAS,	// printTypedVectorList() with lanes, param: arm64_vas
+	AArch64_DOP_VLIST_VESS,	// printTypedVectorList() without lanes, param: arm64_vess
+	AArch64_DOP_VINDEX,	// printVectorIndex()
+	AArch64_DOP_ALIGNEDLABEL,	// printAlignedLabel()
+	AArch64_DOP_ADRPLABEL,	// printAdrpLabel()
+	AArch64_DOP_BARRIER,	// printBarrierOption()
+	AArch64_DOP_MRS,	// printMRSSystemRegister()
+	AArch64_DOP_MSR,	// printMSRSystemRegister()
+	AArch64_DOP_PSTATE,	// printSystemPStateField()
+	AArch64_DOP_SIMDTYPE10,	// printSIMDType10Operand()
+	AArch64_DOP_MEM_BEGIN,	// set_mem_access(MI, true)
+	AArch64_DOP_MEM_END,	// set_mem_access(MI, false)
+	AArch64_DOP_VAS,	// arm64_op_addVectorArrSpecifier(), param: arm64_vas
+	AArch64_DOP_VESS,	// arm64_op_addVectorElementSizeSpecifier(), param: arm64_vess
+	AArch64_DOP_IMM,	// arm64_op_addImm(), param: immediate
+	AArch64_DOP_FP_ZERO,	// arm64_op_addFP(MI, 0.0)
+};
+
+typedef struct aarch64_detail_op {
+	uint8_t kind;	// AArch64_DOP_*
+	uint8_t opnum;	// index of the MCInst operand
+	uint16_t param;
+} aarch64_detail_op;
+
+#include "AArch64GenDetailOps.inc"
+
+// append a new operand of @type, with its access info
+static cs_arm64_op *detail_add_op(MCInst *MI, arm64_op_type type)
+{
+	cs_arm64 *arm64 = &MI->flat_insn->detail->arm64;
+	cs_arm64_op *op = &arm64->operands[arm64->op_count];
+
+	op->access = get_op_access(MI, MI->ac_idx);
+	MI->ac_idx++;
+	op->type = type;
+	arm64->op_count++;
+
+	return op;
+}
+
+static void detail_add_reg(MCInst *MI, unsigned reg)
+{
+	detail_add_op(MI, ARM64_OP_REG)->reg = reg;
+}
+
+static void detail_add_imm(MCInst *MI, int64_t imm)
+{
+	detail_add_op(MI, ARM64_OP_IMM)->imm = imm;
+}
+
+// detail of printShifter()
+static void detail_shifter(MCInst *MI, unsigned OpNum)
+{
+	cs_arm64 *arm64 = &MI->flat_insn->detail->arm64;
+	unsigned Val = (unsigned)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
+	arm64_shifter shifter;
+
+	// LSL #0 is not printed
+	if (AArch64_AM_getShiftType(Val) == AArch64_AM_LSL &&
+			AArch64_AM_getShiftValue(Val) == 0)
+		return;
+
+	switch(AArch64_AM_getShiftType(Val)) {
+		default:	// never reach
+		case AArch64_AM_LSL:
+			shifter = ARM64_SFT_LSL;
+			break;
+		case AArch64_AM_LSR:
+			shifter = ARM64_SFT_LSR;
+			break;
+		case AArch64_AM_ASR:
+			shifter = ARM64_SFT_ASR;
+			break;
+		case AArch64_AM_ROR:
+			shifter = ARM64_SFT_ROR;
+			break;
+		case AArch64_AM_MSL:
+			shifter = ARM64_SFT_MSL;
+			break;
+	}
+
+	arm64->operands[arm64->op_count - 1].shift.type = shifter;
+	arm64->operands[arm64->op_count - 1].shift.value = AArch64_AM_getShiftValue(Val);
+}
+
+// detail of printArithExtend()
+static void detail_arith_extend(MCInst *MI, unsigned OpNum)
+{
+	cs_arm64_op *op = &MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count - 1];
+	unsigned Val = (unsigned)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
+	AArch64_AM_ShiftExtendType ExtType = AArch64_AM_getArithExtendType(Val);
+	unsigned ShiftVal = AArch64_AM_getArithShiftValue(Val);
+
+	// UXTW/UXTX of [W]SP is shown as LSL
+	if (ExtType == AArch64_AM_UXTW || ExtType == AArch64_AM_UXTX) {
+		unsigned Dest = MCOperand_getReg(MCInst_getOperand(MI, 0));
+		unsigned Src1 = MCOperand_getReg(MCInst_getOperand(MI, 1));
+		if ( ((Dest == AArch64_SP || Src1 == AArch64_SP) &&
+					ExtType == AArch64_AM_UXTX) ||
+				((Dest == AArch64_WSP || Src1 == AArch64_WSP) &&
+				 ExtType == AArch64_AM_UXTW) ) {
+			if (ShiftVal != 0) {
+				op->shift.type = ARM64_SFT_LSL;
+				op->shift.value = ShiftVal;
+			}
+
+			return;
+		}
+	}
+
+	switch(ExtType) {
+		default:	// never reach
+		case AArch64_AM_UXTB:
+			op->ext = ARM64_EXT_UXTB;
+			break;
+		case AArch64_AM_UXTH:
+			op->ext = ARM64_EXT_UXTH;
+			break;
+		case AArch64_AM_UXTW:
+			op->ext = ARM64_EXT_UXTW;
+			break;
+		case AArch64_AM_UXTX:
+			op->ext = ARM64_EXT_UXTX;
+			break;
+		case AArch64_AM_SXTB:
+			op->ext = ARM64_EXT_SXTB;
+			break;
+		case AArch64_AM_SXTH:
+			op->ext = ARM64_EXT_SXTH;
+			break;
+		case AArch64_AM_SXTW:
+			op->ext = ARM64_EXT_SXTW;
+			break;
+		case AArch64_AM_SXTX:
+			op->ext = ARM64_EXT_SXTX;
+			break;
+	}
+
+	if (ShiftVal != 0) {
+		op->shift.type = ARM64_SFT_LSL;
+		op->shift.value = ShiftVal;
+	}
+}
+
+// detail of printMemExtend()
+static void detail_mem_extend(MCInst *MI, unsigned OpNum, char SrcRegKind, unsigned Width)
+{
+	cs_arm64_op *op = &MI->flat_insn->detail->arm64.operands[MI->flat_insn->detail->arm64.op_count];
+	unsigned SignExtend = (unsigned)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
+	unsigned DoShift = (unsigned)MCOperand_getImm(MCInst_getOperand(MI, OpNum + 1));
+	bool IsLSL = !SignExtend && SrcRegKind == 'x';
+
+	if (IsLSL)
+		op->shift.type = ARM64_SFT_LSL;
+	else if (SrcRegKind == 'w')
+		op->ext = SignExtend ? ARM64_EXT_SXTW : ARM64_EXT_UXTW;
+	else
+		op->ext = ARM64_EXT_SXTX;
+
+	if (DoShift || IsLSL) {
+		op->shift.type = ARM64_SFT_LSL;
+		op->shift.value = Log2_32(Width / 8);
+	}
+}
+
+// detail of printVectorList()
+static void detail_vector_list(MCInst *MI, unsigned OpNum, arm64_vas vas, arm64_vess vess)
+{
+	unsigned NumRegs, i;
+	unsigned Reg = getVectorListStart(MI, OpNum, (MCRegisterInfo *)MI->csh->printer_info, &NumRegs);
+
+	for (i = 0; i < NumRegs; ++i, Reg = getNextVectorRegister(Reg, 1)) {
+		cs_arm64_op *op = detail_add_op(MI, ARM64_OP_REG);
+		op->reg = AArch64_map_vregister(Reg);
+		op->vas = vas;
+		op->vess = vess;
+	}
+}
+
+// fill in the detail of one step, for MCInst operand @OpNum
+static void detail_step(MCInst *MI, const aarch64_detail_op *step, unsigned OpNum)
+{
+	cs_arm64 *arm64 = &MI->flat_insn->detail->arm64;
+	MCOperand *MO = MCInst_getOperand(MI, OpNum);
+	int64_t imm;
+	unsigned Val;
+	bool Valid;
+
+	switch(step->kind) {
+		default:
+			break;
+
+		case AArch64_DOP_OPERAND:
+			if (MCOperand_isReg(MO)) {
+				unsigned Reg = MCOperand_getReg(MO);
+				if (MI->csh->doing_mem) {
+					if (arm64->operands[arm64->op_count].mem.base == ARM64_REG_INVALID)
+						arm64->operands[arm64->op_count].mem.base = Reg;
+					else if (arm64->operands[arm64->op_count].mem.index == ARM64_REG_INVALID)
+						arm64->operands[arm64->op_count].mem.index = Reg;
+				} else
+					detail_add_reg(MI, Reg);
+			} else if (MCOperand_isImm(MO)) {
+				imm = MCOperand_getImm(MO);
+				if (MI->Opcode == AArch64_ADR)
+					imm += MI->address;
+				if (MI->csh->doing_mem)
+					arm64->operands[arm64->op_count].mem.disp = (int32_t)imm;
+				else
+					detail_add_imm(MI, imm);
+			}
+			break;
+
+		case AArch64_DOP_HEXIMM:
+			detail_add_imm(MI, MCOperand_getImm(MO));
+			break;
+
+		case AArch64_DOP_POSTINC:
+			if (MCOperand_isReg(MO)) {
+				if (MCOperand_getReg(MO) == AArch64_XZR)
+					detail_add_imm(MI, step->param);
+				else
+					detail_add_reg(MI, MCOperand_getReg(MO));
+			}
+			break;
+
+		case AArch64_DOP_VREG:
+			detail_add_reg(MI, AArch64_map_vregister(MCOperand_getReg(MO)));
+			break;
+
+		case AArch64_DOP_SYSCR:
+			detail_add_op(MI, ARM64_OP_CIMM)->imm = MCOperand_getImm(MO);
+			break;
+
+		case AArch64_DOP_ADDSUBIMM:
+			if (MCOperand_isImm(MO)) {
+				detail_add_imm(MI, MCOperand_getImm(MO) & 0xfff);
+				if (AArch64_AM_getShiftValue((int)MCOperand_getImm(MCInst_getOperand(MI, OpNum + 1))) != 0)
+					detail_shifter(MI, OpNum + 1);
+			}
+			break;
+
+		case AArch64_DOP_LOGICALIMM32:
+			detail_add_imm(MI, AArch64_AM_decodeLogicalImmediate(MCOperand_getImm(MO), 32));
+			break;
+
+		case AArch64_DOP_LOGICALIMM64:
+			detail_add_imm(MI, AArch64_AM_decodeLogicalImmediate(MCOperand_getImm(MO), 64));
+			break;
+
+		case AArch64_DOP_SHIFTER:
+			detail_shifter(MI, OpNum);
+			break;
+
+		case AArch64_DOP_SHIFTEDREG:
+			detail_add_reg(MI, MCOperand_getReg(MO));
+			detail_shifter(MI, OpNum + 1);
+			break;
+
+		case AArch64_DOP_ARITHEXTEND:
+			detail_arith_extend(MI, OpNum);
+			break;
+
+		case AArch64_DOP_EXTENDEDREG:
+			detail_add_reg(MI, MCOperand_getReg(MO));
+			detail_arith_extend(MI, OpNum + 1);
+			break;
+
+		case AArch64_DOP_MEMEXTEND_W:
+			detail_mem_extend(MI, OpNum, 'w', step->param);
+			break;
+
+		case AArch64_DOP_MEMEXTEND_X:
+			detail_mem_extend(MI, OpNum, 'x', step->param);
+			break;
+
+		case AArch64_DOP_CONDCODE:
+			arm64->cc = (arm64_cc)(MCOperand_getImm(MO) + 1);
+			break;
+
+		case AArch64_DOP_INVCONDCODE:
+			arm64->cc = (arm64_cc)(getInvertedCondCode((A64CC_CondCode)MCOperand_getImm(MO)) + 1);
+			break;
+
+		case AArch64_DOP_IMMSCALE:
+		case AArch64_DOP_UIMM12OFFSET:
+			if (MCOperand_isImm(MO)) {
+				imm = step->param * MCOperand_getImm(MO);
+				if (MI->csh->doing_mem)
+					arm64->operands[arm64->op_count].mem.disp = (int32_t)imm;
+				else if (step->kind == AArch64_DOP_IMMSCALE)
+					detail_add_imm(MI, imm);
+				else
+					detail_add_imm(MI, (int)imm);
+			}
+			break;
+
+		case AArch64_DOP_PREFETCH:
+			Val = (unsigned)MCOperand_getImm(MO);
+			A64NamedImmMapper_toString(&A64PRFM_PRFMMapper, Val, &Valid);
+			if (Valid) {
+				// no access info for prefetch operations
+				arm64->operands[arm64->op_count].type = ARM64_OP_PREFETCH;
+				arm64->operands[arm64->op_count].prefetch = Val + 1;
+				arm64->op_count++;
+			} else
+				detail_add_imm(MI, Val);
+			break;
+
+		case AArch64_DOP_FPIMM:
+			detail_add_op(MI, ARM64_OP_FP)->fp = MCOperand_isFPImm(MO) ?
+				MCOperand_getFPImm(MO) : AArch64_AM_getFPImmFloat((int)MCOperand_getImm(MO));
+			break;
+
+		case AArch64_DOP_VLIST_VAS:
+			detail_vector_list(MI, OpNum, (arm64_vas)step->param, ARM64_VESS_INVALID);
+			break;
+
+		case AArch64_DOP_VLIST_VESS:
+			detail_vector_list(MI, OpNum, ARM64_VAS_INVALID, (arm64_vess)step->param);
+			break;
+
+		case AArch64_DOP_VINDEX:
+			arm64->operands[arm64->op_count - 1].vector_index = (int)MCOperand_getImm(MO);
+			break;
+
+		case AArch64_DOP_ALIGNEDLABEL:
+			if (MCOperand_isImm(MO))
+				detail_add_imm(MI, (MCOperand_getImm(MO) * 4) + MI->address);
+			break;
+
+		case AArch64_DOP_ADRPLABEL:
+			if (MCOperand_isImm(MO))
+				detail_add_imm(MI, (MCOperand_getImm(MO) * 0x1000) + (MI->address & ~0xfff));
+			break;
+
+		case AArch64_DOP_BARRIER:
+			Val = (unsigned)MCOperand_getImm(MO);
+			if (MCInst_getOpcode(MI) == AArch64_ISB)
+				A64NamedImmMapper_toString(&A64ISB_ISBMapper, Val, &Valid);
+			else
+				A64NamedImmMapper_toString(&A64DB_DBarrierMapper, Val, &Valid);
+			if (Valid)
+				detail_add_op(MI, ARM64_OP_BARRIER)->barrier = Val;
+			else
+				detail_add_imm(MI, Val);
+			break;
+
+		case AArch64_DOP_MRS:
+			detail_add_op(MI, ARM64_OP_REG_MRS)->reg = (unsigned)MCOperand_getImm(MO);
+			break;
+
+		case AArch64_DOP_MSR:
+			detail_add_op(MI, ARM64_OP_REG_MSR)->reg = (unsigned)MCOperand_getImm(MO);
+			break;
+
+		case AArch64_DOP_PSTATE:
+			Val = (unsigned)MCOperand_getImm(MO);
+			A64NamedImmMapper_toString(&A64PState_PStateMapper, Val, &Valid);
+			if (Valid)
+				detail_add_op(MI, ARM64_OP_PSTATE)->pstate = Val;
+			else
+				detail_add_imm(MI, Val);
+			break;
+
+		case AArch64_DOP_SIMDTYPE10:
+			detail_add_imm(MI, AArch64_AM_decodeAdvSIMDModImmType10((uint8_t)MCOperand_getImm(MO)));
+			break;
+
+		case AArch64_DOP_MEM_BEGIN:
+			set_mem_access(MI, true);
+			break;
+
+		case AArch64_DOP_MEM_END:
+			set_mem_access(MI, false);
+			break;
+
+		case AArch64_DOP_VAS:
+			arm64_op_addVectorArrSpecifier(MI, step->param);
+			break;
+
+		case AArch64_DOP_VESS:
+			arm64_op_addVectorElementSizeSpecifier(MI, step->param);
+			break;
+
+		case AArch64_DOP_IMM:
+			arm64_op_addImm(MI, step->param);
+			break;
+
+		case AArch64_DOP_FP_ZERO:
+			arm64_op_addFP(MI, 0.0);
+			break;
+	}
+}
+
+// SBFM/UBFM/BFM are shown as one of their bitfield aliases, see AArch64_printInst()
+static void fill_bitfield_alias(MCInst *MI)
+{
+	unsigned Opcode = MCInst_getOpcode(MI);
+	unsigned Reg0 = MCOperand_getReg(MCInst_getOperand(MI, 0));
+	bool detail = MI->csh->detail == CS_OPT_ON;
+	const char *mnem = NULL;
+
+	if (Opcode == AArch64_BFMXri || Opcode == AArch64_BFMWri) {
+		unsigned Reg2 = MCOperand_getReg(MCInst_getOperand(MI, 2));
+		int ImmR = (int)MCOperand_getImm(MCInst_getOperand(MI, 3));
+		int ImmS = (int)MCOperand_getImm(MCInst_getOperand(MI, 4));
+		int LSB, Width;
+
+		if (ImmS < ImmR) {
+			int BitWidth = Opcode == AArch64_BFMXri ? 64 : 32;
+			mnem = "bfi";
+			LSB = (BitWidth - ImmR) % BitWidth;
+			Width = ImmS + 1;
+		} else {
+			mnem = "bfxil";
+			LSB = ImmR;
+			Width = ImmS - ImmR + 1;
+		}
+
+		MCInst_setOpcodePub(MI, AArch64_map_insn(mnem));
+		if (detail) {
+			detail_add_reg(MI, Reg0);
+			detail_add_reg(MI, Reg2);
+			detail_add_imm(MI, LSB);
+			detail_add_imm(MI, Width);
+		}
+	} else {
+		MCOperand *Op2 = MCInst_getOperand(MI, 2);
+		MCOperand *Op3 = MCInst_getOperand(MI, 3);
+		unsigned Reg1 = MCOperand_getReg(MCInst_getOperand(MI, 1));
+		bool IsSigned = (Opcode == AArch64_SBFMXri || Opcode == AArch64_SBFMWri);
+		bool Is64Bit = (Opcode == AArch64_SBFMXri || Opcode == AArch64_UBFMXri);
+
+		if (MCOperand_isImm(Op2) && MCOperand_getImm(Op2) == 0 && MCOperand_isImm(Op3)) {
+			switch (MCOperand_getImm(Op3)) {
+				default:
+					break;
+				case 7:
+					if (IsSigned)
+						mnem = "sxtb";
+					else if (!Is64Bit)
+						mnem = "uxtb";
+					break;
+				case 15:
+					if (IsSigned)
+						mnem = "sxth";
+					else if (!Is64Bit)
+						mnem = "uxth";
+					break;
+				case 31:
+					if (Is64Bit && IsSigned)
+						mnem = "sxtw";
+					break;
+			}
+
+			if (mnem) {
+				MCInst_setOpcodePub(MI, AArch64_map_insn(mnem));
+				if (detail) {
+					detail_add_reg(MI, Reg0);
+					detail_add_reg(MI, getWRegFromXReg(Reg1));
+				}
+				return;
+			}
+		}
+
+		if (MCOperand_isImm(Op2) && MCOperand_isImm(Op3)) {
+			int shift = 0;
+			int immr = (int)MCOperand_getImm(Op2);
+			int imms = (int)MCOperand_getImm(Op3);
+
+			if (Opcode == AArch64_UBFMWri && imms != 0x1F && ((imms + 1) == immr)) {
+				mnem = "lsl";
+				shift = 31 - imms;
+			} else if (Opcode == AArch64_UBFMXri && imms != 0x3f &&
+					((imms + 1 == immr))) {
+				mnem = "lsl";
+				shift = 63 - imms;
+			} else if ((Opcode == AArch64_UBFMWri && imms == 0x1f) ||
+					(Opcode == AArch64_UBFMXri && imms == 0x3f)) {
+				mnem = "lsr";
+				shift = immr;
+			} else if ((Opcode == AArch64_SBFMWri && imms == 0x1f) ||
+					(Opcode == AArch64_SBFMXri && imms == 0x3f)) {
+				mnem = "asr";
+				shift = immr;
+			}
+
+			if (mnem) {
+				MCInst_setOpcodePub(MI, AArch64_map_insn(mnem));
+				if (detail) {
+					detail_add_reg(MI, Reg0);
+					detail_add_reg(MI, Reg1);
+					detail_add_imm(MI, shift);
+				}
+				return;
+			}
+		}
+
+		if (MCOperand_getImm(Op2) > MCOperand_getImm(Op3)) {
+			// SBFIZ/UBFIZ
+			MCInst_setOpcodePub(MI, AArch64_map_insn(IsSigned ? "sbfiz" : "ubfiz"));
+			if (detail) {
+				detail_add_reg(MI, Reg0);
+				detail_add_reg(MI, Reg1);
+				detail_add_imm(MI, (Is64Bit ? 64 : 32) - (int)MCOperand_getImm(Op2));
+				detail_add_imm(MI, MCOperand_getImm(Op3) + 1);
+			}
+		} else {
+			// SBFX/UBFX
+			MCInst_setOpcodePub(MI, AArch64_map_insn(IsSigned ? "sbfx" : "ubfx"));
+			if (detail) {
+				detail_add_reg(MI, Reg0);
+				detail_add_reg(MI, Reg1);
+				detail_add_imm(MI, MCOperand_getImm(Op2));
+				detail_add_imm(MI, MCOperand_getImm(Op3) - MCOperand_getImm(Op2) + 1);
+			}
+		}
+	}
+}
+
+// fill in the detail of an alias instruction, from its alias asm string
+static void fill_alias(MCInst *MI, const char *AsmString)
+{
+	char mnem[32];
+	const char *c;
+	unsigned i;
+
+	for (i = 0; AsmString[i] && AsmString[i] != ' ' && AsmString[i] != '\t'; i++) {
+		if (i < sizeof(mnem) - 1)
+			mnem[i] = AsmString[i];
+	}
+	mnem[MIN(i, sizeof(mnem) - 1)] = '\0';
+
+	MCInst_setOpcodePub(MI, AArch64_map_insn(mnem));
+
+	if (MI->csh->detail != CS_OPT_ON || !AsmString[i])
+		return;
+
+	for (c = AsmString + i + 1; *c; c++) {
+		if (*c == '[')
+			set_mem_access(MI, true);
+		else if (*c == ']')
+			set_mem_access(MI, false);
+		else if (*c == '$') {
+			c++;
+			if (*c == (char)0xff) {
+				unsigned OpIdx = c[1] - 1;
+				c += 2;
+				detail_step(MI, &alias_ops[*c - 1], OpIdx);
+			} else {
+				static const aarch64_detail_op operand = { AArch64_DOP_OPERAND, 0, 0 };
+				detail_step(MI, &operand, *c - 1);
+			}
+		}
+	}
+}
+
+/// Fill in the details of @MI for CS_OPT_NOTEXT mode, like AArch64_printInst()
+/// does, but without printing. The operands come from the per-opcode operand
+/// programs of AArch64GenDetailOps.inc, or from the alias asm string.
+void AArch64_fill_detail(MCInst *MI)
+{
+	unsigned Opcode = MCInst_getOpcode(MI);
+	const aarch64_detail_op *step;
+	const char *AsmString;
+	const char *SysAsm = NULL;
+	unsigned insn_id, sys_op;
+
+	if (Opcode == AArch64_SYSxt)
+		SysAsm = getSysAlias(MI, &insn_id, &sys_op);
+
+	if (SysAsm) {
+		MCInst_setOpcodePub(MI, insn_id);
+		if (MI->csh->detail == CS_OPT_ON) {
+			detail_add_op(MI, ARM64_OP_SYS)->sys = sys_op;
+			if (!strstr(SysAsm, "all"))
+				detail_add_reg(MI, MCOperand_getReg(MCInst_getOperand(MI, 4)));
+		}
+	} else if (Opcode == AArch64_SBFMXri || Opcode == AArch64_SBFMWri ||
+			Opcode == AArch64_UBFMXri || Opcode == AArch64_UBFMWri ||
+			Opcode == AArch64_BFMXri || Opcode == AArch64_BFMWri) {
+		fill_bitfield_alias(MI);
+	} else if ((AsmString = getAliasAsmString(MI, (MCRegisterInfo *)MI->csh->printer_info))) {
+		fill_alias(MI, AsmString);
+	} else if (MI->csh->detail == CS_OPT_ON && Opcode < ARR_SIZE(detail_op_idx)) {
+		for (step = &detail_ops[detail_op_idx[Opcode]]; step->kind != AArch64_DOP_END; step++)
+			detail_step(MI, step, step->opnum);
+	}
+
+	// writeback flag
+	AArch64_post_printer((csh)MI->csh, MI->flat_insn, MI);
+}
+#endif
+
 #endif
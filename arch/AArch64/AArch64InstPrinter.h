@@ -23,6 +23,8 @@
 
 void AArch64_printInst(MCInst *MI, SStream *O, void *);
 
-void AArch64_post_printer(csh handle, cs_insn *pub_insn, char *insn_asm, MCInst *mci);
+void AArch64_post_printer(csh handle, cs_insn *pub_insn, MCInst *mci);
+
+void AArch64_fill_detail(MCInst *MI);
 
 #endif
@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "../../utils.h"
+#include "../../MCRegisterInfo.h"
 
 #include "AArch64Mapping.h"
 
@@ -292,23 +293,48 @@ const char *AArch64_reg_name(csh handle, unsigned int reg)
 #endif
 }
 
+#ifndef CAPSTONE_DIET
+#include "AArch64MappingInsnPool.inc"
+#endif
+
 static const insn_map insns[] = {
 	// dummy item
 	{
 		0, 0,
 #ifndef CAPSTONE_DIET
-		{ 0 }, { 0 }, { 0 }, 0, 0
+		0, 0, 0, 0, 0, 0, 0, 0
 #endif
 	},
 
 #include "AArch64MappingInsn.inc"
 };
 
+#ifndef CAPSTONE_DIET
+// map instruction to its characteristics
+typedef struct insn_op {
+	unsigned int eflags_update;	// how this instruction update status flags
+	uint8_t access[5];
+} insn_op;
+
+static insn_op insn_ops[] = {
+    {
+         /* NULL item */
+        0, { 0 }
+    },
+
+#include "AArch64MappingInsnOp.inc"
+};
+#endif
+
 // given internal insn id, return public instruction info
-void AArch64_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+void AArch64_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
-	int i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
+	int i = insn_find(h, insns, ARR_SIZE(insns), id);
 	if (i != 0) {
+		MI->mapping = &insns[i];
+#ifndef CAPSTONE_DIET
+		MI->op_info = &insn_ops[i];
+#endif
 		insn->id = insns[i].mapid;
 
 		if (h->detail) {
@@ -316,14 +342,7 @@ void AArch64_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
 			cs_struct handle;
 			handle.detail = h->detail;
 
-			memcpy(insn->detail->regs_read, insns[i].regs_use, sizeof(insns[i].regs_use));
-			insn->detail->regs_read_count = (uint8_t)count_positive(insns[i].regs_use);
-
-			memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-			insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-
-			memcpy(insn->detail->groups, insns[i].groups, sizeof(insns[i].groups));
-			insn->detail->groups_count = (uint8_t)count_positive8(insns[i].groups);
+			map_implicit_detail(insn->detail, &insns[i], insn_regs, insn_groups);
 
 			insn->detail->arm64.update_flags = cs_reg_write((csh)&handle, insn, ARM64_REG_NZCV);
 #endif
@@ -997,28 +1016,13 @@ void arm64_op_addImm(MCInst *MI, int64_t imm)
 
 #ifndef CAPSTONE_DIET
 
-// map instruction to its characteristics
-typedef struct insn_op {
-	unsigned int eflags_update;	// how this instruction update status flags
-	uint8_t access[5];
-} insn_op;
-
-static insn_op insn_ops[] = {
-    {
-         /* NULL item */
-        0, { 0 }
-    },
-
-#include "AArch64MappingInsnOp.inc"
-};
-
-// given internal insn id, return operand access info
-uint8_t *AArch64_get_op_access(cs_struct *h, unsigned int id)
+// return operand access info of the instruction, as resolved by AArch64_get_insn_id()
+const uint8_t *AArch64_get_op_access(const MCInst *MI)
 {
-	int i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
-	if (i != 0) {
-		return insn_ops[i].access;
-	}
+	const insn_op *op = MI->op_info;
+
+	if (op)
+		return op->access;
 
 	return NULL;
 }
@@ -1074,6 +1078,62 @@ void AArch64_reg_access(const cs_insn *insn,
 	*regs_read_count = read_count;
 	*regs_write_count = write_count;
 }
+
+void AArch64_reg_access_mask(const cs_insn *insn,
+		uint64_t *regs_read, uint64_t *regs_write)
+{
+	uint8_t i;
+	cs_arm64 *arm64 = &(insn->detail->arm64);
+
+	for (i = 0; i < arm64->op_count; i++) {
+		cs_arm64_op *op = &(arm64->operands[i]);
+		switch((int)op->type) {
+			case ARM64_OP_REG:
+				if (op->access & CS_AC_READ)
+					REGS_MASK_SET(regs_read, op->reg);
+				if (op->access & CS_AC_WRITE)
+					REGS_MASK_SET(regs_write, op->reg);
+				break;
+			case ARM_OP_MEM:
+				// registers appeared in memory references always being read
+				// (bit 0 is ARM64_REG_INVALID, and is cleared below)
+				REGS_MASK_SET(regs_read, op->mem.base);
+				REGS_MASK_SET(regs_read, op->mem.index);
+				if (arm64->writeback)
+					REGS_MASK_SET(regs_write, op->mem.base);
+			default:
+				break;
+		}
+	}
+
+	regs_read[0] &= ~(uint64_t)1;
+	regs_write[0] &= ~(uint64_t)1;
+}
+
+void AArch64_reg_fold_aliases(cs_struct *h, const uint64_t *regs, uint64_t *aliases)
+{
+	cs_regs_mask q;
+	unsigned int i;
+
+	// Vn registers only exist in Capstone: they are the same as Qn, while
+	// their IDs are used by register tuples in MCRegisterInfo
+	memcpy(q, regs, sizeof(q));
+	for (i = 0; i < 32; i++) {
+		if (CS_REGS_MASK_HAS(regs, ARM64_REG_V0 + i))
+			REGS_MASK_SET(q, ARM64_REG_Q0 + i);
+	}
+
+	MCRegisterInfo_foldAliases((const MCRegisterInfo *)h->printer_info,
+			q, aliases, ARM64_REG_V0);
+
+	for (i = 0; i < 32; i++) {
+		if (CS_REGS_MASK_HAS(q, ARM64_REG_Q0 + i) ||
+				CS_REGS_MASK_HAS(aliases, ARM64_REG_Q0 + i)) {
+			REGS_MASK_SET(aliases, ARM64_REG_Q0 + i);
+			REGS_MASK_SET(aliases, ARM64_REG_V0 + i);
+		}
+	}
+}
 #endif
 
 #endif
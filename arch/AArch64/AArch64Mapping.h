@@ -10,7 +10,7 @@
 const char *AArch64_reg_name(csh handle, unsigned int reg);
 
 // given internal insn id, return public instruction info
-void AArch64_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void AArch64_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 const char *AArch64_insn_name(csh handle, unsigned int id);
 
@@ -32,10 +32,15 @@ void arm64_op_addFP(MCInst *MI, float fp);
 
 void arm64_op_addImm(MCInst *MI, int64_t imm);
 
-uint8_t *AArch64_get_op_access(cs_struct *h, unsigned int id);
+const uint8_t *AArch64_get_op_access(const MCInst *MI);
 
 void AArch64_reg_access(const cs_insn *insn,
 		cs_regs regs_read, uint8_t *regs_read_count,
 		cs_regs regs_write, uint8_t *regs_write_count);
 
+void AArch64_reg_access_mask(const cs_insn *insn,
+		uint64_t *regs_read, uint64_t *regs_write);
+
+void AArch64_reg_fold_aliases(cs_struct *h, const uint64_t *regs, uint64_t *aliases);
+
 #endif
@@ -12,10 +12,10 @@
 
 cs_err AArch64_global_init(cs_struct *ud)
 {
-	MCRegisterInfo *mri;
-	mri = cs_mem_malloc(sizeof(*mri));
+	// register info is constant & shared by all handles, so the printer
+	// & decoder only read it
+	MCRegisterInfo *mri = (MCRegisterInfo *)AArch64_getRegisterInfo();
 
-	AArch64_init(mri);
 	ud->printer = AArch64_printInst;
 	ud->printer_info = mri;
 	ud->getinsn_info = mri;
@@ -27,6 +27,9 @@ cs_err AArch64_global_init(cs_struct *ud)
 	ud->post_printer = AArch64_post_printer;
 #ifndef CAPSTONE_DIET
 	ud->reg_access = AArch64_reg_access;
+	ud->reg_access_mask = AArch64_reg_access_mask;
+	ud->reg_fold_aliases = AArch64_reg_fold_aliases;
+	ud->fill_detail = AArch64_fill_detail;
 #endif
 
 	return CS_ERR_OK;
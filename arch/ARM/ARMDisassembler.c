@@ -424,23 +424,29 @@ static DecodeStatus DecodePredicateOperand(MCInst *Inst, unsigned Val,
 
 #define GET_REGINFO_MC_DESC
 #include "ARMGenRegisterInfo.inc"
-void ARM_init(MCRegisterInfo *MRI)
-{
-	/*
-	   InitMCRegisterInfo(ARMRegDesc, 289,
-	   RA, PC,
-	   ARMMCRegisterClasses, 100,
-	   ARMRegUnitRoots, 77, ARMRegDiffLists, ARMRegStrings,
-	   ARMSubRegIdxLists, 57,
-	   ARMSubRegIdxRanges, ARMRegEncodingTable);
-	 */
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, ARMRegDesc, 289,
-			0, 0, 
-			ARMMCRegisterClasses, 100,
-			0, 0, ARMRegDiffLists, 0, 
-			ARMSubRegIdxLists, 57,
-			0);
+/*
+   InitMCRegisterInfo(ARMRegDesc, 289,
+   RA, PC,
+   ARMMCRegisterClasses, 100,
+   ARMRegUnitRoots, 77, ARMRegDiffLists, ARMRegStrings,
+   ARMSubRegIdxLists, 57,
+   ARMSubRegIdxRanges, ARMRegEncodingTable);
+ */
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo ARM_MRI = {
+	ARMRegDesc, 289,
+	0, 0,
+	ARMMCRegisterClasses, 100,
+	0, 0,
+	ARMRegDiffLists, 0,
+	ARMSubRegIdxLists, 57,
+	0
+};
+
+const MCRegisterInfo *ARM_getRegisterInfo(void)
+{
+	return &ARM_MRI;
 }
 
 // Post-decoding checks
@@ -7,7 +7,7 @@
 #include "capstone/capstone.h"
 #include "../../MCRegisterInfo.h"
 
-void ARM_init(MCRegisterInfo *MRI);
+const MCRegisterInfo *ARM_getRegisterInfo(void);
 
 bool ARM_getInstruction(csh handle, const uint8_t *code, size_t code_len, MCInst *instr, uint16_t *size, uint64_t address, void *info);
 
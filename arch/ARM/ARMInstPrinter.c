@@ -124,9 +124,9 @@ static void printInstSyncBOption(MCInst *MI, unsigned OpNum, SStream *O);
 
 #ifndef CAPSTONE_DIET
 // copy & normalize access info
-static uint8_t get_op_access(cs_struct *h, unsigned int id, unsigned int index)
+static uint8_t get_op_access(MCInst *MI, unsigned int index)
 {
-	uint8_t *arr = ARM_get_op_access(h, id);
+	const uint8_t *arr = ARM_get_op_access(MI);
 
 	if (arr[index] == CS_AC_IGNORE)
 		return 0;
@@ -153,7 +153,7 @@ static void set_mem_access(MCInst *MI, bool status)
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].mem.disp = 0;
 
 #ifndef CAPSTONE_DIET
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].access = access;
 		MI->ac_idx++;
 #endif
@@ -201,6 +201,24 @@ static unsigned translateShiftImm(unsigned imm)
 	return imm;
 }
 
+/// Records the shift of a register shifted by an immediate value.
+static void addRegImmShift(MCInst *MI, ARM_AM_ShiftOpc ShOpc, unsigned ShImm)
+{
+	cs_arm_op *op;
+
+	if (!MI->csh->detail || ShOpc == ARM_AM_no_shift || (ShOpc == ARM_AM_lsl && !ShImm))
+		return;
+
+	if (MI->csh->doing_mem)
+		op = &MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count];
+	else
+		op = &MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1];
+
+	op->shift.type = (arm_shifter)ShOpc;
+	if (ShOpc != ARM_AM_rrx)
+		op->shift.value = translateShiftImm(ShImm);
+}
+
 /// Prints the shift value with an immediate value.
 static void printRegImmShift(MCInst *MI, SStream *O, ARM_AM_ShiftOpc ShOpc, unsigned ShImm)
 {
@@ -210,23 +228,12 @@ static void printRegImmShift(MCInst *MI, SStream *O, ARM_AM_ShiftOpc ShOpc, unsi
 
 	//assert (!(ShOpc == ARM_AM_ror && !ShImm) && "Cannot have ror #0");
 	SStream_concat0(O, ARM_AM_getShiftOpcStr(ShOpc));
-	if (MI->csh->detail) {
-		if (MI->csh->doing_mem)
-			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].shift.type = (arm_shifter)ShOpc;
-		else
-			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.type = (arm_shifter)ShOpc;
-	}
-
 	if (ShOpc != ARM_AM_rrx) {
-		SStream_concat0(O, " ");
-		SStream_concat(O, "#%u", translateShiftImm(ShImm));
-		if (MI->csh->detail) {
-			if (MI->csh->doing_mem)
-				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].shift.value = translateShiftImm(ShImm);
-			else
-				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.value = translateShiftImm(ShImm);
-		}
+		SStream_concat0(O, " #");
+		SStream_concatDec(O, translateShiftImm(ShImm));
 	}
+
+	addRegImmShift(MI, ShOpc, ShImm);
 }
 
 static void printRegName(cs_struct *h, SStream *OS, unsigned RegNo)
@@ -270,13 +277,26 @@ static const name_map insn_update_flgs[] = {
 	{ ARM_INS_UADD8, "uadd8" },
 };
 
-void ARM_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
+// mark @insn as updating the flags, which also writes CPSR
+static void set_update_flags(cs_insn *insn)
 {
-	if (((cs_struct *)ud)->detail != CS_OPT_ON)
-		return;
+	unsigned int j;
+
+	insn->detail->arm.update_flags = true;
+	// we have to update regs_write array as well
+	for (j = 0; j < ARR_SIZE(insn->detail->regs_write); j++) {
+		if (insn->detail->regs_write[j] == 0) {
+			insn->detail->regs_write[j] = ARM_REG_CPSR;
+			break;
+		}
+	}
+}
 
+// fix up the details of @insn that do not depend on its asm text
+static void post_detail(cs_insn *insn, MCInst *mci)
+{
 	// check if this insn requests write-back
-	if (mci->writeback || (strrchr(insn_asm, '!')) != NULL) {
+	if (mci->writeback) {
 		insn->detail->arm.writeback = true;
 	} else if (mci->csh->mode & CS_MODE_THUMB) {
 		// handle some special instructions with writeback
@@ -387,28 +407,6 @@ void ARM_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
 		}
 	}
 
-	// check if this insn requests update flags
-	if (insn->detail->arm.update_flags == false) {
-		// some insn still update flags, regardless of tabgen info
-		unsigned int i, j;
-
-		for (i = 0; i < ARR_SIZE(insn_update_flgs); i++) {
-			if (insn->id == insn_update_flgs[i].id &&
-					!strncmp(insn_asm, insn_update_flgs[i].name,
-						strlen(insn_update_flgs[i].name))) {
-				insn->detail->arm.update_flags = true;
-				// we have to update regs_write array as well
-				for (j = 0; j < ARR_SIZE(insn->detail->regs_write); j++) {
-					if (insn->detail->regs_write[j] == 0) {
-						insn->detail->regs_write[j] = ARM_REG_CPSR;
-						break;
-					}
-				}
-				break;
-			}
-		}
-	}
-
 	// instruction should not have invalid CC
 	if (insn->detail->arm.cc == ARM_CC_INVALID) {
 		insn->detail->arm.cc = ARM_CC_AL;
@@ -431,6 +429,33 @@ void ARM_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
 	}
 }
 
+void ARM_post_printer(csh ud, cs_insn *insn, MCInst *mci)
+{
+	if (((cs_struct *)ud)->detail != CS_OPT_ON)
+		return;
+
+	// check if this insn requests write-back
+	if (strrchr(insn->op_str, '!') != NULL)
+		mci->writeback = true;
+
+	// check if this insn requests update flags
+	if (insn->detail->arm.update_flags == false) {
+		// some insn still update flags, regardless of tabgen info
+		unsigned int i;
+
+		for (i = 0; i < ARR_SIZE(insn_update_flgs); i++) {
+			if (insn->id == insn_update_flgs[i].id &&
+					!strncmp(insn->mnemonic, insn_update_flgs[i].name,
+						strlen(insn_update_flgs[i].name))) {
+				set_update_flags(insn);
+				break;
+			}
+		}
+	}
+
+	post_detail(insn, mci);
+}
+
 void ARM_printInst(MCInst *MI, SStream *O, void *Info)
 {
 	MCRegisterInfo *MRI = (MCRegisterInfo *)Info;
@@ -638,7 +663,7 @@ void ARM_printInst(MCInst *MI, SStream *O, void *Info)
 								MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_REG;
 								MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].reg = MCOperand_getReg(MCInst_getOperand(MI, 1));
 #ifndef CAPSTONE_DIET
-								access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+								access = get_op_access(MI, MI->ac_idx);
 								MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].access = access;
 								MI->ac_idx++;
 #endif
@@ -778,6 +803,10 @@ void ARM_printInst(MCInst *MI, SStream *O, void *Info)
 
 				    MCInst_Init(&NewMI);
 				    MCInst_setOpcode(&NewMI, Opcode);
+				    NewMI.csh = MI->csh;
+				    NewMI.flat_insn = MI->flat_insn;
+				    NewMI.mapping = MI->mapping;
+				    NewMI.op_info = MI->op_info;
 
 				    if (isStore)
 						MCInst_addOperand2(&NewMI, MCInst_getOperand(MI, 0));
@@ -838,7 +867,7 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_REG;
 				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].reg = Reg;
 #ifndef CAPSTONE_DIET
-				access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+				access = get_op_access(MI, MI->ac_idx);
 				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].access = access;
 				MI->ac_idx++;
 #endif
@@ -918,7 +947,7 @@ static void printThumbLdrLabelOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	if (OffImm == INT32_MIN)
 		OffImm = 0;
 	if (isSub) {
-		SStream_concat(O, "#-0x%x", -OffImm);
+		SStream_concatHex(O, "#-0x", (uint32_t)-OffImm);
 	} else {
 		printUInt32Bang(O, OffImm);
 	}
@@ -1018,10 +1047,9 @@ static void printAM2PreOrOffsetIndexOp(MCInst *MI, unsigned Op, SStream *O)
 			subtracted = getAM2Op((unsigned int)MCOperand_getImm(MO3));
 
 			SStream_concat0(O, ", ");
-			if (tmp > HEX_THRESHOLD)
-				SStream_concat(O, "#%s0x%x", ARM_AM_getAddrOpcStr(subtracted), tmp);
-			else
-				SStream_concat(O, "#%s%u", ARM_AM_getAddrOpcStr(subtracted), tmp);
+			SStream_concat1(O, '#');
+			SStream_concat0(O, ARM_AM_getAddrOpcStr(subtracted));
+			printUInt32(O, tmp);
 			if (MI->csh->detail) {
 				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].shift.type = (arm_shifter)getAM2Op((unsigned int)MCOperand_getImm(MO3));
 				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].shift.value = tmp;
@@ -1106,12 +1134,9 @@ static void printAddrMode2OffsetOperand(MCInst *MI, unsigned OpNum, SStream *O)
 
 	if (!MCOperand_getReg(MO1)) {
 		unsigned ImmOffs = getAM2Offset((unsigned int)MCOperand_getImm(MO2));
-		if (ImmOffs > HEX_THRESHOLD)
-			SStream_concat(O, "#%s0x%x",
-					ARM_AM_getAddrOpcStr(subtracted), ImmOffs);
-		else
-			SStream_concat(O, "#%s%u",
-					ARM_AM_getAddrOpcStr(subtracted), ImmOffs);
+		SStream_concat1(O, '#');
+		SStream_concat0(O, ARM_AM_getAddrOpcStr(subtracted));
+		printUInt32(O, ImmOffs);
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = ImmOffs;
@@ -1174,10 +1199,9 @@ static void printAM3PreOrOffsetIndexOp(MCInst *MI, unsigned Op, SStream *O,
 	ImmOffs = getAM3Offset((unsigned int)MCOperand_getImm(MO3));
 
 	if (AlwaysPrintImm0 || ImmOffs || (sign == ARM_AM_sub)) {
-		if (ImmOffs > HEX_THRESHOLD)
-			SStream_concat(O, ", #%s0x%x", ARM_AM_getAddrOpcStr(sign), ImmOffs);
-		else
-			SStream_concat(O, ", #%s%u", ARM_AM_getAddrOpcStr(sign), ImmOffs);
+		SStream_concat0(O, ", #");
+		SStream_concat0(O, ARM_AM_getAddrOpcStr(sign));
+		printUInt32(O, ImmOffs);
 	}
 
 	if (MI->csh->detail) {
@@ -1225,10 +1249,9 @@ static void printAddrMode3OffsetOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	}
 
 	ImmOffs = getAM3Offset((unsigned int)MCOperand_getImm(MO2));
-	if (ImmOffs > HEX_THRESHOLD)
-		SStream_concat(O, "#%s0x%x", ARM_AM_getAddrOpcStr(subtracted), ImmOffs);
-	else
-		SStream_concat(O, "#%s%u", ARM_AM_getAddrOpcStr(subtracted), ImmOffs);
+	SStream_concat1(O, '#');
+	SStream_concat0(O, ARM_AM_getAddrOpcStr(subtracted));
+	printUInt32(O, ImmOffs);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = ImmOffs;
@@ -1241,10 +1264,9 @@ static void printPostIdxImm8Operand(MCInst *MI, unsigned OpNum, SStream *O)
 {
 	MCOperand *MO = MCInst_getOperand(MI, OpNum);
 	unsigned Imm = (unsigned int)MCOperand_getImm(MO);
-	if ((Imm & 0xff) > HEX_THRESHOLD)
-		SStream_concat(O, "#%s0x%x", ((Imm & 256) ? "" : "-"), (Imm & 0xff));
-	else
-		SStream_concat(O, "#%s%u", ((Imm & 256) ? "" : "-"), (Imm & 0xff));
+	SStream_concat1(O, '#');
+	SStream_concat0(O, (Imm & 256) ? "" : "-");
+	printUInt32(O, Imm & 0xff);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = Imm & 0xff;
@@ -1272,11 +1294,9 @@ static void printPostIdxImm8s4Operand(MCInst *MI, unsigned OpNum, SStream *O)
 	MCOperand *MO = MCInst_getOperand(MI, OpNum);
 	int Imm = (int)MCOperand_getImm(MO);
 
-	if (((Imm & 0xff) << 2) > HEX_THRESHOLD) {
-		SStream_concat(O, "#%s0x%x", ((Imm & 256) ? "" : "-"), ((Imm & 0xff) << 2));
-	} else {
-		SStream_concat(O, "#%s%u", ((Imm & 256) ? "" : "-"), ((Imm & 0xff) << 2));
-	}
+	SStream_concat1(O, '#');
+	SStream_concat0(O, (Imm & 256) ? "" : "-");
+	printUInt32(O, (Imm & 0xff) << 2);
 
 	if (MI->csh->detail) {
 		int v = (Imm & 256) ? ((Imm & 0xff) << 2) : -((Imm & 0xff) << 2);
@@ -1313,14 +1333,9 @@ static void printAddrMode5Operand(MCInst *MI, unsigned OpNum, SStream *O,
 
 	ImmOffs = ARM_AM_getAM5Offset((unsigned int)MCOperand_getImm(MO2));
 	if (AlwaysPrintImm0 || ImmOffs || subtracted == ARM_AM_sub) {
-		if (ImmOffs * 4 > HEX_THRESHOLD)
-			SStream_concat(O, ", #%s0x%x",
-					ARM_AM_getAddrOpcStr(subtracted),
-					ImmOffs * 4);
-		else
-			SStream_concat(O, ", #%s%u",
-					ARM_AM_getAddrOpcStr(subtracted),
-					ImmOffs * 4);
+		SStream_concat0(O, ", #");
+		SStream_concat0(O, ARM_AM_getAddrOpcStr(subtracted));
+		printUInt32(O, ImmOffs * 4);
 		if (MI->csh->detail) {
 			if (subtracted)
 				MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].mem.disp = ImmOffs * 4;
@@ -1348,10 +1363,8 @@ static void printAddrMode6Operand(MCInst *MI, unsigned OpNum, SStream *O)
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].mem.base = MCOperand_getReg(MO1);
 	tmp = (unsigned int)MCOperand_getImm(MO2);
 	if (tmp) {
-		if (tmp << 3 > HEX_THRESHOLD)
-			SStream_concat(O, ":0x%x", (tmp << 3));
-		else
-			SStream_concat(O, ":%u", (tmp << 3));
+		SStream_concat1(O, ':');
+		printUInt32(O, tmp << 3);
 		if (MI->csh->detail)
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].mem.disp = tmp << 3;
 	}
@@ -1399,10 +1412,8 @@ static void printBitfieldInvMaskImmOperand(MCInst *MI, unsigned OpNum, SStream *
 	//assert(MO.isImm() && "Not a valid bf_inv_mask_imm value!");
 	printUInt32Bang(O, lsb);
 
-	if (width > HEX_THRESHOLD)
-		SStream_concat(O, ", #0x%x", width);
-	else
-		SStream_concat(O, ", #%u", width);
+	SStream_concat0(O, ", #");
+	printUInt32(O, width);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
@@ -1438,19 +1449,15 @@ static void printShiftImmOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	unsigned Amt = ShiftOp & 0x1f;
 	if (isASR) {
 		unsigned tmp = Amt == 0 ? 32 : Amt;
-		if (tmp > HEX_THRESHOLD)
-			SStream_concat(O, ", asr #0x%x", tmp);
-		else
-			SStream_concat(O, ", asr #%u", tmp);
+		SStream_concat0(O, ", asr #");
+		printUInt32(O, tmp);
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.type = ARM_SFT_ASR;
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.value = tmp;
 		}
 	} else if (Amt) {
-		if (Amt > HEX_THRESHOLD)
-			SStream_concat(O, ", lsl #0x%x", Amt);
-		else
-			SStream_concat(O, ", lsl #%u", Amt);
+		SStream_concat0(O, ", lsl #");
+		printUInt32(O, Amt);
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.type = ARM_SFT_LSL;
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.value = Amt;
@@ -1464,10 +1471,8 @@ static void printPKHLSLShiftImm(MCInst *MI, unsigned OpNum, SStream *O)
 	if (Imm == 0)
 		return;
 	//assert(Imm > 0 && Imm < 32 && "Invalid PKH shift immediate value!");
-	if (Imm > HEX_THRESHOLD)
-		SStream_concat(O, ", lsl #0x%x", Imm);
-	else
-		SStream_concat(O, ", lsl #%u", Imm);
+	SStream_concat0(O, ", lsl #");
+	printUInt32(O, Imm);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.type = ARM_SFT_LSL;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.value = Imm;
@@ -1481,10 +1486,8 @@ static void printPKHASRShiftImm(MCInst *MI, unsigned OpNum, SStream *O)
 	if (Imm == 0)
 		Imm = 32;
 	//assert(Imm > 0 && Imm <= 32 && "Invalid PKH shift immediate value!");
-	if (Imm > HEX_THRESHOLD)
-		SStream_concat(O, ", asr #0x%x", Imm);
-	else
-		SStream_concat(O, ", asr #%u", Imm);
+	SStream_concat0(O, ", asr #");
+	printUInt32(O, Imm);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.type = ARM_SFT_ASR;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].shift.value = Imm;
@@ -1503,7 +1506,7 @@ static void printRegisterList(MCInst *MI, unsigned OpNum, SStream *O)
 
 #ifndef CAPSTONE_DIET
 	if (MI->csh->detail) {
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 	}
 #endif
 
@@ -1727,6 +1730,19 @@ static void printMSRMaskOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	}
 }
 
+// banked registers, by SYSm
+static const arm_sysreg BankedRegIds[] = {
+	ARM_SYSREG_R8_USR, ARM_SYSREG_R9_USR, ARM_SYSREG_R10_USR,
+	ARM_SYSREG_R11_USR, ARM_SYSREG_R12_USR, ARM_SYSREG_SP_USR,
+	ARM_SYSREG_LR_USR, 0, ARM_SYSREG_R8_FIQ, ARM_SYSREG_R9_FIQ,
+	ARM_SYSREG_R10_FIQ, ARM_SYSREG_R11_FIQ, ARM_SYSREG_R12_FIQ,
+	ARM_SYSREG_SP_FIQ, ARM_SYSREG_LR_FIQ, 0, ARM_SYSREG_LR_IRQ,
+	ARM_SYSREG_SP_IRQ, ARM_SYSREG_LR_SVC, ARM_SYSREG_SP_SVC,
+	ARM_SYSREG_LR_ABT, ARM_SYSREG_SP_ABT, ARM_SYSREG_LR_UND,
+	ARM_SYSREG_SP_UND, 0, 0, 0, 0, ARM_SYSREG_LR_MON, ARM_SYSREG_SP_MON,
+	ARM_SYSREG_ELR_HYP, ARM_SYSREG_SP_HYP,
+};
+
 static void printBankedRegOperand(MCInst *MI, unsigned OpNum, SStream *O)
 {
 	uint32_t Banked = (uint32_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
@@ -1738,17 +1754,6 @@ static void printBankedRegOperand(MCInst *MI, unsigned OpNum, SStream *O)
 		"lr_irq", "sp_irq", "lr_svc",  "sp_svc",  "lr_abt",  "sp_abt", "lr_und", "sp_und",
 		"",       "",       "",        "",        "lr_mon",  "sp_mon", "elr_hyp", "sp_hyp"
 	};
-	arm_sysreg RegIds[] = {
-		ARM_SYSREG_R8_USR, ARM_SYSREG_R9_USR, ARM_SYSREG_R10_USR,
-		ARM_SYSREG_R11_USR, ARM_SYSREG_R12_USR, ARM_SYSREG_SP_USR,
-		ARM_SYSREG_LR_USR, 0, ARM_SYSREG_R8_FIQ, ARM_SYSREG_R9_FIQ,
-		ARM_SYSREG_R10_FIQ, ARM_SYSREG_R11_FIQ, ARM_SYSREG_R12_FIQ,
-		ARM_SYSREG_SP_FIQ, ARM_SYSREG_LR_FIQ, 0, ARM_SYSREG_LR_IRQ,
-		ARM_SYSREG_SP_IRQ, ARM_SYSREG_LR_SVC, ARM_SYSREG_SP_SVC,
-		ARM_SYSREG_LR_ABT, ARM_SYSREG_SP_ABT, ARM_SYSREG_LR_UND,
-		ARM_SYSREG_SP_UND, 0, 0, 0, 0, ARM_SYSREG_LR_MON, ARM_SYSREG_SP_MON,
-		ARM_SYSREG_ELR_HYP, ARM_SYSREG_SP_HYP,
-	};
 	const char *Name = RegNames[SysM];
 
 	// Nothing much we can do about this, the encodings are specified in B9.2.3 of
@@ -1772,7 +1777,7 @@ static void printBankedRegOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	//assert(Name[0] && "invalid banked register operand");
 
 	SStream_concat0(O, Name);
-	ARM_addSysReg(MI, RegIds[SysM]);
+	ARM_addSysReg(MI, BankedRegIds[SysM]);
 }
 
 static void printPredicateOperand(MCInst *MI, unsigned OpNum, SStream *O)
@@ -1833,7 +1838,8 @@ static void printPImmediate(MCInst *MI, unsigned OpNum, SStream *O)
 {
 	unsigned imm = (unsigned int)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
 
-	SStream_concat(O, "p%u", imm);
+	SStream_concat1(O, 'p');
+	SStream_concatDec(O, imm);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_PIMM;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = imm;
@@ -1845,7 +1851,8 @@ static void printCImmediate(MCInst *MI, unsigned OpNum, SStream *O)
 {
 	unsigned imm = (unsigned int)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
 
-	SStream_concat(O, "c%u", imm);
+	SStream_concat1(O, 'c');
+	SStream_concatDec(O, imm);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_CIMM;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = imm;
@@ -1856,10 +1863,9 @@ static void printCImmediate(MCInst *MI, unsigned OpNum, SStream *O)
 static void printCoprocOptionImm(MCInst *MI, unsigned OpNum, SStream *O)
 {
 	unsigned tmp = (unsigned int)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
-	if (tmp > HEX_THRESHOLD)
-		SStream_concat(O, "{0x%x}", tmp);
-	else
-		SStream_concat(O, "{%u}", tmp);
+	SStream_concat1(O, '{');
+	printUInt32(O, tmp);
+	SStream_concat1(O, '}');
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = tmp;
@@ -1882,12 +1888,10 @@ static void printAdrLabelOperand(MCInst *MI, unsigned OpNum, SStream *O, unsigne
 		}
 	} else {
 		if (OffImm < 0)
-			SStream_concat(O, "#-0x%x", -OffImm);
+			SStream_concatHex(O, "#-0x", (uint32_t)-OffImm);
 		else {
-			if (OffImm > HEX_THRESHOLD)
-				SStream_concat(O, "#0x%x", OffImm);
-			else
-				SStream_concat(O, "#%u", OffImm);
+			SStream_concat1(O, '#');
+			printUInt32(O, OffImm);
 		}
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
@@ -2069,20 +2073,22 @@ static void printAddrModeImm12Operand(MCInst *MI, unsigned OpNum,
 		OffImm = 0;
 	if (isSub) {
 		if (OffImm < -HEX_THRESHOLD)
-			SStream_concat(O, ", #-0x%x", -OffImm);
-		else
-			SStream_concat(O, ", #-%u", -OffImm);
+			SStream_concatHex(O, ", #-0x", (uint32_t)-OffImm);
+		else {
+			SStream_concat0(O, ", #-");
+			SStream_concatDec(O, (uint32_t)-OffImm);
+		}
 	} else if (AlwaysPrintImm0 || OffImm > 0) {
 		if (OffImm >= 0) {
-			if (OffImm > HEX_THRESHOLD)
-				SStream_concat(O, ", #0x%x", OffImm);
-			else
-				SStream_concat(O, ", #%u", OffImm);
+			SStream_concat0(O, ", #");
+			printUInt32(O, OffImm);
 		} else {
 			if (OffImm < -HEX_THRESHOLD)
-				SStream_concat(O, ", #-0x%x", -OffImm);
-			else
-				SStream_concat(O, ", #-%u", -OffImm);
+				SStream_concatHex(O, ", #-0x", (uint32_t)-OffImm);
+			else {
+				SStream_concat0(O, ", #-");
+				SStream_concatDec(O, (uint32_t)-OffImm);
+			}
 		}
 	}
 	if (MI->csh->detail)
@@ -2113,12 +2119,10 @@ static void printT2AddrModeImm8Operand(MCInst *MI, unsigned OpNum, SStream *O,
 		OffImm = 0;
 
 	if (isSub)
-		SStream_concat(O, ", #-0x%x", -OffImm);
+		SStream_concatHex(O, ", #-0x", (uint32_t)-OffImm);
 	else if (AlwaysPrintImm0 || OffImm > 0) {
-		if (OffImm > HEX_THRESHOLD)
-			SStream_concat(O, ", #0x%x", OffImm);
-		else
-			SStream_concat(O, ", #%u", OffImm);
+		SStream_concat0(O, ", #");
+		printUInt32(O, OffImm);
 	}
 
 	if (MI->csh->detail)
@@ -2155,12 +2159,10 @@ static void printT2AddrModeImm8s4Operand(MCInst *MI,
 	if (OffImm == INT32_MIN)
 		OffImm = 0;
 	if (isSub) {
-		SStream_concat(O, ", #-0x%x", -OffImm);
+		SStream_concatHex(O, ", #-0x", (uint32_t)-OffImm);
 	} else if (AlwaysPrintImm0 || OffImm > 0) {
-		if (OffImm > HEX_THRESHOLD)
-			SStream_concat(O, ", #0x%x", OffImm);
-		else
-			SStream_concat(O, ", #%u", OffImm);
+		SStream_concat0(O, ", #");
+		printUInt32(O, OffImm);
 	}
 	if (MI->csh->detail)
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].mem.disp = OffImm;
@@ -2263,8 +2265,8 @@ static void printT2AddrModeSoRegOperand(MCInst *MI,
 	ShAmt = (unsigned int)MCOperand_getImm(MO3);
 	if (ShAmt) {
 		//assert(ShAmt <= 3 && "Not a valid Thumb2 addressing mode!");
-		SStream_concat0(O, ", lsl ");
-		SStream_concat(O, "#%d", ShAmt);
+		SStream_concat0(O, ", lsl #");
+		SStream_concatDec(O, ShAmt);
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].shift.type = ARM_SFT_LSL;
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].shift.value = ShAmt;
@@ -2281,7 +2283,7 @@ static void printFPImmOperand(MCInst *MI, unsigned OpNum, SStream *O)
 
 #if defined(_KERNEL_MODE)
 	// Issue #681: Windows kernel does not support formatting float point
-	SStream_concat(O, "#<float_point_unsupported>");
+	SStream_concat0(O, "#<float_point_unsupported>");
 #else
 	SStream_concat(O, "#%e", getFPImmFloat((unsigned int)MCOperand_getImm(MO)));
 #endif
@@ -2297,10 +2299,7 @@ static void printNEONModImmOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	unsigned EncodedImm = (unsigned int)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
 	unsigned EltBits;
 	uint64_t Val = ARM_AM_decodeNEONModImm(EncodedImm, &EltBits);
-	if (Val > HEX_THRESHOLD)
-		SStream_concat(O, "#0x%"PRIx64, Val);
-	else
-		SStream_concat(O, "#%"PRIu64, Val);
+	printUInt64Bang(O, Val);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = (unsigned int)Val;
@@ -2361,16 +2360,16 @@ static void printModImmOperand(MCInst *MI, unsigned OpNum, SStream *O)
 		// #rot has the least possible value
 		if (PrintUnsigned) {
 			if (Rotated > HEX_THRESHOLD || Rotated < -HEX_THRESHOLD)
-				SStream_concat(O, "#0x%x", Rotated);
-			else
-				SStream_concat(O, "#%u", Rotated);
+				SStream_concatHex(O, "#0x", (uint32_t)Rotated);
+			else {
+				SStream_concat1(O, '#');
+				SStream_concatDec(O, (uint32_t)Rotated);
+			}
 		} else if (Rotated >= 0) {
-			if (Rotated > HEX_THRESHOLD)
-				SStream_concat(O, "#0x%x", Rotated);
-			else
-				SStream_concat(O, "#%u", Rotated);
+			SStream_concat1(O, '#');
+			printUInt32(O, Rotated);
 		} else {
-			SStream_concat(O, "#0x%x", Rotated);
+			SStream_concatHex(O, "#0x", (uint32_t)Rotated);
 		}
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
@@ -2381,7 +2380,10 @@ static void printModImmOperand(MCInst *MI, unsigned OpNum, SStream *O)
 	}
 
 	// Explicit #bits, #rot implied
-	SStream_concat(O, "#%u, #%u", Bits, Rot);
+	SStream_concat1(O, '#');
+	SStream_concatDec(O, Bits);
+	SStream_concat0(O, ", #");
+	SStream_concatDec(O, Rot);
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_IMM;
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].imm = Bits;
@@ -2423,10 +2425,9 @@ static void printFBits32(MCInst *MI, unsigned OpNum, SStream *O)
 static void printVectorIndex(MCInst *MI, unsigned OpNum, SStream *O)
 {
 	unsigned tmp = (unsigned int)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
-	if (tmp > HEX_THRESHOLD)
-		SStream_concat(O, "[0x%x]", tmp);
-	else
-		SStream_concat(O, "[%u]", tmp);
+	SStream_concat1(O, '[');
+	printUInt32(O, tmp);
+	SStream_concat1(O, ']');
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1].vector_index = tmp;
 	}
@@ -2440,7 +2441,7 @@ static void printVectorListOne(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 		uint8_t access;
 
-		access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+		access = get_op_access(MI, MI->ac_idx);
 #endif
 
 		MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count].type = ARM_OP_REG;
@@ -2468,7 +2469,7 @@ static void printVectorListTwo(MCInst *MI, unsigned OpNum,
 	unsigned Reg1 = MCRegisterInfo_getSubReg(MRI, Reg, ARM_dsub_1);
 
 #ifndef CAPSTONE_DIET
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	SStream_concat0(O, "{");
@@ -2509,7 +2510,7 @@ static void printVectorListTwoSpaced(MCInst *MI, unsigned OpNum,
 	unsigned Reg1 = MCRegisterInfo_getSubReg(MRI, Reg, ARM_dsub_2);
 
 #ifndef CAPSTONE_DIET
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	SStream_concat0(O, "{");
@@ -2544,7 +2545,7 @@ static void printVectorListThree(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -2592,7 +2593,7 @@ static void printVectorListFour(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -2650,7 +2651,7 @@ static void printVectorListOneAllLanes(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	SStream_concat0(O, "{");
@@ -2681,7 +2682,7 @@ static void printVectorListTwoAllLanes(MCInst *MI, unsigned OpNum,
 	unsigned Reg1 = MCRegisterInfo_getSubReg(MRI, Reg, ARM_dsub_1);
 
 #ifndef CAPSTONE_DIET
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	SStream_concat0(O, "{");
@@ -2716,7 +2717,7 @@ static void printVectorListThreeAllLanes(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -2764,7 +2765,7 @@ static void printVectorListFourAllLanes(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -2828,7 +2829,7 @@ static void printVectorListTwoSpacedAllLanes(MCInst *MI,
 	unsigned Reg1 = MCRegisterInfo_getSubReg(MRI, Reg, ARM_dsub_2);
 
 #ifndef CAPSTONE_DIET
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	SStream_concat0(O, "{");
@@ -2864,7 +2865,7 @@ static void printVectorListThreeSpacedAllLanes(MCInst *MI,
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -2913,7 +2914,7 @@ static void printVectorListFourSpacedAllLanes(MCInst *MI,
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -2971,7 +2972,7 @@ static void printVectorListThreeSpaced(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -3019,7 +3020,7 @@ static void printVectorListFourSpaced(MCInst *MI, unsigned OpNum, SStream *O)
 #ifndef CAPSTONE_DIET
 	uint8_t access;
 
-	access = get_op_access(MI->csh, MCInst_getOpcode(MI), MI->ac_idx);
+	access = get_op_access(MI, MI->ac_idx);
 #endif
 
 	// Normally, it's not safe to use register enum values directly with
@@ -3111,4 +3112,806 @@ void ARM_addSysReg(MCInst *MI, arm_sysreg reg)
 	}
 }
 
+#ifndef CAPSTONE_DIET
+// detail steps of ARMGenDetailOps.inc, named after the print methods they mirror
+enum {
+	ARM_DOP_END = 0,
+	ARM_DOP_OPERAND,	// printOperand()
+	ARM_DOP_PRED,	// printPredicateOperand()
+	ARM_DOP_MANDPRED,	// printMandatoryPredicateOperand()
+	ARM_DOP_SBIT,	// printSBitModifierOperand()
+	ARM_DOP_NOHASHIMM,	// printNoHashImmediate()
+	ARM_DOP_PIMM,	// printPImmediate()
+	ARM_DOP_CIMM,	// printCImmediate()
+	ARM_DOP_COPROCOPT,	// printCoprocOptionImm()
+	ARM_DOP_REGLIST,	// printRegisterList()
+	ARM_DOP_VINDEX,	// printVectorIndex()
+	ARM_DOP_VLIST,	// printVectorList*(), param: count | stride << 4
+	ARM_DOP_VLIST_DPAIR,	// printVectorListTwo*(), param: 2 if spaced
+	ARM_DOP_AM2,	// printAddrMode2Operand()
+	ARM_DOP_AM2OFFSET,	// printAddrMode2OffsetOperand()
+	ARM_DOP_AM3,	// printAddrMode3Operand()
+	ARM_DOP_AM3OFFSET,	// printAddrMode3OffsetOperand()
+	ARM_DOP_AM5,	// printAddrMode5Operand()
+	ARM_DOP_AM6,	// printAddrMode6Operand()
+	ARM_DOP_AM6OFFSET,	// printAddrMode6OffsetOperand()
+	ARM_DOP_AM7,	// printAddrMode7Operand()
+	ARM_DOP_TBB,	// printAddrModeTBB()
+	ARM_DOP_TBH,	// printAddrModeTBH()
+	ARM_DOP_IMM12,	// printAddrModeImm12Operand()
+	ARM_DOP_T2IMM8,	// printT2AddrModeImm8Operand(), printT2AddrModeImm8s4Operand()
+	ARM_DOP_T2IMM0_1020S4,	// printT2AddrModeImm0_1020s4Operand()
+	ARM_DOP_T2IMM8OFFSET,	// printT2AddrModeImm8OffsetOperand(), printT2AddrModeImm8s4OffsetOperand()
+	ARM_DOP_T2SOREG,	// printT2AddrModeSoRegOperand()
+	ARM_DOP_THUMBRR,	// printThumbAddrModeRROperand()
+	ARM_DOP_THUMBIMM5S,	// printThumbAddrModeImm5SOperand(), param: scale
+	ARM_DOP_THUMBLDRLABEL,	// printThumbLdrLabelOperand()
+	ARM_DOP_POSTIDXIMM8,	// printPostIdxImm8Operand()
+	ARM_DOP_POSTIDXREG,	// printPostIdxRegOperand()
+	ARM_DOP_POSTIDXIMM8S4,	// printPostIdxImm8s4Operand()
+	ARM_DOP_SOREGREG,	// printSORegRegOperand()
+	ARM_DOP_SOREGIMM,	// printSORegImmOperand()
+	ARM_DOP_T2SO,	// printT2SOOperand()
+	ARM_DOP_MODIMM,	// printModImmOperand()
+	ARM_DOP_NEONMODIMM,	// printNEONModImmOperand()
+	ARM_DOP_FPIMM,	// printFPImmOperand()
+	ARM_DOP_IMMPLUSONE,	// printImmPlusOneOperand()
+	ARM_DOP_FBITS,	// printFBits16(), printFBits32(), param: 16 or 32
+	ARM_DOP_ROTIMM,	// printRotImmOperand()
+	ARM_DOP_SHIFTIMM,	// printShiftImmOperand()
+	ARM_DOP_PKHLSL,	// printPKHLSLShiftImm()
+	ARM_DOP_PKHASR,	// printPKHASRShiftImm()
+	ARM_DOP_BFINVMASK,	// printBitfieldInvMaskImmOperand()
+	ARM_DOP_THUMBS4IMM,	// printThumbS4ImmOperand()
+	ARM_DOP_THUMBSRIMM,	// printThumbSRImm()
+	ARM_DOP_ADRLABEL,	// printAdrLabelOperand(), param: scale
+	ARM_DOP_GPRPAIR,	// printGPRPairOperand()
+	ARM_DOP_SETEND,	// printSetendOperand()
+	ARM_DOP_CPSIMOD,	// printCPSIMod()
+	ARM_DOP_CPSIFLAG,	// printCPSIFlag()
+	ARM_DOP_MSRMASK,	// printMSRMaskOperand()
+	ARM_DOP_BANKEDREG,	// printBankedRegOperand()
+	ARM_DOP_MEMB,	// printMemBOption()
+	ARM_DOP_MEM_BEGIN,	// set_mem_access(MI, true)
+	ARM_DOP_MEM_END,	// set_mem_access(MI, false)
+	ARM_DOP_IMM,	// op_addImm(), param: immediate
+	ARM_DOP_REG,	// ARM_addReg(), param: register
+	ARM_DOP_USERMODE,	// ARM_addUserMode()
+	ARM_DOP_VDT,	// ARM_addVectorDataType(), param: arm_vectordata_type
+	ARM_DOP_VDS,	// ARM_addVectorDataSize(), param: size
+	ARM_DOP_WRITEBACK,	// the asm string has a "!"
+	ARM_DOP_UPDATE_FLAGS,	// the mnemonic is in insn_update_flgs[]
+};
+
+typedef struct arm_detail_op {
+	uint8_t kind;	// ARM_DOP_*
+	uint8_t opnum;	// index of the MCInst operand
+	uint16_t param;
+} arm_detail_op;
+
+#include "ARMGenDetailOps.inc"
+
+// append a new operand of @type
+static cs_arm_op *detail_add_op(MCInst *MI, arm_op_type type)
+{
+	cs_arm *arm = &MI->flat_insn->detail->arm;
+	cs_arm_op *op = &arm->operands[arm->op_count];
+
+	op->type = type;
+	arm->op_count++;
+
+	return op;
+}
+
+static void detail_add_imm(MCInst *MI, int32_t imm)
+{
+	detail_add_op(MI, ARM_OP_IMM)->imm = imm;
+}
+
+// append a register read by the instruction, regardless of the access table
+static cs_arm_op *detail_add_read_reg(MCInst *MI, unsigned reg)
+{
+	cs_arm_op *op = detail_add_op(MI, ARM_OP_REG);
+
+	op->reg = reg;
+	op->access = CS_AC_READ;
+
+	return op;
+}
+
+// the operand being built between set_mem_access() calls
+static cs_arm_op *detail_mem_op(MCInst *MI)
+{
+	return &MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count];
+}
+
+// the last operand added
+static cs_arm_op *detail_last_op(MCInst *MI)
+{
+	return &MI->flat_insn->detail->arm.operands[MI->flat_insn->detail->arm.op_count - 1];
+}
+
+static void detail_set_shift(cs_arm_op *op, arm_shifter type, unsigned value)
+{
+	op->shift.type = type;
+	op->shift.value = value;
+}
+
+// detail of printOperand()
+static void detail_operand(MCInst *MI, unsigned OpNum)
+{
+	MCOperand *Op = MCInst_getOperand(MI, OpNum);
+	cs_arm_op *op;
+
+	if (MCOperand_isReg(Op)) {
+		unsigned Reg = MCOperand_getReg(Op);
+		if (MI->csh->doing_mem) {
+			op = detail_mem_op(MI);
+			if (op->mem.base == ARM_REG_INVALID)
+				op->mem.base = Reg;
+			else
+				op->mem.index = Reg;
+		} else {
+			op = detail_add_op(MI, ARM_OP_REG);
+			op->reg = Reg;
+			op->access = get_op_access(MI, MI->ac_idx);
+			MI->ac_idx++;
+		}
+	} else if (MCOperand_isImm(Op)) {
+		unsigned int opc = MCInst_getOpcode(MI);
+		int32_t imm = (int32_t)MCOperand_getImm(Op);
+
+		// relative branch only has relative offset: see printOperand()
+		if (ARM_rel_branch(MI->csh, opc)) {
+			uint32_t address;
+
+			if (MI->csh->mode & CS_MODE_THUMB) {
+				address = (uint32_t)MI->address + 4;
+				if (ARM_blx_to_arm_mode(MI->csh, opc))
+					address &= ~3U;
+			} else {
+				address = (uint32_t)MI->address + 8;
+			}
+
+			imm += address;
+		}
+
+		if (MI->csh->doing_mem)
+			detail_mem_op(MI)->mem.disp = imm;
+		else
+			detail_add_imm(MI, imm);
+	}
+}
+
+// detail of register lists, all sharing the access of the next operand
+static void detail_reg_list(MCInst *MI, const unsigned *regs, unsigned count)
+{
+	uint8_t access = get_op_access(MI, MI->ac_idx);
+	unsigned i;
+
+	for (i = 0; i < count; i++) {
+		cs_arm_op *op = detail_add_op(MI, ARM_OP_REG);
+		op->reg = regs[i];
+		op->access = access;
+	}
+
+	MI->ac_idx++;
+}
+
+// detail of printMSRMaskOperand()
+static void detail_msr_mask(MCInst *MI, unsigned OpNum)
+{
+	unsigned Val = (unsigned)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
+	unsigned SpecRegRBit = Val >> 4;
+	unsigned Mask = Val & 0xf;
+	uint64_t FeatureBits = ARM_getFeatureBits(MI->csh->mode);
+	unsigned reg = 0;
+
+	if (FeatureBits & ARM_FeatureMClass) {
+		unsigned SYSm = Val;
+		bool isMSR_M = MCInst_getOpcode(MI) == ARM_t2MSR_M;
+
+		if (isMSR_M && (FeatureBits & ARM_FeatureDSPThumb2)) {
+			switch (SYSm) {
+				case 0x400: reg = ARM_SYSREG_APSR_G; break;
+				case 0xc00: reg = ARM_SYSREG_APSR_NZCVQG; break;
+				case 0x401: reg = ARM_SYSREG_IAPSR_G; break;
+				case 0xc01: reg = ARM_SYSREG_IAPSR_NZCVQG; break;
+				case 0x402: reg = ARM_SYSREG_EAPSR_G; break;
+				case 0xc02: reg = ARM_SYSREG_EAPSR_NZCVQG; break;
+				case 0x403: reg = ARM_SYSREG_XPSR_G; break;
+				case 0xc03: reg = ARM_SYSREG_XPSR_NZCVQG; break;
+			}
+		}
+
+		SYSm &= 0xff;
+
+		if (!reg && isMSR_M && (FeatureBits & ARM_HasV7Ops)) {
+			switch (SYSm) {
+				case 0: reg = ARM_SYSREG_APSR_NZCVQ; break;
+				case 1: reg = ARM_SYSREG_IAPSR_NZCVQ; break;
+				case 2: reg = ARM_SYSREG_EAPSR_NZCVQ; break;
+				case 3: reg = ARM_SYSREG_XPSR_NZCVQ; break;
+			}
+		}
+
+		if (!reg) {
+			switch (SYSm) {
+				default:
+				case  0: reg = ARM_SYSREG_APSR; break;
+				case  1: reg = ARM_SYSREG_IAPSR; break;
+				case  2: reg = ARM_SYSREG_EAPSR; break;
+				case  3: reg = ARM_SYSREG_XPSR; break;
+				case  5: reg = ARM_SYSREG_IPSR; break;
+				case  6: reg = ARM_SYSREG_EPSR; break;
+				case  7: reg = ARM_SYSREG_IEPSR; break;
+				case  8: reg = ARM_SYSREG_MSP; break;
+				case  9: reg = ARM_SYSREG_PSP; break;
+				case 16: reg = ARM_SYSREG_PRIMASK; break;
+				case 17: reg = ARM_SYSREG_BASEPRI; break;
+				case 18: reg = ARM_SYSREG_BASEPRI_MAX; break;
+				case 19: reg = ARM_SYSREG_FAULTMASK; break;
+				case 20: reg = ARM_SYSREG_CONTROL; break;
+			}
+		}
+	} else if (!SpecRegRBit && (Mask == 8 || Mask == 4 || Mask == 12)) {
+		switch (Mask) {
+			default:
+			case 4:  reg = ARM_SYSREG_APSR_G; break;
+			case 8:  reg = ARM_SYSREG_APSR_NZCVQ; break;
+			case 12: reg = ARM_SYSREG_APSR_NZCVQG; break;
+		}
+	} else if (Mask) {
+		if (SpecRegRBit) {
+			if (Mask & 8) reg += ARM_SYSREG_SPSR_F;
+			if (Mask & 4) reg += ARM_SYSREG_SPSR_S;
+			if (Mask & 2) reg += ARM_SYSREG_SPSR_X;
+			if (Mask & 1) reg += ARM_SYSREG_SPSR_C;
+		} else {
+			if (Mask & 8) reg += ARM_SYSREG_CPSR_F;
+			if (Mask & 4) reg += ARM_SYSREG_CPSR_S;
+			if (Mask & 2) reg += ARM_SYSREG_CPSR_X;
+			if (Mask & 1) reg += ARM_SYSREG_CPSR_C;
+		}
+	} else {
+		// plain "cpsr" or "spsr" has no operand
+		return;
+	}
+
+	ARM_addSysReg(MI, reg);
+}
+
+// detail of printBankedRegOperand()
+static void detail_banked_reg(MCInst *MI, unsigned OpNum)
+{
+	uint32_t Banked = (uint32_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
+	uint32_t SysM = Banked & 0x1f;
+
+	if (Banked & 0x20) {
+		switch(SysM) {
+			default:
+			case 0x0e: ARM_addSysReg(MI, ARM_SYSREG_SPSR_FIQ); break;
+			case 0x10: ARM_addSysReg(MI, ARM_SYSREG_SPSR_IRQ); break;
+			case 0x12: ARM_addSysReg(MI, ARM_SYSREG_SPSR_SVC); break;
+			case 0x14: ARM_addSysReg(MI, ARM_SYSREG_SPSR_ABT); break;
+			case 0x16: ARM_addSysReg(MI, ARM_SYSREG_SPSR_UND); break;
+			case 0x1c: ARM_addSysReg(MI, ARM_SYSREG_SPSR_MON); break;
+			case 0x1e: ARM_addSysReg(MI, ARM_SYSREG_SPSR_HYP); break;
+		}
+	} else
+		ARM_addSysReg(MI, BankedRegIds[SysM]);
+}
+
+static void detail_step(MCInst *MI, const arm_detail_op *step, unsigned OpNum)
+{
+	cs_arm *arm = &MI->flat_insn->detail->arm;
+	MCOperand *MO1 = MCInst_getOperand(MI, OpNum);
+	MCOperand *MO2 = MCInst_getOperand(MI, OpNum + 1);
+	MCOperand *MO3 = MCInst_getOperand(MI, OpNum + 2);
+	MCRegisterInfo *MRI = (MCRegisterInfo *)MI->csh->printer_info;
+	unsigned regs[4], i, Imm, ImmOffs;
+	int32_t OffImm;
+	ARM_AM_AddrOpc sub;
+	cs_arm_op *op;
+
+	switch(step->kind) {
+		default:
+			break;
+
+		case ARM_DOP_OPERAND:
+			detail_operand(MI, OpNum);
+			break;
+
+		case ARM_DOP_PRED:
+			Imm = (unsigned)MCOperand_getImm(MO1);
+			arm->cc = Imm == 15 ? ARM_CC_INVALID : Imm + 1;
+			break;
+
+		case ARM_DOP_MANDPRED:
+			arm->cc = (arm_cc)(MCOperand_getImm(MO1) + 1);
+			break;
+
+		case ARM_DOP_SBIT:
+			if (MCOperand_getReg(MO1))
+				arm->update_flags = true;
+			break;
+
+		case ARM_DOP_NOHASHIMM:
+			Imm = (unsigned)MCOperand_getImm(MO1);
+			if (MI->csh->doing_mem) {
+				arm->op_count--;
+				arm->operands[arm->op_count].neon_lane = (int8_t)Imm;
+				MI->ac_idx--;	// consecutive operands share the same access right
+			} else
+				detail_add_imm(MI, Imm);
+			break;
+
+		case ARM_DOP_PIMM:
+			detail_add_op(MI, ARM_OP_PIMM)->imm = (unsigned)MCOperand_getImm(MO1);
+			break;
+
+		case ARM_DOP_CIMM:
+			detail_add_op(MI, ARM_OP_CIMM)->imm = (unsigned)MCOperand_getImm(MO1);
+			break;
+
+		case ARM_DOP_COPROCOPT:
+			detail_add_imm(MI, (unsigned)MCOperand_getImm(MO1));
+			break;
+
+		case ARM_DOP_REGLIST: {
+			uint8_t access = get_op_access(MI, MI->ac_idx);
+			for (i = OpNum; i < MCInst_getNumOperands(MI); i++) {
+				op = detail_add_op(MI, ARM_OP_REG);
+				op->reg = MCOperand_getReg(MCInst_getOperand(MI, i));
+				op->access = access;
+			}
+			MI->ac_idx++;
+			break;
+		}
+
+		case ARM_DOP_VINDEX:
+			detail_last_op(MI)->vector_index = (int)MCOperand_getImm(MO1);
+			break;
+
+		case ARM_DOP_VLIST:
+			// VFP registers D<n> are in order, see printVectorListThree()
+			for (i = 0; i < (step->param & 0xf); i++)
+				regs[i] = MCOperand_getReg(MO1) + i * (step->param >> 4);
+			detail_reg_list(MI, regs, step->param & 0xf);
+			break;
+
+		case ARM_DOP_VLIST_DPAIR:
+			regs[0] = MCRegisterInfo_getSubReg(MRI, MCOperand_getReg(MO1), ARM_dsub_0);
+			regs[1] = MCRegisterInfo_getSubReg(MRI, MCOperand_getReg(MO1),
+					step->param == 2 ? ARM_dsub_2 : ARM_dsub_1);
+			detail_reg_list(MI, regs, 2);
+			break;
+
+		case ARM_DOP_AM2:
+			if (!MCOperand_isReg(MO1)) {
+				detail_operand(MI, OpNum);
+				break;
+			}
+			sub = getAM2Op((unsigned int)MCOperand_getImm(MO3));
+			set_mem_access(MI, true);
+			op = detail_mem_op(MI);
+			op->mem.base = MCOperand_getReg(MO1);
+			if (!MCOperand_getReg(MO2)) {
+				ImmOffs = getAM2Offset((unsigned int)MCOperand_getImm(MO3));
+				if (ImmOffs) {
+					detail_set_shift(op, (arm_shifter)sub, ImmOffs);
+					op->subtracted = sub == ARM_AM_sub;
+				}
+			} else {
+				op->mem.index = MCOperand_getReg(MO2);
+				op->subtracted = sub == ARM_AM_sub;
+				addRegImmShift(MI, getAM2ShiftOpc((unsigned int)MCOperand_getImm(MO3)),
+						getAM2Offset((unsigned int)MCOperand_getImm(MO3)));
+			}
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_AM2OFFSET:
+			sub = getAM2Op((unsigned int)MCOperand_getImm(MO2));
+			if (!MCOperand_getReg(MO1)) {
+				op = detail_add_op(MI, ARM_OP_IMM);
+				op->imm = getAM2Offset((unsigned int)MCOperand_getImm(MO2));
+			} else {
+				op = detail_add_read_reg(MI, MCOperand_getReg(MO1));
+				addRegImmShift(MI, getAM2ShiftOpc((unsigned int)MCOperand_getImm(MO2)),
+						getAM2Offset((unsigned int)MCOperand_getImm(MO2)));
+			}
+			op->subtracted = sub == ARM_AM_sub;
+			break;
+
+		case ARM_DOP_AM3:
+			if (!MCOperand_isReg(MO1)) {
+				detail_operand(MI, OpNum);
+				break;
+			}
+			sub = getAM3Op((unsigned int)MCOperand_getImm(MO3));
+			set_mem_access(MI, true);
+			op = detail_mem_op(MI);
+			op->mem.base = MCOperand_getReg(MO1);
+			if (MCOperand_getReg(MO2)) {
+				op->mem.index = MCOperand_getReg(MO2);
+				if (sub == ARM_AM_sub) {
+					op->mem.scale = -1;
+					op->subtracted = true;
+				}
+			} else {
+				ImmOffs = getAM3Offset((unsigned int)MCOperand_getImm(MO3));
+				if (sub == ARM_AM_sub) {
+					op->mem.disp = -(int)ImmOffs;
+					op->subtracted = true;
+				} else
+					op->mem.disp = (int)ImmOffs;
+			}
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_AM3OFFSET:
+			sub = getAM3Op((unsigned int)MCOperand_getImm(MO2));
+			if (MCOperand_getReg(MO1))
+				op = detail_add_read_reg(MI, MCOperand_getReg(MO1));
+			else {
+				op = detail_add_op(MI, ARM_OP_IMM);
+				op->imm = getAM3Offset((unsigned int)MCOperand_getImm(MO2));
+			}
+			op->subtracted = sub == ARM_AM_sub;
+			break;
+
+		case ARM_DOP_AM5:
+			if (!MCOperand_isReg(MO1)) {
+				detail_operand(MI, OpNum);
+				break;
+			}
+			op = detail_add_op(MI, ARM_OP_MEM);
+			op->mem.base = MCOperand_getReg(MO1);
+			op->mem.index = ARM_REG_INVALID;
+			op->mem.scale = 1;
+			op->access = CS_AC_READ;
+			ImmOffs = ARM_AM_getAM5Offset((unsigned int)MCOperand_getImm(MO2));
+			if (ARM_AM_getAM5Op((unsigned int)MCOperand_getImm(MO2)) == ARM_AM_sub)
+				op->mem.disp = -(int)ImmOffs * 4;
+			else
+				op->mem.disp = ImmOffs * 4;
+			break;
+
+		case ARM_DOP_AM6:
+			set_mem_access(MI, true);
+			detail_mem_op(MI)->mem.base = MCOperand_getReg(MO1);
+			if (MCOperand_getImm(MO2))
+				detail_mem_op(MI)->mem.disp = (unsigned int)MCOperand_getImm(MO2) << 3;
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_AM6OFFSET:
+			if (MCOperand_getReg(MO1) == 0)
+				MI->writeback = true;
+			else
+				detail_add_read_reg(MI, MCOperand_getReg(MO1));
+			break;
+
+		case ARM_DOP_AM7:
+			set_mem_access(MI, true);
+			detail_mem_op(MI)->mem.base = MCOperand_getReg(MO1);
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_TBB:
+		case ARM_DOP_TBH:
+			set_mem_access(MI, true);
+			op = detail_mem_op(MI);
+			op->mem.base = MCOperand_getReg(MO1);
+			op->mem.index = MCOperand_getReg(MO2);
+			if (step->kind == ARM_DOP_TBH) {
+				detail_set_shift(op, ARM_SFT_LSL, 1);
+				op->mem.lshift = 1;
+			}
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_IMM12:
+		case ARM_DOP_T2IMM8:
+			if (!MCOperand_isReg(MO1)) {
+				detail_operand(MI, OpNum);
+				break;
+			}
+			OffImm = (int32_t)MCOperand_getImm(MO2);
+			// Special value for #-0. All others are normal.
+			if (OffImm == INT32_MIN)
+				OffImm = 0;
+			set_mem_access(MI, true);
+			detail_mem_op(MI)->mem.base = MCOperand_getReg(MO1);
+			detail_mem_op(MI)->mem.disp = OffImm;
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_T2IMM0_1020S4:
+			set_mem_access(MI, true);
+			detail_mem_op(MI)->mem.base = MCOperand_getReg(MO1);
+			if (MCOperand_getImm(MO2))
+				detail_mem_op(MI)->mem.disp = (unsigned int)MCOperand_getImm(MO2) * 4;
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_T2IMM8OFFSET:
+			OffImm = (int32_t)MCOperand_getImm(MO1);
+			detail_add_imm(MI, OffImm == INT32_MIN ? 0 : OffImm);
+			break;
+
+		case ARM_DOP_T2SOREG:
+			set_mem_access(MI, true);
+			op = detail_mem_op(MI);
+			op->mem.base = MCOperand_getReg(MO1);
+			op->mem.index = MCOperand_getReg(MO2);
+			if (MCOperand_getImm(MO3))
+				detail_set_shift(op, ARM_SFT_LSL, (unsigned int)MCOperand_getImm(MO3));
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_THUMBRR:
+		case ARM_DOP_THUMBIMM5S:
+			if (!MCOperand_isReg(MO1)) {
+				detail_operand(MI, OpNum);
+				break;
+			}
+			set_mem_access(MI, true);
+			op = detail_mem_op(MI);
+			op->mem.base = MCOperand_getReg(MO1);
+			if (step->kind == ARM_DOP_THUMBRR) {
+				if (MCOperand_getReg(MO2))
+					op->mem.index = MCOperand_getReg(MO2);
+			} else if (MCOperand_getImm(MO2))
+				op->mem.disp = (unsigned int)MCOperand_getImm(MO2) * step->param;
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_THUMBLDRLABEL:
+			OffImm = (int32_t)MCOperand_getImm(MO1);
+			op = detail_add_op(MI, ARM_OP_MEM);
+			op->mem.base = ARM_REG_PC;
+			op->mem.index = ARM_REG_INVALID;
+			op->mem.scale = 1;
+			op->mem.disp = OffImm == INT32_MIN ? 0 : OffImm;
+			op->access = CS_AC_READ;
+			break;
+
+		case ARM_DOP_POSTIDXIMM8:
+			detail_add_imm(MI, (unsigned int)MCOperand_getImm(MO1) & 0xff);
+			break;
+
+		case ARM_DOP_POSTIDXREG:
+			detail_add_read_reg(MI, MCOperand_getReg(MO1));
+			break;
+
+		case ARM_DOP_POSTIDXIMM8S4:
+			Imm = (unsigned int)MCOperand_getImm(MO1);
+			detail_add_imm(MI, (Imm & 256) ? ((Imm & 0xff) << 2) : -(int)((Imm & 0xff) << 2));
+			break;
+
+		case ARM_DOP_SOREGREG:
+			Imm = (unsigned int)MCOperand_getImm(MO3);
+			op = detail_add_read_reg(MI, MCOperand_getReg(MO1));
+			op->shift.type = (Imm & 7) + ARM_SFT_ASR_REG - 1;
+			if (ARM_AM_getSORegShOp(Imm) != ARM_AM_rrx)
+				op->shift.value = MCOperand_getReg(MO2);
+			break;
+
+		case ARM_DOP_SOREGIMM:
+			Imm = (unsigned int)MCOperand_getImm(MO2);
+			detail_set_shift(detail_add_read_reg(MI, MCOperand_getReg(MO1)), Imm & 7, Imm >> 3);
+			addRegImmShift(MI, ARM_AM_getSORegShOp(Imm), getSORegOffset(Imm));
+			break;
+
+		case ARM_DOP_T2SO:
+			Imm = (unsigned int)MCOperand_getImm(MO2);
+			detail_add_read_reg(MI, MCOperand_getReg(MO1));
+			addRegImmShift(MI, ARM_AM_getSORegShOp(Imm), getSORegOffset(Imm));
+			break;
+
+		case ARM_DOP_MODIMM: {
+			unsigned Bits = MCOperand_getImm(MO1) & 0xFF;
+			unsigned Rot = (MCOperand_getImm(MO1) & 0xF00) >> 7;
+			int32_t Rotated = rotr32(Bits, Rot);
+
+			if (getSOImmVal(Rotated) == MCOperand_getImm(MO1))
+				detail_add_imm(MI, Rotated);
+			else {
+				detail_add_imm(MI, Bits);
+				detail_add_imm(MI, Rot);
+			}
+			break;
+		}
+
+		case ARM_DOP_NEONMODIMM:
+			detail_add_imm(MI, (unsigned int)ARM_AM_decodeNEONModImm(
+						(unsigned int)MCOperand_getImm(MO1), &Imm));
+			break;
+
+		case ARM_DOP_FPIMM:
+			detail_add_op(MI, ARM_OP_FP)->fp = getFPImmFloat((unsigned int)MCOperand_getImm(MO1));
+			break;
+
+		case ARM_DOP_IMMPLUSONE:
+			detail_add_imm(MI, (unsigned int)MCOperand_getImm(MO1) + 1);
+			break;
+
+		case ARM_DOP_FBITS:
+			detail_add_imm(MI, step->param - (unsigned int)MCOperand_getImm(MO1));
+			break;
+
+		case ARM_DOP_ROTIMM:
+			Imm = (unsigned int)MCOperand_getImm(MO1);
+			if (Imm)
+				detail_set_shift(detail_last_op(MI), ARM_SFT_ROR, Imm * 8);
+			break;
+
+		case ARM_DOP_SHIFTIMM:
+			Imm = (unsigned int)MCOperand_getImm(MO1);
+			if (Imm & (1 << 5))
+				detail_set_shift(detail_last_op(MI), ARM_SFT_ASR, (Imm & 0x1f) ? (Imm & 0x1f) : 32);
+			else if (Imm & 0x1f)
+				detail_set_shift(detail_last_op(MI), ARM_SFT_LSL, Imm & 0x1f);
+			break;
+
+		case ARM_DOP_PKHLSL:
+			Imm = (unsigned int)MCOperand_getImm(MO1);
+			if (Imm)
+				detail_set_shift(detail_last_op(MI), ARM_SFT_LSL, Imm);
+			break;
+
+		case ARM_DOP_PKHASR:
+			Imm = (unsigned int)MCOperand_getImm(MO1);
+			// A shift amount of 32 is encoded as 0.
+			detail_set_shift(detail_last_op(MI), ARM_SFT_ASR, Imm ? Imm : 32);
+			break;
+
+		case ARM_DOP_BFINVMASK: {
+			uint32_t v = ~(uint32_t)MCOperand_getImm(MO1);
+			int32_t lsb = CountTrailingZeros_32(v);
+
+			detail_add_imm(MI, lsb);
+			detail_add_imm(MI, (32 - CountLeadingZeros_32(v)) - lsb);
+			break;
+		}
+
+		case ARM_DOP_THUMBS4IMM:
+			detail_add_imm(MI, (unsigned int)MCOperand_getImm(MO1) * 4);
+			break;
+
+		case ARM_DOP_THUMBSRIMM:
+			Imm = (unsigned int)MCOperand_getImm(MO1);
+			detail_add_imm(MI, Imm ? Imm : 32);
+			break;
+
+		case ARM_DOP_ADRLABEL:
+			OffImm = (int32_t)MCOperand_getImm(MO1) << step->param;
+			detail_add_imm(MI, OffImm == INT32_MIN ? 0 : OffImm);
+			break;
+
+		case ARM_DOP_GPRPAIR:
+			detail_add_op(MI, ARM_OP_REG)->reg = MCRegisterInfo_getSubReg(MRI, MCOperand_getReg(MO1), ARM_gsub_0);
+			detail_add_op(MI, ARM_OP_REG)->reg = MCRegisterInfo_getSubReg(MRI, MCOperand_getReg(MO1), ARM_gsub_1);
+			break;
+
+		case ARM_DOP_SETEND:
+			detail_add_op(MI, ARM_OP_SETEND)->setend = MCOperand_getImm(MO1) ? ARM_SETEND_BE : ARM_SETEND_LE;
+			break;
+
+		case ARM_DOP_CPSIMOD:
+			arm->cps_mode = (arm_cpsmode_type)MCOperand_getImm(MO1);
+			break;
+
+		case ARM_DOP_CPSIFLAG:
+			Imm = (unsigned int)MCOperand_getImm(MO1);
+			arm->cps_flag = Imm ? (arm_cpsflag_type)Imm : ARM_CPSFLAG_NONE;
+			break;
+
+		case ARM_DOP_MSRMASK:
+			detail_msr_mask(MI, OpNum);
+			break;
+
+		case ARM_DOP_BANKEDREG:
+			detail_banked_reg(MI, OpNum);
+			break;
+
+		case ARM_DOP_MEMB:
+			arm->mem_barrier = (arm_mem_barrier)(MCOperand_getImm(MO1) + 1);
+			break;
+
+		case ARM_DOP_MEM_BEGIN:
+			set_mem_access(MI, true);
+			break;
+
+		case ARM_DOP_MEM_END:
+			set_mem_access(MI, false);
+			break;
+
+		case ARM_DOP_IMM:
+			op_addImm(MI, step->param);
+			break;
+
+		case ARM_DOP_REG:
+			ARM_addReg(MI, step->param);
+			break;
+
+		case ARM_DOP_USERMODE:
+			ARM_addUserMode(MI);
+			break;
+
+		case ARM_DOP_VDT:
+			ARM_addVectorDataType(MI, (arm_vectordata_type)step->param);
+			break;
+
+		case ARM_DOP_VDS:
+			ARM_addVectorDataSize(MI, step->param);
+			break;
+
+		case ARM_DOP_WRITEBACK:
+			MI->writeback = true;
+			break;
+
+		case ARM_DOP_UPDATE_FLAGS:
+			if (!arm->update_flags)
+				set_update_flags(MI->flat_insn);
+			break;
+	}
+}
+
+/// Fill in the details of @MI for CS_OPT_NOTEXT mode, like ARM_printInst()
+/// does, but without printing. The operands come from the per-opcode operand
+/// programs of ARMGenDetailOps.inc.
+void ARM_fill_detail(MCInst *MI)
+{
+	unsigned Opcode = MCInst_getOpcode(MI);
+	const arm_detail_op *step;
+	SStream ss;
+
+	switch(Opcode) {
+		default:
+			break;
+
+		// ARM_printInst() handles these by hand, so just print them
+		case ARM_HINT:
+		case ARM_tHINT:
+		case ARM_t2HINT:
+		case ARM_MOVsr:
+		case ARM_MOVsi:
+		case ARM_STMDB_UPD:
+		case ARM_t2STMDB_UPD:
+		case ARM_STR_PRE_IMM:
+		case ARM_LDMIA_UPD:
+		case ARM_t2LDMIA_UPD:
+		case ARM_LDR_POST_IMM:
+		case ARM_VSTMSDB_UPD:
+		case ARM_VSTMDDB_UPD:
+		case ARM_VLDMSIA_UPD:
+		case ARM_VLDMDIA_UPD:
+		case ARM_tLDMIA:
+		case ARM_LDREXD:
+		case ARM_STREXD:
+		case ARM_LDAEXD:
+		case ARM_STLEXD:
+		case ARM_t2SUBS_PC_LR:
+			// the text is dropped later in CS_OPT_NOTEXT mode
+			SStream_InitInsn(&ss, MI->flat_insn->mnemonic, MI->flat_insn->op_str);
+			ARM_printInst(MI, &ss, MI->csh->printer_info);
+			ARM_post_printer((csh)MI->csh, MI->flat_insn, MI);
+			return;
+	}
+
+	if (MI->csh->detail != CS_OPT_ON)
+		return;
+
+	if (Opcode < ARR_SIZE(detail_op_idx)) {
+		for (step = &detail_ops[detail_op_idx[Opcode]]; step->kind != ARM_DOP_END; step++)
+			detail_step(MI, step, step->opnum);
+	}
+
+	post_detail(MI->flat_insn, MI);
+}
+#endif
+
 #endif
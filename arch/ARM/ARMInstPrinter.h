@@ -22,7 +22,9 @@
 #include "../../SStream.h"
 
 void ARM_printInst(MCInst *MI, SStream *O, void *Info);
-void ARM_post_printer(csh handle, cs_insn *pub_insn, char *mnem, MCInst *mci);
+void ARM_post_printer(csh handle, cs_insn *pub_insn, MCInst *mci);
+
+void ARM_fill_detail(MCInst *MI);
 
 // setup handle->get_regname
 void ARM_getRegName(cs_struct *handle, int value);
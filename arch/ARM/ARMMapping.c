@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "../../cs_priv.h"
+#include "../../MCRegisterInfo.h"
 
 #include "ARMMapping.h"
 
@@ -266,23 +267,47 @@ const char *ARM_reg_name2(csh handle, unsigned int reg)
 #endif
 }
 
+#ifndef CAPSTONE_DIET
+#include "ARMMappingInsnPool.inc"
+#endif
+
 static const insn_map insns[] = {
 	// dummy item
 	{
 		0, 0,
 #ifndef CAPSTONE_DIET
-		{ 0 }, { 0 }, { 0 }, 0, 0
+		0, 0, 0, 0, 0, 0, 0, 0
 #endif
 	},
 
 #include "ARMMappingInsn.inc"
 };
 
-void ARM_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+#ifndef CAPSTONE_DIET
+// map instruction to its characteristics
+typedef struct insn_op {
+	uint8_t access[7];
+} insn_op;
+
+static insn_op insn_ops[] = {
+	{
+		// NULL item
+		{ 0 }
+	},
+
+#include "ARMMappingInsnOp.inc"
+};
+#endif
+
+void ARM_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
-	int i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
+	int i = insn_find(h, insns, ARR_SIZE(insns), id);
 	//printf(">> id = %u\n", id);
 	if (i != 0) {
+		MI->mapping = &insns[i];
+#ifndef CAPSTONE_DIET
+		MI->op_info = &insn_ops[i];
+#endif
 		insn->id = insns[i].mapid;
 
 		if (h->detail) {
@@ -290,14 +315,7 @@ void ARM_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
 			cs_struct handle;
 			handle.detail = h->detail;
 
-			memcpy(insn->detail->regs_read, insns[i].regs_use, sizeof(insns[i].regs_use));
-			insn->detail->regs_read_count = (uint8_t)count_positive(insns[i].regs_use);
-
-			memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-			insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-
-			memcpy(insn->detail->groups, insns[i].groups, sizeof(insns[i].groups));
-			insn->detail->groups_count = (uint8_t)count_positive8(insns[i].groups);
+			map_implicit_detail(insn->detail, &insns[i], insn_regs, insn_groups);
 
 			insn->detail->arm.update_flags = cs_reg_write((csh)&handle, insn, ARM_REG_CPSR);
 
@@ -871,27 +889,13 @@ bool ARM_blx_to_arm_mode(cs_struct *h, unsigned int id) {
 }
 
 #ifndef CAPSTONE_DIET
-// map instruction to its characteristics
-typedef struct insn_op {
-	uint8_t access[7];
-} insn_op;
-
-static insn_op insn_ops[] = {
-	{
-		// NULL item
-		{ 0 }
-	},
-
-#include "ARMMappingInsnOp.inc"
-};
-
-// given internal insn id, return operand access info
-uint8_t *ARM_get_op_access(cs_struct *h, unsigned int id)
+// return operand access info of the instruction, as resolved by ARM_get_insn_id()
+const uint8_t *ARM_get_op_access(const MCInst *MI)
 {
-	int i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
-	if (i != 0) {
-		return insn_ops[i].access;
-	}
+	const insn_op *op = MI->op_info;
+
+	if (op)
+		return op->access;
 
 	return NULL;
 }
@@ -947,6 +951,43 @@ void ARM_reg_access(const cs_insn *insn,
 	*regs_read_count = read_count;
 	*regs_write_count = write_count;
 }
+
+void ARM_reg_access_mask(const cs_insn *insn,
+		uint64_t *regs_read, uint64_t *regs_write)
+{
+	uint8_t i;
+	cs_arm *arm = &(insn->detail->arm);
+
+	for (i = 0; i < arm->op_count; i++) {
+		cs_arm_op *op = &(arm->operands[i]);
+		switch((int)op->type) {
+			case ARM_OP_REG:
+				if (op->access & CS_AC_READ)
+					REGS_MASK_SET(regs_read, op->reg);
+				if (op->access & CS_AC_WRITE)
+					REGS_MASK_SET(regs_write, op->reg);
+				break;
+			case ARM_OP_MEM:
+				// registers appeared in memory references always being read
+				// (bit 0 is ARM_REG_INVALID, and is cleared below)
+				REGS_MASK_SET(regs_read, op->mem.base);
+				REGS_MASK_SET(regs_read, op->mem.index);
+				if (arm->writeback)
+					REGS_MASK_SET(regs_write, op->mem.base);
+			default:
+				break;
+		}
+	}
+
+	regs_read[0] &= ~(uint64_t)1;
+	regs_write[0] &= ~(uint64_t)1;
+}
+
+void ARM_reg_fold_aliases(cs_struct *h, const uint64_t *regs, uint64_t *aliases)
+{
+	MCRegisterInfo_foldAliases((const MCRegisterInfo *)h->printer_info,
+			regs, aliases, ARM_REG_ENDING);
+}
 #endif
 
 #endif
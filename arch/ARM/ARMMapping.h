@@ -12,7 +12,7 @@ const char *ARM_reg_name(csh handle, unsigned int reg);
 const char *ARM_reg_name2(csh handle, unsigned int reg);
 
 // given internal insn id, return public instruction ID
-void ARM_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void ARM_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 const char *ARM_insn_name(csh handle, unsigned int id);
 
@@ -23,10 +23,15 @@ bool ARM_rel_branch(cs_struct *h, unsigned int insn_id);
 
 bool ARM_blx_to_arm_mode(cs_struct *h, unsigned int insn_id);
 
-uint8_t *ARM_get_op_access(cs_struct *h, unsigned int id);
+const uint8_t *ARM_get_op_access(const MCInst *MI);
 
 void ARM_reg_access(const cs_insn *insn,
 		cs_regs regs_read, uint8_t *regs_read_count,
 		cs_regs regs_write, uint8_t *regs_write_count);
 
+void ARM_reg_access_mask(const cs_insn *insn,
+		uint64_t *regs_read, uint64_t *regs_write);
+
+void ARM_reg_fold_aliases(cs_struct *h, const uint64_t *regs, uint64_t *aliases);
+
 #endif
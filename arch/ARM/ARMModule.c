@@ -12,10 +12,10 @@
 
 cs_err ARM_global_init(cs_struct *ud)
 {
-	MCRegisterInfo *mri;
-	mri = cs_mem_malloc(sizeof(*mri));
+	// register info is constant & shared by all handles, so the printer
+	// & decoder only read it
+	MCRegisterInfo *mri = (MCRegisterInfo *)ARM_getRegisterInfo();
 
-	ARM_init(mri);
 	ARM_getRegName(ud, 0);	// use default get_regname
 
 	ud->printer = ARM_printInst;
@@ -27,6 +27,9 @@ cs_err ARM_global_init(cs_struct *ud)
 	ud->post_printer = ARM_post_printer;
 #ifndef CAPSTONE_DIET
 	ud->reg_access = ARM_reg_access;
+	ud->reg_access_mask = ARM_reg_access_mask;
+	ud->reg_fold_aliases = ARM_reg_fold_aliases;
+	ud->fill_detail = ARM_fill_detail;
 #endif
 
 	if (ud->mode & CS_MODE_THUMB)
@@ -31,7 +31,7 @@ static int evm_insn_find(cs_evm *insns, unsigned int max, unsigned int id)
 }
 
 // fill in details
-void EVM_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+void EVM_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
 	insn->id = id;
 #ifndef CAPSTONE_DIET
@@ -235,7 +235,7 @@ static int binary_search(const inst_pageX *const inst_pageX_table,
 	return -2;
 }
 
-void M680X_get_insn_id(cs_struct *handle, cs_insn *insn, unsigned int id)
+void M680X_get_insn_id(cs_struct *handle, cs_insn *insn, unsigned int id, MCInst *MI)
 {
 	const m680x_info *const info = (const m680x_info *)handle->printer_info;
 	const cpu_tables *cpu = info->cpu;
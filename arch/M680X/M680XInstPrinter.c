@@ -101,7 +101,7 @@ static name_map s_group_names[] = {
 static void printRegName(cs_struct *handle, SStream *OS, unsigned int reg)
 {
 #ifndef CAPSTONE_DIET
-	SStream_concat(OS, handle->reg_name((csh)handle, reg));
+	SStream_concat0(OS, handle->reg_name((csh)handle, reg));
 #endif
 }
 
@@ -109,7 +109,7 @@ static void printInstructionName(cs_struct *handle, SStream *OS,
 	unsigned int insn)
 {
 #ifndef CAPSTONE_DIET
-	SStream_concat(OS, handle->insn_name((csh)handle, insn));
+	SStream_concat0(OS, handle->insn_name((csh)handle, insn));
 #endif
 }
 
@@ -146,7 +146,7 @@ static void printIncDec(bool isPost, SStream *O, m680x_info *info,
 			prePostfix = (char *)s_inc_dec[op->idx.inc_dec + 2];
 		}
 
-		SStream_concat(O, prePostfix);
+		SStream_concat0(O, prePostfix);
 	}
 }
 
@@ -159,21 +159,21 @@ static void printOperand(MCInst *MI, SStream *O, m680x_info *info,
 		break;
 
 	case M680X_OP_CONSTANT:
-		SStream_concat(O, "%u", op->const_val);
+		SStream_concatDec(O, op->const_val);
 		break;
 
 	case M680X_OP_IMMEDIATE:
+		SStream_concat1(O, '#');
 		if (MI->csh->imm_unsigned)
-			SStream_concat(O, "#%u",
-				get_unsigned(op->imm, op->size));
+			SStream_concatDec(O, get_unsigned(op->imm, op->size));
 		else
-			SStream_concat(O, "#%d", op->imm);
+			printInt32Dec(O, op->imm);
 
 		break;
 
 	case M680X_OP_INDEXED:
 		if (op->idx.flags & M680X_IDX_INDIRECT)
-			SStream_concat(O, "[");
+			SStream_concat1(O, '[');
 
 		if (op->idx.offset_reg != M680X_REG_INVALID)
 			printRegName(MI->csh, O, op->idx.offset_reg);
@@ -181,14 +181,14 @@ static void printOperand(MCInst *MI, SStream *O, m680x_info *info,
 			if (op->idx.base_reg == M680X_REG_PC)
 				SStream_concat(O, "$%04X", op->idx.offset_addr);
 			else
-				SStream_concat(O, "%d", op->idx.offset);
+				printInt32Dec(O, op->idx.offset);
 		}
 		else if (op->idx.inc_dec != 0 &&
 			info->cpu_type == M680X_CPU_TYPE_CPU12)
-			SStream_concat(O, "%d", abs(op->idx.inc_dec));
+			SStream_concatDec(O, abs(op->idx.inc_dec));
 
 		if (!(op->idx.flags & M680X_IDX_NO_COMMA))
-			SStream_concat(O, ",");
+			SStream_concat1(O, ',');
 
 		printIncDec(false, O, info, op);
 
@@ -196,12 +196,12 @@ static void printOperand(MCInst *MI, SStream *O, m680x_info *info,
 
 		if (op->idx.base_reg == M680X_REG_PC &&
 			(op->idx.offset_bits > 0))
-			SStream_concat(O, "R");
+			SStream_concat1(O, 'R');
 
 		printIncDec(true, O, info, op);
 
 		if (op->idx.flags & M680X_IDX_INDIRECT)
-			SStream_concat(O, "]");
+			SStream_concat1(O, ']');
 
 		break;
 
@@ -228,7 +228,7 @@ static void printOperand(MCInst *MI, SStream *O, m680x_info *info,
 		break;
 
 	default:
-		SStream_concat(O, "<invalid_operand>");
+		SStream_concat0(O, "<invalid_operand>");
 		break;
 	}
 }
@@ -271,13 +271,13 @@ void M680X_printInst(MCInst *MI, SStream *O, void *PrinterInfo)
 		if (m680x->op_count)
 			SStream_concat(O, "fcb $%02X", m680x->operands[0].imm);
 		else
-			SStream_concat(O, "fcb $<unknown>");
+			SStream_concat0(O, "fcb $<unknown>");
 
 		return;
 	}
 
 	printInstructionName(MI->csh, O, info->insn);
-	SStream_concat(O, " ");
+	SStream_concat1(O, ' ');
 
 	if ((m680x->flags & M680X_FIRST_OP_IN_MNEM) != 0)
 		suppress_operands++;
@@ -290,7 +290,7 @@ void M680X_printInst(MCInst *MI, SStream *O, void *PrinterInfo)
 			printOperand(MI, O, info, &m680x->operands[i]);
 
 			if ((i + 1) != m680x->op_count)
-				SStream_concat(O, delimiter);
+				SStream_concat0(O, delimiter);
 		}
 	}
 }
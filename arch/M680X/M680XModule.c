@@ -12,7 +12,6 @@
 
 cs_err M680X_global_init(cs_struct *ud)
 {
-	m680x_info *info;
 	cs_err errcode;
 
 	/* Do some validation checks */
@@ -45,13 +44,8 @@ cs_err M680X_global_init(cs_struct *ud)
 		return CS_ERR_MODE;
 	}
 
-	info = cs_mem_malloc(sizeof(m680x_info));
-
-	if (!info)
-		return CS_ERR_MEM;
-
 	ud->printer = M680X_printInst;
-	ud->printer_info = info;
+	// printer_info is the m680x_info state, allocated along with the handle
 	ud->getinsn_info = NULL;
 	ud->disasm = M680X_getInstruction;
 	ud->reg_name = M680X_reg_name;
@@ -221,7 +221,6 @@ static int make_int_8(int value);
 static int make_int_16(int value);
 
 /* Stuff to build the opcode handler jump table */
-static void build_opcode_table(void);
 static int valid_ea(uint opcode, uint mask);
 static int DECL_SPEC compare_nof_true_bits(const void *aptr, const void *bptr);
 static void d68000_invalid(m68k_info *info);
@@ -3790,8 +3789,8 @@ static int DECL_SPEC compare_nof_true_bits(const void *aptr, const void *bptr)
 	return b - a; /* reversed to get greatest to least sorting */
 }
 
-/* build the opcode handler jump table */
-static void build_opcode_table(void)
+/* build the opcode handler jump table, once for all handles */
+void M68K_buildOpcodeTable(void)
 {
 	uint i;
 	uint opcode;
@@ -4030,8 +4029,6 @@ static unsigned int m68k_disassemble(m68k_info *info, uint64_t pc)
 
 	inst->Opcode = M68K_INS_INVALID;
 
-	build_opcode_table();
-
 	memset(ext, 0, sizeof(cs_m68k));
 	ext->op_size.type = M68K_SIZE_TYPE_CPU;
 
@@ -25,6 +25,9 @@ typedef struct m68k_info {
 	uint8_t groups_count;
 } m68k_info;
 
+/* Build the decoding table shared by all handles, when one is opened */
+void M68K_buildOpcodeTable(void);
+
 bool M68K_getInstruction(csh ud, const uint8_t* code, size_t code_len, MCInst* instr, uint16_t* size, uint64_t address, void* info);
 
 #endif
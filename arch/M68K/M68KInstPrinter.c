@@ -111,7 +111,7 @@ static void registerBits(SStream* O, const cs_m68k_op* op)
 	buffer[0] = 0;
 
 	if (!data) {
-		SStream_concat(O, "%s", "#$0");
+		SStream_concat0(O, "#$0");
 		return;
 	}
 
@@ -119,7 +119,7 @@ static void registerBits(SStream* O, const cs_m68k_op* op)
 	printRegbitsRange(buffer, (data >> 8) & 0xff, "a");
 	printRegbitsRange(buffer, (data >> 16) & 0xff, "fp");
 
-	SStream_concat(O, "%s", buffer);
+	SStream_concat0(O, buffer);
 }
 
 static void registerPair(SStream* O, const cs_m68k_op* op)
@@ -140,22 +140,54 @@ static void printAddressingMode(SStream* O, unsigned int pc, const cs_m68k* inst
 					registerPair(O, op);
 					break;
 				case M68K_OP_REG:
-					SStream_concat(O, "%s", s_reg_names[op->reg]);
+					SStream_concat0(O, s_reg_names[op->reg]);
 					break;
 				default:
 					break;
 			}
 			break;
 
-		case M68K_AM_REG_DIRECT_DATA: SStream_concat(O, "d%d", (op->reg - M68K_REG_D0)); break;
-		case M68K_AM_REG_DIRECT_ADDR: SStream_concat(O, "a%d", (op->reg - M68K_REG_A0)); break;
-		case M68K_AM_REGI_ADDR: SStream_concat(O, "(a%d)", (op->reg - M68K_REG_A0)); break;
-		case M68K_AM_REGI_ADDR_POST_INC: SStream_concat(O, "(a%d)+", (op->reg - M68K_REG_A0)); break;
-		case M68K_AM_REGI_ADDR_PRE_DEC: SStream_concat(O, "-(a%d)", (op->reg - M68K_REG_A0)); break;
-		case M68K_AM_REGI_ADDR_DISP: SStream_concat(O, "%s$%x(a%d)", op->mem.disp < 0 ? "-" : "", abs(op->mem.disp), (op->mem.base_reg - M68K_REG_A0)); break;
-		case M68K_AM_PCI_DISP: SStream_concat(O, "$%x(pc)", pc + 2 + op->mem.disp); break;
-		case M68K_AM_ABSOLUTE_DATA_SHORT: SStream_concat(O, "$%x.w", op->imm); break;
-		case M68K_AM_ABSOLUTE_DATA_LONG: SStream_concat(O, "$%x.l", op->imm); break;
+		case M68K_AM_REG_DIRECT_DATA:
+			SStream_concat1(O, 'd');
+			SStream_concatDec(O, op->reg - M68K_REG_D0);
+			break;
+		case M68K_AM_REG_DIRECT_ADDR:
+			SStream_concat1(O, 'a');
+			SStream_concatDec(O, op->reg - M68K_REG_A0);
+			break;
+		case M68K_AM_REGI_ADDR:
+			SStream_concat0(O, "(a");
+			SStream_concatDec(O, op->reg - M68K_REG_A0);
+			SStream_concat1(O, ')');
+			break;
+		case M68K_AM_REGI_ADDR_POST_INC:
+			SStream_concat0(O, "(a");
+			SStream_concatDec(O, op->reg - M68K_REG_A0);
+			SStream_concat0(O, ")+");
+			break;
+		case M68K_AM_REGI_ADDR_PRE_DEC:
+			SStream_concat0(O, "-(a");
+			SStream_concatDec(O, op->reg - M68K_REG_A0);
+			SStream_concat1(O, ')');
+			break;
+		case M68K_AM_REGI_ADDR_DISP:
+			SStream_concatHex(O, op->mem.disp < 0 ? "-$" : "$", abs(op->mem.disp));
+			SStream_concat0(O, "(a");
+			SStream_concatDec(O, op->mem.base_reg - M68K_REG_A0);
+			SStream_concat1(O, ')');
+			break;
+		case M68K_AM_PCI_DISP:
+			SStream_concatHex(O, "$", (uint32_t)(pc + 2 + op->mem.disp));
+			SStream_concat0(O, "(pc)");
+			break;
+		case M68K_AM_ABSOLUTE_DATA_SHORT:
+			SStream_concatHex(O, "$", (uint32_t)op->imm);
+			SStream_concat0(O, ".w");
+			break;
+		case M68K_AM_ABSOLUTE_DATA_LONG:
+			SStream_concatHex(O, "$", (uint32_t)op->imm);
+			SStream_concat0(O, ".l");
+			break;
 		case M68K_AM_IMMEDIATE:
 			 if (inst->op_size.type == M68K_SIZE_TYPE_FPU) {
 #if defined(_KERNEL_MODE)
@@ -172,7 +204,7 @@ static void printAddressingMode(SStream* O, unsigned int pc, const cs_m68k* inst
 				 break;
 #endif
 			 }
-			 SStream_concat(O, "#$%x", op->imm);
+			 SStream_concatHex(O, "#$", (uint32_t)op->imm);
 			 break;
 		case M68K_AM_PCI_INDEX_8_BIT_DISP:
 			SStream_concat(O, "$%x(pc,%s%s.%c)", pc + 2 + op->mem.disp, s_spacing, getRegName(op->mem.index_reg), op->mem.index_size ? 'l' : 'w');
@@ -352,7 +384,7 @@ const char* M68K_reg_name(csh handle, unsigned int reg)
 #endif
 }
 
-void M68K_get_insn_id(cs_struct* h, cs_insn* insn, unsigned int id)
+void M68K_get_insn_id(cs_struct* h, cs_insn* insn, unsigned int id, MCInst *MI)
 {
 	insn->id = id; // These id's matches for 68k
 }
@@ -362,6 +394,9 @@ const char* M68K_insn_name(csh handle, unsigned int id)
 #ifdef CAPSTONE_DIET
 	return NULL;
 #else
+	if (id >= ARR_SIZE(s_instruction_names))
+		return NULL;
+
 	return s_instruction_names[id];
 #endif
 }
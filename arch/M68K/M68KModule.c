@@ -11,15 +11,8 @@
 
 cs_err M68K_global_init(cs_struct *ud)
 {
-	m68k_info *info;
-
-	info = cs_mem_malloc(sizeof(m68k_info));
-	if (!info) {
-		return CS_ERR_MEM;
-	}
-
 	ud->printer = M68K_printInst;
-	ud->printer_info = info;
+	// printer_info is the m68k_info state, allocated along with the handle
 	ud->getinsn_info = NULL;
 	ud->disasm = M68K_getInstruction;
 	ud->skipdata_size = 2;
@@ -30,6 +23,8 @@ cs_err M68K_global_init(cs_struct *ud)
 	ud->insn_name = M68K_insn_name;
 	ud->group_name = M68K_group_name;
 
+	M68K_buildOpcodeTable();
+
 	return CS_ERR_OK;
 }
 
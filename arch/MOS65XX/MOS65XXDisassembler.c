@@ -1,6 +1,8 @@
 /* Capstone Disassembly Engine */
 /* MOS65XX Backend by Sebastian Macke <sebastian@macke.de> 2018 */
 
+#include <string.h>
+
 #include "capstone/mos65xx.h"
 #include "MOS65XXDisassembler.h"
 
@@ -385,12 +387,11 @@ static void fillDetails(MCInst *MI, unsigned char opcode)
 	mos65xx_insn ins = OpInfoTable[opcode].ins;
 	mos65xx_address_mode am = OpInfoTable[opcode].am;
 
+	// like other archs, leave nothing from the last instruction
+	memset(detail, 0, offsetof(cs_detail, mos65xx) + sizeof(cs_mos65xx));
+
 	detail->mos65xx.am = am;
 	detail->mos65xx.modifies_flags = InstructionInfoTable[ins].modifies_status;
-	detail->groups_count = 0;
-	detail->regs_read_count = 0;
-	detail->regs_write_count = 0;
-	detail->mos65xx.op_count = 0;
 
 	if (InstructionInfoTable[ins].group_type != MOS65XX_GRP_INVALID) {
 		detail->groups[0] = InstructionInfoTable[ins].group_type;
@@ -456,7 +457,7 @@ void MOS65XX_printInst(MCInst *MI, struct SStream *O, void *PrinterInfo)
 			break;
 
 		case MOS65XX_AM_ACC:
-			SStream_concat(O, " a");
+			SStream_concat0(O, " a");
 			break;
 
 		case MOS65XX_AM_ABS:
@@ -576,7 +577,7 @@ const char* MOS65XX_reg_name(csh handle, unsigned int reg)
 #endif
 }
 
-void MOS65XX_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+void MOS65XX_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
 	if (id < 256) {
 		insn->id = OpInfoTable[id].ins;
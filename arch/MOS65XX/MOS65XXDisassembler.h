@@ -8,7 +8,7 @@
 
 void MOS65XX_printInst(MCInst *MI, struct SStream *O, void *PrinterInfo);
 
-void MOS65XX_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void MOS65XX_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 const char *MOS65XX_insn_name(csh handle, unsigned int id);
 
@@ -338,30 +338,33 @@ static uint64_t getFeatureBits(int mode)
 #define GET_INSTRINFO_ENUM
 #include "MipsGenInstrInfo.inc"
 
-void Mips_init(MCRegisterInfo *MRI)
-{
-	// InitMCRegisterInfo(MipsRegDesc, 394, RA, PC,
-	// 		MipsMCRegisterClasses, 62,
-	// 		MipsRegUnitRoots,
-	// 		273,
-	// 		MipsRegDiffLists,
-	// 		MipsLaneMaskLists,
-	// 		MipsRegStrings,
-	// 		MipsRegClassStrings,
-	// 		MipsSubRegIdxLists,
-	// 		12,
-	// 		MipsSubRegIdxRanges,
-	// 		MipsRegEncodingTable);
-
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, MipsRegDesc, 394,
-			0, 0,
-			MipsMCRegisterClasses, 62,
-			0, 0,
-			MipsRegDiffLists,
-			0,
-			MipsSubRegIdxLists, 12,
-			0);
+// InitMCRegisterInfo(MipsRegDesc, 394, RA, PC,
+// 		MipsMCRegisterClasses, 62,
+// 		MipsRegUnitRoots,
+// 		273,
+// 		MipsRegDiffLists,
+// 		MipsLaneMaskLists,
+// 		MipsRegStrings,
+// 		MipsRegClassStrings,
+// 		MipsSubRegIdxLists,
+// 		12,
+// 		MipsSubRegIdxRanges,
+// 		MipsRegEncodingTable);
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo Mips_MRI = {
+	MipsRegDesc, 394,
+	0, 0,
+	MipsMCRegisterClasses, 62,
+	0, 0,
+	MipsRegDiffLists, 0,
+	MipsSubRegIdxLists, 12,
+	0
+};
+
+const MCRegisterInfo *Mips_getRegisterInfo(void)
+{
+	return &Mips_MRI;
 }
 
 /// Read two bytes from the ArrayRef and return 16 bit halfword sorted
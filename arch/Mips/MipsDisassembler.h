@@ -8,7 +8,7 @@
 #include "../../MCInst.h"
 #include "../../MCRegisterInfo.h"
 
-void Mips_init(MCRegisterInfo *MRI);
+const MCRegisterInfo *Mips_getRegisterInfo(void);
 
 bool Mips_getInstruction(csh handle, const uint8_t *code, size_t code_len,
 		MCInst *instr, uint16_t *size, uint64_t address, void *info);
@@ -149,7 +149,8 @@ static const char* MipsFCCToString(Mips_CondCode CC)
 
 static void printRegName(SStream *OS, unsigned RegNo)
 {
-	SStream_concat(OS, "$%s", getRegisterName(RegNo));
+	SStream_concat1(OS, '$');
+	SStream_concat0(OS, getRegisterName(RegNo));
 }
 
 void Mips_printInst(MCInst *MI, SStream *O, void *info)
@@ -243,10 +244,7 @@ static void printUnsignedImm8(MCInst *MI, int opNum, SStream *O)
 	MCOperand *MO = MCInst_getOperand(MI, opNum);
 	if (MCOperand_isImm(MO)) {
 		uint8_t imm = (uint8_t)MCOperand_getImm(MO);
-		if (imm > HEX_THRESHOLD)
-			SStream_concat(O, "0x%x", imm);
-		else
-			SStream_concat(O, "%u", imm);
+		printUInt32(O, imm);
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->mips.operands[MI->flat_insn->detail->mips.op_count].type = MIPS_OP_IMM;
 			MI->flat_insn->detail->mips.operands[MI->flat_insn->detail->mips.op_count].imm = imm;
@@ -307,7 +305,8 @@ static void printRegisterPair(MCInst *MI, int opNum, SStream *O)
 
 static char *printAlias1(const char *Str, MCInst *MI, unsigned OpNo, SStream *OS)
 {
-	SStream_concat(OS, "%s\t", Str);
+	SStream_concat0(OS, Str);
+	SStream_concat1(OS, '\t');
 	printOperand(MI, OpNo, OS);
 	return cs_strdup(Str);
 }
@@ -210,12 +210,16 @@ const char *Mips_reg_name(csh handle, unsigned int reg)
 #endif
 }
 
+#ifndef CAPSTONE_DIET
+#include "MipsMappingInsnPool.inc"
+#endif
+
 static insn_map insns[] = {
 	// dummy item
 	{
 		0, 0,
 #ifndef CAPSTONE_DIET
-		{ 0 }, { 0 }, { 0 }, 0, 0
+		0, 0, 0, 0, 0, 0, 0, 0
 #endif
 	},
 
@@ -223,24 +227,18 @@ static insn_map insns[] = {
 };
 
 // given internal insn id, return public instruction info
-void Mips_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+void Mips_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
 	unsigned int i;
 
-	i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
+	i = insn_find(h, insns, ARR_SIZE(insns), id);
 	if (i != 0) {
+		MI->mapping = &insns[i];
 		insn->id = insns[i].mapid;
 
 		if (h->detail) {
 #ifndef CAPSTONE_DIET
-			memcpy(insn->detail->regs_read, insns[i].regs_use, sizeof(insns[i].regs_use));
-			insn->detail->regs_read_count = (uint8_t)count_positive(insns[i].regs_use);
-
-			memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-			insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-
-			memcpy(insn->detail->groups, insns[i].groups, sizeof(insns[i].groups));
-			insn->detail->groups_count = (uint8_t)count_positive8(insns[i].groups);
+			map_implicit_detail(insn->detail, &insns[i], insn_regs, insn_groups);
 
 			if (insns[i].branch || insns[i].indirect_branch) {
 				// this insn also belongs to JUMP group. add JUMP group
@@ -10,7 +10,7 @@
 const char *Mips_reg_name(csh handle, unsigned int reg);
 
 // given internal insn id, return public instruction info
-void Mips_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void Mips_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 const char *Mips_insn_name(csh handle, unsigned int id);
 
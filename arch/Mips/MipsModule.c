@@ -22,10 +22,10 @@ static cs_mode updated_mode(cs_mode mode)
 
 cs_err Mips_global_init(cs_struct *ud)
 {
-	MCRegisterInfo *mri;
-	mri = cs_mem_malloc(sizeof(*mri));
+	// register info is constant & shared by all handles, so the printer
+	// & decoder only read it
+	MCRegisterInfo *mri = (MCRegisterInfo *)Mips_getRegisterInfo();
 
-	Mips_init(mri);
 	ud->printer = Mips_printInst;
 	ud->printer_info = mri;
 	ud->getinsn_info = mri;
@@ -413,32 +413,35 @@ bool PPC_getInstruction(csh ud, const uint8_t *code, size_t code_len,
 
 #define GET_REGINFO_MC_DESC
 #include "PPCGenRegisterInfo.inc"
-void PPC_init(MCRegisterInfo *MRI)
+/*
+   InitMCRegisterInfo(PPCRegDesc, 310, RA, PC,
+   PPCMCRegisterClasses, 23,
+   PPCRegUnitRoots,
+   138,
+   PPCRegDiffLists,
+   PPCLaneMaskLists,
+   PPCRegStrings,
+   PPCRegClassStrings,
+   PPCSubRegIdxLists,
+   8,
+   PPCSubRegIdxRanges,
+   PPCRegEncodingTable);
+ */
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo PPC_MRI = {
+	PPCRegDesc, 310,
+	0, 0,
+	PPCMCRegisterClasses, 23,
+	0, 0,
+	PPCRegDiffLists, 0,
+	PPCSubRegIdxLists, 8,
+	0
+};
+
+const MCRegisterInfo *PPC_getRegisterInfo(void)
 {
-	/*
-	   InitMCRegisterInfo(PPCRegDesc, 310, RA, PC,
-	   PPCMCRegisterClasses, 23,
-	   PPCRegUnitRoots,
-	   138,
-	   PPCRegDiffLists,
-	   PPCLaneMaskLists,
-	   PPCRegStrings,
-	   PPCRegClassStrings,
-	   PPCSubRegIdxLists,
-	   8,
-	   PPCSubRegIdxRanges,
-	   PPCRegEncodingTable);
-	 */
-
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, PPCRegDesc, 310,
-			0, 0,
-			PPCMCRegisterClasses, 23,
-			0, 0,
-			PPCRegDiffLists,
-			0,
-			PPCSubRegIdxLists, 8,
-			0);
+	return &PPC_MRI;
 }
 
 #endif
@@ -8,7 +8,7 @@
 #include "../../MCRegisterInfo.h"
 #include "../../MCInst.h"
 
-void PPC_init(MCRegisterInfo *MRI);
+const MCRegisterInfo *PPC_getRegisterInfo(void);
 
 bool PPC_getInstruction(csh ud, const uint8_t *code, size_t code_len,
 		MCInst *instr, uint16_t *size, uint64_t address, void *info);
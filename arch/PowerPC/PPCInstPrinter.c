@@ -74,15 +74,16 @@ static void set_mem_access(MCInst *MI, bool status)
 	}
 }
 
-void PPC_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
+void PPC_post_printer(csh ud, cs_insn *insn, MCInst *mci)
 {
 	if (((cs_struct *)ud)->detail != CS_OPT_ON)
 		return;
 
 	// check if this insn has branch hint
-	if (strrchr(insn_asm, '+') != NULL && !strstr(insn_asm, ".+")) {
+	if ((strchr(insn->mnemonic, '+') || strchr(insn->op_str, '+')) &&
+			!strstr(insn->mnemonic, ".+") && !strstr(insn->op_str, ".+")) {
 		insn->detail->ppc.bh = PPC_BH_PLUS;
-	} else if (strrchr(insn_asm, '-') != NULL) {
+	} else if (strchr(insn->mnemonic, '-') || strchr(insn->op_str, '-')) {
 		insn->detail->ppc.bh = PPC_BH_MINUS;
 	}
 }
@@ -123,10 +124,8 @@ void PPC_printInst(MCInst *MI, SStream *O, void *Info)
 			printOperand(MI, 0, O);
 			SStream_concat0(O, ", ");
 			printOperand(MI, 1, O);
-			if (SH > HEX_THRESHOLD)
-				SStream_concat(O, ", 0x%x", (unsigned int)SH);
-			else
-				SStream_concat(O, ", %u", (unsigned int)SH);
+			SStream_concat0(O, ", ");
+			printUInt32(O, (unsigned int)SH);
 
 			if (MI->csh->detail) {
 				cs_ppc *ppc = &MI->flat_insn->detail->ppc;
@@ -160,10 +159,8 @@ void PPC_printInst(MCInst *MI, SStream *O, void *Info)
 			printOperand(MI, 0, O);
 			SStream_concat0(O, ", ");
 			printOperand(MI, 1, O);
-			if (SH > HEX_THRESHOLD)
-				SStream_concat(O, ", 0x%x", (unsigned int)SH);
-			else
-				SStream_concat(O, ", %u", (unsigned int)SH);
+			SStream_concat0(O, ", ");
+			printUInt32(O, (unsigned int)SH);
 
 			return;
 		}
@@ -370,10 +367,7 @@ static void printU2ImmOperand(MCInst *MI, unsigned OpNo, SStream *O)
 	unsigned int Value = (int)MCOperand_getImm(MCInst_getOperand(MI, OpNo));
 	//assert(Value <= 3 && "Invalid u2imm argument!");
 
-	if (Value > HEX_THRESHOLD)
-		SStream_concat(O, "0x%x", Value);
-	else
-		SStream_concat(O, "%u", Value);
+	printUInt32(O, Value);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->ppc.operands[MI->flat_insn->detail->ppc.op_count].type = PPC_OP_IMM;
@@ -387,10 +381,7 @@ static void printU4ImmOperand(MCInst *MI, unsigned OpNo, SStream *O)
 	unsigned int Value = (int)MCOperand_getImm(MCInst_getOperand(MI, OpNo));
 	//assert(Value <= 15 && "Invalid u4imm argument!");
 
-	if (Value > HEX_THRESHOLD)
-		SStream_concat(O, "0x%x", Value);
-	else
-		SStream_concat(O, "%u", Value);
+	printUInt32(O, Value);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->ppc.operands[MI->flat_insn->detail->ppc.op_count].type = PPC_OP_IMM;
@@ -445,10 +436,7 @@ static void printU12ImmOperand(MCInst *MI, unsigned OpNo, SStream *O)
 
 	// assert(Value <= 4095 && "Invalid u12imm argument!");
 
-	if (Value > HEX_THRESHOLD)
-		SStream_concat(O, "0x%x", Value);
-	else
-		SStream_concat(O, "%u", Value);
+	printUInt32(O, Value);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->ppc.operands[MI->flat_insn->detail->ppc.op_count].type = PPC_OP_IMM;
@@ -461,10 +449,7 @@ static void printS16ImmOperand(MCInst *MI, unsigned OpNo, SStream *O)
 {
 	if (MCOperand_isImm(MCInst_getOperand(MI, OpNo))) {
 		unsigned short Imm = (unsigned short)MCOperand_getImm(MCInst_getOperand(MI, OpNo));
-        if (Imm > HEX_THRESHOLD)
-            SStream_concat(O, "0x%x", Imm);
-        else
-            SStream_concat(O, "%u", Imm);
+        printUInt32(O, Imm);
 
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->ppc.operands[MI->flat_insn->detail->ppc.op_count].type = PPC_OP_IMM;
@@ -480,17 +465,7 @@ static void printS16ImmOperand_Mem(MCInst *MI, unsigned OpNo, SStream *O)
 	if (MCOperand_isImm(MCInst_getOperand(MI, OpNo))) {
 		short Imm = (short)MCOperand_getImm(MCInst_getOperand(MI, OpNo));
 
-		if (Imm >= 0) {
-			if (Imm > HEX_THRESHOLD)
-				SStream_concat(O, "0x%x", Imm);
-			else
-				SStream_concat(O, "%u", Imm);
-		} else {
-			if (Imm < -HEX_THRESHOLD)
-				SStream_concat(O, "-0x%x", -Imm);
-			else
-				SStream_concat(O, "-%u", -Imm);
-		}
+		printInt32(O, Imm);
 
 		if (MI->csh->detail) {
 			if (MI->csh->doing_mem) {
@@ -509,10 +484,7 @@ static void printU16ImmOperand(MCInst *MI, unsigned OpNo, SStream *O)
 {
 	if (MCOperand_isImm(MCInst_getOperand(MI, OpNo))) {
 		unsigned short Imm = (unsigned short)MCOperand_getImm(MCInst_getOperand(MI, OpNo));
-		if (Imm > HEX_THRESHOLD)
-			SStream_concat(O, "0x%x", Imm);
-		else
-			SStream_concat(O, "%u", Imm);
+		printUInt32(O, Imm);
 
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->ppc.operands[MI->flat_insn->detail->ppc.op_count].type = PPC_OP_IMM;
@@ -550,7 +522,7 @@ static void printAbsBranchOperand(MCInst *MI, unsigned OpNo, SStream *O)
 		imm = MI->address + imm;
 	}
 
-	SStream_concat(O, "0x%"PRIx64, imm);
+	SStream_concatHex(O, "0x", imm);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->ppc.operands[MI->flat_insn->detail->ppc.op_count].type = PPC_OP_IMM;
@@ -581,10 +553,7 @@ static void printcrbitm(MCInst *MI, unsigned OpNo, SStream *O)
 	}
 
 	tmp = 0x80 >> RegNo;
-	if (tmp > HEX_THRESHOLD)
-		SStream_concat(O, "0x%x", tmp);
-	else
-		SStream_concat(O, "%u", tmp);
+	printUInt32(O, tmp);
 }
 
 static void printMemRegImm(MCInst *MI, unsigned OpNo, SStream *O)
@@ -913,7 +882,9 @@ static char *printAliasInstrEx(MCInst *MI, SStream *OS, void *info)
 			SStream_concat0(&ss, " ");
 
 			if (cr > PPC_CR0) {
-				SStream_concat(&ss, "4*cr%d+", cr - PPC_CR0);
+				SStream_concat0(&ss, "4*cr");
+				SStream_concatDec(&ss, cr - PPC_CR0);
+				SStream_concat1(&ss, '+');
 			}
 
 			cr = getBICRCond(MCOperand_getReg(MCInst_getOperand(MI, 1)));
@@ -949,7 +920,8 @@ static char *printAliasInstrEx(MCInst *MI, SStream *OS, void *info)
 		} else {
 			if (cr > PPC_CR0) {
 				needComma = true;
-				SStream_concat(&ss, " cr%d", cr - PPC_CR0);
+				SStream_concat0(&ss, " cr");
+				SStream_concatDec(&ss, cr - PPC_CR0);
 				op_addReg(MI, PPC_REG_CR0 + cr - PPC_CR0);
 			}
 		}
@@ -988,7 +960,7 @@ static char *printAliasInstrEx(MCInst *MI, SStream *OS, void *info)
 				} else
 					printOperand(MI, *c - 1, OS);
 			} else {
-				SStream_concat(OS, "%c", *c);
+				SStream_concat1(OS, *c);
 			}
 		}
 	}
@@ -10,6 +10,6 @@
 
 void PPC_printInst(MCInst *MI, SStream *O, void *Info);
 
-void PPC_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci);
+void PPC_post_printer(csh ud, cs_insn *insn, MCInst *mci);
 
 #endif
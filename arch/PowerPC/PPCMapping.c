@@ -243,12 +243,16 @@ const char *PPC_reg_name(csh handle, unsigned int reg)
 #endif
 }
 
+#ifndef CAPSTONE_DIET
+#include "PPCMappingInsnPool.inc"
+#endif
+
 static const insn_map insns[] = {
 	// dummy item
 	{
 		0, 0,
 #ifndef CAPSTONE_DIET
-		{ 0 }, { 0 }, { 0 }, 0, 0
+		0, 0, 0, 0, 0, 0, 0, 0
 #endif
 	},
 
@@ -256,12 +260,13 @@ static const insn_map insns[] = {
 };
 
 // given internal insn id, return public instruction info
-void PPC_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+void PPC_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
 	int i;
 
-	i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
+	i = insn_find(h, insns, ARR_SIZE(insns), id);
 	if (i != 0) {
+		MI->mapping = &insns[i];
 		insn->id = insns[i].mapid;
 
 		if (h->detail) {
@@ -269,14 +274,7 @@ void PPC_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
 			cs_struct handle;
 			handle.detail = h->detail;
 
-			memcpy(insn->detail->regs_read, insns[i].regs_use, sizeof(insns[i].regs_use));
-			insn->detail->regs_read_count = (uint8_t)count_positive(insns[i].regs_use);
-
-			memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-			insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-
-			memcpy(insn->detail->groups, insns[i].groups, sizeof(insns[i].groups));
-			insn->detail->groups_count = (uint8_t)count_positive8(insns[i].groups);
+			map_implicit_detail(insn->detail, &insns[i], insn_regs, insn_groups);
 
 			if (insns[i].branch || insns[i].indirect_branch) {
 				// this insn also belongs to JUMP group. add JUMP group
@@ -1408,27 +1406,14 @@ static const name_map insn_name_maps[] = {
 	{ PPC_INS_QVFNAND, "qvfnand" },
 	{ PPC_INS_QVFSET, "qvfset" },
 };
-
-// special alias insn
-static const name_map alias_insn_names[] = {
-	{ 0, NULL }
-};
 #endif
 
 const char *PPC_insn_name(csh handle, unsigned int id)
 {
 #ifndef CAPSTONE_DIET
-	unsigned int i;
-
 	if (id >= PPC_INS_ENDING)
 		return NULL;
 
-	// handle special alias first
-	for (i = 0; i < ARR_SIZE(alias_insn_names); i++) {
-		if (alias_insn_names[i].id == id)
-			return alias_insn_names[i].name;
-	}
-
 	return insn_name_maps[id].name;
 #else
 	return NULL;
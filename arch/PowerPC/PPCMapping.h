@@ -10,7 +10,7 @@
 const char *PPC_reg_name(csh handle, unsigned int reg);
 
 // given internal insn id, return public instruction info
-void PPC_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void PPC_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 const char *PPC_insn_name(csh handle, unsigned int id);
 const char *PPC_group_name(csh handle, unsigned int id);
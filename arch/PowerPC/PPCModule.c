@@ -12,10 +12,10 @@
 
 cs_err PPC_global_init(cs_struct *ud)
 {
-	MCRegisterInfo *mri;
-	mri = (MCRegisterInfo *) cs_mem_malloc(sizeof(*mri));
+	// register info is constant & shared by all handles, so the printer
+	// & decoder only read it
+	MCRegisterInfo *mri = (MCRegisterInfo *)PPC_getRegisterInfo();
 
-	PPC_init(mri);
 	ud->printer = PPC_printInst;
 	ud->printer_info = mri;
 	ud->getinsn_info = mri;
@@ -472,29 +472,33 @@ static DecodeStatus DecodeSWAP(MCInst *MI, unsigned insn, uint64_t Address,
 	return MCDisassembler_Success;
 }
 
-void Sparc_init(MCRegisterInfo *MRI)
+/*
+InitMCRegisterInfo(SparcRegDesc, 119, RA, PC,
+		SparcMCRegisterClasses, 8,
+		SparcRegUnitRoots,
+		86,
+		SparcRegDiffLists,
+		SparcRegStrings,
+		SparcSubRegIdxLists,
+		7,
+		SparcSubRegIdxRanges,
+		SparcRegEncodingTable);
+*/
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo Sparc_MRI = {
+	SparcRegDesc, 119,
+	0, 0,
+	SparcMCRegisterClasses, 8,
+	0, 0,
+	SparcRegDiffLists, 0,
+	SparcSubRegIdxLists, 7,
+	0
+};
+
+const MCRegisterInfo *Sparc_getRegisterInfo(void)
 {
-	/*
-	InitMCRegisterInfo(SparcRegDesc, 119, RA, PC,
-			SparcMCRegisterClasses, 8,
-			SparcRegUnitRoots,
-			86,
-			SparcRegDiffLists,
-			SparcRegStrings,
-			SparcSubRegIdxLists,
-			7,
-			SparcSubRegIdxRanges,
-			SparcRegEncodingTable);
-	*/
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, SparcRegDesc, 119,
-			0, 0,
-			SparcMCRegisterClasses, 8,
-			0, 0,
-			SparcRegDiffLists,
-			0,
-			SparcSubRegIdxLists, 7,
-			0);
+	return &Sparc_MRI;
 }
 
 #endif
@@ -10,7 +10,7 @@
 
 void Sparc_printInst(MCInst *MI, SStream *O, void *Info);
 
-void Sparc_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci);
+void Sparc_post_printer(csh ud, cs_insn *insn, MCInst *mci);
 
 void Sparc_addReg(MCInst *MI, int reg);
 
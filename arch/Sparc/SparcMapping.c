@@ -121,12 +121,16 @@ const char *Sparc_reg_name(csh handle, unsigned int reg)
 #endif
 }
 
+#ifndef CAPSTONE_DIET
+#include "SparcMappingInsnPool.inc"
+#endif
+
 static const insn_map insns[] = {
 	// dummy item
 	{
 		0, 0,
 #ifndef CAPSTONE_DIET
-		{ 0 }, { 0 }, { 0 }, 0, 0
+		0, 0, 0, 0, 0, 0, 0, 0
 #endif
 	},
 
@@ -158,24 +162,18 @@ static struct hint_map {
 };
 
 // given internal insn id, return public instruction info
-void Sparc_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+void Sparc_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
 	unsigned short i;
 
-	i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
+	i = insn_find(h, insns, ARR_SIZE(insns), id);
 	if (i != 0) {
+		MI->mapping = &insns[i];
 		insn->id = insns[i].mapid;
 
 		if (h->detail) {
 #ifndef CAPSTONE_DIET
-			memcpy(insn->detail->regs_read, insns[i].regs_use, sizeof(insns[i].regs_use));
-			insn->detail->regs_read_count = (uint8_t)count_positive(insns[i].regs_use);
-
-			memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-			insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-
-			memcpy(insn->detail->groups, insns[i].groups, sizeof(insns[i].groups));
-			insn->detail->groups_count = (uint8_t)count_positive8(insns[i].groups);
+			map_implicit_detail(insn->detail, &insns[i], insn_regs, insn_groups);
 
 			if (insns[i].branch || insns[i].indirect_branch) {
 				// this insn also belongs to JUMP group. add JUMP group
@@ -479,27 +477,12 @@ static const name_map insn_name_maps[] = {
 	{ SPARC_INS_RETL, "retl" },
 };
 
-#ifndef CAPSTONE_DIET
-// special alias insn
-static const name_map alias_insn_names[] = {
-	{ 0, NULL }
-};
-#endif
-
 const char *Sparc_insn_name(csh handle, unsigned int id)
 {
 #ifndef CAPSTONE_DIET
-	unsigned int i;
-
 	if (id >= SPARC_INS_ENDING)
 		return NULL;
 
-	// handle special alias first
-	for (i = 0; i < ARR_SIZE(alias_insn_names); i++) {
-		if (alias_insn_names[i].id == id)
-			return alias_insn_names[i].name;
-	}
-
 	return insn_name_maps[id].name;
 #else
 	return NULL;
@@ -12,10 +12,10 @@
 
 cs_err Sparc_global_init(cs_struct *ud)
 {
-	MCRegisterInfo *mri;
-	mri = cs_mem_malloc(sizeof(*mri));
+	// register info is constant & shared by all handles, so the printer
+	// & decoder only read it
+	MCRegisterInfo *mri = (MCRegisterInfo *)Sparc_getRegisterInfo();
 
-	Sparc_init(mri);
 	ud->printer = Sparc_printInst;
 	ud->printer_info = mri;
 	ud->getinsn_info = mri;
@@ -456,29 +456,33 @@ bool SystemZ_getInstruction(csh ud, const uint8_t *code, size_t code_len, MCInst
 #define GET_REGINFO_ENUM
 #define GET_REGINFO_MC_DESC
 #include "SystemZGenRegisterInfo.inc"
-void SystemZ_init(MCRegisterInfo *MRI)
-{
-	/*
-	InitMCRegisterInfo(SystemZRegDesc, 98, RA, PC,
-			SystemZMCRegisterClasses, 12,
-			SystemZRegUnitRoots,
-			49,
-			SystemZRegDiffLists,
-			SystemZRegStrings,
-			SystemZSubRegIdxLists,
-			7,
-			SystemZSubRegIdxRanges,
-			SystemZRegEncodingTable);
-	*/
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, SystemZRegDesc, 194,
-			0, 0,
-			SystemZMCRegisterClasses, 21,
-			0, 0,
-			SystemZRegDiffLists,
-			0,
-			SystemZSubRegIdxLists, 7,
-			0);
+/*
+InitMCRegisterInfo(SystemZRegDesc, 98, RA, PC,
+		SystemZMCRegisterClasses, 12,
+		SystemZRegUnitRoots,
+		49,
+		SystemZRegDiffLists,
+		SystemZRegStrings,
+		SystemZSubRegIdxLists,
+		7,
+		SystemZSubRegIdxRanges,
+		SystemZRegEncodingTable);
+*/
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo SystemZ_MRI = {
+	SystemZRegDesc, 194,
+	0, 0,
+	SystemZMCRegisterClasses, 21,
+	0, 0,
+	SystemZRegDiffLists, 0,
+	SystemZSubRegIdxLists, 7,
+	0
+};
+
+const MCRegisterInfo *SystemZ_getRegisterInfo(void)
+{
+	return &SystemZ_MRI;
 }
 
 #endif
@@ -31,7 +31,7 @@
 
 static const char *getRegisterName(unsigned RegNo);
 
-void SystemZ_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
+void SystemZ_post_printer(csh ud, cs_insn *insn, MCInst *mci)
 {
 	/*
 	   if (((cs_struct *)ud)->detail != CS_OPT_ON)
@@ -45,9 +45,14 @@ static void printAddress(MCInst *MI, unsigned Base, int64_t Disp, unsigned Index
 
 	if (Base) {
 		SStream_concat0(O, "(");
-		if (Index)
-			SStream_concat(O, "%%%s, ", getRegisterName(Index));
-		SStream_concat(O, "%%%s)", getRegisterName(Base));
+		if (Index) {
+			SStream_concat1(O, '%');
+			SStream_concat0(O, getRegisterName(Index));
+			SStream_concat0(O, ", ");
+		}
+		SStream_concat1(O, '%');
+		SStream_concat0(O, getRegisterName(Base));
+		SStream_concat1(O, ')');
 
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->sysz.operands[MI->flat_insn->detail->sysz.op_count].type = SYSZ_OP_MEM;
@@ -63,7 +68,9 @@ static void printAddress(MCInst *MI, unsigned Base, int64_t Disp, unsigned Index
 			MI->flat_insn->detail->sysz.op_count++;
 		}
 	} else {
-		SStream_concat(O, "(%%%s)", getRegisterName(Index));
+		SStream_concat0(O, "(%");
+		SStream_concat0(O, getRegisterName(Index));
+		SStream_concat1(O, ')');
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->sysz.operands[MI->flat_insn->detail->sysz.op_count].type = SYSZ_OP_MEM;
 			MI->flat_insn->detail->sysz.operands[MI->flat_insn->detail->sysz.op_count].mem.base = (uint8_t)SystemZ_map_register(Base);
@@ -80,7 +87,8 @@ static void _printOperand(MCInst *MI, MCOperand *MO, SStream *O)
 		unsigned reg;
 
 		reg = MCOperand_getReg(MO);
-		SStream_concat(O, "%%%s", getRegisterName(reg));
+		SStream_concat1(O, '%');
+		SStream_concat0(O, getRegisterName(reg));
 		reg = SystemZ_map_register(reg);
 
 		if (MI->csh->detail) {
@@ -172,17 +180,7 @@ static void printS8ImmOperand(MCInst *MI, int OpNum, SStream *O)
 	int8_t Value = (int8_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
 	// assert(isInt<8>(Value) && "Invalid s8imm argument");
 
-	if (Value >= 0) {
-		if (Value > HEX_THRESHOLD)
-			SStream_concat(O, "0x%x", Value);
-		else
-			SStream_concat(O, "%u", Value);
-	} else {
-		if (Value < -HEX_THRESHOLD)
-			SStream_concat(O, "-0x%x", -Value);
-		else
-			SStream_concat(O, "-%u", -Value);
-	}
+	printInt32(O, Value);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->sysz.operands[MI->flat_insn->detail->sysz.op_count].type = SYSZ_OP_IMM;
@@ -196,10 +194,7 @@ static void printU8ImmOperand(MCInst *MI, int OpNum, SStream *O)
 	uint8_t Value = (uint8_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
 	// assert(isUInt<8>(Value) && "Invalid u8imm argument");
 
-	if (Value > HEX_THRESHOLD)
-		SStream_concat(O, "0x%x", Value);
-	else
-		SStream_concat(O, "%u", Value);
+	printUInt32(O, Value);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->sysz.operands[MI->flat_insn->detail->sysz.op_count].type = SYSZ_OP_IMM;
@@ -226,17 +221,7 @@ static void printS16ImmOperand(MCInst *MI, int OpNum, SStream *O)
 	int16_t Value = (int16_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
 	// assert(isInt<16>(Value) && "Invalid s16imm argument");
 
-	if (Value >= 0) {
-		if (Value > HEX_THRESHOLD)
-			SStream_concat(O, "0x%x", Value);
-		else
-			SStream_concat(O, "%u", Value);
-	} else {
-		if (Value < -HEX_THRESHOLD)
-			SStream_concat(O, "-0x%x", -Value);
-		else
-			SStream_concat(O, "-%u", -Value);
-	}
+	printInt32(O, Value);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->sysz.operands[MI->flat_insn->detail->sysz.op_count].type = SYSZ_OP_IMM;
@@ -250,10 +235,7 @@ static void printU16ImmOperand(MCInst *MI, int OpNum, SStream *O)
 	uint16_t Value = (uint16_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum));
 	// assert(isUInt<16>(Value) && "Invalid u16imm argument");
 
-	if (Value > HEX_THRESHOLD)
-		SStream_concat(O, "0x%x", Value);
-	else
-		SStream_concat(O, "%u", Value);
+	printUInt32(O, Value);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->sysz.operands[MI->flat_insn->detail->sysz.op_count].type = SYSZ_OP_IMM;
@@ -351,18 +333,15 @@ static void printBDLAddrOperand(MCInst *MI, int OpNum, SStream *O)
 	uint64_t Disp = (uint64_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum + 1));
 	uint64_t Length = (uint64_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum + 2));
 
-	if (Disp > HEX_THRESHOLD)
-		SStream_concat(O, "0x%"PRIx64, Disp);
-	else
-		SStream_concat(O, "%"PRIu64, Disp);
+	printUInt64(O, Disp);
 
-	if (Length > HEX_THRESHOLD)
-		SStream_concat(O, "(0x%"PRIx64, Length);
-	else
-		SStream_concat(O, "(%"PRIu64, Length);
+	SStream_concat1(O, '(');
+	printUInt64(O, Length);
 
-	if (Base)
-		SStream_concat(O, ", %%%s", getRegisterName(Base));
+	if (Base) {
+		SStream_concat0(O, ", %");
+		SStream_concat0(O, getRegisterName(Base));
+	}
 	SStream_concat0(O, ")");
 
 	if (MI->csh->detail) {
@@ -380,16 +359,15 @@ static void printBDRAddrOperand(MCInst *MI, int OpNum, SStream *O)
 	uint64_t Disp = (uint64_t)MCOperand_getImm(MCInst_getOperand(MI, OpNum + 1));
 	uint64_t Length = MCOperand_getReg(MCInst_getOperand(MI, OpNum + 2));
 
-	if (Disp > HEX_THRESHOLD)
-		SStream_concat(O, "0x%"PRIx64, Disp);
-	else
-		SStream_concat(O, "%"PRIu64, Disp);
+	printUInt64(O, Disp);
 
-	SStream_concat0(O, "(");
-	SStream_concat(O, "%%%s", getRegisterName((unsigned int)Length));
+	SStream_concat0(O, "(%");
+	SStream_concat0(O, getRegisterName((unsigned int)Length));
 
-	if (Base)
-		SStream_concat(O, ", %%%s", getRegisterName(Base));
+	if (Base) {
+		SStream_concat0(O, ", %");
+		SStream_concat0(O, getRegisterName(Base));
+	}
 	SStream_concat0(O, ")");
 
 	if (MI->csh->detail) {
@@ -10,6 +10,6 @@
 
 void SystemZ_printInst(MCInst *MI, SStream *O, void *Info);
 
-void SystemZ_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci);
+void SystemZ_post_printer(csh ud, cs_insn *insn, MCInst *mci);
 
 #endif
@@ -10,7 +10,7 @@
 const char *SystemZ_reg_name(csh handle, unsigned int reg);
 
 // given internal insn id, return public instruction info
-void SystemZ_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void SystemZ_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 const char *SystemZ_insn_name(csh handle, unsigned int id);
 
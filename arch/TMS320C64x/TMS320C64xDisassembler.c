@@ -613,16 +613,20 @@ bool TMS320C64x_getInstruction(csh ud, const uint8_t *code, size_t code_len,
 	return false;
 }
 
-void TMS320C64x_init(MCRegisterInfo *MRI)
+// register info is constant, so all handles share this one
+static const MCRegisterInfo TMS320C64x_MRI = {
+	TMS320C64xRegDesc, 90,
+	0, 0,
+	TMS320C64xMCRegisterClasses, 7,
+	0, 0,
+	TMS320C64xRegDiffLists, 0,
+	TMS320C64xSubRegIdxLists, 1,
+	0
+};
+
+const MCRegisterInfo *TMS320C64x_getRegisterInfo(void)
 {
-	MCRegisterInfo_InitMCRegisterInfo(MRI, TMS320C64xRegDesc, 90,
-			0, 0,
-			TMS320C64xMCRegisterClasses, 7,
-			0, 0,
-			TMS320C64xRegDiffLists,
-			0,
-			TMS320C64xSubRegIdxLists, 1,
-			0);
+	return &TMS320C64x_MRI;
 }
 
 #endif
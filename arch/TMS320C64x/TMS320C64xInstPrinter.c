@@ -33,9 +33,9 @@ static void printMemOperand(MCInst *MI, unsigned OpNo, SStream *O);
 static void printMemOperand2(MCInst *MI, unsigned OpNo, SStream *O);
 static void printRegPair(MCInst *MI, unsigned OpNo, SStream *O);
 
-void TMS320C64x_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
+void TMS320C64x_post_printer(csh ud, cs_insn *insn, MCInst *mci)
 {
-	SStream ss;
+	SStream ss, out;
 	char *p, *p2, tmp[8];
 	unsigned int unit = 0;
 	int i;
@@ -73,16 +73,15 @@ void TMS320C64x_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
 		else
 			SStream_concat0(&ss, "||||||");
 
-		p = strchr(insn_asm, '\t');
-		if (p != NULL)
-			*p++ = '\0';
+		p = insn->op_str[0] ? insn->op_str : NULL;
 
-		SStream_concat0(&ss, insn_asm);
+		SStream_concat0(&ss, insn->mnemonic);
 		if ((p != NULL) && (((p2 = strchr(p, '[')) != NULL) || ((p2 = strchr(p, '(')) != NULL))) {
 			while ((p2 > p) && ((*p2 != 'a') && (*p2 != 'b')))
 				p2--;
 			if (p2 == p) {
-				strcpy(insn_asm, "Invalid!");
+				SStream_InitInsn(&ss, insn->mnemonic, insn->op_str);
+				SStream_concat0(&ss, "Invalid!");
 				return;
 			}
 			if (*p2 == 'a')
@@ -115,8 +114,9 @@ void TMS320C64x_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci)
 		if (tms320c64x->parallel != 0)
 			SStream_concat(&ss, "\t||");
 
-		/* insn_asm is a buffer from an SStream, so there should be enough space */
-		strcpy(insn_asm, ss.buffer);
+		// re-emit the decorated text into the insn
+		SStream_InitInsn(&out, insn->mnemonic, insn->op_str);
+		SStream_concat0(&out, ss.buffer);
 	}
 }
 
@@ -157,17 +157,7 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 	} else if (MCOperand_isImm(Op)) {
 		int64_t Imm = MCOperand_getImm(Op);
 
-		if (Imm >= 0) {
-			if (Imm > HEX_THRESHOLD)
-				SStream_concat(O, "0x%"PRIx64, Imm);
-			else
-				SStream_concat(O, "%"PRIu64, Imm);
-		} else {
-			if (Imm < -HEX_THRESHOLD)
-				SStream_concat(O, "-0x%"PRIx64, -Imm);
-			else
-				SStream_concat(O, "-%"PRIu64, -Imm);
-		}
+		printInt64(O, Imm);
 
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->tms320c64x.operands[MI->flat_insn->detail->tms320c64x.op_count].type = TMS320C64X_OP_IMM;
@@ -10,6 +10,6 @@
 
 void TMS320C64x_printInst(MCInst *MI, SStream *O, void *Info);
 
-void TMS320C64x_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci);
+void TMS320C64x_post_printer(csh ud, cs_insn *insn, MCInst *mci);
 
 #endif
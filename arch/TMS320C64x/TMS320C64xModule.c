@@ -12,11 +12,10 @@
 
 cs_err TMS320C64x_global_init(cs_struct *ud)
 {
-	MCRegisterInfo *mri;
+	// register info is constant & shared by all handles, so the printer
+	// & decoder only read it
+	MCRegisterInfo *mri = (MCRegisterInfo *)TMS320C64x_getRegisterInfo();
 
-	mri = cs_mem_malloc(sizeof(*mri));
-
-	TMS320C64x_init(mri);
 	ud->printer = TMS320C64x_printInst;
 	ud->printer_info = mri;
 	ud->getinsn_info = mri;
@@ -354,27 +354,23 @@ static void _printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 					}
 				}
 
-				SStream_concat(O, "$0x%"PRIx64, imm);
+				SStream_concatHex(O, "$0x", imm);
 			} else {
-				if (imm < -HEX_THRESHOLD)
-					SStream_concat(O, "$-0x%"PRIx64, -imm);
-				else
-					SStream_concat(O, "$-%"PRIu64, -imm);
+				SStream_concat1(O, '$');
+				printInt64(O, imm);
 			}
 		} else {
-			if (imm > HEX_THRESHOLD)
-				SStream_concat(O, "$0x%"PRIx64, imm);
-			else
-				SStream_concat(O, "$%"PRIu64, imm);
+			SStream_concat1(O, '$');
+			printUInt64(O, imm);
 		}
 	}
 }
 
 // convert Intel access info to AT&T access info
-static void get_op_access(cs_struct *h, unsigned int id, uint8_t *access, uint64_t *eflags)
+static void get_op_access(MCInst *MI, uint8_t *access, uint64_t *eflags)
 {
 	uint8_t count, i;
-	uint8_t *arr = X86_get_op_access(h, id, eflags);
+	const uint8_t *arr = X86_get_op_access(MI, eflags);
 
 	if (!arr) {
 		access[0] = 0;
@@ -413,7 +409,7 @@ static void printSrcIdx(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.scale = 1;
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 	}
 
@@ -452,7 +448,7 @@ static void printDstIdx(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.scale = 1;
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 	}
 
@@ -538,7 +534,7 @@ static void printMemOffset(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.scale = 1;
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 	}
 
@@ -556,14 +552,10 @@ static void printMemOffset(MCInst *MI, unsigned Op, SStream *O)
 		int64_t imm = MCOperand_getImm(DispSpec);
 		if (MI->csh->detail)
 			MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = imm;
-		if (imm < 0) {
-			SStream_concat(O, "0x%"PRIx64, arch_masks[MI->csh->mode] & imm);
-		} else {
-			if (imm > HEX_THRESHOLD)
-				SStream_concat(O, "0x%"PRIx64, imm);
-			else
-				SStream_concat(O, "%"PRIu64, imm);
-		}
+		if (imm < 0)
+			SStream_concatHex(O, "0x", arch_masks[MI->csh->mode] & imm);
+		else
+			printUInt64(O, imm);
 	}
 
 	if (MI->csh->detail)
@@ -575,10 +567,8 @@ static void printU8Imm(MCInst *MI, unsigned Op, SStream *O)
 {
 	uint8_t val = MCOperand_getImm(MCInst_getOperand(MI, Op)) & 0xff;
 
-	if (val > HEX_THRESHOLD)
-		SStream_concat(O, "$0x%x", val);
-	else
-		SStream_concat(O, "$%u", val);
+	SStream_concat1(O, '$');
+	printUInt32(O, val);
 
 	if (MI->csh->detail) {
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].type = X86_OP_IMM;
@@ -641,14 +631,10 @@ static void printPCRelImm(MCInst *MI, unsigned OpNo, SStream *O)
 		if (MI->Opcode == X86_CALLpcrel16 || MI->Opcode == X86_JMP_2)
 			imm = imm & 0xffff;
 
-		if (imm < 0) {
-			SStream_concat(O, "0x%"PRIx64, imm);
-		} else {
-			if (imm > HEX_THRESHOLD)
-				SStream_concat(O, "0x%"PRIx64, imm);
-			else
-				SStream_concat(O, "%"PRIu64, imm);
-		}
+		if (imm < 0)
+			SStream_concatHex(O, "0x", imm);
+		else
+			printUInt64(O, imm);
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].type = X86_OP_IMM;
 			MI->has_imm = true;
@@ -674,7 +660,7 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].reg = reg;
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].size = MI->csh->regsize_map[reg];
 
-				get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+				get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 
 				MI->flat_insn->detail->x86.op_count++;
@@ -692,10 +678,8 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 		switch(MI->flat_insn->id) {
 			default:
 				if (imm >= 0) {
-					if (imm > HEX_THRESHOLD)
-						SStream_concat(O, "$0x%"PRIx64, imm);
-					else
-						SStream_concat(O, "$%"PRIu64, imm);
+					SStream_concat1(O, '$');
+					printUInt64(O, imm);
 				} else {
 					if (MI->csh->imm_unsigned) {
 						if (opsize) {
@@ -714,21 +698,21 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 							}
 						}
 
-						SStream_concat(O, "$0x%"PRIx64, imm);
+						SStream_concatHex(O, "$0x", imm);
 					} else {
 						if (imm == 0x8000000000000000LL)  // imm == -imm
 							SStream_concat0(O, "$0x8000000000000000");
-						else if (imm < -HEX_THRESHOLD)
-							SStream_concat(O, "$-0x%"PRIx64, -imm);
-						else
-							SStream_concat(O, "$-%"PRIu64, -imm);
+						else {
+							SStream_concat1(O, '$');
+							printInt64(O, imm);
+						}
 					}
 				}
 				break;
 
 			case X86_INS_MOVABS:
 				// do not print number in negative form
-				SStream_concat(O, "$0x%"PRIx64, imm);
+				SStream_concatHex(O, "$0x", imm);
 				break;
 
 			case X86_INS_IN:
@@ -736,11 +720,8 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 			case X86_INS_INT:
 				// do not print number in negative form
 				imm = imm & 0xff;
-				if (imm >= 0 && imm <= HEX_THRESHOLD)
-					SStream_concat(O, "$%u", imm);
-				else {
-					SStream_concat(O, "$0x%x", imm);
-				}
+				SStream_concat1(O, '$');
+				printUInt64(O, imm);
 				break;
 
 			case X86_INS_LCALL:
@@ -750,29 +731,31 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 					imm = imm & 0xffff;
 					opsize = 2;
 				}
-				SStream_concat(O, "$0x%"PRIx64, imm);
+				SStream_concatHex(O, "$0x", imm);
 				break;
 
 			case X86_INS_AND:
 			case X86_INS_OR:
 			case X86_INS_XOR:
 				// do not print number in negative form
-				if (imm >= 0 && imm <= HEX_THRESHOLD)
-					SStream_concat(O, "$%u", imm);
-				else {
+				if (imm >= 0 && imm <= HEX_THRESHOLD) {
+					SStream_concat1(O, '$');
+					SStream_concatDec(O, imm);
+				} else {
 					imm = arch_masks[opsize? opsize : MI->imm_size] & imm;
-					SStream_concat(O, "$0x%"PRIx64, imm);
+					SStream_concatHex(O, "$0x", imm);
 				}
 				break;
 
 			case X86_INS_RET:
 			case X86_INS_RETF:
 				// RET imm16
-				if (imm >= 0 && imm <= HEX_THRESHOLD)
-					SStream_concat(O, "$%u", imm);
-				else {
+				if (imm >= 0 && imm <= HEX_THRESHOLD) {
+					SStream_concat1(O, '$');
+					SStream_concatDec(O, imm);
+				} else {
 					imm = 0xffff & imm;
-					SStream_concat(O, "$0x%x", imm);
+					SStream_concatHex(O, "$0x", imm);
 				}
 				break;
 		}
@@ -788,7 +771,9 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 
 				if (opsize > 0) {
 					MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].size = opsize;
-					MI->flat_insn->detail->x86.encoding.imm_size = encsize;
+					// ptr16 of LJMP & LCALL keeps the size found by the decoder
+					if (encsize)
+						MI->flat_insn->detail->x86.encoding.imm_size = encsize;
 				} else if (MI->op1_size > 0)
 					MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].size = MI->op1_size;
 				else
@@ -821,7 +806,7 @@ static void printMemReference(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.scale = 1;
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 	}
 
@@ -845,14 +830,10 @@ static void printMemReference(MCInst *MI, unsigned Op, SStream *O)
 				printInt64(O, DispVal);
 			} else {
 				// only immediate as address of memory
-				if (DispVal < 0) {
-					SStream_concat(O, "0x%"PRIx64, arch_masks[MI->csh->mode] & DispVal);
-				} else {
-					if (DispVal > HEX_THRESHOLD)
-						SStream_concat(O, "0x%"PRIx64, DispVal);
-					else
-						SStream_concat(O, "%"PRIu64, DispVal);
-				}
+				if (DispVal < 0)
+					SStream_concatHex(O, "0x", arch_masks[MI->csh->mode] & DispVal);
+				else
+					printUInt64(O, DispVal);
 			}
 		} else {
 		}
@@ -871,7 +852,8 @@ static void printMemReference(MCInst *MI, unsigned Op, SStream *O)
 			if (MI->csh->detail)
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.scale = (int)ScaleVal;
 			if (ScaleVal != 1) {
-				SStream_concat(O, ", %u", ScaleVal);
+				SStream_concat0(O, ", ");
+				SStream_concatDec(O, ScaleVal);
 			}
 		}
 		SStream_concat0(O, ")");
@@ -917,7 +899,8 @@ static void printanymem(MCInst *MI, unsigned OpNo, SStream *O)
 
 static void printRegName(SStream *OS, unsigned RegNo)
 {
-	SStream_concat(OS, "%%%s", getRegisterName(RegNo));
+	SStream_concat1(OS, '%');
+	SStream_concat0(OS, getRegisterName(RegNo));
 }
 
 void X86_ATT_printInst(MCInst *MI, SStream *OS, void *info)
@@ -929,7 +912,7 @@ void X86_ATT_printInst(MCInst *MI, SStream *OS, void *info)
 
 	// perhaps this instruction does not need printer
 	if (MI->assembly[0]) {
-		strncpy(OS->buffer, MI->assembly, sizeof(OS->buffer));
+		SStream_concat0(OS, MI->assembly);
 		return;
 	}
 
@@ -957,7 +940,7 @@ void X86_ATT_printInst(MCInst *MI, SStream *OS, void *info)
 	switch(MI->flat_insn->id) {
 		default: break;
 		case X86_INS_SYSEXIT:
-				 SStream_Init(OS);
+				 SStream_Clear(OS);
 				 SStream_concat0(OS, "sysexit");
 				 break;
 	}
@@ -1089,7 +1072,7 @@ void X86_ATT_printInst(MCInst *MI, SStream *OS, void *info)
 		}
 
 #ifndef CAPSTONE_DIET
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[0].access = access[0];
 		MI->flat_insn->detail->x86.operands[1].access = access[1];
 #endif
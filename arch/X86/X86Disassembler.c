@@ -904,23 +904,29 @@ static void update_pub_insn(cs_insn *pub, InternalInstruction *inter, uint8_t *p
 		pub->detail->x86.encoding.imm_size = inter->immediateSize;
 }
 
-void X86_init(MCRegisterInfo *MRI)
+/*
+   InitMCRegisterInfo(X86RegDesc, 234,
+   RA, PC,
+   X86MCRegisterClasses, 79,
+   X86RegUnitRoots, 119, X86RegDiffLists, X86RegStrings,
+   X86SubRegIdxLists, 7,
+   X86SubRegIdxRanges, X86RegEncodingTable);
+*/
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo X86_MRI = {
+	X86RegDesc, 234,
+	0, 0,
+	X86MCRegisterClasses, 79,
+	0, 0,
+	X86RegDiffLists, 0,
+	X86SubRegIdxLists, 7,
+	0
+};
+
+const MCRegisterInfo *X86_getRegisterInfo(void)
 {
-	/*
-	   InitMCRegisterInfo(X86RegDesc, 234,
-	   RA, PC,
-	   X86MCRegisterClasses, 79,
-	   X86RegUnitRoots, 119, X86RegDiffLists, X86RegStrings,
-	   X86SubRegIdxLists, 7,
-	   X86SubRegIdxRanges, X86RegEncodingTable);
-	*/
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, X86RegDesc, 234,
-			0, 0,
-			X86MCRegisterClasses, 79,
-			0, 0, X86RegDiffLists, 0,
-			X86SubRegIdxLists, 7,
-			0);
+	return &X86_MRI;
 }
 
 // Public interface for the disassembler
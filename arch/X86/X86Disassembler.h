@@ -87,6 +87,6 @@
 bool X86_getInstruction(csh handle, const uint8_t *code, size_t code_len,
 		MCInst *instr, uint16_t *size, uint64_t address, void *info);
 
-void X86_init(MCRegisterInfo *MRI);
+const MCRegisterInfo *X86_getRegisterInfo(void);
 
 #endif
@@ -2414,5 +2414,21 @@ int decodeInstruction(struct InternalInstruction *insn,
 	return 0;
 }
 
+/*
+ * X86_getOperandSpecifiers - Given an instruction opcode, returns its operand
+ *   specification, in the same order as the operands of the decoded MCInst.
+ *
+ * @param opcode - The opcode of the instruction, as set in the MCInst.
+ * @return       - X86_MAX_OPERANDS operand specifiers, or NULL if the opcode
+ *                 is out of range.
+ */
+const OperandSpecifier *X86_getOperandSpecifiers(unsigned int opcode)
+{
+	if (opcode >= ARR_SIZE(INSTRUCTIONS_SYM))
+		return NULL;
+
+	return x86OperandSets[specifierForUID(opcode)->operands];
+}
+
 #endif
 
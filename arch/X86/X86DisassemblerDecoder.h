@@ -738,4 +738,10 @@ int decodeInstruction(struct InternalInstruction* insn,
 
 //const char *x86DisassemblerGetInstrName(unsigned Opcode, const void *mii);
 
+/*
+ * X86_getOperandSpecifiers - Returns the operand specification of an
+ *   instruction, given its opcode, or NULL if the opcode is out of range.
+ */
+const OperandSpecifier *X86_getOperandSpecifiers(unsigned int opcode);
+
 #endif
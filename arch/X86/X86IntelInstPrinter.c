@@ -359,20 +359,6 @@ static void printRegName(SStream *OS, unsigned RegNo)
 	SStream_concat0(OS, getRegisterName(RegNo));
 }
 
-// for MASM syntax, 0x123 = 123h, 0xA123 = 0A123h
-// this function tell us if we need to have prefix 0 in front of a number
-static bool need_zero_prefix(uint64_t imm)
-{
-	// find the first hex letter representing imm
-	while(imm >= 0x10)
-		imm >>= 4;
-
-	if (imm < 0xa)
-		return false;
-	else	// this need 0 prefix
-		return true;
-}
-
 static void printImm(MCInst *MI, SStream *O, int64_t imm, bool positive)
 {
 	if (positive) {
@@ -395,20 +381,12 @@ static void printImm(MCInst *MI, SStream *O, int64_t imm, bool positive)
 					}
 				}
 
-				if (imm == 0x8000000000000000LL)  // imm == -imm
-					SStream_concat0(O, "8000000000000000h");
-				else if (need_zero_prefix(imm))
-					SStream_concat(O, "0%"PRIx64"h", imm);
-				else
-					SStream_concat(O, "%"PRIx64"h", imm);
+				SStream_concatMasmHex(O, imm);
 			} else {
-				if (imm > HEX_THRESHOLD) {
-					if (need_zero_prefix(imm))
-						SStream_concat(O, "0%"PRIx64"h", imm);
-					else
-						SStream_concat(O, "%"PRIx64"h", imm);
-				} else
-					SStream_concat(O, "%"PRIu64, imm);
+				if (imm > HEX_THRESHOLD)
+					SStream_concatMasmHex(O, imm);
+				else
+					SStream_concatDec(O, imm);
 			}
 		} else {	// Intel syntax
 			if (imm < 0) {
@@ -428,13 +406,9 @@ static void printImm(MCInst *MI, SStream *O, int64_t imm, bool positive)
 					}
 				}
 
-				SStream_concat(O, "0x%"PRIx64, imm);
-			} else {
-				if (imm > HEX_THRESHOLD)
-					SStream_concat(O, "0x%"PRIx64, imm);
-				else
-					SStream_concat(O, "%"PRIu64, imm);
-			}
+				SStream_concatHex(O, "0x", imm);
+			} else
+				printUInt64(O, imm);
 		}
 	} else {
 		if (MI->csh->syntax == CS_OPT_SYNTAX_MASM) {
@@ -442,36 +416,24 @@ static void printImm(MCInst *MI, SStream *O, int64_t imm, bool positive)
 				if (imm == 0x8000000000000000LL)  // imm == -imm
 					SStream_concat0(O, "8000000000000000h");
 				else if (imm < -HEX_THRESHOLD) {
-					if (need_zero_prefix(imm))
-						SStream_concat(O, "-0%"PRIx64"h", -imm);
-					else
-						SStream_concat(O, "-%"PRIx64"h", -imm);
-				} else
-					SStream_concat(O, "-%"PRIu64, -imm);
-			} else {
-				if (imm > HEX_THRESHOLD) {
-					if (need_zero_prefix(imm))
-						SStream_concat(O, "0%"PRIx64"h", imm);
-					else
-						SStream_concat(O, "%"PRIx64"h", imm);
-				} else
-					SStream_concat(O, "%"PRIu64, imm);
-			}
-		} else {	// Intel syntax
-			if (imm < 0) {
-				if (imm == 0x8000000000000000LL)  // imm == -imm
-					SStream_concat0(O, "0x8000000000000000");
-				else if (imm < -HEX_THRESHOLD)
-					SStream_concat(O, "-0x%"PRIx64, -imm);
-				else
-					SStream_concat(O, "-%"PRIu64, -imm);
-
+					// the magnitude always gets the 0 prefix here
+					SStream_concatHex(O, "-0", -imm);
+					SStream_concat1(O, 'h');
+				} else {
+					SStream_concat1(O, '-');
+					SStream_concatDec(O, -imm);
+				}
 			} else {
 				if (imm > HEX_THRESHOLD)
-					SStream_concat(O, "0x%"PRIx64, imm);
+					SStream_concatMasmHex(O, imm);
 				else
-					SStream_concat(O, "%"PRIu64, imm);
+					SStream_concatDec(O, imm);
 			}
+		} else {	// Intel syntax
+			if (imm == 0x8000000000000000LL)  // imm == -imm
+				SStream_concat0(O, "0x8000000000000000");
+			else
+				printInt64(O, imm);
 		}
 	}
 }
@@ -490,11 +452,11 @@ static void _printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 
 #ifndef CAPSTONE_DIET
 // copy & normalize access info
-static void get_op_access(cs_struct *h, unsigned int id, uint8_t *access, uint64_t *eflags)
+static void get_op_access(MCInst *MI, uint8_t *access, uint64_t *eflags)
 {
 #ifndef CAPSTONE_DIET
 	uint8_t i;
-	uint8_t *arr = X86_get_op_access(h, id, eflags);
+	const uint8_t *arr = X86_get_op_access(MI, eflags);
 
 	if (!arr) {
 		access[0] = 0;
@@ -534,7 +496,7 @@ static void printSrcIdx(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
 #ifndef CAPSTONE_DIET
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 	}
@@ -574,19 +536,19 @@ static void printDstIdx(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
 #ifndef CAPSTONE_DIET
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 	}
 
 	// DI accesses are always ES-based on non-64bit mode
 	if (MI->csh->mode != CS_MODE_64) {
-		SStream_concat(O, "es:[");
+		SStream_concat0(O, "es:[");
 		if (MI->csh->detail) {
 			MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.segment = X86_REG_ES;
 		}
 	} else
-		SStream_concat(O, "[");
+		SStream_concat0(O, "[");
 
 	set_mem_access(MI, true);
 	printOperand(MI, Op, O);
@@ -670,7 +632,7 @@ static void printMemOffset(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
 #ifndef CAPSTONE_DIET
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 	}
@@ -724,7 +686,7 @@ static void printU8Imm(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].size = 1;
 
 #ifndef CAPSTONE_DIET
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 
@@ -776,7 +738,7 @@ void X86_Intel_printInst(MCInst *MI, SStream *O, void *Info)
 
 	// perhaps this instruction does not need printer
 	if (MI->assembly[0]) {
-		strncpy(O->buffer, MI->assembly, sizeof(O->buffer));
+		SStream_concat0(O, MI->assembly);
 		return;
 	}
 
@@ -821,7 +783,7 @@ void X86_Intel_printInst(MCInst *MI, SStream *O, void *Info)
 		}
 
 #ifndef CAPSTONE_DIET
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[0].access = access[0];
 		MI->flat_insn->detail->x86.operands[1].access = access[1];
 #endif
@@ -876,7 +838,7 @@ static void printPCRelImm(MCInst *MI, unsigned OpNo, SStream *O)
 			MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].imm = imm;
 
 #ifndef CAPSTONE_DIET
-			get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+			get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 			MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 
@@ -909,7 +871,7 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].size = MI->csh->regsize_map[reg];
 
 #ifndef CAPSTONE_DIET
-				get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+				get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 
@@ -991,7 +953,9 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].type = X86_OP_IMM;
 				if (opsize > 0) {
 					MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].size = opsize;
-					MI->flat_insn->detail->x86.encoding.imm_size = encsize;
+					// ptr16 of LJMP & LCALL keeps the size found by the decoder
+					if (encsize)
+						MI->flat_insn->detail->x86.encoding.imm_size = encsize;
 				} else if (MI->flat_insn->detail->x86.op_count > 0) {
 					if (MI->flat_insn->id != X86_INS_LCALL && MI->flat_insn->id != X86_INS_LJMP) {
 						MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].size =
@@ -1003,7 +967,7 @@ static void printOperand(MCInst *MI, unsigned OpNo, SStream *O)
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].imm = imm;
 
 #ifndef CAPSTONE_DIET
-				get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+				get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 				MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 
@@ -1037,7 +1001,7 @@ static void printMemReference(MCInst *MI, unsigned Op, SStream *O)
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].mem.disp = 0;
 
 #ifndef CAPSTONE_DIET
-		get_op_access(MI->csh, MCInst_getOpcode(MI), access, &MI->flat_insn->detail->x86.eflags);
+		get_op_access(MI, access, &MI->flat_insn->detail->x86.eflags);
 		MI->flat_insn->detail->x86.operands[MI->flat_insn->detail->x86.op_count].access = access[MI->flat_insn->detail->x86.op_count];
 #endif
 	}
@@ -1062,8 +1026,10 @@ static void printMemReference(MCInst *MI, unsigned Op, SStream *O)
 	if (MCOperand_getReg(IndexReg)) {
 		if (NeedPlus) SStream_concat0(O, " + ");
 		_printOperand(MI, Op + X86_AddrIndexReg, O);
-		if (ScaleVal != 1)
-			SStream_concat(O, "*%u", ScaleVal);
+		if (ScaleVal != 1) {
+			SStream_concat1(O, '*');
+			SStream_concatDec(O, ScaleVal);
+		}
 		NeedPlus = true;
 	}
 
@@ -16,8 +16,10 @@
 
 #include "X86Mapping.h"
 #include "X86DisassemblerDecoder.h"
+#include "X86BaseInfo.h"
 
 #include "../../utils.h"
+#include "../../MCRegisterInfo.h"
 
 
 const uint64_t arch_masks[9] = {
@@ -2447,13 +2449,17 @@ const char *X86_group_name(csh handle, unsigned int id)
 #include "X86GenInstrInfo.inc"
 #endif
 
+#ifndef CAPSTONE_DIET
+#include "X86MappingInsnPool.inc"
+#endif
+
 #ifndef CAPSTONE_X86_REDUCE
 static const insn_map insns[] = {	// full x86 instructions
 	// dummy item
 	{
 		0, 0,
 #ifndef CAPSTONE_DIET
-		{ 0 }, { 0 }, { 0 }, 0, 0
+		0, 0, 0, 0, 0, 0, 0, 0
 #endif
 	},
 
@@ -2465,7 +2471,7 @@ static insn_map insns[] = {	// reduce x86 instructions
 	{
 		0, 0,
 #ifndef CAPSTONE_DIET
-		{ 0 }, { 0 }, { 0 }, 0, 0
+		0, 0, 0, 0, 0, 0, 0, 0
 #endif
 	},
 
@@ -2474,185 +2480,65 @@ static insn_map insns[] = {	// reduce x86 instructions
 #endif
 
 #ifndef CAPSTONE_DIET
-// replace r1 = r2
-static void arr_replace(uint16_t *arr, uint8_t max, x86_reg r1, x86_reg r2)
+// map instruction to its characteristics
+typedef struct insn_op {
+	uint64_t flags;	// how this instruction update EFLAGS(arithmetic instrcutions) of FPU FLAGS(for FPU instructions)
+	uint8_t access[6];
+} insn_op;
+
+static insn_op insn_ops[] = {
+	{	/* NULL item  */
+		0,
+		{ 0 }
+	},
+
+#ifdef CAPSTONE_X86_REDUCE
+#include "X86MappingInsnOp_reduce.inc"
+#else
+#include "X86MappingInsnOp.inc"
+#endif
+};
+#endif
+
+// look up the mapping of @id once, for all later users of this MCInst
+static int set_mapping(cs_struct *h, MCInst *MI, unsigned int id)
 {
-	uint8_t i;
+	int i = insn_find(h, insns, ARR_SIZE(insns), id);
 
-	for(i = 0; i < max; i++) {
-		if (arr[i] == r1) {
-			arr[i] = r2;
-			break;
-		}
+	MI->mapping = i ? &insns[i] : NULL;
+#ifndef CAPSTONE_DIET
+	MI->op_info = i ? &insn_ops[i] : NULL;
+#endif
+
+	return i;
+}
+
+#ifndef CAPSTONE_DIET
+// return the pool of implicit registers for @mode: registers like stack
+// & string registers depend on mode, and are resolved in these pools
+const uint16_t *X86_implicit_regs(cs_mode mode)
+{
+	switch(mode) {
+		case CS_MODE_16:
+			return insn_regs_16;
+		case CS_MODE_32:
+			return insn_regs_32;
+		default:
+			return insn_regs_64;
 	}
 }
 #endif
 
 // given internal insn id, return public instruction info
-void X86_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
+void X86_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI)
 {
-	int i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
+	int i = set_mapping(h, MI, id);
 	if (i != 0) {
 		insn->id = insns[i].mapid;
 
 		if (h->detail) {
 #ifndef CAPSTONE_DIET
-			memcpy(insn->detail->regs_read, insns[i].regs_use, sizeof(insns[i].regs_use));
-			insn->detail->regs_read_count = (uint8_t)count_positive(insns[i].regs_use);
-
-			// special cases when regs_write[] depends on arch
-			switch(id) {
-				default:
-					memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-					insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-					break;
-				case X86_RDTSC:
-					if (h->mode == CS_MODE_64) {
-						memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-						insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-					} else {
-						insn->detail->regs_write[0] = X86_REG_EAX;
-						insn->detail->regs_write[1] = X86_REG_EDX;
-						insn->detail->regs_write_count = 2;
-					}
-					break;
-				case X86_RDTSCP:
-					if (h->mode == CS_MODE_64) {
-						memcpy(insn->detail->regs_write, insns[i].regs_mod, sizeof(insns[i].regs_mod));
-						insn->detail->regs_write_count = (uint8_t)count_positive(insns[i].regs_mod);
-					} else {
-						insn->detail->regs_write[0] = X86_REG_EAX;
-						insn->detail->regs_write[1] = X86_REG_ECX;
-						insn->detail->regs_write[2] = X86_REG_EDX;
-						insn->detail->regs_write_count = 3;
-					}
-					break;
-			}
-
-			switch(insn->id) {
-				default:
-					break;
-
-				case X86_INS_LOOP:
-				case X86_INS_LOOPE:
-				case X86_INS_LOOPNE:
-					switch(h->mode) {
-						default: break;
-						case CS_MODE_16:
-								 insn->detail->regs_read[0] = X86_REG_CX;
-								 insn->detail->regs_read_count = 1;
-								 insn->detail->regs_write[0] = X86_REG_CX;
-								 insn->detail->regs_write_count = 1;
-								 break;
-						case CS_MODE_32:
-								 insn->detail->regs_read[0] = X86_REG_ECX;
-								 insn->detail->regs_read_count = 1;
-								 insn->detail->regs_write[0] = X86_REG_ECX;
-								 insn->detail->regs_write_count = 1;
-								 break;
-						case CS_MODE_64:
-								 insn->detail->regs_read[0] = X86_REG_RCX;
-								 insn->detail->regs_read_count = 1;
-								 insn->detail->regs_write[0] = X86_REG_RCX;
-								 insn->detail->regs_write_count = 1;
-								 break;
-					}
-
-					// LOOPE & LOOPNE also read EFLAGS
-					if (insn->id != X86_INS_LOOP) {
-						insn->detail->regs_read[1] = X86_REG_EFLAGS;
-						insn->detail->regs_read_count = 2;
-					}
-
-					break;
-
-				case X86_INS_LODSB:
-				case X86_INS_LODSD:
-				case X86_INS_LODSQ:
-				case X86_INS_LODSW:
-					switch(h->mode) {
-						default:
-							break;
-						case CS_MODE_16:
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_ESI, X86_REG_SI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_ESI, X86_REG_SI);
-							break;
-						case CS_MODE_64:
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_ESI, X86_REG_RSI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_ESI, X86_REG_RSI);
-							break;
-					}
-					break;
-
-				case X86_INS_SCASB:
-				case X86_INS_SCASW:
-				case X86_INS_SCASQ:
-				case X86_INS_STOSB:
-				case X86_INS_STOSD:
-				case X86_INS_STOSQ:
-				case X86_INS_STOSW:
-					switch(h->mode) {
-						default:
-							break;
-						case CS_MODE_16:
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_EDI, X86_REG_DI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_EDI, X86_REG_DI);
-							break;
-						case CS_MODE_64:
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_EDI, X86_REG_RDI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_EDI, X86_REG_RDI);
-							break;
-					}
-					break;
-
-				case X86_INS_CMPSB:
-				case X86_INS_CMPSD:
-				case X86_INS_CMPSQ:
-				case X86_INS_CMPSW:
-				case X86_INS_MOVSB:
-				case X86_INS_MOVSW:
-				case X86_INS_MOVSD:
-				case X86_INS_MOVSQ:
-					switch(h->mode) {
-						default:
-							break;
-						case CS_MODE_16:
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_EDI, X86_REG_DI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_EDI, X86_REG_DI);
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_ESI, X86_REG_SI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_ESI, X86_REG_SI);
-							break;
-						case CS_MODE_64:
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_EDI, X86_REG_RDI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_EDI, X86_REG_RDI);
-							arr_replace(insn->detail->regs_read, insn->detail->regs_read_count, X86_REG_ESI, X86_REG_RSI);
-							arr_replace(insn->detail->regs_write, insn->detail->regs_write_count, X86_REG_ESI, X86_REG_RSI);
-							break;
-					}
-					break;
-
-				case X86_INS_RET:
-					switch(h->mode) {
-						case CS_MODE_16:
-							insn->detail->regs_write[0] = X86_REG_SP;
-							insn->detail->regs_read[0] = X86_REG_SP;
-							break;
-						case CS_MODE_32:
-							insn->detail->regs_write[0] = X86_REG_ESP;
-							insn->detail->regs_read[0] = X86_REG_ESP;
-							break;
-						default:	// 64-bit
-							insn->detail->regs_write[0] = X86_REG_RSP;
-							insn->detail->regs_read[0] = X86_REG_RSP;
-							break;
-					}
-					insn->detail->regs_write_count = 1;
-					insn->detail->regs_read_count = 1;
-					break;
-			}
-
-			memcpy(insn->detail->groups, insns[i].groups, sizeof(insns[i].groups));
-			insn->detail->groups_count = (uint8_t)count_positive8(insns[i].groups);
+			map_implicit_detail(insn->detail, &insns[i], h->implicit_regs, insn_groups);
 
 			if (insns[i].branch || insns[i].indirect_branch) {
 				// this insn also belongs to JUMP group. add JUMP group
@@ -2680,300 +2566,33 @@ void X86_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id)
 	}
 }
 
-// map special instructions with accumulate registers.
-// this is needed because LLVM embeds these register names into AsmStrs[],
-// but not separately in operands
-struct insn_reg {
-	uint16_t insn;
-	x86_reg reg;
-	enum cs_ac_type access;
-};
-
-struct insn_reg2 {
-	uint16_t insn;
-	x86_reg reg1, reg2;
-	enum cs_ac_type access1, access2;
-};
-
-static struct insn_reg insn_regs_att[] = {
-	{ X86_INSB, X86_REG_DX },
-	{ X86_INSW, X86_REG_DX },
-	{ X86_INSL, X86_REG_DX },
-
-	{ X86_MOV8o16a, X86_REG_AL },
-	{ X86_MOV8o32a, X86_REG_AL },
-	{ X86_MOV8o64a, X86_REG_AL },
-
-	{ X86_MOV16o16a, X86_REG_AX },
-	{ X86_MOV16o32a, X86_REG_AX },
-	{ X86_MOV16o64a, X86_REG_AX },
-
-	{ X86_MOV32o16a, X86_REG_EAX },
-	{ X86_MOV32o32a, X86_REG_EAX },
-	{ X86_MOV32o64a, X86_REG_EAX },
-
-	{ X86_MOV64o32a, X86_REG_RAX },
-	{ X86_MOV64o64a, X86_REG_RAX },
-
-	{ X86_PUSHCS32, X86_REG_CS },
-	{ X86_PUSHDS32, X86_REG_DS },
-	{ X86_PUSHES32, X86_REG_ES },
-	{ X86_PUSHFS32, X86_REG_FS },
-	{ X86_PUSHGS32, X86_REG_GS },
-	{ X86_PUSHSS32, X86_REG_SS },
-
-	{ X86_PUSHFS64, X86_REG_FS },
-	{ X86_PUSHGS64, X86_REG_GS },
-
-	{ X86_PUSHCS16, X86_REG_CS },
-	{ X86_PUSHDS16, X86_REG_DS },
-	{ X86_PUSHES16, X86_REG_ES },
-	{ X86_PUSHFS16, X86_REG_FS },
-	{ X86_PUSHGS16, X86_REG_GS },
-	{ X86_PUSHSS16, X86_REG_SS },
-
-	{ X86_POPDS32, X86_REG_DS },
-	{ X86_POPES32, X86_REG_ES },
-	{ X86_POPFS32, X86_REG_FS },
-	{ X86_POPGS32, X86_REG_GS },
-	{ X86_POPSS32, X86_REG_SS },
-
-	{ X86_POPFS64, X86_REG_FS },
-	{ X86_POPGS64, X86_REG_GS },
-
-	{ X86_POPDS16, X86_REG_DS },
-	{ X86_POPES16, X86_REG_ES },
-	{ X86_POPFS16, X86_REG_FS },
-	{ X86_POPGS16, X86_REG_GS },
-	{ X86_POPSS16, X86_REG_SS },
-
-	{ X86_RCL32rCL, X86_REG_CL },
-	{ X86_SHL8rCL, X86_REG_CL },
-	{ X86_SHL16rCL, X86_REG_CL },
-	{ X86_SHL32rCL, X86_REG_CL },
-	{ X86_SHL64rCL, X86_REG_CL },
-	{ X86_SAL8rCL, X86_REG_CL },
-	{ X86_SAL16rCL, X86_REG_CL },
-	{ X86_SAL32rCL, X86_REG_CL },
-	{ X86_SAL64rCL, X86_REG_CL },
-	{ X86_SHR8rCL, X86_REG_CL },
-	{ X86_SHR16rCL, X86_REG_CL },
-	{ X86_SHR32rCL, X86_REG_CL },
-	{ X86_SHR64rCL, X86_REG_CL },
-	{ X86_SAR8rCL, X86_REG_CL },
-	{ X86_SAR16rCL, X86_REG_CL },
-	{ X86_SAR32rCL, X86_REG_CL },
-	{ X86_SAR64rCL, X86_REG_CL },
-	{ X86_RCL8rCL, X86_REG_CL },
-	{ X86_RCL16rCL, X86_REG_CL },
-	{ X86_RCL32rCL, X86_REG_CL },
-	{ X86_RCL64rCL, X86_REG_CL },
-	{ X86_RCR8rCL, X86_REG_CL },
-	{ X86_RCR16rCL, X86_REG_CL },
-	{ X86_RCR32rCL, X86_REG_CL },
-	{ X86_RCR64rCL, X86_REG_CL },
-	{ X86_ROL8rCL, X86_REG_CL },
-	{ X86_ROL16rCL, X86_REG_CL },
-	{ X86_ROL32rCL, X86_REG_CL },
-	{ X86_ROL64rCL, X86_REG_CL },
-	{ X86_ROR8rCL, X86_REG_CL },
-	{ X86_ROR16rCL, X86_REG_CL },
-	{ X86_ROR32rCL, X86_REG_CL },
-	{ X86_ROR64rCL, X86_REG_CL },
-	{ X86_SHLD16rrCL, X86_REG_CL },
-	{ X86_SHRD16rrCL, X86_REG_CL },
-	{ X86_SHLD32rrCL, X86_REG_CL },
-	{ X86_SHRD32rrCL, X86_REG_CL },
-	{ X86_SHLD64rrCL, X86_REG_CL },
-	{ X86_SHRD64rrCL, X86_REG_CL },
-	{ X86_SHLD16mrCL, X86_REG_CL },
-	{ X86_SHRD16mrCL, X86_REG_CL },
-	{ X86_SHLD32mrCL, X86_REG_CL },
-	{ X86_SHRD32mrCL, X86_REG_CL },
-	{ X86_SHLD64mrCL, X86_REG_CL },
-	{ X86_SHRD64mrCL, X86_REG_CL },
-
-	{ X86_OUT8ir, X86_REG_AL },
-	{ X86_OUT16ir, X86_REG_AX },
-	{ X86_OUT32ir, X86_REG_EAX },
-
-#ifndef CAPSTONE_X86_REDUCE
-	{ X86_SKINIT, X86_REG_EAX },
-	{ X86_VMRUN32, X86_REG_EAX },
-	{ X86_VMRUN64, X86_REG_RAX },
-	{ X86_VMLOAD32, X86_REG_EAX },
-	{ X86_VMLOAD64, X86_REG_RAX },
-	{ X86_VMSAVE32, X86_REG_EAX },
-	{ X86_VMSAVE64, X86_REG_RAX },
-
-	{ X86_FNSTSW16r, X86_REG_AX },
-
-	{ X86_ADD_FrST0, X86_REG_ST0 },
-	{ X86_SUB_FrST0, X86_REG_ST0 },
-	{ X86_SUBR_FrST0, X86_REG_ST0 },
-	{ X86_MUL_FrST0, X86_REG_ST0 },
-	{ X86_DIV_FrST0, X86_REG_ST0 },
-	{ X86_DIVR_FrST0, X86_REG_ST0 },
-#endif
-};
-
-static struct insn_reg insn_regs_intel[] = {
-	{ X86_OUTSB, X86_REG_DX, CS_AC_WRITE },
-	{ X86_OUTSW, X86_REG_DX, CS_AC_WRITE },
-	{ X86_OUTSL, X86_REG_DX, CS_AC_WRITE },
-
-	{ X86_MOV8ao16, X86_REG_AL, CS_AC_WRITE },     // 16-bit A0 1020                  // mov     al, byte ptr [0x2010]
-	{ X86_MOV8ao32, X86_REG_AL, CS_AC_WRITE },     // 32-bit A0 10203040              // mov     al, byte ptr [0x40302010]
-	{ X86_MOV8ao64, X86_REG_AL, CS_AC_WRITE },     // 64-bit 66 A0 1020304050607080   // movabs  al, byte ptr [0x8070605040302010]
-
-	{ X86_MOV16ao16, X86_REG_AX, CS_AC_WRITE },    // 16-bit A1 1020                  // mov     ax, word ptr [0x2010]
-	{ X86_MOV16ao32, X86_REG_AX, CS_AC_WRITE },    // 32-bit A1 10203040              // mov     ax, word ptr [0x40302010]
-	{ X86_MOV16ao64, X86_REG_AX, CS_AC_WRITE },    // 64-bit 66 A1 1020304050607080   // movabs  ax, word ptr [0x8070605040302010]
-
-	{ X86_MOV32ao16, X86_REG_EAX, CS_AC_WRITE },   // 32-bit 67 A1 1020               // mov     eax, dword ptr [0x2010]
-	{ X86_MOV32ao32, X86_REG_EAX, CS_AC_WRITE },   // 32-bit A1 10203040              // mov     eax, dword ptr [0x40302010]
-	{ X86_MOV32ao64, X86_REG_EAX, CS_AC_WRITE },   // 64-bit A1 1020304050607080      // movabs  eax, dword ptr [0x8070605040302010]
-
-	{ X86_MOV64ao32, X86_REG_RAX, CS_AC_WRITE },   // 64-bit 48 8B04 10203040         // mov     rax, qword ptr [0x40302010]
-	{ X86_MOV64ao64, X86_REG_RAX, CS_AC_WRITE },   // 64-bit 48 A1 1020304050607080   // movabs  rax, qword ptr [0x8070605040302010]
-
-	{ X86_LODSQ, X86_REG_RAX, CS_AC_WRITE },
-	{ X86_OR32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SUB32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_TEST32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADD32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XCHG64ar, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_LODSB, X86_REG_AL, CS_AC_WRITE },
-	{ X86_AND32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_IN16ri, X86_REG_AX, CS_AC_WRITE },
-	{ X86_CMP64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XOR32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XCHG16ar, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_LODSW, X86_REG_AX, CS_AC_WRITE },
-	{ X86_AND16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADC16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XCHG32ar64, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADC8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_CMP32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_AND8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SCASW, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XOR8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SUB16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_OR16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XCHG32ar, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SBB8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SCASQ, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SBB32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XOR64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SUB64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADD64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_OR8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_TEST64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SBB16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_TEST8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_IN8ri, X86_REG_AL, CS_AC_WRITE },
-	{ X86_TEST16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SCASL, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SUB8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADD8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_OR64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SCASB, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_SBB64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADD16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_XOR16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_AND64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_LODSL, X86_REG_EAX, CS_AC_WRITE },
-	{ X86_CMP8i8, X86_REG_AL, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADC64i32, X86_REG_RAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_CMP16i16, X86_REG_AX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_ADC32i32, X86_REG_EAX, CS_AC_WRITE | CS_AC_READ },
-	{ X86_IN32ri, X86_REG_EAX, CS_AC_WRITE },
-
-	{ X86_PUSHCS32, X86_REG_CS, CS_AC_READ },
-	{ X86_PUSHDS32, X86_REG_DS, CS_AC_READ },
-	{ X86_PUSHES32, X86_REG_ES, CS_AC_READ },
-	{ X86_PUSHFS32, X86_REG_FS, CS_AC_READ },
-	{ X86_PUSHGS32, X86_REG_GS, CS_AC_READ },
-	{ X86_PUSHSS32, X86_REG_SS, CS_AC_READ },
-
-	{ X86_PUSHFS64, X86_REG_FS, CS_AC_READ },
-	{ X86_PUSHGS64, X86_REG_GS, CS_AC_READ },
-
-	{ X86_PUSHCS16, X86_REG_CS, CS_AC_READ },
-	{ X86_PUSHDS16, X86_REG_DS, CS_AC_READ },
-	{ X86_PUSHES16, X86_REG_ES, CS_AC_READ },
-	{ X86_PUSHFS16, X86_REG_FS, CS_AC_READ },
-	{ X86_PUSHGS16, X86_REG_GS, CS_AC_READ },
-	{ X86_PUSHSS16, X86_REG_SS, CS_AC_READ },
-
-	{ X86_POPDS32, X86_REG_DS, CS_AC_WRITE },
-	{ X86_POPES32, X86_REG_ES, CS_AC_WRITE },
-	{ X86_POPFS32, X86_REG_FS, CS_AC_WRITE },
-	{ X86_POPGS32, X86_REG_GS, CS_AC_WRITE },
-	{ X86_POPSS32, X86_REG_SS, CS_AC_WRITE },
-
-	{ X86_POPFS64, X86_REG_FS, CS_AC_WRITE },
-	{ X86_POPGS64, X86_REG_GS, CS_AC_WRITE },
-
-	{ X86_POPDS16, X86_REG_DS, CS_AC_WRITE },
-	{ X86_POPES16, X86_REG_ES, CS_AC_WRITE },
-	{ X86_POPFS16, X86_REG_FS, CS_AC_WRITE },
-	{ X86_POPGS16, X86_REG_GS, CS_AC_WRITE },
-	{ X86_POPSS16, X86_REG_SS, CS_AC_WRITE },
+// per-opcode info, indexed by internal opcode.
+// accumulate registers need special handling, because LLVM embeds these
+// register names into AsmStrs[], but not separately in operands
+typedef struct x86_opcode_regs {
+	uint8_t intel, intel_access;	// register embedded in Intel syntax
+	uint8_t att, att_access;	// register embedded in AT&T syntax
+	uint8_t reg1, access1, reg2, access2;	// pair of registers embedded in Intel syntax
+} x86_opcode_regs;
+
+typedef struct x86_opcode_info {
+	uint8_t imm_size;	// size of immediate operand, or 0
+	uint8_t imm_enc_size;	// encoded size of immediate operand
+	uint8_t regs;	// index of embedded registers in opcode_regs[], or 0
+} x86_opcode_info;
 
 #ifndef CAPSTONE_X86_REDUCE
-	{ X86_SKINIT, X86_REG_EAX, CS_AC_WRITE },
-	{ X86_VMRUN32, X86_REG_EAX, CS_AC_WRITE },
-	{ X86_VMRUN64, X86_REG_RAX, CS_AC_WRITE },
-	{ X86_VMLOAD32, X86_REG_EAX, CS_AC_WRITE },
-	{ X86_VMLOAD64, X86_REG_RAX, CS_AC_WRITE },
-	{ X86_VMSAVE32, X86_REG_EAX, CS_AC_READ },
-	{ X86_VMSAVE64, X86_REG_RAX, CS_AC_READ },
-
-	{ X86_FNSTSW16r, X86_REG_AX, CS_AC_WRITE },
-
-	{ X86_CMOVB_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_CMOVBE_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_CMOVE_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_CMOVP_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_CMOVNB_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_CMOVNBE_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_CMOVNE_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_CMOVNP_F, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FXCHST0r, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FXCHST0r_alt, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FCOMST0r, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FCOMPST0r, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FCOMPST0r_alt, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FPST0r, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FPST0r_alt, X86_REG_ST0, CS_AC_WRITE },
-	{ X86_ST_FPNCEST0r, X86_REG_ST0, CS_AC_WRITE },
+#include "X86OpcodeInfo.inc"
+#else
+#include "X86OpcodeInfo_reduce.inc"
 #endif
-};
-
-static struct insn_reg2 insn_regs_intel2[] = {
-	{ X86_IN8rr, X86_REG_AL, X86_REG_DX, CS_AC_WRITE, CS_AC_READ },
-	{ X86_IN16rr, X86_REG_AX, X86_REG_DX, CS_AC_WRITE, CS_AC_READ },
-	{ X86_IN32rr, X86_REG_EAX, X86_REG_DX, CS_AC_WRITE, CS_AC_READ },
 
-	{ X86_OUT8rr, X86_REG_DX, X86_REG_AL, CS_AC_READ, CS_AC_READ },
-	{ X86_OUT16rr, X86_REG_DX, X86_REG_AX, CS_AC_READ, CS_AC_READ },
-	{ X86_OUT32rr, X86_REG_DX, X86_REG_EAX, CS_AC_READ, CS_AC_READ },
-
-	{ X86_INVLPGA32, X86_REG_EAX, X86_REG_ECX, CS_AC_READ, CS_AC_READ },
-	{ X86_INVLPGA64, X86_REG_RAX, X86_REG_ECX, CS_AC_READ, CS_AC_READ },
-};
-
-static struct insn_reg insn_regs_intel_sorted [ARR_SIZE(insn_regs_intel)];
-
-// Explicitly specified calling convention with CAPSTONE_API so that it is always
-// compiled as __cdecl on MSVC and does not cause a compile error even when
-// default calling convention is __stdcall (eg. capstone_static_winkernel project)
-static int CAPSTONE_API regs_cmp(const void *a, const void *b)
+static const x86_opcode_regs *get_opcode_regs(unsigned int id)
 {
-	uint16_t l = ((struct insn_reg *)a)->insn;
-	uint16_t r = ((struct insn_reg *)b)->insn;
-	return (l - r);
+	if (id >= ARR_SIZE(opcode_info))
+		return NULL;
+
+	return opcode_info[id].regs ? &opcode_regs[opcode_info[id].regs] : NULL;
 }
 
 // return register of given instruction id
@@ -2981,110 +2600,72 @@ static int CAPSTONE_API regs_cmp(const void *a, const void *b)
 // this is to handle instructions embedding accumulate registers into AsmStrs[]
 x86_reg X86_insn_reg_intel(unsigned int id, enum cs_ac_type *access)
 {
-	static bool intel_regs_sorted = false;
-	unsigned int first = 0;
-	unsigned int last = ARR_SIZE(insn_regs_intel) - 1;
-	unsigned int mid;
-
-	if (!intel_regs_sorted) {
-		memcpy(insn_regs_intel_sorted, insn_regs_intel,
-				sizeof(insn_regs_intel_sorted));
-		qsort(insn_regs_intel_sorted,
-				ARR_SIZE(insn_regs_intel_sorted),
-				sizeof(struct insn_reg), regs_cmp);
-		intel_regs_sorted = true;
-	}
+	const x86_opcode_regs *r = get_opcode_regs(id);
 
-	if (insn_regs_intel_sorted[0].insn > id ||
-			insn_regs_intel_sorted[last].insn < id) {
+	if (!r || !r->intel)
 		return 0;
-	}
 
-	while (first <= last) {
-		mid = (first + last) / 2;
-		if (insn_regs_intel_sorted[mid].insn < id) {
-			first = mid + 1;
-		} else if (insn_regs_intel_sorted[mid].insn == id) {
-			if (access) {
-				*access = insn_regs_intel_sorted[mid].access;
-			}
-			return insn_regs_intel_sorted[mid].reg;
-		} else {
-			if (mid == 0)
-				break;
-			last = mid - 1;
-		}
-	}
+	if (access)
+		*access = r->intel_access;
 
-	// not found
-	return 0;
+	return r->intel;
 }
 
 bool X86_insn_reg_intel2(unsigned int id, x86_reg *reg1, enum cs_ac_type *access1, x86_reg *reg2, enum cs_ac_type *access2)
 {
-	unsigned int i;
-
-	for (i = 0; i < ARR_SIZE(insn_regs_intel2); i++) {
-		if (insn_regs_intel2[i].insn == id) {
-			*reg1 = insn_regs_intel2[i].reg1;
-			*reg2 = insn_regs_intel2[i].reg2;
-			if (access1)
-				*access1 = insn_regs_intel2[i].access1;
-			if (access2)
-				*access2 = insn_regs_intel2[i].access2;
-			return true;
-		}
-	}
+	const x86_opcode_regs *r = get_opcode_regs(id);
 
-	// not found
-	return false;
+	if (!r || !r->reg1)
+		return false;
+
+	*reg1 = r->reg1;
+	*reg2 = r->reg2;
+	if (access1)
+		*access1 = r->access1;
+	if (access2)
+		*access2 = r->access2;
+
+	return true;
 }
 
 // ATT just reuses Intel data, but with the order of registers reversed
 bool X86_insn_reg_att2(unsigned int id, x86_reg *reg1, enum cs_ac_type *access1, x86_reg *reg2, enum cs_ac_type *access2)
 {
-	unsigned int i;
-
-	for (i = 0; i < ARR_SIZE(insn_regs_intel2); i++) {
-		if (insn_regs_intel2[i].insn == id) {
-			// reverse order of Intel syntax registers
-			*reg1 = insn_regs_intel2[i].reg2;
-			*reg2 = insn_regs_intel2[i].reg1;
-            if (access1)
-                *access1 = insn_regs_intel2[i].access2;
-            if (access2)
-                *access2 = insn_regs_intel2[i].access1;
-			return true;
-		}
-	}
+	const x86_opcode_regs *r = get_opcode_regs(id);
 
-	// not found
-	return false;
+	if (!r || !r->reg1)
+		return false;
+
+	// reverse order of Intel syntax registers
+	*reg1 = r->reg2;
+	*reg2 = r->reg1;
+	if (access1)
+		*access1 = r->access2;
+	if (access2)
+		*access2 = r->access1;
+
+	return true;
 }
 
 x86_reg X86_insn_reg_att(unsigned int id, enum cs_ac_type *access)
 {
-	unsigned int i;
+	const x86_opcode_regs *r = get_opcode_regs(id);
 
-	for (i = 0; i < ARR_SIZE(insn_regs_att); i++) {
-		if (insn_regs_att[i].insn == id) {
-			if (access)
-				*access = insn_regs_att[i].access;
-			return insn_regs_att[i].reg;
-		}
-	}
+	if (!r || !r->att)
+		return 0;
 
-	// not found
-	return 0;
+	if (access)
+		*access = r->att_access;
+
+	return r->att;
 }
 
 // given MCInst's id, find out if this insn is valid for REPNE prefix
-static bool valid_repne(cs_struct *h, unsigned int opcode)
+static bool valid_repne(const MCInst *MI, unsigned int opcode)
 {
 	unsigned int id;
-	int i = insn_find(insns, ARR_SIZE(insns), opcode, &h->insn_cache);
-	if (i != 0) {
-		id = insns[i].mapid;
+	if (MI->mapping) {
+		id = MI->mapping->mapid;
 		switch(id) {
 			default:
 				return false;
@@ -3145,12 +2726,11 @@ static bool valid_repne(cs_struct *h, unsigned int opcode)
 // given MCInst's id, find out if this insn is valid for BND prefix
 // BND prefix is valid for CALL/JMP/RET
 #ifndef CAPSTONE_DIET
-static bool valid_bnd(cs_struct *h, unsigned int opcode)
+static bool valid_bnd(const MCInst *MI, unsigned int opcode)
 {
 	unsigned int id;
-	int i = insn_find(insns, ARR_SIZE(insns), opcode, &h->insn_cache);
-	if (i != 0) {
-		id = insns[i].mapid;
+	if (MI->mapping) {
+		id = MI->mapping->mapid;
 		switch(id) {
 			default:
 				return false;
@@ -3190,12 +2770,11 @@ static bool valid_bnd(cs_struct *h, unsigned int opcode)
 #endif
 
 // given MCInst's id, find out if this insn is valid for REP prefix
-static bool valid_rep(cs_struct *h, unsigned int opcode)
+static bool valid_rep(const MCInst *MI, unsigned int opcode)
 {
 	unsigned int id;
-	int i = insn_find(insns, ARR_SIZE(insns), opcode, &h->insn_cache);
-	if (i != 0) {
-		id = insns[i].mapid;
+	if (MI->mapping) {
+		id = MI->mapping->mapid;
 		switch(id) {
 			default:
 				return false;
@@ -3245,12 +2824,11 @@ static bool valid_rep(cs_struct *h, unsigned int opcode)
 }
 
 // given MCInst's id, find out if this insn is valid for REPE prefix
-static bool valid_repe(cs_struct *h, unsigned int opcode)
+static bool valid_repe(const MCInst *MI, unsigned int opcode)
 {
 	unsigned int id;
-	int i = insn_find(insns, ARR_SIZE(insns), opcode, &h->insn_cache);
-	if (i != 0) {
-		id = insns[i].mapid;
+	if (MI->mapping) {
+		id = MI->mapping->mapid;
 		switch(id) {
 			default:
 				return false;
@@ -3316,17 +2894,17 @@ bool X86_lockrep(MCInst *MI, SStream *O)
 			break;
 		case 0xf0:
 #ifndef CAPSTONE_DIET
-			SStream_concat(O, "lock|");
+			SStream_concat0(O, "lock|");
 #endif
 			break;
 		case 0xf2:	// repne
 			opcode = MCInst_getOpcode(MI);
 #ifndef CAPSTONE_DIET	// only care about memonic in standard (non-diet) mode
-			if (valid_repne(MI->csh, opcode)) {
-				SStream_concat(O, "repne|");
+			if (valid_repne(MI, opcode)) {
+				SStream_concat0(O, "repne|");
 				add_cx(MI);
-			} else if (valid_bnd(MI->csh, opcode)) {
-				SStream_concat(O, "bnd|");
+			} else if (valid_bnd(MI, opcode)) {
+				SStream_concat0(O, "bnd|");
 			} else {
 				// invalid prefix
 				MI->x86_prefix[0] = 0;
@@ -3335,19 +2913,21 @@ bool X86_lockrep(MCInst *MI, SStream *O)
 #ifndef CAPSTONE_X86_REDUCE
 				if (opcode == X86_MULPDrr) {
 					MCInst_setOpcode(MI, X86_MULSDrr);
-					SStream_concat(O, "mulsd\t");
+					set_mapping(MI->csh, MI, X86_MULSDrr);
+					SStream_concat0(O, "mulsd\t");
 					res = true;
 				}
 #endif
 			}
 #else	// diet mode -> only patch opcode in special cases
-			if (!valid_repne(MI->csh, opcode)) {
+			if (!valid_repne(MI, opcode)) {
 				MI->x86_prefix[0] = 0;
 			}
 #ifndef CAPSTONE_X86_REDUCE
 			// handle special cases
 			if (opcode == X86_MULPDrr) {
 				MCInst_setOpcode(MI, X86_MULSDrr);
+				set_mapping(MI->csh, MI, X86_MULSDrr);
 			}
 #endif
 #endif
@@ -3356,11 +2936,11 @@ bool X86_lockrep(MCInst *MI, SStream *O)
 		case 0xf3:
 			opcode = MCInst_getOpcode(MI);
 #ifndef CAPSTONE_DIET	// only care about memonic in standard (non-diet) mode
-			if (valid_rep(MI->csh, opcode)) {
-				SStream_concat(O, "rep|");
+			if (valid_rep(MI, opcode)) {
+				SStream_concat0(O, "rep|");
 				add_cx(MI);
-			} else if (valid_repe(MI->csh, opcode)) {
-				SStream_concat(O, "repe|");
+			} else if (valid_repe(MI, opcode)) {
+				SStream_concat0(O, "repe|");
 				add_cx(MI);
 			} else {
 				// invalid prefix
@@ -3370,19 +2950,21 @@ bool X86_lockrep(MCInst *MI, SStream *O)
 #ifndef CAPSTONE_X86_REDUCE
 				if (opcode == X86_MULPDrr) {
 					MCInst_setOpcode(MI, X86_MULSSrr);
-					SStream_concat(O, "mulss\t");
+					set_mapping(MI->csh, MI, X86_MULSSrr);
+					SStream_concat0(O, "mulss\t");
 					res = true;
 				}
 #endif
 			}
 #else	// diet mode -> only patch opcode in special cases
-			if (!valid_rep(MI->csh, opcode) && !valid_repe(MI->csh, opcode)) {
+			if (!valid_rep(MI, opcode) && !valid_repe(MI, opcode)) {
 				MI->x86_prefix[0] = 0;
 			}
 #ifndef CAPSTONE_X86_REDUCE
 			// handle special cases
 			if (opcode == X86_MULPDrr) {
 				MCInst_setOpcode(MI, X86_MULSSrr);
+				set_mapping(MI->csh, MI, X86_MULSSrr);
 			}
 #endif
 #endif
@@ -3482,32 +3064,14 @@ void op_addAvxBroadcast(MCInst *MI, x86_avx_bcast v)
 }
 
 #ifndef CAPSTONE_DIET
-// map instruction to its characteristics
-typedef struct insn_op {
-	uint64_t flags;	// how this instruction update EFLAGS(arithmetic instrcutions) of FPU FLAGS(for FPU instructions)
-	uint8_t access[6];
-} insn_op;
-
-static insn_op insn_ops[] = {
-	{	/* NULL item  */
-		0,
-		{ 0 }
-	},
-
-#ifdef CAPSTONE_X86_REDUCE
-#include "X86MappingInsnOp_reduce.inc"
-#else
-#include "X86MappingInsnOp.inc"
-#endif
-};
-
-// given internal insn id, return operand access info
-uint8_t *X86_get_op_access(cs_struct *h, unsigned int id, uint64_t *eflags)
+// return operand access info of the instruction, as resolved by X86_get_insn_id()
+const uint8_t *X86_get_op_access(const MCInst *MI, uint64_t *eflags)
 {
-	int i = insn_find(insns, ARR_SIZE(insns), id, &h->insn_cache);
-	if (i != 0) {
-		*eflags = insn_ops[i].flags;
-		return insn_ops[i].access;
+	const insn_op *op = MI->op_info;
+
+	if (op) {
+		*eflags = op->flags;
+		return op->access;
 	}
 
 	return NULL;
@@ -3564,49 +3128,91 @@ void X86_reg_access(const cs_insn *insn,
 	*regs_read_count = read_count;
 	*regs_write_count = write_count;
 }
-#endif
 
-// map immediate size to instruction id
-static struct size_id {
-	uint8_t		enc_size;
-	uint8_t		size;
-	uint16_t 	id;
-} x86_imm_size[] = {
-#include "X86ImmSize.inc"
-};
-
-// given the instruction name, return the size of its immediate operand (or 0)
-uint8_t X86_immediate_size(unsigned int id, uint8_t *enc_size)
+void X86_reg_access_mask(const cs_insn *insn,
+		uint64_t *regs_read, uint64_t *regs_write)
 {
-#if 0
-	// linear searching
-	unsigned int i;
+	uint8_t i;
+	cs_x86 *x86 = &(insn->detail->x86);
 
-	for (i = 0; i < ARR_SIZE(x86_imm_size); i++) {
-		if (id == x86_imm_size[i].id) {
-			return x86_imm_size[i].size;
+	for (i = 0; i < x86->op_count; i++) {
+		cs_x86_op *op = &(x86->operands[i]);
+		switch((int)op->type) {
+			case X86_OP_REG:
+				if (op->access & CS_AC_READ)
+					REGS_MASK_SET(regs_read, op->reg);
+				if (op->access & CS_AC_WRITE)
+					REGS_MASK_SET(regs_write, op->reg);
+				break;
+			case X86_OP_MEM:
+				// registers appeared in memory references always being read
+				// (bit 0 is X86_REG_INVALID, and is cleared below)
+				REGS_MASK_SET(regs_read, op->mem.segment);
+				REGS_MASK_SET(regs_read, op->mem.base);
+				REGS_MASK_SET(regs_read, op->mem.index);
+			default:
+				break;
 		}
 	}
+
+	regs_read[0] &= ~(uint64_t)1;
+}
+
+void X86_reg_fold_aliases(cs_struct *h, const uint64_t *regs, uint64_t *aliases)
+{
+	MCRegisterInfo_foldAliases((const MCRegisterInfo *)h->printer_info,
+			regs, aliases, X86_REG_ENDING);
+}
 #endif
 
+// given the instruction id, return the size of its immediate operand (or 0)
+uint8_t X86_immediate_size(unsigned int id, uint8_t *enc_size)
+{
+	if (enc_size != NULL)
+		*enc_size = 0;
+
+	if (id >= ARR_SIZE(opcode_info) || !opcode_info[id].imm_size)
+		return 0;
+
+	if (enc_size != NULL)
+		*enc_size = opcode_info[id].imm_enc_size;
+
+	return opcode_info[id].imm_size;
+}
+
+#ifndef CAPSTONE_DIET
+// map instruction to the size of its memory operand, when that is not
+// determined by the operand type alone
+static const struct mem_size_id {
+	uint8_t		size;
+	uint16_t 	id;
+} x86_mem_size[] = {
+#ifdef CAPSTONE_X86_REDUCE
+#include "X86MemSize_reduce.inc"
+#else
+#include "X86MemSize.inc"
+#endif
+};
+
+// given the instruction name, return the size of its memory operand (or 0)
+static uint8_t memory_size(unsigned int id)
+{
 	// binary searching since the IDs are sorted in order
 	unsigned int left, right, m;
 
 	left = 0;
-	right = ARR_SIZE(x86_imm_size) - 1;
+	right = ARR_SIZE(x86_mem_size) - 1;
 
 	while(left <= right) {
 		m = (left + right) / 2;
-		if (id == x86_imm_size[m].id) {
-			if (enc_size != NULL)
-				*enc_size = x86_imm_size[m].enc_size;
+		if (id == x86_mem_size[m].id)
+			return x86_mem_size[m].size;
 
-			return x86_imm_size[m].size;
-		}
-
-		if (id < x86_imm_size[m].id)
+		if (id < x86_mem_size[m].id) {
+			if (m == 0)
+				break;
 			right = m - 1;
-		else
+		} else
 			left = m + 1;
 	}
 
@@ -3614,4 +3220,771 @@ uint8_t X86_immediate_size(unsigned int id, uint8_t *enc_size)
 	return 0;
 }
 
+// size of memory operands printed as "ptr" without explicit size
+static uint8_t opaque_memory_size(MCInst *MI)
+{
+	unsigned int id = MI->flat_insn->id;
+
+	switch(MCInst_getOpcode(MI)) {
+		default:
+			break;
+#ifndef CAPSTONE_X86_REDUCE
+		case X86_FSTENVm:
+		case X86_FLDENVm:
+			return (MI->csh->mode == CS_MODE_16)? 14 : 28;
+#endif
+	}
+
+	switch(MI->csh->mode) {
+		default:	// never reach
+			return 0;
+		case CS_MODE_16:
+			if (id == X86_INS_LJMP || id == X86_INS_LCALL)
+				return 4;
+			if (id == X86_INS_SGDT || id == X86_INS_SIDT ||
+					id == X86_INS_LGDT || id == X86_INS_LIDT)
+				return 6;
+			return 2;
+		case CS_MODE_32:
+			if (id == X86_INS_LJMP || id == X86_INS_LCALL ||
+					id == X86_INS_SGDT || id == X86_INS_SIDT ||
+					id == X86_INS_LGDT || id == X86_INS_LIDT)
+				return 6;
+			return 4;
+		case CS_MODE_64:
+			if (id == X86_INS_LJMP || id == X86_INS_LCALL ||
+					id == X86_INS_SGDT || id == X86_INS_SIDT ||
+					id == X86_INS_LGDT || id == X86_INS_LIDT)
+				return 10;
+			return 8;
+	}
+}
+
+// return register embedded at the end of Intel asm string of given instruction
+// return 0 if not found
+static x86_reg insn_reg_intel_last(unsigned int id)
+{
+	switch(id) {
+		default:
+			return X86_REG_INVALID;
+#ifndef CAPSTONE_X86_REDUCE
+		case X86_ADD_FrST0:
+		case X86_DIVR_FrST0:
+		case X86_DIV_FrST0:
+		case X86_MUL_FrST0:
+		case X86_ST_FPNCEST0r:
+		case X86_ST_FPST0r:
+		case X86_ST_FPST0r_alt:
+		case X86_SUBR_FrST0:
+		case X86_SUB_FrST0:
+#endif
+			return X86_REG_ST0;
+		case X86_INSB:
+		case X86_INSL:
+		case X86_INSW:
+			return X86_REG_DX;
+		case X86_MOV16o16a:
+		case X86_MOV16o32a:
+		case X86_MOV16o64a:
+		case X86_OUT16ir:
+		case X86_STOSW:
+			return X86_REG_AX;
+		case X86_MOV32o16a:
+		case X86_MOV32o32a:
+		case X86_MOV32o64a:
+		case X86_OUT32ir:
+		case X86_STOSL:
+			return X86_REG_EAX;
+		case X86_MOV64o32a:
+		case X86_MOV64o64a:
+		case X86_STOSQ:
+			return X86_REG_RAX;
+		case X86_MOV8o16a:
+		case X86_MOV8o32a:
+		case X86_MOV8o64a:
+		case X86_OUT8ir:
+		case X86_STOSB:
+			return X86_REG_AL;
+		case X86_RCL16mCL:
+		case X86_RCL16rCL:
+		case X86_RCL32mCL:
+		case X86_RCL32rCL:
+		case X86_RCL64mCL:
+		case X86_RCL64rCL:
+		case X86_RCL8mCL:
+		case X86_RCL8rCL:
+		case X86_RCR16mCL:
+		case X86_RCR16rCL:
+		case X86_RCR32mCL:
+		case X86_RCR32rCL:
+		case X86_RCR64mCL:
+		case X86_RCR64rCL:
+		case X86_RCR8mCL:
+		case X86_RCR8rCL:
+		case X86_ROL16mCL:
+		case X86_ROL16rCL:
+		case X86_ROL32mCL:
+		case X86_ROL32rCL:
+		case X86_ROL64mCL:
+		case X86_ROL64rCL:
+		case X86_ROL8mCL:
+		case X86_ROL8rCL:
+		case X86_ROR16mCL:
+		case X86_ROR16rCL:
+		case X86_ROR32mCL:
+		case X86_ROR32rCL:
+		case X86_ROR64mCL:
+		case X86_ROR64rCL:
+		case X86_ROR8mCL:
+		case X86_ROR8rCL:
+		case X86_SAL16mCL:
+		case X86_SAL16rCL:
+		case X86_SAL32mCL:
+		case X86_SAL32rCL:
+		case X86_SAL64mCL:
+		case X86_SAL64rCL:
+		case X86_SAL8mCL:
+		case X86_SAL8rCL:
+		case X86_SAR16mCL:
+		case X86_SAR16rCL:
+		case X86_SAR32mCL:
+		case X86_SAR32rCL:
+		case X86_SAR64mCL:
+		case X86_SAR64rCL:
+		case X86_SAR8mCL:
+		case X86_SAR8rCL:
+		case X86_SHL16mCL:
+		case X86_SHL16rCL:
+		case X86_SHL32mCL:
+		case X86_SHL32rCL:
+		case X86_SHL64mCL:
+		case X86_SHL64rCL:
+		case X86_SHL8mCL:
+		case X86_SHL8rCL:
+		case X86_SHLD16mrCL:
+		case X86_SHLD16rrCL:
+		case X86_SHLD32mrCL:
+		case X86_SHLD32rrCL:
+		case X86_SHLD64mrCL:
+		case X86_SHLD64rrCL:
+		case X86_SHR16mCL:
+		case X86_SHR16rCL:
+		case X86_SHR32mCL:
+		case X86_SHR32rCL:
+		case X86_SHR64mCL:
+		case X86_SHR64rCL:
+		case X86_SHR8mCL:
+		case X86_SHR8rCL:
+		case X86_SHRD16mrCL:
+		case X86_SHRD16rrCL:
+		case X86_SHRD32mrCL:
+		case X86_SHRD32rrCL:
+		case X86_SHRD64mrCL:
+		case X86_SHRD64rrCL:
+			return X86_REG_CL;
+	}
+}
+
+// return true if Intel asm string of given instruction ends with immediate 1,
+// like in "shl eax, 1"
+static bool insn_imm1_intel_last(unsigned int id)
+{
+	switch(id) {
+		default:
+			return false;
+		case X86_RCL16m1:
+		case X86_RCL16r1:
+		case X86_RCL32m1:
+		case X86_RCL32r1:
+		case X86_RCL64m1:
+		case X86_RCL64r1:
+		case X86_RCL8m1:
+		case X86_RCL8r1:
+		case X86_RCR16m1:
+		case X86_RCR16r1:
+		case X86_RCR32m1:
+		case X86_RCR32r1:
+		case X86_RCR64m1:
+		case X86_RCR64r1:
+		case X86_RCR8m1:
+		case X86_RCR8r1:
+		case X86_ROL16m1:
+		case X86_ROL16r1:
+		case X86_ROL32m1:
+		case X86_ROL32r1:
+		case X86_ROL64m1:
+		case X86_ROL64r1:
+		case X86_ROL8m1:
+		case X86_ROL8r1:
+		case X86_ROR16m1:
+		case X86_ROR16r1:
+		case X86_ROR32m1:
+		case X86_ROR32r1:
+		case X86_ROR64m1:
+		case X86_ROR64r1:
+		case X86_ROR8m1:
+		case X86_ROR8r1:
+		case X86_SAL16m1:
+		case X86_SAL16r1:
+		case X86_SAL32m1:
+		case X86_SAL32r1:
+		case X86_SAL64m1:
+		case X86_SAL64r1:
+		case X86_SAL8m1:
+		case X86_SAL8r1:
+		case X86_SAR16m1:
+		case X86_SAR16r1:
+		case X86_SAR32m1:
+		case X86_SAR32r1:
+		case X86_SAR64m1:
+		case X86_SAR64r1:
+		case X86_SAR8m1:
+		case X86_SAR8r1:
+		case X86_SHL16m1:
+		case X86_SHL16r1:
+		case X86_SHL32m1:
+		case X86_SHL32r1:
+		case X86_SHL64m1:
+		case X86_SHL64r1:
+		case X86_SHL8m1:
+		case X86_SHL8r1:
+		case X86_SHR16m1:
+		case X86_SHR16r1:
+		case X86_SHR32m1:
+		case X86_SHR32r1:
+		case X86_SHR64m1:
+		case X86_SHR64r1:
+		case X86_SHR8m1:
+		case X86_SHR8r1:
+			return true;
+	}
+}
+
+// return true if Intel syntax prints the two operands of this instruction
+// in the reverse order of the MCInst
+static bool insn_ops_reversed_intel(unsigned int id)
+{
+	switch(id) {
+		default:
+			return false;
+		case X86_CMPSB:
+		case X86_CMPSW:
+		case X86_CMPSL:
+		case X86_CMPSQ:
+		case X86_FARCALL16i:
+		case X86_FARCALL32i:
+		case X86_FARJMP16i:
+		case X86_FARJMP32i:
+		case X86_NOOP19rr:
+		case X86_TEST8rm:
+		case X86_TEST16rm:
+		case X86_TEST32rm:
+		case X86_TEST64rm:
+		case X86_XCHG8rm:
+		case X86_XCHG16rm:
+		case X86_XCHG32rm:
+		case X86_XCHG64rm:
+		case X86_XCHG8rr:
+		case X86_XCHG16rr:
+		case X86_XCHG32rr:
+		case X86_XCHG64rr:
+			return true;
+	}
+}
+
+// number of MCInst operands produced by the decoder for this operand
+static unsigned int spec_num_mcops(const OperandSpecifier *op)
+{
+	switch(op->encoding) {
+		default:
+			break;
+		CASE_ENCODING_RM:
+			switch(op->type) {
+				default:
+					return 1;
+				case TYPE_M:
+				case TYPE_M8:
+				case TYPE_M16:
+				case TYPE_M32:
+				case TYPE_M64:
+				case TYPE_M128:
+				case TYPE_M256:
+				case TYPE_M512:
+				case TYPE_Mv:
+				case TYPE_M32FP:
+				case TYPE_M64FP:
+				case TYPE_M80FP:
+				case TYPE_M1616:
+				case TYPE_M1632:
+				case TYPE_M1664:
+				case TYPE_LEA:
+					// base, scale, index, displacement, segment
+					return 5;
+			}
+		case ENCODING_SI:
+			// index, segment
+			return 2;
+	}
+
+	switch(op->type) {
+		default:
+			return 1;
+		case TYPE_MOFFS8:
+		case TYPE_MOFFS16:
+		case TYPE_MOFFS32:
+		case TYPE_MOFFS64:
+			// displacement, segment
+			return 2;
+	}
+}
+
+// prepare a new memory operand in detail, without base/index/displacement
+static cs_x86_op *add_mem_op(MCInst *MI, uint8_t size, uint8_t *access)
+{
+	cs_x86 *x86 = &MI->flat_insn->detail->x86;
+	cs_x86_op *op = &x86->operands[x86->op_count];
+
+	op->type = X86_OP_MEM;
+	op->size = size;
+	op->access = access[x86->op_count];
+	op->mem.segment = X86_REG_INVALID;
+	op->mem.base = X86_REG_INVALID;
+	op->mem.index = X86_REG_INVALID;
+	op->mem.scale = 1;
+	op->mem.disp = 0;
+	x86->op_count++;
+
+	return op;
+}
+
+// add an immediate operand, with the same rules as X86 Intel printer
+static void add_imm_op(MCInst *MI, unsigned int OpNo, uint8_t *access)
+{
+	cs_x86 *x86 = &MI->flat_insn->detail->x86;
+	cs_x86_op *op = &x86->operands[x86->op_count];
+	uint8_t encsize;
+	int64_t imm = MCOperand_getImm(MCInst_getOperand(MI, OpNo));
+	uint8_t opsize = X86_immediate_size(MCInst_getOpcode(MI), &encsize);
+
+	if (opsize == 1)
+		imm = imm & 0xff;
+
+	switch(MI->flat_insn->id) {
+		default:
+			break;
+		case X86_INS_IN:
+		case X86_INS_OUT:
+		case X86_INS_INT:
+			imm = imm & 0xff;
+			break;
+		case X86_INS_LCALL:
+		case X86_INS_LJMP:
+			if (OpNo == 1) {	// ptr16 part
+				imm = imm & 0xffff;
+				opsize = 2;
+			}
+			break;
+		case X86_INS_AND:
+		case X86_INS_OR:
+		case X86_INS_XOR:
+			if (imm < 0 || imm > HEX_THRESHOLD)
+				imm = arch_masks[opsize? opsize : MI->imm_size] & imm;
+			break;
+		case X86_INS_RET:
+		case X86_INS_RETF:
+			if (imm < 0 || imm > HEX_THRESHOLD)
+				imm = 0xffff & imm;
+			break;
+	}
+
+	op->type = X86_OP_IMM;
+	if (opsize > 0) {
+		op->size = opsize;
+		// ptr16 of LJMP & LCALL keeps the size found by the decoder
+		if (encsize)
+			x86->encoding.imm_size = encsize;
+	} else if (x86->op_count > 0 &&
+			MI->flat_insn->id != X86_INS_LCALL && MI->flat_insn->id != X86_INS_LJMP)
+		op->size = x86->operands[0].size;
+	else
+		op->size = MI->imm_size;
+	op->imm = imm;
+	op->access = access[x86->op_count];
+	x86->op_count++;
+}
+
+// add a PC-relative operand, with the same rules as X86 Intel printer
+static void add_pcrel_op(MCInst *MI, unsigned int OpNo, uint8_t *access)
+{
+	cs_x86 *x86 = &MI->flat_insn->detail->x86;
+	cs_x86_op *op = &x86->operands[x86->op_count];
+	int64_t imm = MCOperand_getImm(MCInst_getOperand(MI, OpNo)) + MI->flat_insn->size + MI->address;
+	uint8_t opsize = X86_immediate_size(MCInst_getOpcode(MI), NULL);
+
+	// truncate imm for non-64bit
+	if (MI->csh->mode != CS_MODE_64)
+		imm = imm & 0xffffffff;
+
+	if (MI->csh->mode == CS_MODE_16 &&
+			(MI->Opcode != X86_JMP_4 && MI->Opcode != X86_CALLpcrel32))
+		imm = imm & 0xffff;
+
+	// X86 16bit with opcode X86_JMP_4
+	if (MI->csh->mode == CS_MODE_16 &&
+			(MI->Opcode == X86_JMP_4 && MI->x86_prefix[2] != 0x66))
+		imm = imm & 0xffff;
+
+	// CALL/JMP rel16 is special
+	if (MI->Opcode == X86_CALLpcrel16 || MI->Opcode == X86_JMP_2)
+		imm = imm & 0xffff;
+
+	op->type = X86_OP_IMM;
+	if (x86->op_count > 0)
+		op->size = x86->operands[0].size;
+	else if (opsize > 0)
+		op->size = opsize;
+	else
+		op->size = MI->imm_size;
+	op->imm = imm;
+	op->access = access[x86->op_count];
+	x86->op_count++;
+}
+
+static bool is_xop_cc(unsigned int id)
+{
+	switch(id) {
+		default:
+			return false;
+		case X86_INS_VPCOMB:
+		case X86_INS_VPCOMW:
+		case X86_INS_VPCOMD:
+		case X86_INS_VPCOMQ:
+		case X86_INS_VPCOMUB:
+		case X86_INS_VPCOMUW:
+		case X86_INS_VPCOMUD:
+		case X86_INS_VPCOMUQ:
+			return true;
+	}
+}
+
+// handle condition code operand, which is not reported as an operand
+static void set_cc(MCInst *MI, const OperandSpecifier *spec, int64_t imm)
+{
+	cs_x86 *x86 = MI->csh->detail ? &MI->flat_insn->detail->x86 : NULL;
+
+	switch(spec->type) {
+		default:
+			break;
+		case TYPE_IMM3:
+			// XOP instructions take XOPCC, others take SSECC
+			if (is_xop_cc(MI->flat_insn->id)) {
+				if (x86 && imm >= 0 && imm <= 7)
+					x86->xop_cc = (x86_xop_cc)(imm + 1);
+			} else {
+				imm &= 7;
+				if (x86)
+					x86->sse_cc = (x86_sse_cc)(imm + 1);
+				MI->popcode_adjust = (uint8_t)(imm + 1);
+			}
+			break;
+		case TYPE_IMM5:
+		case TYPE_AVX512ICC:
+			imm &= 0x1f;
+			if (x86)
+				x86->avx_cc = (x86_avx_cc)(imm + 1);
+			MI->popcode_adjust = (uint8_t)(imm + 1);
+			break;
+	}
+}
+
+static bool is_cc_operand(const OperandSpecifier *spec)
+{
+	return spec->type == TYPE_IMM3 || spec->type == TYPE_IMM5 ||
+		spec->type == TYPE_AVX512ICC;
+}
+
+// fill in detail of X86 instruction straight from the decoded MCInst,
+// without going through the asm printer (CS_OPT_NOTEXT mode).
+// the result is the same as X86_Intel_printInst() produces.
+void X86_fill_detail(MCInst *MI)
+{
+	const OperandSpecifier *specs, *spec;
+	const OperandSpecifier *ops[X86_MAX_OPERANDS];
+	unsigned int mcops[X86_MAX_OPERANDS];
+	uint8_t access[X86_MAX_OPERANDS + 2] = {0};
+	bool dup_seen[X86_MAX_OPERANDS] = {false};
+	unsigned int i, j, count = 0, mcop = 0, opcode;
+	bool has_mem = false, alias = false;
+	cs_x86 *x86;
+	cs_x86_op *op;
+	x86_reg reg, reg2;
+	enum cs_ac_type access1, access2;
+	const uint8_t *arr;
+	uint8_t evex = 0;
+
+	// this instruction does not need printer
+	if (MI->assembly[0])
+		return;
+
+	opcode = MCInst_getOpcode(MI);
+
+	// aliases take their own operands, and skip the prefix handling
+	switch(opcode) {
+		default:
+			break;
+		case X86_AAD8i8:
+		case X86_AAM8i8:
+			if (MCInst_getNumOperands(MI) == 1 &&
+					MCOperand_isImm(MCInst_getOperand(MI, 0)) &&
+					MCOperand_getImm(MCInst_getOperand(MI, 0)) == 10)
+				// "aad" & "aam" have no operand
+				alias = true;
+			break;
+		case X86_XSTORE:
+			alias = true;
+			break;
+#ifndef CAPSTONE_X86_REDUCE
+		case X86_CVTSD2SI64rm:
+			alias = true;
+			break;
+#endif
+	}
+
+	specs = X86_getOperandSpecifiers(opcode);
+	if (!specs)
+		return;
+
+	if (alias && (opcode == X86_AAD8i8 || opcode == X86_AAM8i8))
+		specs = NULL;
+
+	// collect the operands in their printing order, together with the index
+	// of their first MCInst operand. a duplicate of a later operand is
+	// printed at its own position, while a duplicate of an earlier operand
+	// is not printed at all.
+	for (i = 0; specs && i < X86_MAX_OPERANDS; i++) {
+		spec = &specs[i];
+		if (spec->encoding == ENCODING_NONE)
+			continue;
+
+		if (spec->encoding == ENCODING_DUP) {
+			j = spec->type - TYPE_DUP0;
+			spec = &specs[j];
+			if (j > i) {
+				dup_seen[j] = true;
+				ops[count] = spec;
+				mcops[count] = mcop;
+				count++;
+			}
+		} else if (!dup_seen[i]) {
+			ops[count] = spec;
+			mcops[count] = mcop;
+			count++;
+		}
+
+		mcop += spec_num_mcops(spec);
+	}
+
+	if (!MI->csh->detail) {
+		// only pseudo opcode of condition code matters
+		for (i = 0; i < count; i++) {
+			if (is_cc_operand(ops[i]))
+				set_cc(MI, ops[i], MCOperand_getImm(MCInst_getOperand(MI, mcops[i])));
+		}
+
+		return;
+	}
+
+#ifndef CAPSTONE_X86_REDUCE
+	if (!alias) {
+		// normalize LOCK/REP/REPNE prefixes, just like printer does
+		SStream ss;
+
+		SStream_Init(&ss);
+		X86_lockrep(MI, &ss);
+		opcode = MCInst_getOpcode(MI);
+	}
+#endif
+
+	x86 = &MI->flat_insn->detail->x86;
+
+	// operand access is taken from the position of each operand
+	arr = X86_get_op_access(MI, &x86->eflags);
+	if (arr) {
+		for (i = 0; arr[i] && i < ARR_SIZE(access) - 1; i++) {
+			if (arr[i] != CS_AC_IGNORE)
+				access[i] = arr[i];
+		}
+	}
+
+	// EVEX prefix keeps broadcast, zeroing-masking & SAE bits
+	if (x86->opcode[0] == 0x62)
+		evex = x86->opcode[3];
+
+	if (count == 2 && insn_ops_reversed_intel(opcode)) {
+		spec = ops[0];
+		ops[0] = ops[1];
+		ops[1] = spec;
+		mcop = mcops[0];
+		mcops[0] = mcops[1];
+		mcops[1] = mcop;
+	}
+
+	for (i = 0; i < count; i++) {
+		MCOperand *MO = MCInst_getOperand(MI, mcops[i]);
+		spec = ops[i];
+
+		if (is_cc_operand(spec)) {
+			set_cc(MI, spec, MCOperand_getImm(MO));
+			continue;
+		}
+
+		switch(spec->encoding) {
+			default:
+				break;
+			CASE_ENCODING_RM:
+				if (spec_num_mcops(spec) == 1)
+					break;
+
+				// memory reference
+				op = add_mem_op(MI, memory_size(opcode), access);
+				if (!op->size)
+					op->size = opaque_memory_size(MI);
+				op->mem.base = MCOperand_getReg(MCInst_getOperand(MI, mcops[i] + X86_AddrBaseReg));
+				op->mem.index = MCOperand_getReg(MCInst_getOperand(MI, mcops[i] + X86_AddrIndexReg));
+				op->mem.scale = (int)MCOperand_getImm(MCInst_getOperand(MI, mcops[i] + X86_AddrScaleAmt));
+				if (MCOperand_isImm(MCInst_getOperand(MI, mcops[i] + X86_AddrDisp)))
+					op->mem.disp = MCOperand_getImm(MCInst_getOperand(MI, mcops[i] + X86_AddrDisp));
+				reg = MCOperand_getReg(MCInst_getOperand(MI, mcops[i] + X86_AddrSegmentReg));
+				if (reg)
+					op->mem.segment = reg;
+				has_mem = true;
+				continue;
+			case ENCODING_SI:
+				op = add_mem_op(MI, 1 << (spec->type - TYPE_SRCIDX8), access);
+				reg = MCOperand_getReg(MCInst_getOperand(MI, mcops[i] + 1));
+				if (reg)
+					op->mem.segment = reg;
+				op->mem.base = MCOperand_getReg(MO);
+				continue;
+			case ENCODING_DI:
+				op = add_mem_op(MI, 1 << (spec->type - TYPE_DSTIDX8), access);
+				// DI accesses are always ES-based on non-64bit mode
+				if (MI->csh->mode != CS_MODE_64)
+					op->mem.segment = X86_REG_ES;
+				op->mem.base = MCOperand_getReg(MO);
+				continue;
+		}
+
+		switch(spec->type) {
+			default:
+				break;
+			case TYPE_MOFFS8:
+			case TYPE_MOFFS16:
+			case TYPE_MOFFS32:
+			case TYPE_MOFFS64:
+				op = add_mem_op(MI, 1 << (spec->type - TYPE_MOFFS8), access);
+				reg = MCOperand_getReg(MCInst_getOperand(MI, mcops[i] + 1));
+				if (reg)
+					op->mem.segment = reg;
+				if (MCOperand_isImm(MO))
+					op->mem.disp = MCOperand_getImm(MO);
+				continue;
+			case TYPE_REL8:
+			case TYPE_REL16:
+			case TYPE_REL32:
+			case TYPE_REL64:
+			case TYPE_RELv:
+				if (MCOperand_isImm(MO)) {
+					add_pcrel_op(MI, mcops[i], access);
+					continue;
+				}
+				break;
+			case TYPE_UIMM8:
+				if (MCOperand_isImm(MO)) {
+					op = &x86->operands[x86->op_count];
+					op->type = X86_OP_IMM;
+					op->imm = MCOperand_getImm(MO) & 0xff;
+					op->size = 1;
+					op->access = access[x86->op_count];
+					x86->op_count++;
+					continue;
+				}
+				break;
+		}
+
+		if (MCOperand_isReg(MO)) {
+			op = &x86->operands[x86->op_count];
+			op->type = X86_OP_REG;
+			op->reg = MCOperand_getReg(MO);
+			op->size = MI->csh->regsize_map[op->reg];
+			op->access = access[x86->op_count];
+			// zeroing-masking applies to the opmask register
+			if (spec->encoding == ENCODING_WRITEMASK && (evex & 0x80))
+				op->avx_zero_opmask = true;
+			x86->op_count++;
+		} else if (MCOperand_isImm(MO))
+			add_imm_op(MI, mcops[i], access);
+	}
+
+	// some operands are embedded in the asm string by llvm
+	reg = insn_reg_intel_last(opcode);
+	if (reg)
+		op_addReg(MI, reg);
+	else if (insn_imm1_intel_last(opcode))
+		op_addImm(MI, 1);
+
+	if (evex & 0x10) {
+		if (has_mem) {
+			// broadcast a memory element to the whole vector
+			for (i = 0; i < x86->op_count; i++) {
+				op = &x86->operands[i];
+				if (op->type == X86_OP_MEM && op->size) {
+					switch((16 << ((evex >> 5) & 3)) / op->size) {
+						default:
+							break;
+						case 2:
+							op->avx_bcast = X86_AVX_BCAST_2;
+							break;
+						case 4:
+							op->avx_bcast = X86_AVX_BCAST_4;
+							break;
+						case 8:
+							op->avx_bcast = X86_AVX_BCAST_8;
+							break;
+						case 16:
+							op->avx_bcast = X86_AVX_BCAST_16;
+							break;
+					}
+				}
+			}
+		} else
+			x86->avx_sae = true;
+	}
+
+	// first op can be embedded in the asm by llvm.
+	// so we have to add the missing register as the first operand
+	reg = X86_insn_reg_intel(opcode, &access1);
+	if (reg) {
+		// shift all the ops right to leave 1st slot for this new register op
+		memmove(&(x86->operands[1]), &(x86->operands[0]),
+				sizeof(x86->operands[0]) * (ARR_SIZE(x86->operands) - 1));
+		x86->operands[0].type = X86_OP_REG;
+		x86->operands[0].reg = reg;
+		x86->operands[0].size = MI->csh->regsize_map[reg];
+		x86->op_count++;
+	} else if (X86_insn_reg_intel2(opcode, &reg, &access1, &reg2, &access2)) {
+		x86->operands[0].type = X86_OP_REG;
+		x86->operands[0].reg = reg;
+		x86->operands[0].size = MI->csh->regsize_map[reg];
+		x86->operands[1].type = X86_OP_REG;
+		x86->operands[1].reg = reg2;
+		x86->operands[1].size = MI->csh->regsize_map[reg2];
+		x86->op_count = 2;
+	}
+
+	x86->operands[0].access = access[0];
+	x86->operands[1].access = access[1];
+}
+#endif
+
 #endif
@@ -20,7 +20,7 @@ x86_reg x86_map_segment(int r);
 const char *X86_reg_name(csh handle, unsigned int reg);
 
 // given internal insn id, return public instruction info
-void X86_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void X86_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 // return insn name, given insn id
 const char *X86_insn_name(csh handle, unsigned int id);
@@ -61,14 +61,25 @@ void op_addAvxSae(MCInst *MI);
 
 void op_addAvxRoundingMode(MCInst *MI, int v);
 
+// return the pool of implicit registers of instructions for @mode
+const uint16_t *X86_implicit_regs(cs_mode mode);
+
 // given internal insn id, return operand access info
-uint8_t *X86_get_op_access(cs_struct *h, unsigned int id, uint64_t *eflags);
+const uint8_t *X86_get_op_access(const MCInst *MI, uint64_t *eflags);
 
 void X86_reg_access(const cs_insn *insn,
 		cs_regs regs_read, uint8_t *regs_read_count,
 		cs_regs regs_write, uint8_t *regs_write_count);
 
+void X86_reg_access_mask(const cs_insn *insn,
+		uint64_t *regs_read, uint64_t *regs_write);
+
+void X86_reg_fold_aliases(cs_struct *h, const uint64_t *regs, uint64_t *aliases);
+
 // given the instruction id, return the size of its immediate operand (or 0)
 uint8_t X86_immediate_size(unsigned int id, uint8_t *enc_size);
 
+// fill in instruction details without printing (CS_OPT_NOTEXT mode)
+void X86_fill_detail(MCInst *MI);
+
 #endif
@@ -12,10 +12,9 @@
 
 cs_err X86_global_init(cs_struct *ud)
 {
-	MCRegisterInfo *mri;
-	mri = cs_mem_malloc(sizeof(*mri));
-
-	X86_init(mri);
+	// register info is constant & shared by all handles, so the printer
+	// & decoder only read it
+	MCRegisterInfo *mri = (MCRegisterInfo *)X86_getRegisterInfo();
 
 	// by default, we use Intel syntax
 	ud->printer = X86_Intel_printInst;
@@ -29,6 +28,9 @@ cs_err X86_global_init(cs_struct *ud)
 	ud->post_printer = NULL;;
 #ifndef CAPSTONE_DIET
 	ud->reg_access = X86_reg_access;
+	ud->reg_access_mask = X86_reg_access_mask;
+	ud->reg_fold_aliases = X86_reg_fold_aliases;
+	ud->fill_detail = X86_fill_detail;
 #endif
 
 	if (ud->mode == CS_MODE_64)
@@ -36,6 +38,10 @@ cs_err X86_global_init(cs_struct *ud)
 	else
 		ud->regsize_map = regsize_map_32;
 
+#ifndef CAPSTONE_DIET
+	ud->implicit_regs = X86_implicit_regs(ud->mode);
+#endif
+
 	return CS_ERR_OK;
 }
 
@@ -50,6 +56,9 @@ cs_err X86_option(cs_struct *handle, cs_opt_type type, size_t value)
 			else
 				handle->regsize_map = regsize_map_32;
 
+#ifndef CAPSTONE_DIET
+			handle->implicit_regs = X86_implicit_regs((cs_mode)value);
+#endif
 			handle->mode = (cs_mode)value;
 			break;
 		case CS_OPT_SYNTAX:
@@ -63,17 +72,25 @@ cs_err X86_option(cs_struct *handle, cs_opt_type type, size_t value)
 				case CS_OPT_SYNTAX_INTEL:
 					handle->syntax = CS_OPT_SYNTAX_INTEL;
 					handle->printer = X86_Intel_printInst;
+#ifndef CAPSTONE_DIET
+					handle->fill_detail = X86_fill_detail;
+#endif
 					break;
 
 				case CS_OPT_SYNTAX_MASM:
 					handle->printer = X86_Intel_printInst;
 					handle->syntax = (int)value;
+#ifndef CAPSTONE_DIET
+					handle->fill_detail = X86_fill_detail;
+#endif
 					break;
 
 				case CS_OPT_SYNTAX_ATT:
 #if !defined(CAPSTONE_DIET) && !defined(CAPSTONE_X86_ATT_DISABLE)
 					handle->printer = X86_ATT_printInst;
 					handle->syntax = CS_OPT_SYNTAX_ATT;
+					// details in AT&T syntax come from its printer
+					handle->fill_detail = NULL;
 					break;
 #elif !defined(CAPSTONE_DIET) && defined(CAPSTONE_X86_ATT_DISABLE)
 					// ATT syntax is unsupported
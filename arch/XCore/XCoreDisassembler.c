@@ -765,30 +765,33 @@ bool XCore_getInstruction(csh ud, const uint8_t *code, size_t code_len, MCInst *
 	return false;
 }
 
-void XCore_init(MCRegisterInfo *MRI)
-{
-	/*
-	InitMCRegisterInfo(XCoreRegDesc, 17, RA, PC,
-			XCoreMCRegisterClasses, 2,
-			XCoreRegUnitRoots,
-			16,
-			XCoreRegDiffLists,
-			XCoreRegStrings,
-			XCoreSubRegIdxLists,
-			1,
-			XCoreSubRegIdxRanges,
-			XCoreRegEncodingTable);
-	*/
-
-
-	MCRegisterInfo_InitMCRegisterInfo(MRI, XCoreRegDesc, 17,
-			0, 0,
-			XCoreMCRegisterClasses, 2,
-			0, 0,
-			XCoreRegDiffLists,
-			0,
-			XCoreSubRegIdxLists, 1,
-			0);
+/*
+InitMCRegisterInfo(XCoreRegDesc, 17, RA, PC,
+		XCoreMCRegisterClasses, 2,
+		XCoreRegUnitRoots,
+		16,
+		XCoreRegDiffLists,
+		XCoreRegStrings,
+		XCoreSubRegIdxLists,
+		1,
+		XCoreSubRegIdxRanges,
+		XCoreRegEncodingTable);
+*/
+
+// register info is constant, so all handles share this one
+static const MCRegisterInfo XCore_MRI = {
+	XCoreRegDesc, 17,
+	0, 0,
+	XCoreMCRegisterClasses, 2,
+	0, 0,
+	XCoreRegDiffLists, 0,
+	XCoreSubRegIdxLists, 1,
+	0
+};
+
+const MCRegisterInfo *XCore_getRegisterInfo(void)
+{
+	return &XCore_MRI;
 }
 
 #endif
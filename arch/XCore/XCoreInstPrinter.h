@@ -10,7 +10,7 @@
 
 void XCore_printInst(MCInst *MI, SStream *O, void *Info);
 
-void XCore_post_printer(csh ud, cs_insn *insn, char *insn_asm, MCInst *mci);
+void XCore_post_printer(csh ud, cs_insn *insn, MCInst *mci);
 
 // extract details from assembly code @code
 void XCore_insn_extract(MCInst *MI, const char *code);
@@ -10,7 +10,7 @@
 const char *XCore_reg_name(csh handle, unsigned int reg);
 
 // given internal insn id, return public instruction info
-void XCore_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id);
+void XCore_get_insn_id(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 const char *XCore_insn_name(csh handle, unsigned int id);
 
@@ -98,6 +98,7 @@ __all__ = [
     'CS_ERR_SKIPDATA',
     'CS_ERR_X86_ATT',
     'CS_ERR_X86_INTEL',
+    'CS_ERR_PATTERN',
 
     'CS_SUPPORT_DIET',
     'CS_SUPPORT_X86_REDUCE',
@@ -200,6 +201,9 @@ CS_OPT_SKIPDATA = 5  # Skip data when disassembling
 CS_OPT_SKIPDATA_SETUP = 6      # Setup user-defined function for SKIPDATA option
 CS_OPT_MNEMONIC = 7  # Customize instruction mnemonic
 CS_OPT_UNSIGNED = 8  # Print immediate in unsigned form
+CS_OPT_NOTEXT = 9  # Do not generate mnemonic & op_str
+CS_OPT_THREADS = 10  # Number of threads of recursive traversals
+CS_OPT_BRANCH = 11  # Classify control transfers into cs_detail.branch
 
 # Capstone option value
 CS_OPT_OFF = 0             # Turn OFF an option - default option of CS_OPT_DETAIL
@@ -249,6 +253,7 @@ CS_ERR_SKIPDATA = 11 # Access irrelevant data for "data" instruction in SKIPDATA
 CS_ERR_X86_ATT = 12 # X86 AT&T syntax is unsupported (opt-out at compile time)
 CS_ERR_X86_INTEL = 13 # X86 Intel syntax is unsupported (opt-out at compile time)
 CS_ERR_X86_MASM = 14 # X86 Intel syntax is unsupported (opt-out at compile time)
+CS_ERR_PATTERN = 15 # Invalid instruction pattern
 
 # query id for cs_support()
 CS_SUPPORT_DIET = CS_ARCH_ALL + 1
@@ -348,6 +353,12 @@ class _cs_arch(ctypes.Union):
         ('mos65xx', mos65xx.CsMOS65xx),
     )
 
+class _cs_branch(ctypes.Structure):
+    _fields_ = (
+        ('target', ctypes.c_uint64),
+        ('type', ctypes.c_uint8),
+    )
+
 class _cs_detail(ctypes.Structure):
     _fields_ = (
         ('regs_read', ctypes.c_uint16 * 16),
@@ -357,6 +368,9 @@ class _cs_detail(ctypes.Structure):
         ('groups', ctypes.c_ubyte * 8),
         ('groups_count', ctypes.c_ubyte),
         ('arch', _cs_arch),
+        ('groups_mask', ctypes.c_uint64),
+        ('arch_groups_mask', ctypes.c_uint64),
+        ('branch', _cs_branch),
     )
 
 class _cs_insn(ctypes.Structure):
@@ -18,6 +18,14 @@ CAPSTONE_ARCHS ?= arm aarch64 m68k mips powerpc sparc systemz x86 xcore tms320c6
 CAPSTONE_USE_SYS_DYN_MEM ?= yes
 
 
+################################################################################
+# Change 'CAPSTONE_USE_THREADS = yes' to 'CAPSTONE_USE_THREADS = no' to build
+# without threads, so cs_disasm_recursive() & cs_cfg_build() ignore the
+# CS_OPT_THREADS option & always run in the calling thread.
+
+CAPSTONE_USE_THREADS ?= yes
+
+
 ################################################################################
 # Change 'CAPSTONE_DIET = no' to 'CAPSTONE_DIET = yes' to make the library
 # more compact: use less memory & smaller in binary size.
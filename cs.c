@@ -18,6 +18,8 @@
 
 #include "utils.h"
 #include "MCRegisterInfo.h"
+#include "flow.h"
+#include "thread.h"
 
 #if defined(_KERNEL_MODE)
 #include "windows\winkernel_mm.h"
@@ -66,6 +68,26 @@
 #include "arch/XCore/XCoreModule.h"
 #include "arch/MOS65XX/MOS65XXModule.h"
 
+// for arch-specialized iterators, like cs_disasm_iter_x86()
+#ifdef CAPSTONE_HAS_ARM64
+#include "arch/AArch64/AArch64Disassembler.h"
+#include "arch/AArch64/AArch64InstPrinter.h"
+#include "arch/AArch64/AArch64Mapping.h"
+#endif
+#ifdef CAPSTONE_HAS_X86
+#include "arch/X86/X86Disassembler.h"
+#include "arch/X86/X86InstPrinter.h"
+#include "arch/X86/X86Mapping.h"
+#endif
+
+// for size of arch state, see cs_arch_state_size[]
+#ifdef CAPSTONE_HAS_M68K
+#include "arch/M68K/M68KDisassembler.h"
+#endif
+#ifdef CAPSTONE_HAS_M680X
+#include "arch/M680X/M680XDisassemblerInternals.h"
+#endif
+
 // constructor initialization for all archs
 static cs_err (*cs_arch_init[MAX_ARCH])(cs_struct *) = {
 #ifdef CAPSTONE_HAS_ARM
@@ -282,6 +304,53 @@ static cs_mode cs_arch_disallowed_mode_mask[MAX_ARCH] = {
 #endif
 };
 
+// size of mutable per-handle state of each arch, allocated along with the
+// handle & given to the arch as printer_info: to be called in cs_open()
+static const size_t cs_arch_state_size[MAX_ARCH] = {
+	0,	// ARM
+	0,	// ARM64
+	0,	// Mips
+	0,	// X86
+	0,	// PowerPC
+	0,	// Sparc
+	0,	// SystemZ
+	0,	// XCore
+#ifdef CAPSTONE_HAS_M68K
+	sizeof(m68k_info),
+#else
+	0,
+#endif
+	0,	// TMS320C64x
+#ifdef CAPSTONE_HAS_M680X
+	sizeof(m680x_info),
+#else
+	0,
+#endif
+	0,	// EVM
+	0,	// MOS65XX
+};
+
+// arch state starts right after the handle, suitably aligned
+#define HANDLE_SIZE ((sizeof(struct cs_struct) + 15) & ~(size_t)15)
+
+// upper bounds of register, instruction & group IDs of each arch:
+// to be called in cs_reg_id()/cs_insn_id()/cs_group_id() & CS_OPT_MNEMONIC
+static const unsigned int cs_arch_name_max[MAX_ARCH][3] = {
+	{ ARM_REG_ENDING, ARM_INS_ENDING, ARM_GRP_ENDING },
+	{ ARM64_REG_ENDING, ARM64_INS_ENDING, ARM64_GRP_ENDING },
+	{ MIPS_REG_ENDING, MIPS_INS_ENDING, MIPS_GRP_ENDING },
+	{ X86_REG_ENDING, X86_INS_ENDING, X86_GRP_ENDING },
+	{ PPC_REG_ENDING, PPC_INS_ENDING, PPC_GRP_ENDING },
+	{ SPARC_REG_ENDING, SPARC_INS_ENDING, SPARC_GRP_ENDING },
+	{ SYSZ_REG_ENDING, SYSZ_INS_ENDING, SYSZ_GRP_ENDING },
+	{ XCORE_REG_ENDING, XCORE_INS_ENDING, XCORE_GRP_ENDING },
+	{ M68K_REG_ENDING, M68K_INS_ENDING, M68K_GRP_ENDING },
+	{ TMS320C64X_REG_ENDING, TMS320C64X_INS_ENDING, TMS320C64X_GRP_ENDING },
+	{ M680X_REG_ENDING, M680X_INS_ENDING, M680X_GRP_ENDING },
+	{ 0, EVM_INS_ENDING, EVM_GRP_ENDING },	// EVM has no register
+	{ MOS65XX_REG_ENDING, MOS65XX_INS_ENDING, MOS65XX_GRP_ENDING },
+};
+
 // bitmask of enabled architectures
 static uint32_t all_arch = 0
 #ifdef CAPSTONE_HAS_ARM
@@ -373,6 +442,32 @@ cs_vsnprintf_t cs_vsnprintf = NULL;
 
 #endif  // defined(CAPSTONE_USE_SYS_DYN_MEM)
 
+// allocator of handles from cs_open(), forwarding to the global functions
+// of CS_OPT_MEM at the time of each call
+static void * CAPSTONE_API global_malloc(void *user_data, size_t size)
+{
+	return cs_mem_malloc(size);
+}
+
+static void * CAPSTONE_API global_calloc(void *user_data, size_t nmemb, size_t size)
+{
+	return cs_mem_calloc(nmemb, size);
+}
+
+static void * CAPSTONE_API global_realloc(void *user_data, void *ptr, size_t size)
+{
+	return cs_mem_realloc(ptr, size);
+}
+
+static void CAPSTONE_API global_free(void *user_data, void *ptr)
+{
+	cs_mem_free(ptr);
+}
+
+static const cs_opt_mem_handle global_mem = {
+	global_malloc, global_calloc, global_realloc, global_free, NULL
+};
+
 CAPSTONE_EXPORT
 unsigned int CAPSTONE_API cs_version(int *major, int *minor)
 {
@@ -467,17 +562,32 @@ const char * CAPSTONE_API cs_strerror(cs_err code)
 			return "INTEL syntax is unavailable (CS_ERR_X86_INTEL)";
 		case CS_ERR_X86_MASM:
 			return "MASM syntax is unavailable (CS_ERR_X86_MASM)";
+		case CS_ERR_PATTERN:
+			return "Invalid instruction pattern (CS_ERR_PATTERN)";
 	}
 }
 
 CAPSTONE_EXPORT
 cs_err CAPSTONE_API cs_open(cs_arch arch, cs_mode mode, csh *handle)
+{
+	return cs_open_mem(arch, mode, NULL, handle);
+}
+
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_open_mem(cs_arch arch, cs_mode mode,
+		const cs_opt_mem_handle *mem, csh *handle)
 {
 	cs_err err;
 	struct cs_struct *ud;
-	if (!cs_mem_malloc || !cs_mem_calloc || !cs_mem_realloc || !cs_mem_free || !cs_vsnprintf)
-		// Error: before cs_open(), dynamic memory management must be initialized
-		// with cs_option(CS_OPT_MEM)
+
+	if (mem == NULL) {
+		if (!cs_mem_malloc || !cs_mem_calloc || !cs_mem_realloc || !cs_mem_free || !cs_vsnprintf)
+			// Error: before cs_open(), dynamic memory management must be initialized
+			// with cs_option(CS_OPT_MEM)
+			return CS_ERR_MEMSETUP;
+
+		mem = &global_mem;
+	} else if (!mem->malloc || !mem->calloc || !mem->realloc || !mem->free || !cs_vsnprintf)
 		return CS_ERR_MEMSETUP;
 
 	if (arch < CS_ARCH_MAX && cs_arch_init[arch]) {
@@ -487,24 +597,31 @@ cs_err CAPSTONE_API cs_open(cs_arch arch, cs_mode mode, csh *handle)
 			return CS_ERR_MODE;
 		}
 
-		ud = cs_mem_calloc(1, sizeof(*ud));
+		// a single allocation for the handle & its arch state
+		ud = mem->calloc(mem->user_data, 1, HANDLE_SIZE + cs_arch_state_size[arch]);
 		if (!ud) {
 			// memory insufficient
 			return CS_ERR_MEM;
 		}
 
+		if (cs_arch_state_size[arch])
+			ud->printer_info = (uint8_t *)ud + HANDLE_SIZE;
+
+		ud->mem = *mem;
 		ud->errnum = CS_ERR_OK;
 		ud->arch = arch;
 		ud->mode = mode;
 		// by default, do not break instruction into details
 		ud->detail = CS_OPT_OFF;
+		// recursive traversals run in the calling thread
+		ud->threads = 1;
 
 		// default skipdata setup
 		ud->skipdata_setup.mnemonic = SKIPDATA_MNEM;
 
 		err = cs_arch_init[ud->arch](ud);
 		if (err) {
-			cs_mem_free(ud);
+			mem->free(mem->user_data, ud);
 			*handle = 0;
 			return err;
 		}
@@ -518,11 +635,71 @@ cs_err CAPSTONE_API cs_open(cs_arch arch, cs_mode mode, csh *handle)
 	}
 }
 
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_open_arena(cs_arch arch, cs_mode mode,
+		size_t chunk_size, csh *handle)
+{
+	cs_opt_mem_handle mem;
+	cs_arena *arena;
+	cs_err err;
+
+	if (!cs_mem_malloc || !cs_mem_calloc || !cs_mem_realloc || !cs_mem_free || !cs_vsnprintf)
+		return CS_ERR_MEMSETUP;
+
+	arena = arena_new(chunk_size);
+	if (!arena)
+		return CS_ERR_MEM;
+
+	mem.malloc = arena_malloc;
+	mem.calloc = arena_calloc;
+	mem.realloc = arena_realloc;
+	mem.free = arena_free;
+	mem.user_data = arena;
+
+	err = cs_open_mem(arch, mode, &mem, handle);
+	if (err) {
+		arena_destroy(arena);
+		return err;
+	}
+
+	((struct cs_struct *)(*handle))->arena = arena;
+	// cs_arena_reset() keeps what cs_open() allocated
+	arena_mark(arena);
+
+	return CS_ERR_OK;
+}
+
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_arena_reset(csh ud)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle)
+		return CS_ERR_CSH;
+
+	if (!handle->arena) {
+		handle->errnum = CS_ERR_HANDLE;
+		return CS_ERR_HANDLE;
+	}
+
+	// forget everything allocated after cs_open_arena()
+	handle->mnem_table = NULL;
+	handle->mnem_table_size = 0;
+	handle->insn_cache = NULL;
+	memset(&handle->reg_index, 0, sizeof(handle->reg_index));
+	memset(&handle->insn_index, 0, sizeof(handle->insn_index));
+	memset(&handle->group_index, 0, sizeof(handle->group_index));
+
+	arena_reset(handle->arena);
+
+	return CS_ERR_OK;
+}
+
 CAPSTONE_EXPORT
 cs_err CAPSTONE_API cs_close(csh *handle)
 {
 	struct cs_struct *ud;
-	struct insn_mnem *next, *tmp;
+	unsigned int i;
 
 	if (*handle == 0)
 		// invalid handle
@@ -530,21 +707,33 @@ cs_err CAPSTONE_API cs_close(csh *handle)
 
 	ud = (struct cs_struct *)(*handle);
 
-	if (ud->printer_info)
-		cs_mem_free(ud->printer_info);
-
-	// free the linked list of customized mnemonic
-	tmp = ud->mnem_list;
-	while(tmp) {
-		next = tmp->next;
-		cs_mem_free(tmp);
-		tmp = next;
+	if (ud->arena) {
+		// the handle lives in its arena too, so everything goes at once
+		arena_destroy(ud->arena);
+		*handle = 0;
+		return CS_ERR_OK;
 	}
 
-	cs_mem_free(ud->insn_cache);
+	// free the table of customized mnemonic
+	for (i = 0; i < ud->mnem_table_size; i++)
+		HANDLE_FREE(ud, ud->mnem_table[i]);
+	HANDLE_FREE(ud, ud->mnem_table);
+
+	HANDLE_FREE(ud, ud->insn_cache);
+
+#ifndef CAPSTONE_DIET
+	name_index_free(ud, &ud->reg_index);
+	name_index_free(ud, &ud->insn_index);
+	name_index_free(ud, &ud->group_index);
+	HANDLE_FREE(ud, ud->branch_plain);
+#endif
+
+	{
+		cs_opt_mem_handle mem = ud->mem;
 
-	memset(ud, 0, sizeof(*ud));
-	cs_mem_free(ud);
+		memset(ud, 0, sizeof(*ud));
+		mem.free(mem.user_data, ud);
+	}
 
 	// invalidate this handle by ZERO out its value.
 	// this is to make sure it is unusable after cs_close()
@@ -554,12 +743,9 @@ cs_err CAPSTONE_API cs_close(csh *handle)
 }
 
 // fill insn with mnemonic & operands info
-static void fill_insn(struct cs_struct *handle, cs_insn *insn, char *buffer, MCInst *mci,
+static void fill_insn(struct cs_struct *handle, cs_insn *insn, MCInst *mci,
 		PostPrinter_t postprinter, const uint8_t *code)
 {
-#ifndef CAPSTONE_DIET
-	char *sp, *mnem;
-#endif
 	uint16_t copy_size = MIN(sizeof(insn->bytes), insn->size);
 
 	// fill the instruction bytes.
@@ -573,53 +759,37 @@ static void fill_insn(struct cs_struct *handle, cs_insn *insn, char *buffer, MCI
 
 	// post printer handles some corner cases (hacky)
 	if (postprinter)
-		postprinter((csh)handle, insn, buffer, mci);
+		postprinter((csh)handle, insn, mci);
 
-#ifndef CAPSTONE_DIET
-	// fill in mnemonic & operands
-	// find first space or tab
-	mnem = insn->mnemonic;
-	for (sp = buffer; *sp; sp++) {
-		if (*sp == ' '|| *sp == '\t')
-			break;
-		if (*sp == '|')	// lock|rep prefix for x86
-			*sp = ' ';
-		// copy to @mnemonic
-		*mnem = *sp;
-		mnem++;
-	}
+	// groups are final now, so cs_insn_group() can test them with a mask
+	if (handle->detail && insn->detail)
+		map_groups_mask(insn->detail);
 
-	*mnem = '\0';
+#ifndef CAPSTONE_DIET
+	if (handle->branch && handle->detail && insn->detail) {
+		cs_flow flow;
 
-	// we might have customized mnemonic
-	if (handle->mnem_list) {
-		struct insn_mnem *tmp = handle->mnem_list;
-		while(tmp) {
-			if (tmp->insn.id == insn->id) {
-				// found this instruction, so copy its mnemonic
-				(void)strncpy(insn->mnemonic, tmp->insn.mnemonic, sizeof(insn->mnemonic) - 1);
-				insn->mnemonic[sizeof(insn->mnemonic) - 1] = '\0';
-				break;
-			}
-			tmp = tmp->next;
-		}
+		Flow_get(handle, insn, &flow);
+		Flow_branch(&flow, &insn->detail->branch);
 	}
 
-	// copy @op_str
-	if (*sp) {
-		// find the next non-space char
-		sp++;
-		for (; ((*sp == ' ') || (*sp == '\t')); sp++);
-		strncpy(insn->op_str, sp, sizeof(insn->op_str) - 1);
-		insn->op_str[sizeof(insn->op_str) - 1] = '\0';
-	} else
+	// no mnemonic & operands in CS_OPT_NOTEXT mode
+	if (handle->notext) {
+		insn->mnemonic[0] = '\0';
 		insn->op_str[0] = '\0';
+		return;
+	}
+
+	// mnemonic & operands are already in place, but
+	// we might have customized mnemonic
+	if (insn->id < handle->mnem_table_size && handle->mnem_table[insn->id])
+		memcpy(insn->mnemonic, handle->mnem_table[insn->id], sizeof(insn->mnemonic));
 #endif
 }
 
 // how many bytes will we skip when encountering data (CS_OPT_SKIPDATA)?
 // this very much depends on instruction alignment requirement of each arch.
-static uint8_t skipdata_size(cs_struct *handle)
+uint8_t skipdata_size(cs_struct *handle)
 {
 	switch(handle->arch) {
 		default:
@@ -666,6 +836,24 @@ static uint8_t skipdata_size(cs_struct *handle)
 	}
 }
 
+// size of all instructions of the arch of @handle, or 0 if it varies
+unsigned int insn_fixed_size(cs_struct *handle)
+{
+	switch (handle->arch) {
+		default:
+			return 0;
+		case CS_ARCH_ARM:
+			return (handle->mode & CS_MODE_THUMB) ? 0 : 4;
+		case CS_ARCH_MIPS:
+			return (handle->mode & CS_MODE_MICRO) ? 0 : 4;
+		case CS_ARCH_ARM64:
+		case CS_ARCH_PPC:
+		case CS_ARCH_SPARC:
+		case CS_ARCH_TMS320C64X:
+			return 4;
+	}
+}
+
 CAPSTONE_EXPORT
 cs_err CAPSTONE_API cs_option(csh ud, cs_opt_type type, size_t value)
 {
@@ -698,10 +886,27 @@ cs_err CAPSTONE_API cs_option(csh ud, cs_opt_type type, size_t value)
 			handle->imm_unsigned = (cs_opt_value)value;
 			return CS_ERR_OK;
 
+		case CS_OPT_NOTEXT:
+			handle->notext = (value == CS_OPT_ON);
+			return CS_ERR_OK;
+
 		case CS_OPT_DETAIL:
 			handle->detail = (cs_opt_value)value;
 			return CS_ERR_OK;
 
+		case CS_OPT_THREADS:
+			handle->threads = (unsigned int)value;
+			return CS_ERR_OK;
+
+		case CS_OPT_BRANCH:
+#ifdef CAPSTONE_DIET
+			// branches are classified from the detail, which diet engines lack
+			return CS_ERR_DIET;
+#else
+			handle->branch = (value == CS_OPT_ON);
+			return CS_ERR_OK;
+#endif
+
 		case CS_OPT_SKIPDATA:
 			handle->skipdata = (value == CS_OPT_ON);
 			if (handle->skipdata) {
@@ -721,53 +926,42 @@ cs_err CAPSTONE_API cs_option(csh ud, cs_opt_type type, size_t value)
 			opt = (cs_opt_mnem *)value;
 			if (opt->id) {
 				if (opt->mnemonic) {
-					struct insn_mnem *tmp;
-
 					// add new instruction, or replace existing instruction
-					// 1. find if we already had this insn in the linked list
-					tmp = handle->mnem_list;
-					while(tmp) {
-						if (tmp->insn.id == opt->id) {
-							// found this instruction, so replace its mnemonic
-							(void)strncpy(tmp->insn.mnemonic, opt->mnemonic, sizeof(tmp->insn.mnemonic) - 1);
-							tmp->insn.mnemonic[sizeof(tmp->insn.mnemonic) - 1] = '\0';
-							break;
+					// 1. only instructions of this arch can be customized
+					if (opt->id >= cs_arch_name_max[handle->arch][1]) {
+						handle->errnum = CS_ERR_OPTION;
+						return CS_ERR_OPTION;
+					}
+
+					// the table covers all instructions once allocated
+					if (!handle->mnem_table) {
+						handle->mnem_table = HANDLE_CALLOC(handle,
+								cs_arch_name_max[handle->arch][1], sizeof(char *));
+						if (!handle->mnem_table) {
+							handle->errnum = CS_ERR_MEM;
+							return CS_ERR_MEM;
 						}
-						tmp = tmp->next;
+						handle->mnem_table_size = cs_arch_name_max[handle->arch][1];
 					}
 
 					// 2. add this instruction if we have not had it yet
-					if (!tmp) {
-						tmp = cs_mem_malloc(sizeof(*tmp));
-						tmp->insn.id = opt->id;
-						(void)strncpy(tmp->insn.mnemonic, opt->mnemonic, sizeof(tmp->insn.mnemonic) - 1);
-						tmp->insn.mnemonic[sizeof(tmp->insn.mnemonic) - 1] = '\0';
-						// this new instruction is heading the list
-						tmp->next = handle->mnem_list;
-						handle->mnem_list = tmp;
+					if (!handle->mnem_table[opt->id]) {
+						handle->mnem_table[opt->id] = HANDLE_MALLOC(handle, CS_MNEMONIC_SIZE);
+						if (!handle->mnem_table[opt->id]) {
+							handle->errnum = CS_ERR_MEM;
+							return CS_ERR_MEM;
+						}
 					}
+
+					// 3. replace its mnemonic
+					(void)strncpy(handle->mnem_table[opt->id], opt->mnemonic, CS_MNEMONIC_SIZE - 1);
+					handle->mnem_table[opt->id][CS_MNEMONIC_SIZE - 1] = '\0';
 					return CS_ERR_OK;
 				} else {
-					struct insn_mnem *prev, *tmp;
-
 					// we want to delete an existing instruction
-					// iterate the list to find the instruction to remove it
-					tmp = handle->mnem_list;
-					prev = tmp;
-					while(tmp) {
-						if (tmp->insn.id == opt->id) {
-							// delete this instruction
-							if (tmp == prev) {
-								// head of the list
-								handle->mnem_list = tmp->next;
-							} else {
-								prev->next = tmp->next;
-							}
-							cs_mem_free(tmp);
-							break;
-						}
-						prev = tmp;
-						tmp = tmp->next;
+					if (opt->id < handle->mnem_table_size) {
+						HANDLE_FREE(handle, handle->mnem_table[opt->id]);
+						handle->mnem_table[opt->id] = NULL;
 					}
 				}
 			}
@@ -778,6 +972,14 @@ cs_err CAPSTONE_API cs_option(csh ud, cs_opt_type type, size_t value)
 			if (value & cs_arch_disallowed_mode_mask[handle->arch]) {
 				return CS_ERR_OPTION;
 			}
+			// names of registers can depend on mode, as well as on syntax
+			// fall through
+		case CS_OPT_SYNTAX:
+#ifndef CAPSTONE_DIET
+			name_index_free(handle, &handle->reg_index);
+			name_index_free(handle, &handle->insn_index);
+			name_index_free(handle, &handle->group_index);
+#endif
 			break;
 	}
 
@@ -788,31 +990,32 @@ cs_err CAPSTONE_API cs_option(csh ud, cs_opt_type type, size_t value)
 #ifndef CAPSTONE_DIET
 static void skipdata_opstr(char *opstr, const uint8_t *buffer, size_t size)
 {
+	static const char hex[] = "0123456789abcdef";
 	char *p = opstr;
-	int len;
+	// leave room for the terminating NUL
+	char *end = opstr + sizeof(((cs_insn*)NULL)->op_str) - 1;
+	char item[6] = { ',', ' ', '0', 'x' };
 	size_t i;
-	size_t available = sizeof(((cs_insn*)NULL)->op_str);
 
-	if (!size) {
-		opstr[0] = '\0';
-		return;
-	}
+	for (i = 0; i < size; i++) {
+		const char *s = i ? item : item + 2;
+		size_t len = i ? 6 : 4;
 
-	len = cs_snprintf(p, available, "0x%02x", buffer[0]);
-	p+= len;
-	available -= len;
+		item[4] = hex[buffer[i] >> 4];
+		item[5] = hex[buffer[i] & 0xf];
 
-	for(i = 1; i < size; i++) {
-		len = cs_snprintf(p, available, ", 0x%02x", buffer[i]);
-		if (len < 0) {
+		if (len > (size_t)(end - p)) {
+			// truncate the last item, like snprintf() would
+			memcpy(p, s, end - p);
+			p = end;
 			break;
 		}
-		if ((size_t)len > available - 1) {
-			break;
-		}
-		p+= len;
-		available -= len;
+
+		memcpy(p, s, len);
+		p += len;
 	}
+
+	*p = '\0';
 }
 #endif
 
@@ -862,7 +1065,7 @@ size_t CAPSTONE_API cs_disasm(csh ud, const uint8_t *buffer, size_t size, uint64
 	size_org = size;
 
 	total_size = sizeof(cs_insn) * cache_size;
-	total = cs_mem_malloc(total_size);
+	total = HANDLE_MALLOC(handle, total_size);
 	if (total == NULL) {
 		// insufficient memory
 		handle->errnum = CS_ERR_MEM;
@@ -880,7 +1083,7 @@ size_t CAPSTONE_API cs_disasm(csh ud, const uint8_t *buffer, size_t size, uint64
 
 		if (handle->detail) {
 			// allocate memory for @detail pointer
-			insn_cache->detail = cs_mem_malloc(sizeof(cs_detail));
+			insn_cache->detail = HANDLE_MALLOC(handle, sizeof(cs_detail));
 		} else {
 			insn_cache->detail = NULL;
 		}
@@ -888,6 +1091,8 @@ size_t CAPSTONE_API cs_disasm(csh ud, const uint8_t *buffer, size_t size, uint64
 		// save all the information for non-detailed mode
 		mci.flat_insn = insn_cache;
 		mci.flat_insn->address = offset;
+		// opcodes without a public ID stay invalid, rather than keep the last one
+		mci.flat_insn->id = 0;
 #ifdef CAPSTONE_DIET
 		// zero out mnemonic & op_str
 		mci.flat_insn->mnemonic[0] = '\0';
@@ -896,17 +1101,24 @@ size_t CAPSTONE_API cs_disasm(csh ud, const uint8_t *buffer, size_t size, uint64
 
 		r = handle->disasm(ud, buffer, size, &mci, &insn_size, offset, handle->getinsn_info);
 		if (r) {
+			// the printer writes mnemonic & operands straight into the insn
 			SStream ss;
-			SStream_Init(&ss);
+			SStream_InitInsn(&ss, insn_cache->mnemonic, insn_cache->op_str);
 
 			mci.flat_insn->size = insn_size;
 
 			// map internal instruction opcode to public insn ID
 
-			handle->insn_id(handle, insn_cache, mci.Opcode);
+			handle->insn_id(handle, insn_cache, mci.Opcode, &mci);
 
-			handle->printer(&mci, &ss, handle->printer_info);
-			fill_insn(handle, insn_cache, ss.buffer, &mci, handle->post_printer, buffer);
+			if (handle->notext && handle->fill_detail) {
+				// build details straight from the decoded instruction
+				handle->fill_detail(&mci);
+				fill_insn(handle, insn_cache, &mci, NULL, buffer);
+			} else {
+				handle->printer(&mci, &ss, handle->printer_info);
+				fill_insn(handle, insn_cache, &mci, handle->post_printer, buffer);
+			}
 
 			// adjust for pseudo opcode (X86)
 			if (handle->arch == CS_ARCH_X86)
@@ -915,10 +1127,9 @@ size_t CAPSTONE_API cs_disasm(csh ud, const uint8_t *buffer, size_t size, uint64
 			next_offset = insn_size;
 		} else	{
 			// encounter a broken instruction
-
 			// free memory of @detail pointer
 			if (handle->detail) {
-				cs_mem_free(insn_cache->detail);
+				HANDLE_FREE(handle, insn_cache->detail);
 			}
 
 			// if there is no request to skip data, or remaining data is too small,
@@ -970,15 +1181,15 @@ size_t CAPSTONE_API cs_disasm(csh ud, const uint8_t *buffer, size_t size, uint64
 			// full cache, so expand the cache to contain incoming insns
 			cache_size = cache_size * 8 / 5; // * 1.6 ~ golden ratio
 			total_size += (sizeof(cs_insn) * cache_size);
-			tmp = cs_mem_realloc(total, total_size);
+			tmp = HANDLE_REALLOC(handle, total, total_size);
 			if (tmp == NULL) {	// insufficient memory
 				if (handle->detail) {
 					insn_cache = (cs_insn *)total;
 					for (i = 0; i < c; i++, insn_cache++)
-						cs_mem_free(insn_cache->detail);
+						HANDLE_FREE(handle, insn_cache->detail);
 				}
 
-				cs_mem_free(total);
+				HANDLE_FREE(handle, total);
 				*insn = NULL;
 				handle->errnum = CS_ERR_MEM;
 				return 0;
@@ -1000,20 +1211,20 @@ size_t CAPSTONE_API cs_disasm(csh ud, const uint8_t *buffer, size_t size, uint64
 
 	if (!c) {
 		// we did not disassemble any instruction
-		cs_mem_free(total);
+		HANDLE_FREE(handle, total);
 		total = NULL;
 	} else if (f != cache_size) {
 		// total did not fully use the last cache, so downsize it
-		tmp = cs_mem_realloc(total, total_size - (cache_size - f) * sizeof(*insn_cache));
+		tmp = HANDLE_REALLOC(handle, total, total_size - (cache_size - f) * sizeof(*insn_cache));
 		if (tmp == NULL) {	// insufficient memory
 			// free all detail pointers
 			if (handle->detail) {
 				insn_cache = (cs_insn *)total;
 				for (i = 0; i < c; i++, insn_cache++)
-					cs_mem_free(insn_cache->detail);
+					HANDLE_FREE(handle, insn_cache->detail);
 			}
 
-			cs_mem_free(total);
+			HANDLE_FREE(handle, total);
 			*insn = NULL;
 
 			handle->errnum = CS_ERR_MEM;
@@ -1048,13 +1259,30 @@ void CAPSTONE_API cs_free(cs_insn *insn, size_t count)
 	cs_mem_free(insn);
 }
 
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_handle_free(csh ud, cs_insn *insn, size_t count)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+	size_t i;
+
+	if (!handle)
+		return;
+
+	// free all detail pointers
+	for (i = 0; i < count; i++)
+		HANDLE_FREE(handle, insn[i].detail);
+
+	// then free pointer to cs_insn array
+	HANDLE_FREE(handle, insn);
+}
+
 CAPSTONE_EXPORT
 cs_insn * CAPSTONE_API cs_malloc(csh ud)
 {
 	cs_insn *insn;
 	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
 
-	insn = cs_mem_malloc(sizeof(cs_insn));
+	insn = HANDLE_MALLOC(handle, sizeof(cs_insn));
 	if (!insn) {
 		// insufficient memory
 		handle->errnum = CS_ERR_MEM;
@@ -1062,9 +1290,9 @@ cs_insn * CAPSTONE_API cs_malloc(csh ud)
 	} else {
 		if (handle->detail) {
 			// allocate memory for @detail pointer
-			insn->detail = cs_mem_malloc(sizeof(cs_detail));
+			insn->detail = HANDLE_MALLOC(handle, sizeof(cs_detail));
 			if (insn->detail == NULL) {	// insufficient memory
-				cs_mem_free(insn);
+				HANDLE_FREE(handle, insn);
 				handle->errnum = CS_ERR_MEM;
 				return NULL;
 			}
@@ -1075,21 +1303,26 @@ cs_insn * CAPSTONE_API cs_malloc(csh ud)
 	return insn;
 }
 
-// iterator for instruction "single-stepping"
-CAPSTONE_EXPORT
-bool CAPSTONE_API cs_disasm_iter(csh ud, const uint8_t **code, size_t *size,
-		uint64_t *address, cs_insn *insn)
+// force inlining of the iterator into the arch-specialized entry points,
+// so the callbacks given to it become direct (and inlinable) calls
+#if defined(_MSC_VER)
+#define ITER_INLINE static __forceinline
+#elif defined(__GNUC__)
+#define ITER_INLINE static inline __attribute__((always_inline))
+#else
+#define ITER_INLINE static
+#endif
+
+// body of cs_disasm_iter() & its arch-specialized versions
+ITER_INLINE bool disasm_iter(struct cs_struct *handle, const uint8_t **code, size_t *size,
+		uint64_t *address, cs_insn *insn, cs_arch arch, Disasm_t disasm,
+		GetID_t insn_id, Printer_t printer, PostPrinter_t post_printer,
+		FillDetail_t fill_detail, bool skipdata)
 {
-	struct cs_struct *handle;
 	uint16_t insn_size;
 	MCInst mci;
 	bool r;
 
-	handle = (struct cs_struct *)(uintptr_t)ud;
-	if (!handle) {
-		return false;
-	}
-
 	handle->errnum = CS_ERR_OK;
 
 	MCInst_Init(&mci);
@@ -1101,28 +1334,36 @@ bool CAPSTONE_API cs_disasm_iter(csh ud, const uint8_t **code, size_t *size,
 	// save all the information for non-detailed mode
 	mci.flat_insn = insn;
 	mci.flat_insn->address = *address;
+	// opcodes without a public ID stay invalid, rather than keep the last one
+	mci.flat_insn->id = 0;
 #ifdef CAPSTONE_DIET
 	// zero out mnemonic & op_str
 	mci.flat_insn->mnemonic[0] = '\0';
 	mci.flat_insn->op_str[0] = '\0';
 #endif
 
-	r = handle->disasm(ud, *code, *size, &mci, &insn_size, *address, handle->getinsn_info);
+	r = disasm((csh)handle, *code, *size, &mci, &insn_size, *address, handle->getinsn_info);
 	if (r) {
+		// the printer writes mnemonic & operands straight into the insn
 		SStream ss;
-		SStream_Init(&ss);
+		SStream_InitInsn(&ss, insn->mnemonic, insn->op_str);
 
 		mci.flat_insn->size = insn_size;
 
 		// map internal instruction opcode to public insn ID
-		handle->insn_id(handle, insn, mci.Opcode);
-
-		handle->printer(&mci, &ss, handle->printer_info);
+		insn_id(handle, insn, mci.Opcode, &mci);
 
-		fill_insn(handle, insn, ss.buffer, &mci, handle->post_printer, *code);
+		if (handle->notext && fill_detail) {
+			// build details straight from the decoded instruction
+			fill_detail(&mci);
+			fill_insn(handle, insn, &mci, NULL, *code);
+		} else {
+			printer(&mci, &ss, handle->printer_info);
+			fill_insn(handle, insn, &mci, post_printer, *code);
+		}
 
 		// adjust for pseudo opcode (X86)
-		if (handle->arch == CS_ARCH_X86)
+		if (arch == CS_ARCH_X86)
 			insn->id += mci.popcode_adjust;
 
 		*code += insn_size;
@@ -1133,7 +1374,7 @@ bool CAPSTONE_API cs_disasm_iter(csh ud, const uint8_t **code, size_t *size,
 
 		// if there is no request to skip data, or remaining data is too small,
 		// then bail out
-		if (!handle->skipdata || handle->skipdata_size > *size)
+		if (!skipdata || handle->skipdata_size > *size)
 			return false;
 
 		if (handle->skipdata_setup.callback) {
@@ -1171,102 +1412,1726 @@ bool CAPSTONE_API cs_disasm_iter(csh ud, const uint8_t **code, size_t *size,
 	return true;
 }
 
-// return friendly name of regiser in a string
+// iterator for instruction "single-stepping"
 CAPSTONE_EXPORT
-const char * CAPSTONE_API cs_reg_name(csh ud, unsigned int reg)
+bool CAPSTONE_API cs_disasm_iter(csh ud, const uint8_t **code, size_t *size,
+		uint64_t *address, cs_insn *insn)
 {
-	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+	struct cs_struct *handle;
 
-	if (!handle || handle->reg_name == NULL) {
-		return NULL;
+	handle = (struct cs_struct *)(uintptr_t)ud;
+	if (!handle) {
+		return false;
 	}
 
-	return handle->reg_name(ud, reg);
+	return disasm_iter(handle, code, size, address, insn, handle->arch,
+			handle->disasm, handle->insn_id, handle->printer,
+			handle->post_printer, handle->fill_detail, handle->skipdata);
 }
 
 CAPSTONE_EXPORT
-const char * CAPSTONE_API cs_insn_name(csh ud, unsigned int insn)
+bool CAPSTONE_API cs_disasm_iter_x86(csh ud, const uint8_t **code, size_t *size,
+		uint64_t *address, cs_insn *insn)
 {
-	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+	struct cs_struct *handle;
 
-	if (!handle || handle->insn_name == NULL) {
-		return NULL;
+	handle = (struct cs_struct *)(uintptr_t)ud;
+	if (!handle) {
+		return false;
 	}
 
-	return handle->insn_name(ud, insn);
-}
-
-CAPSTONE_EXPORT
-const char * CAPSTONE_API cs_group_name(csh ud, unsigned int group)
-{
-	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
-
-	if (!handle || handle->group_name == NULL) {
-		return NULL;
+#ifdef CAPSTONE_HAS_X86
+	if (handle->arch == CS_ARCH_X86) {
+		// only the default Intel syntax is dispatched statically
+		if (handle->printer == X86_Intel_printInst)
+			return disasm_iter(handle, code, size, address, insn, CS_ARCH_X86,
+					X86_getInstruction, X86_get_insn_id, X86_Intel_printInst,
+					NULL, handle->fill_detail, handle->skipdata);
+
+		return disasm_iter(handle, code, size, address, insn, CS_ARCH_X86,
+				X86_getInstruction, X86_get_insn_id, handle->printer,
+				NULL, handle->fill_detail, handle->skipdata);
 	}
+#endif
 
-	return handle->group_name(ud, group);
+	handle->errnum = CS_ERR_ARCH;
+	return false;
 }
 
 CAPSTONE_EXPORT
-bool CAPSTONE_API cs_insn_group(csh ud, const cs_insn *insn, unsigned int group_id)
+bool CAPSTONE_API cs_disasm_iter_arm64(csh ud, const uint8_t **code, size_t *size,
+		uint64_t *address, cs_insn *insn)
 {
 	struct cs_struct *handle;
-	if (!ud)
-		return false;
 
 	handle = (struct cs_struct *)(uintptr_t)ud;
-
-	if (!handle->detail) {
-		handle->errnum = CS_ERR_DETAIL;
+	if (!handle) {
 		return false;
 	}
 
-	if (!insn->id) {
-		handle->errnum = CS_ERR_SKIPDATA;
-		return false;
-	}
+#ifdef CAPSTONE_HAS_ARM64
+	if (handle->arch == CS_ARCH_ARM64)
+		return disasm_iter(handle, code, size, address, insn, CS_ARCH_ARM64,
+				AArch64_getInstruction, AArch64_get_insn_id, AArch64_printInst,
+				AArch64_post_printer, handle->fill_detail, handle->skipdata);
+#endif
 
-	if (!insn->detail) {
-		handle->errnum = CS_ERR_DETAIL;
-		return false;
-	}
+	handle->errnum = CS_ERR_ARCH;
+	return false;
+}
 
-	return arr_exist8(insn->detail->groups, insn->detail->groups_count, group_id);
+#ifndef CAPSTONE_DIET
+// worklist of a traversal: its owner pushes & pops paths at the tail, while
+// other threads of a parallel traversal steal them at the head
+typedef struct walk_todo {
+	size_t *items;	// offsets of paths left to follow
+	size_t head, tail, size;
+#ifdef CAPSTONE_HAS_THREADS
+	cs_mutex lock;
+#endif
+} walk_todo;
+
+struct walker;
+
+// state of a recursive traversal, shared by all its threads
+typedef struct walk_state {
+	const uint8_t *code;
+	size_t code_size;
+	uint64_t address;
+	uint8_t *done;	// one bit per offset: the instruction there is in the output
+	uint8_t *cont;	// one bit per offset: a path went on past the instruction there
+	size_t *rank;	// number of instructions before each group of 64 offsets
+	bool detail;	// return the detail of instructions
+	bool flows;	// return the flow of instructions
+	struct walker *walkers;
+	unsigned int count;	// number of walkers
+	long pending;	// paths pushed, but not followed to their end yet
+	long failed;	// a walker ran out of memory
+	cs_insn *insns;	// output sorted by address, with its flow
+	cs_flow *flow_out;
+} walk_state;
+
+// a thread of a traversal, with its own decoder, worklist & output
+typedef struct walker {
+	struct cs_struct *handle;
+	walk_state *state;
+	walk_todo todo;
+	cs_insn *insns;
+	cs_flow *flows;
+	// details are allocated by the caller's handle, unless it cannot be used from
+	// this thread: then they are kept here, until copied in the calling thread
+	cs_detail *details;
+	bool aside;
+	size_t count, size;
+	cs_insn scratch;
+	cs_detail scratch_detail;
+#ifdef CAPSTONE_HAS_THREADS
+	cs_thread thread;
+	bool started;
+#endif
+} walker;
+
+static void todo_lock(walker *w)
+{
+#ifdef CAPSTONE_HAS_THREADS
+	if (w->state->count > 1)
+		Mutex_lock(&w->todo.lock);
+#endif
 }
 
-CAPSTONE_EXPORT
-bool CAPSTONE_API cs_reg_read(csh ud, const cs_insn *insn, unsigned int reg_id)
+static void todo_unlock(walker *w)
 {
-	struct cs_struct *handle;
-	if (!ud)
-		return false;
+#ifdef CAPSTONE_HAS_THREADS
+	if (w->state->count > 1)
+		Mutex_unlock(&w->todo.lock);
+#endif
+}
 
-	handle = (struct cs_struct *)(uintptr_t)ud;
+// add a path starting at @offset to the worklist of @w
+static bool todo_push(walker *w, size_t offset)
+{
+	walk_todo *t = &w->todo;
+	size_t *tmp;
+	bool ok = true;
+
+	ATOMIC_ADD(&w->state->pending, 1);
+
+	todo_lock(w);
+	if (t->tail == t->size) {
+		if (t->head >= t->size / 2 && t->head) {
+			// reuse the room left by stolen paths
+			memmove(t->items, t->items + t->head, (t->tail - t->head) * sizeof(*t->items));
+			t->tail -= t->head;
+			t->head = 0;
+		} else {
+			size_t size = t->size ? t->size * 2 : 64;
 
-	if (!handle->detail) {
-		handle->errnum = CS_ERR_DETAIL;
-		return false;
+			tmp = HANDLE_REALLOC(w->handle, t->items, size * sizeof(*tmp));
+			if (tmp) {
+				t->items = tmp;
+				t->size = size;
+			} else
+				ok = false;
+		}
 	}
 
-	if (!insn->id) {
-		handle->errnum = CS_ERR_SKIPDATA;
-		return false;
-	}
+	if (ok)
+		t->items[t->tail++] = offset;
+	todo_unlock(w);
 
-	if (!insn->detail) {
-		handle->errnum = CS_ERR_DETAIL;
-		return false;
-	}
+	if (!ok)
+		ATOMIC_ADD(&w->state->pending, -1);
 
-	return arr_exist(insn->detail->regs_read, insn->detail->regs_read_count, reg_id);
+	return ok;
 }
 
-CAPSTONE_EXPORT
-bool CAPSTONE_API cs_reg_write(csh ud, const cs_insn *insn, unsigned int reg_id)
+// take the latest path of @w
+static bool todo_pop(walker *w, size_t *offset)
 {
-	struct cs_struct *handle;
-	if (!ud)
+	walk_todo *t = &w->todo;
+	bool ok;
+
+	todo_lock(w);
+	ok = t->tail > t->head;
+	if (ok) {
+		*offset = t->items[--t->tail];
+		if (t->tail == t->head)
+			t->head = t->tail = 0;
+	}
+	todo_unlock(w);
+
+	return ok;
+}
+
+// take the oldest path of another walker, which likely leads to the most work
+static bool todo_steal(walker *w, size_t *offset)
+{
+	walk_state *s = w->state;
+	unsigned int i;
+
+	for (i = 1; i < s->count; i++) {
+		walker *v = &s->walkers[(w - s->walkers + i) % s->count];
+		walk_todo *t = &v->todo;
+		bool ok;
+
+		todo_lock(v);
+		ok = t->tail > t->head;
+		if (ok) {
+			*offset = t->items[t->head++];
+			if (t->tail == t->head)
+				t->head = t->tail = 0;
+		}
+		todo_unlock(v);
+
+		if (ok)
+			return true;
+	}
+
+	return false;
+}
+
+// append the instruction just decoded by @w to its output
+static bool walk_output(walker *w, const cs_flow *flow)
+{
+	walk_state *s = w->state;
+	cs_insn *insn;
+
+	if (w->count == w->size) {
+		// grow the output like cs_disasm() does
+		size_t size = w->size ? w->size * 8 / 5 : INSN_CACHE_SIZE;
+		void *tmp;
+
+		tmp = HANDLE_REALLOC(w->handle, w->insns, size * sizeof(*w->insns));
+		if (!tmp)
+			return false;
+		w->insns = tmp;
+
+		if (s->flows) {
+			tmp = HANDLE_REALLOC(w->handle, w->flows, size * sizeof(*w->flows));
+			if (!tmp)
+				return false;
+			w->flows = tmp;
+		}
+
+		if (w->aside) {
+			tmp = HANDLE_REALLOC(w->handle, w->details, size * sizeof(*w->details));
+			if (!tmp)
+				return false;
+			w->details = tmp;
+		}
+
+		w->size = size;
+	}
+
+	insn = &w->insns[w->count];
+	*insn = w->scratch;
+	insn->detail = NULL;
+
+	if (w->aside)
+		w->details[w->count] = w->scratch_detail;
+	else if (s->detail) {
+		insn->detail = HANDLE_MALLOC(w->handle, sizeof(cs_detail));
+		if (!insn->detail)
+			return false;
+		memcpy(insn->detail, &w->scratch_detail, sizeof(cs_detail));
+	}
+
+	if (s->flows)
+		w->flows[w->count] = *flow;
+
+	w->count++;
+
+	return true;
+}
+
+// follow the path starting at @offset, until an unconditional transfer or
+// an instruction some other path went on past already
+static bool walk_path(walker *w, size_t offset)
+{
+	walk_state *s = w->state;
+	struct cs_struct *handle = w->handle;
+	unsigned int stop = 0;	// delay slots left before the path ends
+	cs_flow flow;
+
+	// a path can start anywhere, so forget the IT block of the last one
+	if (handle->arch == CS_ARCH_ARM)
+		handle->ITBlock.size = 0;
+
+	while (offset < s->code_size) {
+		const uint8_t *p = s->code + offset;
+		size_t size = s->code_size - offset;
+		uint64_t addr = s->address + offset;
+		uint8_t bit = 1 << (offset % 8);
+
+		// a delay slot does not claim the path past it, which thus
+		// does not depend on which path reached the delay slot first
+		if (!stop && (ATOMIC_OR8(&s->cont[offset / 8], bit) & bit))
+			break;
+
+		if (!disasm_iter(handle, &p, &size, &addr, &w->scratch, handle->arch,
+					handle->disasm, handle->insn_id, handle->printer,
+					handle->post_printer, handle->fill_detail, false))
+			// invalid instruction ends the path
+			break;
+
+		Flow_get(handle, &w->scratch, &flow);
+
+		// only the first path decoding this instruction outputs it
+		if (!(ATOMIC_OR8(&s->done[offset / 8], bit) & bit) && !walk_output(w, &flow))
+			return false;
+
+		offset += w->scratch.size;
+
+		if (flow.type && !(flow.flags & (FLOW_INDIRECT | FLOW_MODE_SWITCH)) &&
+				flow.target >= s->address && flow.target - s->address < s->code_size) {
+			size_t target = (size_t)(flow.target - s->address);
+
+			if (!(ATOMIC_LOAD8(&s->cont[target / 8]) & (1 << (target % 8))) &&
+					!todo_push(w, target))
+				return false;
+		}
+
+		if (stop) {
+			if (!--stop)
+				break;
+		} else if ((flow.type == FLOW_JUMP || flow.type == FLOW_RET) &&
+				!(flow.flags & FLOW_COND)) {
+			// nothing after an unconditional transfer, but its delay slots
+			if (!flow.delay)
+				break;
+			stop = flow.delay;
+		}
+	}
+
+	return true;
+}
+
+// follow paths of @arg (a walker), or of other walkers, until none is left
+static void walk_thread(void *arg)
+{
+	walker *w = (walker *)arg;
+	walk_state *s = w->state;
+	size_t offset;
+
+	while (!ATOMIC_LOAD(&s->failed)) {
+		if (todo_pop(w, &offset) || todo_steal(w, &offset)) {
+			if (!walk_path(w, offset))
+				ATOMIC_ADD(&s->failed, 1);
+			ATOMIC_ADD(&s->pending, -1);
+		} else if (!ATOMIC_LOAD(&s->pending))
+			break;
+#ifdef CAPSTONE_HAS_THREADS
+		else
+			// paths being followed by others might push new ones
+			Thread_yield();
+#endif
+	}
+}
+
+static unsigned int popcount8(uint8_t v)
+{
+	v = v - ((v >> 1) & 0x55);
+	v = (v & 0x33) + ((v >> 2) & 0x33);
+
+	return (v + (v >> 4)) & 0x0f;
+}
+
+// index in the sorted output of the instruction at @offset
+static size_t walk_rank(const walk_state *s, size_t offset)
+{
+	size_t i, r = s->rank[offset / 64];
+
+	for (i = offset / 64 * 8; i < offset / 8; i++)
+		r += popcount8(s->done[i]);
+
+	return r + popcount8(s->done[offset / 8] & ((1 << (offset % 8)) - 1));
+}
+
+// move the output of @arg (a walker) to its place in the sorted output
+static void walk_scatter(void *arg)
+{
+	walker *w = (walker *)arg;
+	walk_state *s = w->state;
+	size_t i, r;
+
+	for (i = 0; i < w->count; i++) {
+		r = walk_rank(s, (size_t)(w->insns[i].address - s->address));
+		s->insns[r] = w->insns[i];
+		if (s->flows)
+			s->flow_out[r] = w->flows[i];
+	}
+}
+
+// run @func on every walker, the first one in the calling thread
+static void walk_run(walk_state *s, void (*func)(void *arg))
+{
+#ifdef CAPSTONE_HAS_THREADS
+	unsigned int i;
+
+	for (i = 1; i < s->count; i++)
+		s->walkers[i].started = Thread_start(&s->walkers[i].thread, func, &s->walkers[i]);
+#endif
+
+	func(&s->walkers[0]);
+
+#ifdef CAPSTONE_HAS_THREADS
+	for (i = 1; i < s->count; i++) {
+		if (s->walkers[i].started)
+			Thread_join(&s->walkers[i].thread);
+		else
+			func(&s->walkers[i]);
+	}
+#endif
+}
+
+// sort the @c instructions decoded by all walkers into @s->insns
+static bool walk_merge(struct cs_struct *handle, walk_state *s, size_t c)
+{
+	size_t n = (s->code_size + 7) / 8, r = 0, i, j;
+
+	s->rank = HANDLE_MALLOC(handle, (n + 7) / 8 * sizeof(*s->rank));
+	s->insns = HANDLE_MALLOC(handle, c * sizeof(*s->insns));
+	if (s->flows)
+		s->flow_out = HANDLE_MALLOC(handle, c * sizeof(*s->flow_out));
+
+	if (!s->rank || !s->insns || (s->flows && !s->flow_out))
+		return false;
+
+	// instructions are unique per offset, so their order follows the bitmap
+	for (i = 0; i < n; i++) {
+		if (i % 8 == 0)
+			s->rank[i / 8] = r;
+		r += popcount8(s->done[i]);
+	}
+
+	// details kept aside by other threads go to the caller's allocator now
+	for (i = 1; i < s->count; i++) {
+		walker *w = &s->walkers[i];
+
+		if (!w->aside)
+			continue;
+
+		for (j = 0; j < w->count; j++) {
+			w->insns[j].detail = HANDLE_MALLOC(handle, sizeof(cs_detail));
+			if (!w->insns[j].detail)
+				return false;
+			memcpy(w->insns[j].detail, &w->details[j], sizeof(cs_detail));
+		}
+	}
+
+	walk_run(s, walk_scatter);
+
+	return true;
+}
+
+// a copy of @handle, decoding the same way, for another thread of a traversal
+static struct cs_struct *handle_clone(struct cs_struct *handle)
+{
+	struct cs_struct *clone;
+	csh ud;
+
+	if (cs_open(handle->arch, handle->mode, &ud) != CS_ERR_OK)
+		return NULL;
+
+	clone = (struct cs_struct *)ud;
+	if (handle->syntax && cs_option(ud, CS_OPT_SYNTAX, handle->syntax) != CS_ERR_OK) {
+		cs_close(&ud);
+		return NULL;
+	}
+
+	clone->detail = CS_OPT_ON;
+	clone->imm_unsigned = handle->imm_unsigned;
+	clone->notext = handle->notext;
+	clone->branch = handle->branch;
+	// customized mnemonics are only read while decoding, so they are shared
+	clone->mnem_table = handle->mnem_table;
+	clone->mnem_table_size = handle->mnem_table_size;
+
+	return clone;
+}
+
+static void handle_release(struct cs_struct *clone)
+{
+	csh ud = (uintptr_t)clone;
+
+	clone->mnem_table = NULL;
+	clone->mnem_table_size = 0;
+	cs_close(&ud);
+}
+
+size_t disasm_recursive(struct cs_struct *handle, const uint8_t *code, size_t code_size,
+		uint64_t address, const uint64_t *entries, size_t entry_count,
+		cs_insn **insn, cs_flow **flows)
+{
+	walk_state s;
+	walker *w;
+	unsigned int threads = 1, i;
+	size_t c = 0, n, j;
+	cs_opt_value detail;
+	bool ok = true;
+
+	*insn = NULL;
+	if (flows)
+		*flows = NULL;
+
+	handle->errnum = CS_ERR_OK;
+
+	if (!code_size)
+		return 0;
+
+#ifdef CAPSTONE_HAS_THREADS
+	threads = handle->threads ? handle->threads : Thread_cpus();
+#endif
+
+	memset(&s, 0, sizeof(s));
+	s.code = code;
+	s.code_size = code_size;
+	s.address = address;
+	s.detail = handle->detail != CS_OPT_OFF;
+	s.flows = flows != NULL;
+
+	n = (code_size + 7) / 8;
+	s.done = HANDLE_CALLOC(handle, 2 * n, 1);
+	s.walkers = HANDLE_CALLOC(handle, threads, sizeof(*s.walkers));
+	if (!s.done || !s.walkers) {
+		HANDLE_FREE(handle, s.done);
+		HANDLE_FREE(handle, s.walkers);
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+	s.cont = s.done + n;
+
+	// the calling thread decodes with @handle, other threads with a copy each.
+	// without a copy, there are just less threads
+	s.walkers[0].handle = handle;
+	for (s.count = 1; s.count < threads; s.count++) {
+		w = &s.walkers[s.count];
+		w->handle = handle_clone(handle);
+		if (!w->handle)
+			break;
+		w->aside = s.detail && memcmp(&w->handle->mem, &handle->mem, sizeof(handle->mem));
+	}
+
+	for (i = 0; i < s.count; i++) {
+		w = &s.walkers[i];
+		w->state = &s;
+		w->scratch.detail = &w->scratch_detail;
+#ifdef CAPSTONE_HAS_THREADS
+		if (s.count > 1)
+			Mutex_init(&w->todo.lock);
+#endif
+	}
+
+	if (!entries || !entry_count)
+		ok = todo_push(&s.walkers[0], 0);
+	else {
+		// entries are followed in the given order, when there is one thread
+		for (j = entry_count; ok && j > 0; j--) {
+			if (entries[j - 1] >= address && entries[j - 1] - address < code_size)
+				ok = todo_push(&s.walkers[(j - 1) % s.count],
+						(size_t)(entries[j - 1] - address));
+		}
+	}
+
+	// branches are classified from the detail, so always build it internally
+	detail = handle->detail;
+	handle->detail = CS_OPT_ON;
+
+	if (ok)
+		walk_run(&s, walk_thread);
+	ok = ok && !s.failed;
+
+	handle->detail = detail;
+
+	for (i = 0; i < s.count; i++)
+		c += s.walkers[i].count;
+
+	if (ok && c)
+		ok = walk_merge(handle, &s, c);
+
+	for (i = 0; i < s.count; i++) {
+		w = &s.walkers[i];
+
+		// on failure, instructions were not moved to the output
+		if (!ok) {
+			for (j = 0; j < w->count; j++)
+				HANDLE_FREE(handle, w->insns[j].detail);
+		}
+
+		HANDLE_FREE(w->handle, w->todo.items);
+		HANDLE_FREE(w->handle, w->insns);
+		HANDLE_FREE(w->handle, w->flows);
+		HANDLE_FREE(w->handle, w->details);
+#ifdef CAPSTONE_HAS_THREADS
+		if (s.count > 1)
+			Mutex_destroy(&w->todo.lock);
+#endif
+		if (i)
+			handle_release(w->handle);
+	}
+
+	HANDLE_FREE(handle, s.walkers);
+	HANDLE_FREE(handle, s.done);
+	HANDLE_FREE(handle, s.rank);
+
+	if (!ok) {
+		HANDLE_FREE(handle, s.insns);
+		HANDLE_FREE(handle, s.flow_out);
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+
+	*insn = s.insns;
+	if (flows)
+		*flows = s.flow_out;
+
+	return c;
+}
+
+// decoder of single instructions at any offset, one per thread
+typedef struct offset_decoder {
+	struct cs_struct *handle;
+	bool by_id;	// instructions without transfer are known from their ID
+	cs_insn insn;
+	cs_detail detail;
+	// one bit per instruction ID, set once it is found without transfer.
+	// the detail is then not built for it anymore (see Flow_by_id())
+	uint8_t plain[65536 / 8];
+} offset_decoder;
+
+// options of a handle changed by decoder_init()
+typedef struct decoder_options {
+	cs_opt_value detail;
+	bool notext, branch;
+} decoder_options;
+
+// instructions are classified from their detail, but neither the detail
+// nor any text goes to the output. the options to restore go to @saved
+static void decoder_init(offset_decoder *d, struct cs_struct *handle, decoder_options *saved)
+{
+	if (saved) {
+		saved->detail = handle->detail;
+		saved->notext = handle->notext;
+		saved->branch = handle->branch;
+	}
+
+	d->handle = handle;
+	d->by_id = Flow_by_id(handle->arch);
+	d->insn.detail = d->by_id ? NULL : &d->detail;
+	handle->detail = d->by_id ? CS_OPT_OFF : CS_OPT_ON;
+	handle->notext = true;
+	handle->branch = false;
+}
+
+static void decoder_restore(struct cs_struct *handle, const decoder_options *saved)
+{
+	handle->detail = saved->detail;
+	handle->notext = saved->notext;
+	handle->branch = saved->branch;
+}
+
+static bool decoder_iter(offset_decoder *d, const cs_superset *set, const uint8_t *code,
+		size_t offset)
+{
+	struct cs_struct *handle = d->handle;
+	size_t size = set->count - offset;
+	uint64_t address = set->address + offset;
+
+	code += offset;
+
+	// every offset starts a path of its own
+	if (handle->arch == CS_ARCH_ARM)
+		handle->ITBlock.size = 0;
+
+	return disasm_iter(handle, &code, &size, &address, &d->insn, handle->arch,
+			handle->disasm, handle->insn_id, handle->printer,
+			handle->post_printer, handle->fill_detail, false);
+}
+
+// decode the instruction at @offset of @set, whose first byte is @code.
+// return the number of its delay slots
+static unsigned int superset_decode(offset_decoder *d, cs_superset *set,
+		const uint8_t *code, size_t offset)
+{
+	struct cs_struct *handle = d->handle;
+	cs_branch branch;
+	cs_flow flow;
+	unsigned int id;
+
+	set->next[offset] = CS_SUPERSET_NONE;
+	set->targets[offset] = CS_SUPERSET_NONE;
+	set->branches[offset] = CS_BRANCH_NONE;
+
+	if (!decoder_iter(d, set, code, offset)) {
+		set->sizes[offset] = 0;
+		set->ids[offset] = 0;
+		return 0;
+	}
+
+	memset(&flow, 0, sizeof(flow));
+	id = d->insn.id;
+	if (d->by_id) {
+		// the first decode has no detail, which is only built when the ID
+		// may transfer control: the rest of the work is not redone
+		if (!(d->plain[id / 8] & (1 << (id % 8)))) {
+			handle->detail = CS_OPT_ON;
+			d->insn.detail = &d->detail;
+			if (decoder_iter(d, set, code, offset))
+				Flow_get(handle, &d->insn, &flow);
+			d->insn.detail = NULL;
+			handle->detail = CS_OPT_OFF;
+
+			if (flow.type == FLOW_NONE)
+				d->plain[id / 8] |= 1 << (id % 8);
+		}
+	} else
+		Flow_get(handle, &d->insn, &flow);
+
+	Flow_branch(&flow, &branch);
+
+	set->sizes[offset] = (uint8_t)d->insn.size;
+	set->ids[offset] = (uint16_t)id;
+	set->branches[offset] = branch.type;
+
+	// the next instruction runs unless the transfer is always taken, but
+	// delay slots run anyway
+	if ((flow.type == FLOW_NONE || flow.type == FLOW_CALL ||
+				(flow.flags & FLOW_COND) || flow.delay) &&
+			offset + d->insn.size < set->count)
+		set->next[offset] = (uint32_t)(offset + d->insn.size);
+
+	// targets decoded in another mode are not in this superset
+	if (branch.target && !(flow.flags & FLOW_MODE_SWITCH) &&
+			branch.target - set->address < set->count)
+		set->targets[offset] = (uint32_t)(branch.target - set->address);
+
+	return flow.delay;
+}
+
+// offsets decoded at once by a thread of cs_disasm_superset()
+#define SUPERSET_CHUNK 4096
+
+// state of a superset disassembly, shared by all its threads
+typedef struct superset_state {
+	cs_superset *set;
+	const uint8_t *code;
+	long chunk;	// next chunk of offsets to decode
+} superset_state;
+
+// thread of a superset disassembly, with its own handle
+typedef struct superset_part {
+	superset_state *state;
+	offset_decoder decoder;
+#ifdef CAPSTONE_HAS_THREADS
+	cs_thread thread;
+	bool started;
+#endif
+} superset_part;
+
+static void superset_thread(void *arg)
+{
+	superset_part *p = (superset_part *)arg;
+	size_t count = p->state->set->count, start, end;
+
+	// chunks go to whichever thread is free first
+	for (;;) {
+		start = (size_t)(ATOMIC_ADD(&p->state->chunk, 1) - 1) * SUPERSET_CHUNK;
+		if (start >= count)
+			break;
+
+		end = MIN(start + SUPERSET_CHUNK, count);
+		for (; start < end; start++)
+			superset_decode(&p->decoder, p->state->set, p->state->code, start);
+	}
+}
+
+// bytes scanned for gadget ends at once by a thread of cs_gadget_find()
+#define GADGET_CHUNK 65536
+
+// state of a gadget search, shared by all its threads
+typedef struct gadget_state {
+	const uint8_t *code;
+	size_t code_size;
+	uint64_t address;
+	unsigned int max_insns;	// longest gadget, in instructions
+	unsigned int align;	// alignment of instructions
+	unsigned int max_size;	// longest instruction, in bytes
+	long chunk;	// next chunk of bytes to scan
+	long failed;	// a thread ran out of memory
+} gadget_state;
+
+// thread of a gadget search, with its own handle & table of gadgets
+typedef struct gadget_part {
+	gadget_state *state;
+	offset_decoder decoder;
+	// instructions decoded before a gadget end, at offsets of the buffer
+	// from window.address
+	cs_superset window;
+	uint8_t *reach;	// instructions from each offset of @window to its gadget end, or 0
+	// gadgets with distinct instruction IDs, hashed by them
+	cs_gadget *table;
+	size_t size, count;	// slots (power of 2) & gadgets of @table
+#ifdef CAPSTONE_HAS_THREADS
+	cs_thread thread;
+	bool started;
+#endif
+} gadget_part;
+
+static uint32_t gadget_hash(const cs_gadget *g)
+{
+	// FNV-1a
+	uint32_t h = 2166136261u;
+	unsigned int i;
+
+	for (i = 0; i < g->insn_count; i++) {
+		h = (h ^ g->ids[i]) * 16777619u;
+		h = (h ^ (g->ids[i] >> 8)) * 16777619u;
+	}
+
+	return h;
+}
+
+// count gadget @g in @table of @size slots: gadgets with the same instruction
+// IDs are merged into the first one. return false if @g is not there yet, and
+// that the table is full
+static bool gadget_merge(cs_gadget *table, size_t size, const cs_gadget *g, bool insert)
+{
+	size_t i = gadget_hash(g) & (size - 1);
+
+	for (;; i = (i + 1) & (size - 1)) {
+		cs_gadget *e = &table[i];
+
+		if (!e->insn_count) {
+			if (!insert)
+				return false;
+			*e = *g;
+			return true;
+		}
+
+		if (e->insn_count == g->insn_count &&
+				!memcmp(e->ids, g->ids, g->insn_count * sizeof(g->ids[0]))) {
+			e->count += g->count;
+			if (g->address < e->address) {
+				e->address = g->address;
+				e->size = g->size;
+			}
+			return true;
+		}
+	}
+}
+
+// add gadget @g to the table of @p, with the allocator of @handle
+static bool gadget_add(struct cs_struct *handle, gadget_part *p, const cs_gadget *g)
+{
+	cs_gadget *table;
+	size_t size, i;
+
+	// grow the table when it is half full
+	if (2 * (p->count + 1) > p->size) {
+		size = p->size ? 2 * p->size : 1024;
+		table = HANDLE_CALLOC(handle, size, sizeof(*table));
+		if (!table)
+			return false;
+
+		for (i = 0; i < p->size; i++) {
+			if (p->table[i].insn_count)
+				gadget_merge(table, size, &p->table[i], true);
+		}
+
+		HANDLE_FREE(handle, p->table);
+		p->table = table;
+		p->size = size;
+	}
+
+	if (!gadget_merge(p->table, p->size, g, false)) {
+		gadget_merge(p->table, p->size, g, true);
+		p->count++;
+	}
+
+	return true;
+}
+
+// find the gadgets ending with the instruction at offset @end of the buffer.
+// return false if out of memory
+static bool gadget_window(gadget_part *p, size_t end)
+{
+	gadget_state *s = p->state;
+	cs_superset *w = &p->window;
+	size_t before = (size_t)(s->max_insns - 1) * s->max_size, first, last, i, j, n;
+	unsigned int delay, delays = 0, k;
+	uint16_t delay_ids[2];
+	cs_gadget g;
+
+	// the window starts at offset @first of the buffer, so that the gadget
+	// end is at offset @last of the window
+	first = end > before ? end - before : 0;
+	first += (s->align - (s->address + first) % s->align) % s->align;
+	last = end - first;
+	w->address = s->address + first;
+	w->count = MIN(s->code_size - first, last + (size_t)s->max_size * 3);
+
+	// most candidates are rejected here, without decoding anything before
+	delay = superset_decode(&p->decoder, w, s->code + first, last);
+	if (w->branches[last] != CS_BRANCH_RET &&
+			w->branches[last] != CS_BRANCH_INDIRECT_JUMP &&
+			w->branches[last] != CS_BRANCH_INDIRECT_CALL)
+		return true;
+
+	memset(&g, 0, sizeof(g));
+	g.type = w->branches[last];
+	g.count = 1;
+
+	// delay slots run before the transfer, so they end the gadget
+	n = last + w->sizes[last];
+	for (; delay; delay--) {
+		if (n >= w->count || delays == sizeof(delay_ids) / sizeof(delay_ids[0]) ||
+				superset_decode(&p->decoder, w, s->code + first, n) ||
+				!w->sizes[n] || w->branches[n] != CS_BRANCH_NONE)
+			return true;
+		delay_ids[delays++] = w->ids[n];
+		n += w->sizes[n];
+	}
+	if (1 + delays > s->max_insns)
+		return true;
+
+	// from the closest offset before the end: an instruction leads to the
+	// end if the next one does, without any transfer in between
+	p->reach[last] = 1;
+	for (i = last; i >= s->align; ) {
+		i -= s->align;
+		p->reach[i] = 0;
+		superset_decode(&p->decoder, w, s->code + first, i);
+		if (!w->sizes[i] || w->branches[i] != CS_BRANCH_NONE)
+			continue;
+
+		j = i + w->sizes[i];
+		if (j <= last && p->reach[j] && p->reach[j] + 1 + delays <= s->max_insns)
+			p->reach[i] = p->reach[j] + 1;
+	}
+
+	for (i = last % s->align; i <= last; i += s->align) {
+		if (!p->reach[i])
+			continue;
+
+		k = 0;
+		for (j = i; j < last; j += w->sizes[j])
+			g.ids[k++] = w->ids[j];
+		g.ids[k++] = w->ids[last];
+		memcpy(g.ids + k, delay_ids, delays * sizeof(delay_ids[0]));
+		// the longer gadget found before may have left IDs past this one
+		memset(g.ids + k + delays, 0,
+				(CS_GADGET_MAX_INSNS - k - delays) * sizeof(g.ids[0]));
+
+		g.insn_count = (uint8_t)(k + delays);
+		g.address = w->address + i;
+		g.size = (uint16_t)(n - i);
+		if (!gadget_add(p->decoder.handle, p, &g))
+			return false;
+	}
+
+	return true;
+}
+
+static void gadget_thread(void *arg)
+{
+	gadget_part *p = (gadget_part *)arg;
+	gadget_state *s = p->state;
+	size_t start, end, ends[FLOW_GADGET_ENDS];
+	unsigned int c, i;
+
+	while (!ATOMIC_LOAD(&s->failed)) {
+		start = (size_t)(ATOMIC_ADD(&s->chunk, 1) - 1) * GADGET_CHUNK;
+		if (start >= s->code_size)
+			break;
+
+		end = MIN(start + GADGET_CHUNK, s->code_size);
+		// only aligned instructions end gadgets
+		start += (s->align - (s->address + start) % s->align) % s->align;
+		for (; start < end; start += s->align) {
+			c = Flow_gadget_ends(p->decoder.handle, s->code, s->code_size, start, ends);
+			for (i = 0; i < c; i++) {
+				if (!gadget_window(p, ends[i])) {
+					ATOMIC_ADD(&s->failed, 1);
+					return;
+				}
+			}
+		}
+	}
+}
+
+// longest instruction of the arch of @handle, in bytes
+static unsigned int insn_max_size(cs_struct *handle)
+{
+	switch (handle->arch) {
+		default:
+			return 4;
+		case CS_ARCH_X86:
+			return 15;
+		case CS_ARCH_SYSZ:
+			return 6;
+		case CS_ARCH_M68K:
+			return 22;
+		case CS_ARCH_M680X:
+			return 6;
+		case CS_ARCH_EVM:
+			// PUSH32 & its immediate
+			return 33;
+	}
+}
+
+static int gadget_cmp(const void *a, const void *b)
+{
+	uint64_t x = ((const cs_gadget *)a)->address, y = ((const cs_gadget *)b)->address;
+
+	return x < y ? -1 : x > y;
+}
+#endif
+
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_disasm_block(csh ud, const uint8_t *code, size_t code_size,
+		uint64_t address, uint64_t groups, cs_insn **insn, uint64_t *target, bool *has_target)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	cs_insn *total = NULL, *tmp;
+	size_t c = 0, total_size = 0, i;
+	unsigned int stop = 0;	// delay slots left before the block ends
+	cs_opt_value detail;
+	cs_detail scratch_detail;
+	cs_insn scratch;
+	cs_flow flow;
+	bool ok = true;
+#endif
+
+	if (!handle)
+		return 0;
+
+	*insn = NULL;
+	if (has_target)
+		*has_target = false;
+
+#ifdef CAPSTONE_DIET
+	// groups & operands are needed to find the end of the block
+	handle->errnum = CS_ERR_DIET;
+	return 0;
+#else
+	handle->errnum = CS_ERR_OK;
+
+	if (!groups)
+		groups = CS_BLOCK_GROUPS;
+
+	// the block can start anywhere, so forget the last IT block
+	if (handle->arch == CS_ARCH_ARM)
+		handle->ITBlock.size = 0;
+
+	// the end of the block is found from the detail, so always build it internally
+	detail = handle->detail;
+	handle->detail = CS_OPT_ON;
+	scratch.detail = &scratch_detail;
+
+	while (disasm_iter(handle, &code, &code_size, &address, &scratch, handle->arch,
+				handle->disasm, handle->insn_id, handle->printer,
+				handle->post_printer, handle->fill_detail, false)) {
+		uint64_t mask;
+
+		if (c == total_size) {
+			// grow the output like cs_disasm() does
+			total_size = total_size ? total_size * 8 / 5 : INSN_CACHE_SIZE;
+			tmp = HANDLE_REALLOC(handle, total, total_size * sizeof(*total));
+			if (!tmp) {
+				ok = false;
+				break;
+			}
+			total = tmp;
+		}
+
+		total[c] = scratch;
+		if (detail) {
+			total[c].detail = HANDLE_MALLOC(handle, sizeof(cs_detail));
+			if (!total[c].detail) {
+				ok = false;
+				break;
+			}
+			memcpy(total[c].detail, &scratch_detail, sizeof(cs_detail));
+		} else
+			total[c].detail = NULL;
+		c++;
+
+		if (stop) {
+			if (!--stop)
+				break;
+			continue;
+		}
+
+		Flow_get(handle, &scratch, &flow);
+
+		// branches missing their group in some archs are found from their flow
+		mask = scratch_detail.groups_mask;
+		if (flow.type == FLOW_JUMP)
+			mask |= (uint64_t)1 << CS_GRP_JUMP;
+		else if (flow.type == FLOW_CALL)
+			mask |= (uint64_t)1 << CS_GRP_CALL;
+		else if (flow.type == FLOW_RET)
+			mask |= (uint64_t)1 << CS_GRP_RET;
+
+		if (mask & groups) {
+			if ((flow.type == FLOW_JUMP || flow.type == FLOW_CALL) &&
+					!(flow.flags & FLOW_INDIRECT)) {
+				if (target)
+					*target = flow.target;
+				if (has_target)
+					*has_target = true;
+			}
+
+			// nothing after the last instruction, but its delay slots
+			if (!flow.delay)
+				break;
+			stop = flow.delay;
+		}
+	}
+
+	handle->detail = detail;
+
+	if (!ok) {
+		for (i = 0; i < c; i++)
+			HANDLE_FREE(handle, total[i].detail);
+		HANDLE_FREE(handle, total);
+		if (has_target)
+			*has_target = false;
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+
+	if (!c) {
+		HANDLE_FREE(handle, total);
+		return 0;
+	}
+
+	// downsize the output to what was decoded
+	tmp = HANDLE_REALLOC(handle, total, c * sizeof(*total));
+	if (tmp)
+		total = tmp;
+
+	*insn = total;
+
+	return c;
+#endif
+}
+
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_disasm_recursive(csh ud, const uint8_t *code, size_t code_size,
+		uint64_t address, const uint64_t *entries, size_t entry_count, cs_insn **insn)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle)
+		return 0;
+
+#ifdef CAPSTONE_DIET
+	// groups & operands are needed to follow branches
+	*insn = NULL;
+	handle->errnum = CS_ERR_DIET;
+	return 0;
+#else
+	return disasm_recursive(handle, code, code_size, address, entries, entry_count,
+			insn, NULL);
+#endif
+}
+
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_disasm_superset(csh ud, const uint8_t *code, size_t code_size,
+		uint64_t address, cs_superset **set)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	superset_state s;
+	superset_part *parts;
+	cs_superset *g;
+	unsigned int threads = 1, count, i;
+	decoder_options saved;
+#endif
+
+	if (!handle)
+		return CS_ERR_HANDLE;
+
+	*set = NULL;
+
+#ifdef CAPSTONE_DIET
+	// groups & operands are needed to classify instructions
+	handle->errnum = CS_ERR_DIET;
+	return CS_ERR_DIET;
+#else
+	handle->errnum = CS_ERR_OK;
+
+	// offsets are kept in 32 bits, where CS_SUPERSET_NONE is none of them
+	if (code_size >= CS_SUPERSET_NONE) {
+		handle->errnum = CS_ERR_MEM;
+		return CS_ERR_MEM;
+	}
+
+	// all arrays live in the allocation of the superset, widest first
+	g = HANDLE_MALLOC(handle, sizeof(*g) + code_size * (2 * sizeof(uint32_t) +
+				sizeof(uint16_t) + 2 * sizeof(uint8_t)));
+	if (!g) {
+		handle->errnum = CS_ERR_MEM;
+		return CS_ERR_MEM;
+	}
+
+	g->address = address;
+	g->count = code_size;
+	g->next = (uint32_t *)(g + 1);
+	g->targets = g->next + code_size;
+	g->ids = (uint16_t *)(g->targets + code_size);
+	g->sizes = (uint8_t *)(g->ids + code_size);
+	g->branches = g->sizes + code_size;
+
+#ifdef CAPSTONE_HAS_THREADS
+	threads = handle->threads ? handle->threads : Thread_cpus();
+	// no more threads than chunks of offsets
+	if (threads > code_size / SUPERSET_CHUNK + 1)
+		threads = (unsigned int)(code_size / SUPERSET_CHUNK + 1);
+#endif
+
+	parts = HANDLE_CALLOC(handle, threads, sizeof(*parts));
+	if (!parts) {
+		HANDLE_FREE(handle, g);
+		handle->errnum = CS_ERR_MEM;
+		return CS_ERR_MEM;
+	}
+
+	s.set = g;
+	s.code = code;
+	s.chunk = 0;
+
+	// the calling thread decodes with @handle, other threads with a copy each.
+	// without a copy, there are just less threads
+	decoder_init(&parts[0].decoder, handle, &saved);
+	for (count = 1; count < threads; count++) {
+		struct cs_struct *clone = handle_clone(handle);
+
+		if (!clone)
+			break;
+		decoder_init(&parts[count].decoder, clone, NULL);
+	}
+
+	for (i = 0; i < count; i++)
+		parts[i].state = &s;
+
+#ifdef CAPSTONE_HAS_THREADS
+	for (i = 1; i < count; i++)
+		parts[i].started = Thread_start(&parts[i].thread, superset_thread, &parts[i]);
+#endif
+
+	// chunks of a thread failing to start are decoded by the others
+	superset_thread(&parts[0]);
+
+#ifdef CAPSTONE_HAS_THREADS
+	for (i = 1; i < count; i++) {
+		if (parts[i].started)
+			Thread_join(&parts[i].thread);
+	}
+#endif
+
+	decoder_restore(handle, &saved);
+
+	for (i = 1; i < count; i++)
+		handle_release(parts[i].decoder.handle);
+	HANDLE_FREE(handle, parts);
+
+	*set = g;
+
+	return CS_ERR_OK;
+#endif
+}
+
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_superset_free(csh ud, cs_superset *set)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || !set)
+		return;
+
+	// arrays live in the allocation of @set
+	HANDLE_FREE(handle, set);
+}
+
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_gadget_find(csh ud, const uint8_t *code, size_t code_size,
+		uint64_t address, unsigned int max_insns, cs_gadget **gadgets)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	gadget_state s;
+	gadget_part *parts;
+	cs_gadget *table = NULL, *out = NULL;
+	size_t window, size, total = 0, n = 0, i, j;
+	unsigned int threads = 1, count;
+	decoder_options saved;
+#endif
+
+	if (!handle)
+		return 0;
+
+	*gadgets = NULL;
+
+#ifdef CAPSTONE_DIET
+	// groups & operands are needed to classify instructions
+	handle->errnum = CS_ERR_DIET;
+	return 0;
+#else
+	handle->errnum = CS_ERR_OK;
+
+	if (!code_size)
+		return 0;
+
+	if (!max_insns || max_insns > CS_GADGET_MAX_INSNS)
+		max_insns = CS_GADGET_MAX_INSNS;
+
+	s.code = code;
+	s.code_size = code_size;
+	s.address = address;
+	s.max_insns = max_insns;
+	s.align = skipdata_size(handle);
+	// microMips has 16-bit instructions too
+	if (handle->arch == CS_ARCH_MIPS && (handle->mode & CS_MODE_MICRO))
+		s.align = 2;
+	s.max_size = insn_max_size(handle);
+	s.chunk = 0;
+	s.failed = 0;
+
+	// offsets of a window: instructions before a gadget end, then the end
+	// itself & its delay slots
+	window = (size_t)(max_insns + 2) * s.max_size + 1;
+
+#ifdef CAPSTONE_HAS_THREADS
+	threads = handle->threads ? handle->threads : Thread_cpus();
+	// no more threads than chunks of bytes
+	if (threads > code_size / GADGET_CHUNK + 1)
+		threads = (unsigned int)(code_size / GADGET_CHUNK + 1);
+#endif
+
+	parts = HANDLE_CALLOC(handle, threads, sizeof(*parts));
+	if (!parts) {
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+
+	// the calling thread searches with @handle, other threads with a copy each.
+	// without a copy, there are just less threads
+	decoder_init(&parts[0].decoder, handle, &saved);
+	for (count = 1; count < threads; count++) {
+		struct cs_struct *clone = handle_clone(handle);
+
+		if (!clone)
+			break;
+		decoder_init(&parts[count].decoder, clone, NULL);
+	}
+
+	// the arrays of a window live in one allocation, widest first
+	for (i = 0; i < count; i++) {
+		cs_superset *w = &parts[i].window;
+
+		parts[i].state = &s;
+		w->next = HANDLE_MALLOC(parts[i].decoder.handle, window *
+				(2 * sizeof(uint32_t) + sizeof(uint16_t) + 3 * sizeof(uint8_t)));
+		if (!w->next) {
+			s.failed = 1;
+			break;
+		}
+		w->targets = w->next + window;
+		w->ids = (uint16_t *)(w->targets + window);
+		w->sizes = (uint8_t *)(w->ids + window);
+		w->branches = w->sizes + window;
+		parts[i].reach = w->branches + window;
+	}
+
+	if (!s.failed) {
+#ifdef CAPSTONE_HAS_THREADS
+		for (i = 1; i < count; i++)
+			parts[i].started = Thread_start(&parts[i].thread, gadget_thread, &parts[i]);
+#endif
+
+		// chunks of a thread failing to start are searched by the others
+		gadget_thread(&parts[0]);
+
+#ifdef CAPSTONE_HAS_THREADS
+		for (i = 1; i < count; i++) {
+			if (parts[i].started)
+				Thread_join(&parts[i].thread);
+		}
+#endif
+	}
+
+	decoder_restore(handle, &saved);
+
+	for (i = 0; i < count; i++)
+		total += parts[i].count;
+
+	// merge the gadgets of all threads, in a table at most half full
+	if (!s.failed && total) {
+		for (size = 1024; size < 2 * total; size *= 2)
+			;
+		table = HANDLE_CALLOC(handle, size, sizeof(*table));
+		if (table) {
+			for (i = 0; i < count; i++) {
+				for (j = 0; j < parts[i].size; j++) {
+					const cs_gadget *g = &parts[i].table[j];
+
+					if (g->insn_count && !gadget_merge(table, size, g, false)) {
+						gadget_merge(table, size, g, true);
+						n++;
+					}
+				}
+			}
+
+			out = HANDLE_MALLOC(handle, n * sizeof(*out));
+			if (out) {
+				for (i = 0, j = 0; i < size; i++) {
+					if (table[i].insn_count)
+						out[j++] = table[i];
+				}
+				qsort(out, n, sizeof(*out), gadget_cmp);
+			}
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		HANDLE_FREE(parts[i].decoder.handle, parts[i].window.next);
+		HANDLE_FREE(parts[i].decoder.handle, parts[i].table);
+		if (i)
+			handle_release(parts[i].decoder.handle);
+	}
+	HANDLE_FREE(handle, parts);
+	HANDLE_FREE(handle, table);
+
+	if (!out && (s.failed || total)) {
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+
+	*gadgets = out;
+
+	return n;
+#endif
+}
+
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_gadget_free(csh ud, cs_gadget *gadgets)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || !gadgets)
+		return;
+
+	HANDLE_FREE(handle, gadgets);
+}
+
+// return friendly name of regiser in a string
+CAPSTONE_EXPORT
+const char * CAPSTONE_API cs_reg_name(csh ud, unsigned int reg)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || handle->reg_name == NULL) {
+		return NULL;
+	}
+
+	return handle->reg_name(ud, reg);
+}
+
+CAPSTONE_EXPORT
+const char * CAPSTONE_API cs_insn_name(csh ud, unsigned int insn)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || handle->insn_name == NULL) {
+		return NULL;
+	}
+
+	return handle->insn_name(ud, insn);
+}
+
+CAPSTONE_EXPORT
+const char * CAPSTONE_API cs_group_name(csh ud, unsigned int group)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || handle->group_name == NULL) {
+		return NULL;
+	}
+
+	return handle->group_name(ud, group);
+}
+
+#ifndef CAPSTONE_DIET
+static unsigned int name_lookup(struct cs_struct *handle, cs_name_index *index,
+		GetName_t get_name, unsigned int max, const char *name)
+{
+	if (get_name == NULL || name == NULL)
+		return 0;
+
+	// build the index on first use, as most programs never need it
+	if (index->size == 0 &&
+			!name_index_build(handle, index, get_name, max)) {
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+
+	return name_index_find(handle, index, get_name, name);
+}
+#endif
+
+CAPSTONE_EXPORT
+unsigned int CAPSTONE_API cs_reg_id(csh ud, const char *name)
+{
+#ifndef CAPSTONE_DIET
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle)
+		return 0;
+
+	return name_lookup(handle, &handle->reg_index, handle->reg_name,
+			cs_arch_name_max[handle->arch][0], name);
+#else
+	return 0;
+#endif
+}
+
+CAPSTONE_EXPORT
+unsigned int CAPSTONE_API cs_insn_id(csh ud, const char *name)
+{
+#ifndef CAPSTONE_DIET
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle)
+		return 0;
+
+	return name_lookup(handle, &handle->insn_index, handle->insn_name,
+			cs_arch_name_max[handle->arch][1], name);
+#else
+	return 0;
+#endif
+}
+
+CAPSTONE_EXPORT
+unsigned int CAPSTONE_API cs_group_id(csh ud, const char *name)
+{
+#ifndef CAPSTONE_DIET
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle)
+		return 0;
+
+	return name_lookup(handle, &handle->group_index, handle->group_name,
+			cs_arch_name_max[handle->arch][2], name);
+#else
+	return 0;
+#endif
+}
+
+CAPSTONE_EXPORT
+bool CAPSTONE_API cs_insn_group(csh ud, const cs_insn *insn, unsigned int group_id)
+{
+	struct cs_struct *handle;
+	if (!ud)
+		return false;
+
+	handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return false;
+	}
+
+	if (!insn->id) {
+		handle->errnum = CS_ERR_SKIPDATA;
+		return false;
+	}
+
+	if (!insn->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return false;
+	}
+
+	return CS_DETAIL_GROUP(insn->detail, group_id);
+}
+
+#ifndef CAPSTONE_DIET
+// classify @insn with CS_OPT_BRANCH while CS_OPT_DETAIL is off: its bytes are
+// decoded again, alone, into a scratch detail & without text. archs classified
+// by ID skip this for IDs already found without transfer (see Flow_by_id())
+static void branch_decode(struct cs_struct *handle, const cs_insn *insn, cs_flow *flow)
+{
+	const uint8_t *code = insn->bytes;
+	size_t size = insn->size;
+	uint64_t address = insn->address;
+	unsigned int id = insn->id, count = cs_arch_name_max[handle->arch][1];
+	ARM_ITStatus it = handle->ITBlock;
+	bool notext = handle->notext;
+	bool by_id = Flow_by_id(handle->arch) && id < count;
+	cs_detail detail;
+	cs_insn scratch;
+
+	memset(flow, 0, sizeof(*flow));
+
+	// without memory for these bits, every instruction is just decoded again
+	if (by_id && !handle->branch_plain)
+		handle->branch_plain = HANDLE_CALLOC(handle, (count + 7) / 8, 1);
+	by_id = by_id && handle->branch_plain;
+
+	if (by_id && (handle->branch_plain[id / 8] & (1 << (id % 8))))
+		return;
+
+	// out of any IT block, which is left as it is for the next instruction
+	handle->ITBlock.size = 0;
+	handle->detail = CS_OPT_ON;
+	handle->notext = true;
+	handle->branch = false;
+	scratch.detail = &detail;
+
+	if (disasm_iter(handle, &code, &size, &address, &scratch, handle->arch,
+				handle->disasm, handle->insn_id, handle->printer,
+				handle->post_printer, handle->fill_detail, false))
+		Flow_get(handle, &scratch, flow);
+
+	handle->ITBlock = it;
+	handle->detail = CS_OPT_OFF;
+	handle->notext = notext;
+	handle->branch = true;
+
+	if (by_id && flow->type == FLOW_NONE)
+		handle->branch_plain[id / 8] |= 1 << (id % 8);
+}
+#endif
+
+CAPSTONE_EXPORT
+cs_branch_type CAPSTONE_API cs_insn_branch_target(csh ud, const cs_insn *insn, uint64_t *target)
+{
+	struct cs_struct *handle;
+#ifndef CAPSTONE_DIET
+	cs_branch branch;
+	cs_flow flow;
+#endif
+
+	if (target)
+		*target = 0;
+
+	if (!ud)
+		return CS_BRANCH_NONE;
+
+	handle = (struct cs_struct *)(uintptr_t)ud;
+
+#ifdef CAPSTONE_DIET
+	handle->errnum = CS_ERR_DIET;
+	return CS_BRANCH_NONE;
+#else
+	if (!handle->detail && !handle->branch) {
+		handle->errnum = CS_ERR_DETAIL;
+		return CS_BRANCH_NONE;
+	}
+
+	if (!insn->id) {
+		// data of CS_OPT_SKIPDATA transfers nothing
+		if (!handle->branch)
+			handle->errnum = CS_ERR_SKIPDATA;
+		return CS_BRANCH_NONE;
+	}
+
+	if (!handle->detail) {
+		// CS_OPT_BRANCH without the detail
+		branch_decode(handle, insn, &flow);
+		Flow_branch(&flow, &branch);
+	} else if (!insn->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return CS_BRANCH_NONE;
+	} else if (handle->branch)
+		// classified while decoding already
+		branch = insn->detail->branch;
+	else {
+		Flow_get(handle, insn, &flow);
+		Flow_branch(&flow, &branch);
+	}
+
+	if (target)
+		*target = branch.target;
+
+	return (cs_branch_type)branch.type;
+#endif
+}
+
+CAPSTONE_EXPORT
+bool CAPSTONE_API cs_reg_read(csh ud, const cs_insn *insn, unsigned int reg_id)
+{
+	struct cs_struct *handle;
+	if (!ud)
+		return false;
+
+	handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return false;
+	}
+
+	if (!insn->id) {
+		handle->errnum = CS_ERR_SKIPDATA;
+		return false;
+	}
+
+	if (!insn->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return false;
+	}
+
+	return arr_exist(insn->detail->regs_read, insn->detail->regs_read_count, reg_id);
+}
+
+CAPSTONE_EXPORT
+bool CAPSTONE_API cs_reg_write(csh ud, const cs_insn *insn, unsigned int reg_id)
+{
+	struct cs_struct *handle;
+	if (!ud)
 		return false;
 
 	handle = (struct cs_struct *)(uintptr_t)ud;
@@ -1578,3 +3443,69 @@ cs_err CAPSTONE_API cs_regs_access(csh ud, const cs_insn *insn,
 	return CS_ERR_OK;
 #endif
 }
+
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_regs_access_mask(csh ud, const cs_insn *insn,
+		cs_regs_mask regs_read, cs_regs_mask regs_write, bool fold_aliases)
+{
+	struct cs_struct *handle;
+#ifndef CAPSTONE_DIET
+	cs_regs_mask regs;
+	uint8_t i;
+#endif
+
+	if (!ud)
+		return -1;
+
+	handle = (struct cs_struct *)(uintptr_t)ud;
+
+#ifdef CAPSTONE_DIET
+	// This API does not work in DIET mode
+	handle->errnum = CS_ERR_DIET;
+	return CS_ERR_DIET;
+#else
+	if (!handle->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return CS_ERR_DETAIL;
+	}
+
+	if (!insn->id) {
+		handle->errnum = CS_ERR_SKIPDATA;
+		return CS_ERR_SKIPDATA;
+	}
+
+	if (!insn->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return CS_ERR_DETAIL;
+	}
+
+	if (!handle->reg_access) {
+		// this arch is unsupported yet
+		handle->errnum = CS_ERR_ARCH;
+		return CS_ERR_ARCH;
+	}
+
+	memset(regs_read, 0, sizeof(cs_regs_mask));
+	memset(regs_write, 0, sizeof(cs_regs_mask));
+
+	// implicit registers
+	for (i = 0; i < insn->detail->regs_read_count; i++)
+		REGS_MASK_SET(regs_read, insn->detail->regs_read[i]);
+
+	for (i = 0; i < insn->detail->regs_write_count; i++)
+		REGS_MASK_SET(regs_write, insn->detail->regs_write[i]);
+
+	// explicit registers
+	if (handle->reg_access_mask)
+		handle->reg_access_mask(insn, regs_read, regs_write);
+
+	if (fold_aliases && handle->reg_fold_aliases) {
+		memcpy(regs, regs_read, sizeof(regs));
+		handle->reg_fold_aliases(handle, regs, regs_read);
+		memcpy(regs, regs_write, sizeof(regs));
+		handle->reg_fold_aliases(handle, regs, regs_write);
+	}
+
+	return CS_ERR_OK;
+#endif
+}
@@ -11,15 +11,19 @@
 
 typedef void (*Printer_t)(MCInst *MI, SStream *OS, void *info);
 
+// fill in instruction details without printing, for CS_OPT_NOTEXT mode.
+// called at the same place as Printer_t, so insn's ID is already known
+typedef void (*FillDetail_t)(MCInst *MI);
+
 // function to be called after Printer_t
 // this is the best time to gather insn's characteristics
-typedef void (*PostPrinter_t)(csh handle, cs_insn *, char *mnem, MCInst *mci);
+typedef void (*PostPrinter_t)(csh handle, cs_insn *, MCInst *mci);
 
 typedef bool (*Disasm_t)(csh handle, const uint8_t *code, size_t code_len, MCInst *instr, uint16_t *size, uint64_t address, void *info);
 
 typedef const char *(*GetName_t)(csh handle, unsigned int id);
 
-typedef void (*GetID_t)(cs_struct *h, cs_insn *insn, unsigned int id);
+typedef void (*GetID_t)(cs_struct *h, cs_insn *insn, unsigned int id, MCInst *MI);
 
 // return register name, given register ID
 typedef const char *(*GetRegisterName_t)(unsigned RegNo);
@@ -29,30 +33,32 @@ typedef void (*GetRegisterAccess_t)(const cs_insn *insn,
 		cs_regs regs_read, uint8_t *regs_read_count,
 		cs_regs regs_write, uint8_t *regs_write_count);
 
+// set bits of registers accessed by explicit operands of instruction
+typedef void (*GetRegisterAccessMask_t)(const cs_insn *insn,
+		uint64_t *regs_read, uint64_t *regs_write);
+
+// set bits of all registers overlapping with registers in bitmap @regs
+typedef void (*FoldRegisterAliases_t)(cs_struct *h, const uint64_t *regs, uint64_t *aliases);
+
+// reverse map of names returned by a GetName_t callback back to their IDs,
+// see cs_reg_id(), cs_insn_id() & cs_group_id()
+typedef struct cs_name_index {
+	unsigned int *slots;	// IDs hashed by their name, 0 for an empty slot
+	unsigned int size;	// number of slots (power of 2), or 0 if not built yet
+} cs_name_index;
+
 // for ARM only
 typedef struct ARM_ITStatus {
 	unsigned char ITStates[8];
 	unsigned int size;
 } ARM_ITStatus;
 
-// Customize mnemonic for instructions with alternative name.
-struct customized_mnem {
-	// ID of instruction to be customized.
-	unsigned int id;
-	// Customized instruction mnemonic.
-	char mnemonic[CS_MNEMONIC_SIZE];
-};
-
-struct insn_mnem {
-	struct customized_mnem insn;
-	struct insn_mnem *next;	// linked list of customized mnemonics
-};
-
 struct cs_struct {
 	cs_arch arch;
 	cs_mode mode;
 	Printer_t printer;	// asm printer
 	void *printer_info; // aux info for printer
+	FillDetail_t fill_detail;	// detail builder for CS_OPT_NOTEXT, or NULL to fall back on printer
 	Disasm_t disasm;	// disassembler
 	void *getinsn_info; // auxiliary info for printer
 	GetName_t reg_name;
@@ -63,6 +69,7 @@ struct cs_struct {
 	cs_err errnum;
 	ARM_ITStatus ITBlock;	// for Arm only
 	cs_opt_value detail, imm_unsigned;
+	bool notext;	// do not generate mnemonic & op_str (CS_OPT_NOTEXT)
 	int syntax;	// asm syntax for simple printer such as ARM, Mips & PPC
 	bool doing_mem;	// handling memory operand in InstPrinter code
 	unsigned short *insn_cache;	// index caching for mapping.c
@@ -71,8 +78,20 @@ struct cs_struct {
 	uint8_t skipdata_size;	// how many bytes to skip
 	cs_opt_skipdata skipdata_setup;	// user-defined skipdata setup
 	const uint8_t *regsize_map;	// map to register size (x86-only for now)
+	const uint16_t *implicit_regs;	// pool of implicit registers for current mode (x86-only for now)
 	GetRegisterAccess_t reg_access;
-	struct insn_mnem *mnem_list;	// linked list of customized instruction mnemonic
+	GetRegisterAccessMask_t reg_access_mask;	// explicit part of cs_regs_access_mask(), or NULL
+	FoldRegisterAliases_t reg_fold_aliases;	// register aliasing for cs_regs_access_mask(), or NULL
+	char **mnem_table;	// customized instruction mnemonics, indexed by instruction ID
+	unsigned int mnem_table_size;	// number of slots in @mnem_table
+	cs_name_index reg_index, insn_index, group_index;	// built on first use of cs_*_id()
+	cs_opt_mem_handle mem;	// allocator of all memory owned by this handle
+	struct cs_arena *arena;	// arena behind @mem for cs_open_arena(), or NULL
+	unsigned int threads;	// threads of recursive traversals (CS_OPT_THREADS), 0 for one per CPU
+	bool branch;	// fill in cs_detail.branch (CS_OPT_BRANCH)
+#ifndef CAPSTONE_DIET
+	uint8_t *branch_plain;	// one bit per instruction ID found without transfer for CS_OPT_BRANCH, or NULL
+#endif
 };
 
 #define MAX_ARCH CS_ARCH_MAX
@@ -86,4 +105,10 @@ extern cs_realloc_t cs_mem_realloc;
 extern cs_free_t cs_mem_free;
 extern cs_vsnprintf_t cs_vsnprintf;
 
+// allocate & free memory owned by handle @h, through its own allocator
+#define HANDLE_MALLOC(h, size) ((h)->mem.malloc((h)->mem.user_data, (size)))
+#define HANDLE_CALLOC(h, nmemb, size) ((h)->mem.calloc((h)->mem.user_data, (nmemb), (size)))
+#define HANDLE_REALLOC(h, ptr, size) ((h)->mem.realloc((h)->mem.user_data, (ptr), (size)))
+#define HANDLE_FREE(h, ptr) ((h)->mem.free((h)->mem.user_data, (ptr)))
+
 #endif
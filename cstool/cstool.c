@@ -132,10 +132,13 @@ static uint8_t *preprocess(char *code, size_t *size)
 	return result;
 }
 
+// longest gadget searched by -g
+#define GADGET_INSNS 6
+
 static void usage(char *prog)
 {
 	printf("Cstool for Capstone Disassembler Engine v%u.%u.%u\n\n", CS_VERSION_MAJOR, CS_VERSION_MINOR, CS_VERSION_EXTRA);
-	printf("Syntax: %s [-u|-d|-s|-v] <arch+mode> <assembly-hexstring> [start-address-in-hex-format]\n", prog);
+	printf("Syntax: %s [-u|-d|-s|-g|-p <pattern>|-v] <arch+mode> <assembly-hexstring> [start-address-in-hex-format]\n", prog);
 	printf("\nThe following <arch+mode> options are supported:\n");
 
 	if (cs_support(CS_ARCH_X86)) {
@@ -218,6 +221,9 @@ static void usage(char *prog)
 	printf("        -d show detailed information of the instructions\n");
 	printf("        -u show immediates as unsigned\n");
 	printf("        -s decode in SKIPDATA mode\n");
+	printf("        -g search for ROP/JOP gadgets of up to %u instructions\n", GADGET_INSNS);
+	printf("        -p search for instructions matching a pattern, like \"xor reg, reg; call *\"\n");
+	printf("           (can be repeated, see cs_pattern_compile() for the syntax)\n");
 	printf("        -v show version & Capstone core build info\n\n");
 }
 
@@ -279,6 +285,93 @@ static void print_details(csh handle, cs_arch arch, cs_mode md, cs_insn *ins)
 	printf("\n");
 }
 
+static int print_gadgets(csh handle, uint8_t *code, size_t size, uint64_t address)
+{
+	cs_gadget *gadgets;
+	cs_insn *insn;
+	size_t count, i, j, n;
+
+	count = cs_gadget_find(handle, code, size, address, GADGET_INSNS, &gadgets);
+	if (!count) {
+		if (cs_errno(handle)) {
+			printf("ERROR: %s\n", cs_strerror(cs_errno(handle)));
+			return -4;
+		}
+		printf("No gadget found\n");
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		// decode the first occurrence again for its text
+		n = cs_disasm(handle, code + (gadgets[i].address - address), gadgets[i].size,
+				gadgets[i].address, 0, &insn);
+
+		printf("%2"PRIx64"  ", gadgets[i].address);
+		for (j = 0; j < n; j++) {
+			if (j > 0)
+				printf(" ; ");
+			printf("%s%s%s", insn[j].mnemonic, insn[j].op_str[0] ? " " : "", insn[j].op_str);
+		}
+		if (gadgets[i].count > 1)
+			printf("  (x%u)", gadgets[i].count);
+		printf("\n");
+
+		cs_free(insn, n);
+	}
+
+	printf("%u unique gadgets\n", (unsigned int)count);
+	cs_gadget_free(handle, gadgets);
+
+	return 0;
+}
+
+static int print_matches(csh handle, const char *patterns, uint8_t *code, size_t size,
+		uint64_t address)
+{
+	cs_pattern *pattern;
+	cs_match *matches;
+	cs_insn *insn;
+	size_t count, i, j, n;
+	cs_err err;
+
+	err = cs_pattern_compile(handle, patterns, &pattern);
+	if (err) {
+		printf("ERROR: %s\n", cs_strerror(err));
+		return -4;
+	}
+
+	count = cs_pattern_search(handle, pattern, code, size, address, &matches);
+	cs_pattern_free(handle, pattern);
+	if (!count) {
+		if (cs_errno(handle)) {
+			printf("ERROR: %s\n", cs_strerror(cs_errno(handle)));
+			return -4;
+		}
+		printf("No match found\n");
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		n = cs_disasm(handle, code + (matches[i].address - address), matches[i].size,
+				matches[i].address, matches[i].insn_count, &insn);
+
+		printf("%2"PRIx64"  #%u  ", matches[i].address, matches[i].pattern);
+		for (j = 0; j < n; j++) {
+			if (j > 0)
+				printf(" ; ");
+			printf("%s%s%s", insn[j].mnemonic, insn[j].op_str[0] ? " " : "", insn[j].op_str);
+		}
+		printf("\n");
+
+		cs_free(insn, n);
+	}
+
+	printf("%u matches\n", (unsigned int)count);
+	cs_match_free(handle, matches);
+
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
 	int i, c;
@@ -294,9 +387,12 @@ int main(int argc, char **argv)
 	bool detail_flag = false;
 	bool unsigned_flag = false;
 	bool skipdata = false;
+	bool gadget_flag = false;
+	char *patterns = NULL;
+	size_t patterns_size = 0;
 	int args_left;
 
-	while ((c = getopt (argc, argv, "sudhv")) != -1) {
+	while ((c = getopt (argc, argv, "sudgp:hv")) != -1) {
 		switch (c) {
 			case 's':
 				skipdata = true;
@@ -307,6 +403,25 @@ int main(int argc, char **argv)
 			case 'd':
 				detail_flag = true;
 				break;
+			case 'g':
+				gadget_flag = true;
+				break;
+			case 'p': {
+				// one pattern per line
+				size_t n = strlen(optarg);
+				char *p = realloc(patterns, patterns_size + n + 2);
+
+				if (!p) {
+					printf("ERROR: out of memory, quit!\n");
+					return -1;
+				}
+				patterns = p;
+				memcpy(patterns + patterns_size, optarg, n);
+				patterns_size += n;
+				patterns[patterns_size++] = '\n';
+				patterns[patterns_size] = '\0';
+				break;
+			}
 			case 'v':
 				printf("cstool for Capstone Disassembler, v%u.%u.%u\n", CS_VERSION_MAJOR, CS_VERSION_MINOR, CS_VERSION_EXTRA);
 
@@ -442,6 +557,21 @@ int main(int argc, char **argv)
 		cs_option(handle, CS_OPT_UNSIGNED, CS_OPT_ON);
 	}
 
+	if (gadget_flag) {
+		c = print_gadgets(handle, assembly, size, address);
+		cs_close(&handle);
+		free(assembly);
+		return c;
+	}
+
+	if (patterns) {
+		c = print_matches(handle, patterns, assembly, size, address);
+		cs_close(&handle);
+		free(assembly);
+		free(patterns);
+		return c;
+	}
+
 	count = cs_disasm(handle, assembly, size, address, 0, &insn);
 	if (count > 0) {
 		size_t i;
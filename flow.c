@@ -0,0 +1,1438 @@
+/* Capstone Disassembly Engine */
+/* Control flow of decoded instructions */
+
+#if defined(CAPSTONE_HAS_OSXKERNEL)
+#include <libkern/libkern.h>
+#else
+#include <string.h>
+#endif
+
+#include "flow.h"
+
+#ifndef CAPSTONE_DIET
+
+static void set_jump(cs_flow *flow, uint8_t type, uint8_t flags, uint64_t target)
+{
+	flow->type = type;
+	flow->flags = flags;
+	flow->target = target;
+}
+
+// read the first 4 bytes of an instruction of a fixed-width arch
+static uint32_t insn_word(const cs_insn *insn, bool big_endian)
+{
+	const uint8_t *b = insn->bytes;
+
+	if (big_endian)
+		return ((uint32_t)b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+
+	return ((uint32_t)b[3] << 24) | (b[2] << 16) | (b[1] << 8) | b[0];
+}
+
+static bool in_group(const cs_insn *insn, uint8_t group)
+{
+	int i;
+
+	for (i = 0; i < insn->detail->groups_count; i++) {
+		if (insn->detail->groups[i] == group)
+			return true;
+	}
+
+	return false;
+}
+
+static int64_t sign_extend(uint64_t v, unsigned int bits)
+{
+	uint64_t m = (uint64_t)1 << (bits - 1);
+
+	v &= ((uint64_t)1 << bits) - 1;
+	return (int64_t)((v ^ m) - m);
+}
+
+#ifdef CAPSTONE_HAS_X86
+static void x86_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const cs_x86 *x86 = &insn->detail->x86;
+	uint8_t flags = 0;
+
+	switch (insn->id) {
+		default:
+			if (!in_group(insn, X86_GRP_JUMP))
+				return;
+			// jcc & jcxz
+			flags = FLOW_COND;
+			break;
+		case X86_INS_LOOP:
+		case X86_INS_LOOPE:
+		case X86_INS_LOOPNE:
+			flags = FLOW_COND;
+			break;
+		case X86_INS_JMP:
+			break;
+		case X86_INS_CALL:
+			flow->type = FLOW_CALL;
+			break;
+		case X86_INS_LJMP:
+		case X86_INS_LCALL:
+			// far transfers go to another segment
+			set_jump(flow, insn->id == X86_INS_LJMP ? FLOW_JUMP : FLOW_CALL, FLOW_INDIRECT, 0);
+			return;
+		case X86_INS_RET:
+		case X86_INS_RETF:
+		case X86_INS_RETFQ:
+		case X86_INS_IRET:
+		case X86_INS_IRETD:
+		case X86_INS_IRETQ:
+		case X86_INS_SYSRET:
+		case X86_INS_SYSEXIT:
+			flow->type = FLOW_RET;
+			return;
+	}
+
+	if (!flow->type)
+		flow->type = FLOW_JUMP;
+
+	// the immediate of a relative transfer is its absolute target already
+	if (x86->op_count == 1 && x86->operands[0].type == X86_OP_IMM) {
+		flow->flags = flags;
+		flow->target = (uint64_t)x86->operands[0].imm;
+	} else
+		flow->flags = flags | FLOW_INDIRECT;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_ARM
+static void arm_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const cs_arm *arm = &insn->detail->arm;
+	uint8_t flags = (arm->cc != ARM_CC_AL && arm->cc != ARM_CC_INVALID) ? FLOW_COND : 0;
+	const cs_arm_op *op = &arm->operands[arm->op_count ? arm->op_count - 1 : 0];
+	int i;
+
+	switch (insn->id) {
+		default:
+			// any other instruction writing to PC, like "pop {pc}" or "ldr pc, [r0]"
+			for (i = 0; i < arm->op_count; i++) {
+				if (arm->operands[i].type == ARM_OP_REG &&
+						arm->operands[i].reg == ARM_REG_PC &&
+						(arm->operands[i].access & CS_AC_WRITE))
+					break;
+			}
+			if (i == arm->op_count)
+				return;
+
+			if (insn->id == ARM_INS_POP ||
+					(insn->id == ARM_INS_LDM && arm->operands[0].reg == ARM_REG_SP) ||
+					(insn->id == ARM_INS_MOV && arm->operands[1].reg == ARM_REG_LR))
+				set_jump(flow, FLOW_RET, flags, 0);
+			else
+				set_jump(flow, FLOW_JUMP, flags | FLOW_INDIRECT, 0);
+			return;
+		case ARM_INS_CBZ:
+		case ARM_INS_CBNZ:
+			flags |= FLOW_COND;
+			// fall through
+		case ARM_INS_B:
+			flow->type = FLOW_JUMP;
+			break;
+		case ARM_INS_BL:
+			flow->type = FLOW_CALL;
+			break;
+		case ARM_INS_BLX:
+			flow->type = FLOW_CALL;
+			// BLX #imm always switches between ARM & Thumb
+			flags |= FLOW_MODE_SWITCH;
+			break;
+		case ARM_INS_BX:
+			if (op->type == ARM_OP_REG && op->reg == ARM_REG_LR) {
+				set_jump(flow, FLOW_RET, flags, 0);
+				return;
+			}
+			// fall through
+		case ARM_INS_BXJ:
+		case ARM_INS_TBB:
+		case ARM_INS_TBH:
+			set_jump(flow, FLOW_JUMP, flags | FLOW_INDIRECT, 0);
+			return;
+		case ARM_INS_ERET:
+		case ARM_INS_RFEDA:
+		case ARM_INS_RFEDB:
+		case ARM_INS_RFEIA:
+		case ARM_INS_RFEIB:
+			set_jump(flow, FLOW_RET, flags, 0);
+			return;
+	}
+
+	if (arm->op_count && op->type == ARM_OP_IMM) {
+		flow->flags = flags;
+		flow->target = (uint32_t)op->imm;
+	} else
+		flow->flags = (flags & ~FLOW_MODE_SWITCH) | FLOW_INDIRECT;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_ARM64
+static void arm64_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const cs_arm64 *arm64 = &insn->detail->arm64;
+	uint8_t flags = 0;
+
+	switch (insn->id) {
+		default:
+			return;
+		case ARM64_INS_B:
+			if (arm64->cc != ARM64_CC_INVALID && arm64->cc != ARM64_CC_AL &&
+					arm64->cc != ARM64_CC_NV)
+				flags = FLOW_COND;
+			flow->type = FLOW_JUMP;
+			break;
+		case ARM64_INS_CBZ:
+		case ARM64_INS_CBNZ:
+		case ARM64_INS_TBZ:
+		case ARM64_INS_TBNZ:
+			flags = FLOW_COND;
+			flow->type = FLOW_JUMP;
+			break;
+		case ARM64_INS_BL:
+			flow->type = FLOW_CALL;
+			break;
+		case ARM64_INS_BLR:
+			set_jump(flow, FLOW_CALL, FLOW_INDIRECT, 0);
+			return;
+		case ARM64_INS_BR:
+			set_jump(flow, FLOW_JUMP, FLOW_INDIRECT, 0);
+			return;
+		case ARM64_INS_RET:
+		case ARM64_INS_ERET:
+			set_jump(flow, FLOW_RET, 0, 0);
+			return;
+	}
+
+	// the target is always the last operand
+	flow->flags = flags;
+	flow->target = (uint64_t)arm64->operands[arm64->op_count - 1].imm;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_MIPS
+static void mips_flow(cs_struct *handle, const cs_insn *insn, cs_flow *flow)
+{
+	const cs_mips *mips = &insn->detail->mips;
+	bool compact = false;	// R6 compact branches have no delay slot
+	uint8_t flags = 0;
+	int64_t imm = 0;
+	int i;
+
+	switch (insn->id) {
+		default:
+			return;
+
+		// unconditional jumps
+		case MIPS_INS_BC:
+			compact = true;
+			// fall through
+		case MIPS_INS_B:
+		case MIPS_INS_B16:
+		case MIPS_INS_J:
+			flow->type = FLOW_JUMP;
+			break;
+
+		// indirect jumps & returns through $ra
+		case MIPS_INS_JRC:
+		case MIPS_INS_JIC:
+		case MIPS_INS_JRADDIUSP:
+			compact = true;
+			// fall through
+		case MIPS_INS_JR:
+		case MIPS_INS_JR16:
+		case MIPS_INS_JR_HB:
+			if (insn->id == MIPS_INS_JRADDIUSP ||
+					(mips->operands[0].type == MIPS_OP_REG &&
+					 mips->operands[0].reg == MIPS_REG_RA && insn->id != MIPS_INS_JIC))
+				flow->type = FLOW_RET;
+			else {
+				flow->type = FLOW_JUMP;
+				flags = FLOW_INDIRECT;
+			}
+			break;
+
+		case MIPS_INS_ERET:
+		case MIPS_INS_DERET:
+			set_jump(flow, FLOW_RET, 0, 0);
+			return;
+
+		// calls
+		case MIPS_INS_BALC:
+			compact = true;
+			// fall through
+		case MIPS_INS_JAL:
+		case MIPS_INS_JALS:
+		case MIPS_INS_BAL:
+			flow->type = FLOW_CALL;
+			break;
+		case MIPS_INS_JALX:
+			// JALX switches between Mips & microMips
+			flow->type = FLOW_CALL;
+			flags = FLOW_MODE_SWITCH;
+			break;
+		case MIPS_INS_BEQZALC:
+		case MIPS_INS_BNEZALC:
+		case MIPS_INS_BGEZALC:
+		case MIPS_INS_BGTZALC:
+		case MIPS_INS_BLEZALC:
+		case MIPS_INS_BLTZALC:
+			compact = true;
+			// fall through
+		case MIPS_INS_BGEZAL:
+		case MIPS_INS_BLTZAL:
+		case MIPS_INS_BGEZALL:
+		case MIPS_INS_BLTZALL:
+		case MIPS_INS_BGEZALS:
+		case MIPS_INS_BLTZALS:
+			flow->type = FLOW_CALL;
+			flags = FLOW_COND;
+			break;
+		case MIPS_INS_JALRC:
+		case MIPS_INS_JIALC:
+			compact = true;
+			// fall through
+		case MIPS_INS_JALR:
+		case MIPS_INS_JALRS:
+		case MIPS_INS_JALRS16:
+		case MIPS_INS_JALR_HB:
+			flow->type = FLOW_CALL;
+			flags = FLOW_INDIRECT;
+			break;
+
+		// conditional branches
+		case MIPS_INS_BEQC:
+		case MIPS_INS_BNEC:
+		case MIPS_INS_BEQZC:
+		case MIPS_INS_BNEZC:
+		case MIPS_INS_BGEC:
+		case MIPS_INS_BGEUC:
+		case MIPS_INS_BLTC:
+		case MIPS_INS_BLTUC:
+		case MIPS_INS_BGEZC:
+		case MIPS_INS_BGTZC:
+		case MIPS_INS_BLEZC:
+		case MIPS_INS_BLTZC:
+		case MIPS_INS_BOVC:
+		case MIPS_INS_BNVC:
+			compact = true;
+			// fall through
+		case MIPS_INS_BEQ:
+		case MIPS_INS_BEQL:
+		case MIPS_INS_BEQZ:
+		case MIPS_INS_BEQZ16:
+		case MIPS_INS_BNE:
+		case MIPS_INS_BNEL:
+		case MIPS_INS_BNEZ:
+		case MIPS_INS_BNEZ16:
+		case MIPS_INS_BGEZ:
+		case MIPS_INS_BGEZL:
+		case MIPS_INS_BGTZ:
+		case MIPS_INS_BGTZL:
+		case MIPS_INS_BLEZ:
+		case MIPS_INS_BLEZL:
+		case MIPS_INS_BLTZ:
+		case MIPS_INS_BLTZL:
+		case MIPS_INS_BC0F:
+		case MIPS_INS_BC0FL:
+		case MIPS_INS_BC0T:
+		case MIPS_INS_BC0TL:
+		case MIPS_INS_BC1F:
+		case MIPS_INS_BC1FL:
+		case MIPS_INS_BC1T:
+		case MIPS_INS_BC1TL:
+		case MIPS_INS_BC2F:
+		case MIPS_INS_BC2FL:
+		case MIPS_INS_BC2T:
+		case MIPS_INS_BC2TL:
+		case MIPS_INS_BC3F:
+		case MIPS_INS_BC3FL:
+		case MIPS_INS_BC3T:
+		case MIPS_INS_BC3TL:
+		case MIPS_INS_BC1EQZ:
+		case MIPS_INS_BC1NEZ:
+		case MIPS_INS_BC2EQZ:
+		case MIPS_INS_BC2NEZ:
+		case MIPS_INS_BBIT0:
+		case MIPS_INS_BBIT032:
+		case MIPS_INS_BBIT1:
+		case MIPS_INS_BBIT132:
+		case MIPS_INS_BZ:
+		case MIPS_INS_BNZ:
+		case MIPS_INS_BPOSGE32:
+		case MIPS_INS_BTEQZ:
+		case MIPS_INS_BTNEZ:
+			flow->type = FLOW_JUMP;
+			flags = FLOW_COND;
+			break;
+	}
+
+	flow->flags = flags;
+	flow->delay = compact ? 0 : 1;
+	if ((flags & FLOW_INDIRECT) || flow->type == FLOW_RET)
+		return;
+
+	// the target is the last immediate
+	for (i = 0; i < mips->op_count; i++) {
+		if (mips->operands[i].type == MIPS_OP_IMM)
+			imm = mips->operands[i].imm;
+	}
+
+	if (handle->mode & CS_MODE_MICRO) {
+		// microMips keeps the offset of branches & the index of jumps
+		if (insn->id == MIPS_INS_J || insn->id == MIPS_INS_JAL ||
+				insn->id == MIPS_INS_JALS || insn->id == MIPS_INS_JALX)
+			flow->target = ((insn->address + insn->size) & ~(uint64_t)0x07ffffff) | (uint64_t)imm;
+		else
+			flow->target = insn->address + insn->size + imm;
+	} else if (compact)
+		// so do R6 compact branches
+		flow->target = insn->address + insn->size + imm;
+	else
+		flow->target = (uint64_t)imm;
+
+	if (!(handle->mode & CS_MODE_MIPS64))
+		flow->target &= 0xffffffff;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_POWERPC
+// branches of PPC are fully described by their encoding
+static void ppc_flow(cs_struct *handle, const cs_insn *insn, cs_flow *flow)
+{
+	uint32_t w = insn_word(insn, MODE_IS_BIG_ENDIAN(handle->mode));
+	uint8_t flags = 0;
+	bool link = w & 1;
+
+	switch (w >> 26) {
+		default:
+			return;
+		case 18:	// b, ba, bl, bla
+			flow->target = sign_extend(w & 0x03fffffc, 26);
+			if (!(w & 2))
+				flow->target += insn->address;
+			break;
+		case 16:	// bc, bca, bcl, bcla
+			flow->target = sign_extend(w & 0xfffc, 16);
+			if (!(w & 2))
+				flow->target += insn->address;
+			// BO field: branch always when both "ignore" bits are set
+			if ((w & (0x14 << 21)) != (0x14 << 21))
+				flags = FLOW_COND;
+			break;
+		case 19:
+			if ((w & (0x14 << 21)) != (0x14 << 21))
+				flags = FLOW_COND;
+			switch ((w >> 1) & 0x3ff) {
+				default:
+					return;
+				case 16:	// bclr
+					if (link)
+						set_jump(flow, FLOW_CALL, flags | FLOW_INDIRECT, 0);
+					else
+						set_jump(flow, FLOW_RET, flags, 0);
+					return;
+				case 528:	// bcctr
+				case 560:	// bctar
+					set_jump(flow, link ? FLOW_CALL : FLOW_JUMP, flags | FLOW_INDIRECT, 0);
+					return;
+				case 18:	// rfid
+				case 50:	// rfi
+				case 51:	// rfci
+				case 274:	// hrfid
+					set_jump(flow, FLOW_RET, 0, 0);
+					return;
+			}
+	}
+
+	flow->type = link ? FLOW_CALL : FLOW_JUMP;
+	flow->flags = flags;
+	if (!(handle->mode & CS_MODE_64))
+		flow->target &= 0xffffffff;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_SPARC
+// so are the ones of Sparc, which all have a delay slot
+static void sparc_flow(const cs_insn *insn, cs_flow *flow)
+{
+	uint32_t w = insn_word(insn, true);
+	unsigned int cond;
+
+	flow->delay = 1;
+
+	switch (w >> 30) {
+		default:
+			break;
+		case 1:	// call
+			set_jump(flow, FLOW_CALL, 0, insn->address + sign_extend((uint64_t)w << 2, 32));
+			return;
+		case 0:
+			cond = (w >> 25) & 0xf;
+			switch ((w >> 22) & 7) {
+				default:
+					// not a branch
+					flow->delay = 0;
+					return;
+				case 2:	// Bicc
+				case 6:	// FBfcc
+				case 7:	// CBccc
+					flow->target = insn->address + sign_extend((w & 0x3fffff) << 2, 24);
+					break;
+				case 1:	// BPcc
+				case 5:	// FBPfcc
+					flow->target = insn->address + sign_extend((w & 0x7ffff) << 2, 21);
+					break;
+				case 3:	// BPr
+					flow->target = insn->address +
+						sign_extend(((((w >> 20) & 3) << 14) | (w & 0x3fff)) << 2, 18);
+					set_jump(flow, FLOW_JUMP, FLOW_COND, flow->target);
+					return;
+			}
+			if (cond == 0)
+				// branch never
+				break;
+
+			flow->type = FLOW_JUMP;
+			if (cond != 8)
+				flow->flags = FLOW_COND;
+			else if (w & (1 << 29))
+				// "branch always" with the annul bit skips its delay slot
+				flow->delay = 0;
+			return;
+		case 2:
+			switch ((w >> 19) & 0x3f) {
+				default:
+					break;
+				case 0x38:	// jmpl
+					if (((w >> 25) & 0x1f) == 15)
+						// the return address goes to %o7
+						set_jump(flow, FLOW_CALL, FLOW_INDIRECT, 0);
+					else if (((w >> 25) & 0x1f) == 0 && (w & 0x3fff) == (0x2000 | 8) &&
+							(((w >> 14) & 0x1f) == 31 || ((w >> 14) & 0x1f) == 15))
+						// ret & retl: jmpl %i7+8 or %o7+8
+						set_jump(flow, FLOW_RET, 0, 0);
+					else
+						set_jump(flow, FLOW_JUMP, FLOW_INDIRECT, 0);
+					return;
+				case 0x39:	// return
+					set_jump(flow, FLOW_RET, 0, 0);
+					return;
+			}
+			break;
+	}
+
+	flow->delay = 0;
+	flow->target = 0;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_SYSZ
+// branches of SystemZ are recognized by their encoding, too
+static void sysz_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const uint8_t *b = insn->bytes;
+	unsigned int mask = b[1] >> 4;
+	int64_t rel16 = (int16_t)((b[2] << 8) | b[3]);
+	uint8_t flags = 0;
+
+	switch (b[0]) {
+		default:
+			return;
+		case 0x07:	// bcr
+			if (!mask || !(b[1] & 0xf))
+				// no branch
+				return;
+			if (mask != 15)
+				flags = FLOW_COND;
+			if ((b[1] & 0xf) == 14)
+				// br %r14
+				set_jump(flow, FLOW_RET, flags, 0);
+			else
+				set_jump(flow, FLOW_JUMP, flags | FLOW_INDIRECT, 0);
+			return;
+		case 0x47:	// bc
+			if (!mask)
+				return;
+			set_jump(flow, FLOW_JUMP, (mask != 15 ? FLOW_COND : 0) | FLOW_INDIRECT, 0);
+			return;
+		case 0x05:	// balr
+		case 0x0d:	// basr
+			if (!(b[1] & 0xf))
+				return;
+			// fall through
+		case 0x45:	// bal
+		case 0x4d:	// bas
+			set_jump(flow, FLOW_CALL, FLOW_INDIRECT, 0);
+			return;
+		case 0x06:	// bctr
+			if (!(b[1] & 0xf))
+				return;
+			// fall through
+		case 0x46:	// bct
+			set_jump(flow, FLOW_JUMP, FLOW_COND | FLOW_INDIRECT, 0);
+			return;
+		case 0x84:	// brxh
+		case 0x85:	// brxle
+			set_jump(flow, FLOW_JUMP, FLOW_COND, insn->address + rel16 * 2);
+			return;
+		case 0xa7:
+			switch (b[1] & 0xf) {
+				default:
+					return;
+				case 4:	// brc
+					if (!mask)
+						return;
+					if (mask != 15)
+						flags = FLOW_COND;
+					set_jump(flow, FLOW_JUMP, flags, insn->address + rel16 * 2);
+					return;
+				case 5:	// bras
+					set_jump(flow, FLOW_CALL, 0, insn->address + rel16 * 2);
+					return;
+				case 6:	// brct
+				case 7:	// brctg
+					set_jump(flow, FLOW_JUMP, FLOW_COND, insn->address + rel16 * 2);
+					return;
+			}
+		case 0xc0:
+		case 0xcc: {
+			int64_t rel32 = (int32_t)(((uint32_t)b[2] << 24) | (b[3] << 16) | (b[4] << 8) | b[5]);
+
+			if (b[0] == 0xcc) {
+				// brcth
+				if ((b[1] & 0xf) == 6)
+					set_jump(flow, FLOW_JUMP, FLOW_COND, insn->address + rel32 * 2);
+				return;
+			}
+
+			switch (b[1] & 0xf) {
+				default:
+					return;
+				case 4:	// brcl
+					if (!mask)
+						return;
+					if (mask != 15)
+						flags = FLOW_COND;
+					set_jump(flow, FLOW_JUMP, flags, insn->address + rel32 * 2);
+					return;
+				case 5:	// brasl
+					set_jump(flow, FLOW_CALL, 0, insn->address + rel32 * 2);
+					return;
+			}
+		}
+		case 0xe3:
+			if (b[5] == 0x46)	// bctg
+				set_jump(flow, FLOW_JUMP, FLOW_COND | FLOW_INDIRECT, 0);
+			return;
+		case 0xec:
+			switch (b[5]) {
+				default:
+					return;
+				// compare & branch relative
+				case 0x44:	// brxhg
+				case 0x45:	// brxlg
+				case 0x64:	// cgrj
+				case 0x65:	// clgrj
+				case 0x76:	// crj
+				case 0x77:	// clrj
+				case 0x7c:	// cgij
+				case 0x7d:	// clgij
+				case 0x7e:	// cij
+				case 0x7f:	// clij
+					set_jump(flow, FLOW_JUMP, FLOW_COND, insn->address + rel16 * 2);
+					return;
+				// compare & branch to a computed address
+				case 0xe4:	// cgrb
+				case 0xe5:	// clgrb
+				case 0xf6:	// crb
+				case 0xf7:	// clrb
+				case 0xfc:	// cgib
+				case 0xfd:	// clgib
+				case 0xfe:	// cib
+				case 0xff:	// clib
+					set_jump(flow, FLOW_JUMP, FLOW_COND | FLOW_INDIRECT, 0);
+					return;
+			}
+	}
+}
+#endif
+
+#ifdef CAPSTONE_HAS_XCORE
+static void xcore_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const cs_xcore *xcore = &insn->detail->xcore;
+	const cs_xcore_op *op = &xcore->operands[xcore->op_count - 1];
+
+	switch (insn->id) {
+		default:
+			return;
+		case XCORE_INS_BU:
+			flow->type = FLOW_JUMP;
+			break;
+		case XCORE_INS_BT:
+		case XCORE_INS_BF:
+			flow->type = FLOW_JUMP;
+			flow->flags = FLOW_COND;
+			break;
+		case XCORE_INS_BL:
+			flow->type = FLOW_CALL;
+			break;
+		case XCORE_INS_BLA:
+		case XCORE_INS_BLAT:
+			set_jump(flow, FLOW_CALL, FLOW_INDIRECT, 0);
+			return;
+		case XCORE_INS_BAU:
+		case XCORE_INS_BRU:
+			set_jump(flow, FLOW_JUMP, FLOW_INDIRECT, 0);
+			return;
+		case XCORE_INS_RETSP:
+		case XCORE_INS_KRET:
+		case XCORE_INS_DRET:
+			set_jump(flow, FLOW_RET, 0, 0);
+			return;
+	}
+
+	if (xcore->op_count && op->type == XCORE_OP_IMM)
+		// offset in 16-bit words from the next instruction, negative for backward forms
+		flow->target = (uint32_t)(insn->address + insn->size + (int64_t)op->imm * 2);
+	else
+		// "bla cp[...]" & the like
+		flow->flags |= FLOW_INDIRECT;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_M68K
+static void m68k_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const cs_m68k *m68k = &insn->detail->m68k;
+	const cs_m68k_op *op;
+	int i;
+
+	if ((insn->id >= M68K_INS_BHS && insn->id <= M68K_INS_BLE) ||
+			(insn->id >= M68K_INS_DBT && insn->id <= M68K_INS_DBRA) ||
+			(insn->id >= M68K_INS_FBF && insn->id <= M68K_INS_FBST)) {
+		flow->type = FLOW_JUMP;
+		flow->flags = FLOW_COND;
+	} else {
+		switch (insn->id) {
+			default:
+				return;
+			case M68K_INS_BRA:
+			case M68K_INS_JMP:
+				flow->type = FLOW_JUMP;
+				break;
+			case M68K_INS_BSR:
+			case M68K_INS_JSR:
+				flow->type = FLOW_CALL;
+				break;
+			case M68K_INS_RTS:
+			case M68K_INS_RTR:
+			case M68K_INS_RTD:
+			case M68K_INS_RTE:
+			case M68K_INS_RTM:
+				set_jump(flow, FLOW_RET, 0, 0);
+				return;
+		}
+	}
+
+	for (i = 0; i < m68k->op_count; i++) {
+		op = &m68k->operands[i];
+		if (op->type == M68K_OP_BR_DISP) {
+			// displacement from the extension word
+			flow->target = (uint32_t)(insn->address + 2 + op->br_disp.disp);
+			return;
+		}
+		if (op->type == M68K_OP_MEM &&
+				op->address_mode == M68K_AM_ABSOLUTE_DATA_LONG) {
+			flow->target = (uint32_t)op->imm;
+			return;
+		}
+		if (op->type == M68K_OP_MEM &&
+				op->address_mode == M68K_AM_ABSOLUTE_DATA_SHORT) {
+			flow->target = (uint32_t)(int16_t)op->imm;
+			return;
+		}
+	}
+
+	flow->flags |= FLOW_INDIRECT;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_TMS320C64X
+static void tms320c64x_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const cs_tms320c64x *tms = &insn->detail->tms320c64x;
+	const cs_tms320c64x_op *op = &tms->operands[0];
+
+	switch (insn->id) {
+		default:
+			return;
+		case TMS320C64X_INS_BDEC:
+		case TMS320C64X_INS_BPOS:
+			flow->flags = FLOW_COND;
+			// fall through
+		case TMS320C64X_INS_B:
+		case TMS320C64X_INS_BNOP:
+			flow->type = FLOW_JUMP;
+			break;
+	}
+
+	if (tms->condition.reg != TMS320C64X_REG_INVALID)
+		flow->flags |= FLOW_COND;
+
+	// branches take effect after 5 delay slots, counted here in instructions
+	flow->delay = 5;
+
+	if (tms->op_count && op->type == TMS320C64X_OP_IMM)
+		flow->target = (uint32_t)op->imm;
+	else if (tms->op_count && op->type == TMS320C64X_OP_REG &&
+			(op->reg == TMS320C64X_REG_B3 || op->reg == TMS320C64X_REG_IRP ||
+			 op->reg == TMS320C64X_REG_NRP))
+		// B3 holds the return address of calls
+		flow->type = FLOW_RET;
+	else
+		flow->flags |= FLOW_INDIRECT;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_M680X
+static void m680x_flow(cs_struct *handle, const cs_insn *insn, cs_flow *flow)
+{
+	const cs_m680x *m680x = &insn->detail->m680x;
+	const cs_m680x_op *op;
+	int i;
+
+	switch (insn->id) {
+		default:
+			if (!in_group(insn, M680X_GRP_JUMP))
+				return;
+			flow->type = FLOW_JUMP;
+			flow->flags = FLOW_COND;
+			break;
+		case M680X_INS_BRN:
+		case M680X_INS_LBRN:
+			// branch never
+			return;
+		case M680X_INS_BRA:
+		case M680X_INS_LBRA:
+		case M680X_INS_JMP:
+			flow->type = FLOW_JUMP;
+			break;
+		case M680X_INS_BSR:
+		case M680X_INS_LBSR:
+		case M680X_INS_JSR:
+			flow->type = FLOW_CALL;
+			break;
+		case M680X_INS_CALL:
+			// call to another memory page
+			set_jump(flow, FLOW_CALL, FLOW_INDIRECT, 0);
+			return;
+		case M680X_INS_RTS:
+		case M680X_INS_RTI:
+		case M680X_INS_RTC:
+			set_jump(flow, FLOW_RET, 0, 0);
+			return;
+	}
+
+	for (i = 0; i < m680x->op_count; i++) {
+		op = &m680x->operands[i];
+		if (op->type == M680X_OP_RELATIVE) {
+			flow->target = op->rel.address;
+			return;
+		}
+		if (op->type == M680X_OP_EXTENDED && !op->ext.indirect) {
+			flow->target = op->ext.address;
+			return;
+		}
+		// direct page is only known to be 0 without the DP register
+		if (op->type == M680X_OP_DIRECT &&
+				!(handle->mode & (CS_MODE_M680X_6809 | CS_MODE_M680X_6309))) {
+			flow->target = op->direct_addr;
+			return;
+		}
+	}
+
+	flow->flags |= FLOW_INDIRECT;
+}
+#endif
+
+#ifdef CAPSTONE_HAS_EVM
+static void evm_flow(const cs_insn *insn, cs_flow *flow)
+{
+	switch (insn->id) {
+		default:
+			return;
+		// targets come from the stack
+		case EVM_INS_JUMP:
+			set_jump(flow, FLOW_JUMP, FLOW_INDIRECT, 0);
+			return;
+		case EVM_INS_JUMPI:
+			set_jump(flow, FLOW_JUMP, FLOW_COND | FLOW_INDIRECT, 0);
+			return;
+		// execution ends
+		case EVM_INS_STOP:
+		case EVM_INS_RETURN:
+		case EVM_INS_REVERT:
+		case EVM_INS_INVALID:
+		case EVM_INS_SUICIDE:
+			set_jump(flow, FLOW_RET, 0, 0);
+			return;
+	}
+}
+#endif
+
+#ifdef CAPSTONE_HAS_MOS65XX
+static void mos65xx_flow(const cs_insn *insn, cs_flow *flow)
+{
+	const cs_mos65xx *mos = &insn->detail->mos65xx;
+
+	switch (insn->id) {
+		default:
+			return;
+		case MOS65XX_INS_BCC:
+		case MOS65XX_INS_BCS:
+		case MOS65XX_INS_BEQ:
+		case MOS65XX_INS_BMI:
+		case MOS65XX_INS_BNE:
+		case MOS65XX_INS_BPL:
+		case MOS65XX_INS_BVC:
+		case MOS65XX_INS_BVS:
+			// the offset is not kept in operands
+			set_jump(flow, FLOW_JUMP, FLOW_COND,
+					(insn->address + 2 + (int8_t)insn->bytes[1]) & 0xffff);
+			return;
+		case MOS65XX_INS_JMP:
+			flow->type = FLOW_JUMP;
+			break;
+		case MOS65XX_INS_JSR:
+			flow->type = FLOW_CALL;
+			break;
+		case MOS65XX_INS_RTS:
+		case MOS65XX_INS_RTI:
+			set_jump(flow, FLOW_RET, 0, 0);
+			return;
+	}
+
+	if (mos->am == MOS65XX_AM_ABS && mos->op_count)
+		flow->target = mos->operands[0].mem;
+	else
+		flow->flags = FLOW_INDIRECT;
+}
+#endif
+
+void Flow_get(cs_struct *handle, const cs_insn *insn, cs_flow *flow)
+{
+	memset(flow, 0, sizeof(*flow));
+
+	// no transfer in data skipped by SKIPDATA
+	if (!insn->id || !insn->detail)
+		return;
+
+	switch (handle->arch) {
+		default:
+			break;
+#ifdef CAPSTONE_HAS_ARM
+		case CS_ARCH_ARM:
+			arm_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		case CS_ARCH_ARM64:
+			arm64_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		case CS_ARCH_MIPS:
+			mips_flow(handle, insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_X86
+		case CS_ARCH_X86:
+			x86_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_POWERPC
+		case CS_ARCH_PPC:
+			ppc_flow(handle, insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_SPARC
+		case CS_ARCH_SPARC:
+			sparc_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_SYSZ
+		case CS_ARCH_SYSZ:
+			sysz_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_XCORE
+		case CS_ARCH_XCORE:
+			xcore_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_M68K
+		case CS_ARCH_M68K:
+			m68k_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_TMS320C64X
+		case CS_ARCH_TMS320C64X:
+			tms320c64x_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_M680X
+		case CS_ARCH_M680X:
+			m680x_flow(handle, insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_EVM
+		case CS_ARCH_EVM:
+			evm_flow(insn, flow);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_MOS65XX
+		case CS_ARCH_MOS65XX:
+			mos65xx_flow(insn, flow);
+			break;
+#endif
+	}
+}
+
+bool Flow_by_id(cs_arch arch)
+{
+	switch (arch) {
+		default:
+			// ARM instructions writing to PC, M680X TFR & EXG to PC, and
+			// archs classified from their encoding
+			return false;
+		case CS_ARCH_X86:
+		case CS_ARCH_ARM64:
+		case CS_ARCH_MIPS:
+		case CS_ARCH_XCORE:
+		case CS_ARCH_M68K:
+		case CS_ARCH_TMS320C64X:
+		case CS_ARCH_EVM:
+		case CS_ARCH_MOS65XX:
+			return true;
+	}
+}
+
+void Flow_branch(const cs_flow *flow, cs_branch *branch)
+{
+	branch->target = 0;
+	switch (flow->type) {
+		default:
+			branch->type = CS_BRANCH_NONE;
+			return;
+		case FLOW_RET:
+			branch->type = CS_BRANCH_RET;
+			return;
+		case FLOW_JUMP:
+			if (flow->flags & FLOW_INDIRECT) {
+				branch->type = CS_BRANCH_INDIRECT_JUMP;
+				return;
+			}
+			branch->type = (flow->flags & FLOW_COND) ? CS_BRANCH_COND_JUMP : CS_BRANCH_JUMP;
+			break;
+		case FLOW_CALL:
+			if (flow->flags & FLOW_INDIRECT) {
+				branch->type = CS_BRANCH_INDIRECT_CALL;
+				return;
+			}
+			branch->type = CS_BRANCH_CALL;
+			break;
+	}
+
+	branch->target = flow->target;
+}
+
+// read @n bytes at @p, in the byte order of @big_endian
+static uint32_t read_word(const uint8_t *p, unsigned int n, bool big_endian)
+{
+	uint32_t w = 0;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		w |= (uint32_t)p[big_endian ? i : n - 1 - i] << (8 * (n - 1 - i));
+
+	return w;
+}
+
+static bool gadget_prefix(uint8_t b, bool rex)
+{
+	switch (b) {
+		default:
+			return rex && (b & 0xf0) == 0x40;
+		case 0x26: case 0x2e: case 0x36: case 0x3e:
+		case 0x64: case 0x65: case 0x66: case 0x67:
+		case 0xf0: case 0xf2: case 0xf3:
+			return true;
+	}
+}
+
+unsigned int Flow_gadget_ends(cs_struct *handle, const uint8_t *code, size_t size,
+		size_t offset, size_t *ends)
+{
+	bool big_endian = MODE_IS_BIG_ENDIAN(handle->mode);
+	const uint8_t *p = code + offset;
+	size_t left = size - offset;
+	unsigned int n = 0;
+	uint32_t w, h2;
+
+	switch (handle->arch) {
+		default:
+			break;
+
+		case CS_ARCH_X86:
+			// ret, retf & jmp/call through ff /2 to /5, with their prefixes
+			// before them as other possible starts
+			if ((p[0] & 0xf6) != 0xc2 &&
+					(p[0] != 0xff || left < 2 || ((p[1] >> 3) & 7) < 2 || ((p[1] >> 3) & 7) > 5))
+				return 0;
+			ends[n++] = offset;
+			while (n < FLOW_GADGET_ENDS && n <= offset &&
+					gadget_prefix(code[offset - n], handle->mode & CS_MODE_64)) {
+				ends[n] = offset - n;
+				n++;
+			}
+			return n;
+
+		case CS_ARCH_ARM:
+			if (handle->mode & CS_MODE_THUMB) {
+				if (left < 2)
+					return 0;
+				w = read_word(p, 2, big_endian);
+				// bx & blx reg, pop {pc}, mov & add pc
+				if ((w & 0xff00) == 0x4700 || (w & 0xff00) == 0xbd00 ||
+						(w & 0xff87) == 0x4687 || (w & 0xff87) == 0x4487)
+					break;
+				if (left < 4)
+					return 0;
+				h2 = read_word(p + 2, 2, big_endian);
+				// ldm & ldmdb with pc, ldr pc, tbb & tbh
+				if ((((w & 0xffd0) == 0xe890 || (w & 0xffd0) == 0xe910) && (h2 & 0x8000)) ||
+						(((w & 0xfff0) == 0xf850 || (w & 0xfff0) == 0xf8d0) && (h2 >> 12) == 15) ||
+						((w & 0xfff0) == 0xe8d0 && (h2 & 0xffe0) == 0xf000))
+					break;
+				return 0;
+			}
+			if (left < 4)
+				return 0;
+			w = read_word(p, 4, big_endian);
+			// bx & blx reg, ldm with pc, and data processing or loads to pc
+			if ((w & 0x0ffffff0) == 0x012fff10 || (w & 0x0ffffff0) == 0x012fff30 ||
+					(w & 0x0e108000) == 0x08108000 ||
+					(((w >> 26) & 3) <= 1 && ((w >> 12) & 15) == 15))
+				break;
+			return 0;
+
+		case CS_ARCH_ARM64:
+			// br, blr, ret & eret
+			if (left < 4 || (read_word(p, 4, big_endian) & 0xfe1f0000) != 0xd61f0000)
+				return 0;
+			break;
+
+		case CS_ARCH_MIPS:
+			// the 16-bit encodings of microMips are not screened
+			if (handle->mode & CS_MODE_MICRO)
+				break;
+			if (left < 4)
+				return 0;
+			w = read_word(p, 4, big_endian);
+			// jr & jalr, then jic & jialc of R6
+			if (((w >> 26) == 0 && ((w & 0x3f) == 8 || (w & 0x3f) == 9)) ||
+					(((w >> 26) == 0x36 || (w >> 26) == 0x3e) && ((w >> 21) & 31) == 0))
+				break;
+			return 0;
+
+		case CS_ARCH_PPC:
+			if (left < 4)
+				return 0;
+			w = read_word(p, 4, big_endian);
+			// bclr, bcctr & bctar
+			if ((w >> 26) == 19 && (((w >> 1) & 0x3ff) == 16 ||
+						((w >> 1) & 0x3ff) == 528 || ((w >> 1) & 0x3ff) == 560))
+				break;
+			return 0;
+	}
+
+	ends[n++] = offset;
+	return n;
+}
+
+// index of the instruction at @address in @insns sorted by address, or @count if none
+static size_t insn_at(const cs_insn *insns, size_t count, uint64_t address)
+{
+	size_t lo = 0, hi = count, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (insns[mid].address < address)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return (lo < count && insns[lo].address == address) ? lo : count;
+}
+
+// index of the block starting at @address, or @count if none
+static uint32_t block_at(const cs_block *blocks, size_t count, uint64_t address)
+{
+	size_t lo = 0, hi = count, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (blocks[mid].address < address)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return (uint32_t)((lo < count && blocks[lo].address == address) ? lo : count);
+}
+
+static bool direct(const cs_flow *flow)
+{
+	return flow->type != FLOW_NONE && flow->type != FLOW_RET &&
+		!(flow->flags & (FLOW_INDIRECT | FLOW_MODE_SWITCH));
+}
+
+// mark the instructions starting a basic block in @leader
+static size_t find_leaders(cs_struct *handle, const cs_insn *insns, const cs_flow *flows,
+		size_t count, const uint64_t *entries, size_t entry_count, uint8_t *leader)
+{
+	size_t i, j, end, blocks = 0;
+
+	leader[0] = 1;
+	for (i = 1; i < count; i++) {
+		// gaps between paths
+		if (insns[i].address != insns[i - 1].address + insns[i - 1].size)
+			leader[i] = 1;
+	}
+
+	for (i = 0; entries && i < entry_count; i++) {
+		j = insn_at(insns, count, entries[i]);
+		if (j < count)
+			leader[j] = 1;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (direct(&flows[i])) {
+			j = insn_at(insns, count, flows[i].target);
+			if (j < count)
+				leader[j] = 1;
+		}
+
+		// a block ends after a jump or return, with its delay slots
+		if (flows[i].type == FLOW_JUMP || flows[i].type == FLOW_RET) {
+			end = i + flows[i].delay + 1;
+			if (end < count)
+				leader[end] = 1;
+		}
+	}
+
+#ifdef CAPSTONE_HAS_ARM
+	if (handle->arch == CS_ARCH_ARM) {
+		// instructions predicated by IT (0xbfxy, y != 0) stay with it
+		for (i = 0; i < count; i++) {
+			unsigned int mask = insns[i].bytes[MODE_IS_BIG_ENDIAN(handle->mode) ? 1 : 0] & 0xf, n;
+
+			if (insns[i].id != ARM_INS_IT || !mask)
+				continue;
+
+			for (n = 4; !(mask & 1); mask >>= 1)
+				n--;
+
+			for (j = i + 1; j <= i + n && j < count; j++) {
+				if (insns[j].address != insns[j - 1].address + insns[j - 1].size)
+					break;
+				leader[j] = 0;
+			}
+		}
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+		blocks += leader[i];
+
+	return blocks;
+}
+
+// add the edges leaving block @b
+static void add_edges(cs_cfg *cfg, const cs_flow *flows, uint32_t b)
+{
+	cs_block *block = &cfg->blocks[b];
+	const cs_flow *term = NULL;
+	uint32_t i, last = block->insn + block->insn_count - 1, to;
+	bool fallthrough = true;
+
+	block->succ = (uint32_t)cfg->edge_count;
+
+	for (i = block->insn; i <= last; i++) {
+		const cs_flow *f = &flows[i];
+
+		if (f->type == FLOW_CALL) {
+			to = direct(f) ? block_at(cfg->blocks, cfg->block_count, f->target) :
+				(uint32_t)cfg->block_count;
+			if (to < cfg->block_count) {
+				cfg->edges[cfg->edge_count].from = b;
+				cfg->edges[cfg->edge_count].to = to;
+				cfg->edges[cfg->edge_count++].type = CS_EDGE_CALL;
+			}
+		} else if ((f->type == FLOW_JUMP || f->type == FLOW_RET) && i + f->delay >= last)
+			// transfer ending this block, maybe followed by its delay slots
+			term = f;
+	}
+
+	if (term) {
+		if (term->type == FLOW_JUMP && direct(term)) {
+			to = block_at(cfg->blocks, cfg->block_count, term->target);
+			if (to < cfg->block_count) {
+				cfg->edges[cfg->edge_count].from = b;
+				cfg->edges[cfg->edge_count].to = to;
+				cfg->edges[cfg->edge_count++].type =
+					(term->flags & FLOW_COND) ? CS_EDGE_COND : CS_EDGE_JUMP;
+			}
+		}
+		fallthrough = (term->flags & FLOW_COND) != 0;
+	}
+
+	if (fallthrough && b + 1 < cfg->block_count &&
+			cfg->blocks[b + 1].address == block->address + block->size) {
+		cfg->edges[cfg->edge_count].from = b;
+		cfg->edges[cfg->edge_count].to = b + 1;
+		cfg->edges[cfg->edge_count++].type = CS_EDGE_FALLTHROUGH;
+	}
+
+	block->succ_count = (uint32_t)cfg->edge_count - block->succ;
+}
+#endif
+
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_cfg_build(csh ud, const uint8_t *code, size_t code_size,
+		uint64_t address, const uint64_t *entries, size_t entry_count, cs_cfg **cfg)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	cs_insn *insns;
+	cs_flow *flows = NULL;
+	uint8_t *leader = NULL;
+	size_t count, blocks = 0, edges = 0, i;
+	uint32_t b;
+	cs_cfg *g;
+#endif
+
+	if (!handle)
+		return CS_ERR_HANDLE;
+
+	*cfg = NULL;
+
+#ifdef CAPSTONE_DIET
+	handle->errnum = CS_ERR_DIET;
+	return CS_ERR_DIET;
+#else
+	count = disasm_recursive(handle, code, code_size, address, entries, entry_count,
+			&insns, &flows);
+	if (!count && handle->errnum)
+		return handle->errnum;
+
+	if (count) {
+		leader = HANDLE_CALLOC(handle, count, 1);
+		if (!leader)
+			goto nomem;
+
+		blocks = find_leaders(handle, insns, flows, count, entries, entry_count, leader);
+
+		// a block has at most 2 edges besides its calls
+		edges = blocks * 2;
+		for (i = 0; i < count; i++) {
+			if (flows[i].type == FLOW_CALL)
+				edges++;
+		}
+	}
+
+	// the graph, its blocks, edges & predecessors all go in one allocation
+	g = HANDLE_CALLOC(handle, 1, sizeof(*g) + blocks * sizeof(cs_block) +
+			edges * (sizeof(cs_edge) + sizeof(uint32_t)));
+	if (!g)
+		goto nomem;
+
+	g->insns = insns;
+	g->insn_count = count;
+	g->blocks = (cs_block *)(g + 1);
+	g->edges = (cs_edge *)(g->blocks + blocks);
+	g->preds = (uint32_t *)(g->edges + edges);
+
+	// split instructions into blocks
+	for (i = 0; i < count; i++) {
+		cs_block *block;
+
+		if (leader[i]) {
+			block = &g->blocks[g->block_count++];
+			block->address = insns[i].address;
+			block->insn = (uint32_t)i;
+		} else
+			block = &g->blocks[g->block_count - 1];
+
+		block->size += insns[i].size;
+		block->insn_count++;
+	}
+
+	for (b = 0; b < g->block_count; b++)
+		add_edges(g, flows, b);
+
+	// predecessors: count the incoming edges of every block, then place them
+	for (i = 0; i < g->edge_count; i++)
+		g->blocks[g->edges[i].to].pred_count++;
+
+	for (b = 0, i = 0; b < g->block_count; b++) {
+		g->blocks[b].pred = (uint32_t)i;
+		i += g->blocks[b].pred_count;
+		g->blocks[b].pred_count = 0;
+	}
+
+	for (i = 0; i < g->edge_count; i++) {
+		cs_block *to = &g->blocks[g->edges[i].to];
+		g->preds[to->pred + to->pred_count++] = (uint32_t)i;
+	}
+
+	HANDLE_FREE(handle, leader);
+	HANDLE_FREE(handle, flows);
+
+	*cfg = g;
+	return CS_ERR_OK;
+
+nomem:
+	HANDLE_FREE(handle, leader);
+	HANDLE_FREE(handle, flows);
+	for (i = 0; i < count; i++)
+		HANDLE_FREE(handle, insns[i].detail);
+	HANDLE_FREE(handle, insns);
+
+	handle->errnum = CS_ERR_MEM;
+	return CS_ERR_MEM;
+#endif
+}
+
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_cfg_free(csh ud, cs_cfg *cfg)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+	size_t i;
+
+	if (!handle || !cfg)
+		return;
+
+	for (i = 0; i < cfg->insn_count; i++)
+		HANDLE_FREE(handle, cfg->insns[i].detail);
+
+	HANDLE_FREE(handle, cfg->insns);
+	HANDLE_FREE(handle, cfg);
+}
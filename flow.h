@@ -0,0 +1,57 @@
+/* Capstone Disassembly Engine */
+/* Control flow of decoded instructions */
+
+#ifndef CS_FLOW_H
+#define CS_FLOW_H
+
+#include "cs_priv.h"
+
+// how an instruction transfers control
+typedef enum flow_type {
+	FLOW_NONE = 0,	// no transfer: continue with the next instruction
+	FLOW_JUMP,	// jump or branch
+	FLOW_CALL,	// call, expected to return to the next instruction
+	FLOW_RET,	// return, from a function or an exception
+} flow_type;
+
+// flags of a transfer
+#define FLOW_COND	1	// conditional, so it can also fall through
+#define FLOW_INDIRECT	2	// target is not known statically
+#define FLOW_MODE_SWITCH	4	// target is decoded in another mode (ARM BLX, Mips JALX)
+
+typedef struct cs_flow {
+	uint8_t type;	// flow_type
+	uint8_t flags;	// FLOW_COND | FLOW_INDIRECT | FLOW_MODE_SWITCH
+	uint8_t delay;	// number of delay slots executed before the transfer
+	uint64_t target;	// target of a direct transfer
+} cs_flow;
+
+#ifndef CAPSTONE_DIET
+// classify the control transfer of @insn, which must have its detail filled
+void Flow_get(cs_struct *handle, const cs_insn *insn, cs_flow *flow);
+
+// true if, on @arch, whether an instruction transfers control only depends on
+// its ID (groups of x86 are tied to the ID too)
+bool Flow_by_id(cs_arch arch);
+
+// convert @flow to its public form, as in cs_detail.branch
+void Flow_branch(const cs_flow *flow, cs_branch *branch);
+
+// most gadget ends found by Flow_gadget_ends()
+#define FLOW_GADGET_ENDS	5
+
+// screen the encoding at @offset of @code of @size bytes for a return or an
+// indirect transfer, without decoding it. return the number of offsets where
+// such an instruction may start, which go to @ends. archs that are not screened
+// return @offset itself, for the decoder to check
+unsigned int Flow_gadget_ends(cs_struct *handle, const uint8_t *code, size_t size,
+		size_t offset, size_t *ends);
+
+// recursive descent behind cs_disasm_recursive() & cs_cfg_build(), in cs.c.
+// instructions are sorted by address, with their flow in @flows if not NULL
+size_t disasm_recursive(cs_struct *handle, const uint8_t *code, size_t code_size,
+		uint64_t address, const uint64_t *entries, size_t entry_count,
+		cs_insn **insn, cs_flow **flows);
+#endif
+
+#endif
@@ -0,0 +1,350 @@
+/* Capstone Disassembly Engine */
+/* Normalized hashes of instructions, for code similarity */
+
+#if defined(CAPSTONE_HAS_OSXKERNEL)
+#include <libkern/libkern.h>
+#else
+#include <string.h>
+#endif
+
+#include "cs_priv.h"
+#include "utils.h"
+
+#ifndef CAPSTONE_DIET
+
+// operands hashed, after their count
+#define HASH_OPS 16
+
+// instruction words whose tokens are cached on fixed-width archs
+#define HASH_CACHE 4096
+
+// multiplier of the polynomial rolled over the tokens of n-grams
+#define HASH_BASE 0x100000001b3ULL
+
+static uint64_t hash_mix(uint64_t h, uint64_t v)
+{
+	return (h ^ v) * 0x9e3779b97f4a7c15ULL;
+}
+
+// spread every bit of @h over the whole hash, so that its low 32 bits are
+// as good as all of it
+static uint64_t hash_final(uint64_t h)
+{
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebULL;
+	return h ^ (h >> 31);
+}
+
+// class of register @reg, which is never 0
+static unsigned int reg_class(cs_struct *handle, unsigned int reg)
+{
+	const char *name;
+	unsigned int h, len;
+
+	if (handle->arch == CS_ARCH_X86) {
+		// general purpose registers are mixed with the others, and only
+		// differ by their size
+		if (reg >= X86_REG_CR0 && reg <= X86_REG_CR15)
+			return 1;
+		if (reg >= X86_REG_DR0 && reg <= X86_REG_DR15)
+			return 2;
+		if ((reg >= X86_REG_FP0 && reg <= X86_REG_FP7) ||
+				(reg >= X86_REG_ST0 && reg <= X86_REG_ST7))
+			return 3;
+		if (reg >= X86_REG_K0 && reg <= X86_REG_K7)
+			return 4;
+		if (reg >= X86_REG_MM0 && reg <= X86_REG_MM7)
+			return 5;
+		if (reg >= X86_REG_XMM0 && reg <= X86_REG_XMM31)
+			return 6;
+		if (reg >= X86_REG_YMM0 && reg <= X86_REG_YMM31)
+			return 7;
+		if (reg >= X86_REG_ZMM0 && reg <= X86_REG_ZMM31)
+			return 8;
+
+		switch (reg) {
+			case X86_REG_CS:
+			case X86_REG_DS:
+			case X86_REG_ES:
+			case X86_REG_FS:
+			case X86_REG_GS:
+			case X86_REG_SS:
+				return 9;
+			case X86_REG_IP:
+			case X86_REG_EIP:
+			case X86_REG_RIP:
+				return 10;
+			case X86_REG_EFLAGS:
+			case X86_REG_FPSW:
+				return 11;
+		}
+
+		if (reg < X86_REG_ENDING && handle->regsize_map)
+			return 16 + handle->regsize_map[reg];
+		return 16;
+	}
+
+	// elsewhere, registers of a class are named alike up to their number,
+	// like x0 & x30 or q0 & q15
+	name = handle->reg_name ? handle->reg_name((csh)handle, reg) : NULL;
+	if (!name)
+		return reg;
+
+	for (len = (unsigned int)strlen(name); len > 1; len--) {
+		if (name[len - 1] < '0' || name[len - 1] > '9')
+			break;
+	}
+
+	h = 2166136261u;
+	while (len--)
+		h = (h ^ (uint8_t)*name++) * 16777619u;
+
+	return h | 1;
+}
+
+// register @reg as hashed at @level
+static unsigned int hash_reg(cs_struct *handle, unsigned int reg, cs_hash_level level)
+{
+	if (!reg || level == CS_HASH_OPERANDS)
+		return 0;
+
+	return level == CS_HASH_CLASSES ? reg_class(handle, reg) : reg;
+}
+
+// token of @insn, whose detail is needed above CS_HASH_ID
+static uint64_t insn_token(cs_struct *handle, const cs_insn *insn, cs_hash_level level)
+{
+	detail_op ops[HASH_OPS];
+	unsigned int count, i;
+	uint64_t h;
+
+	h = hash_mix(0, insn->id);
+
+	// skipped data has no operands
+	if (level != CS_HASH_ID && insn->id) {
+		count = detail_operands(handle->arch, insn->detail, ops, HASH_OPS);
+		h = hash_mix(h, count);
+
+		// immediates & displacements are left out, as they change with
+		// addresses & layouts
+		for (i = 0; i < count && i < HASH_OPS; i++) {
+			uint64_t v = ops[i].type;
+
+			if (ops[i].type == CS_OP_REG)
+				v |= (uint64_t)hash_reg(handle, ops[i].reg, level) << 8;
+			else if (ops[i].type == CS_OP_MEM)
+				v |= ((uint64_t)hash_reg(handle, ops[i].reg, level) << 8) ^
+					((uint64_t)hash_reg(handle, ops[i].index, level) << 36);
+
+			h = hash_mix(h, v);
+		}
+	}
+
+	return hash_final(h);
+}
+#endif
+
+CAPSTONE_EXPORT
+uint64_t CAPSTONE_API cs_insn_hash(csh ud, const cs_insn *insn, cs_hash_level level)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle)
+		return 0;
+
+#ifdef CAPSTONE_DIET
+	handle->errnum = CS_ERR_DIET;
+	return 0;
+#else
+	if (level > CS_HASH_REGS) {
+		handle->errnum = CS_ERR_OPTION;
+		return 0;
+	}
+
+	if (level != CS_HASH_ID && insn->id && !insn->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return 0;
+	}
+
+	return insn_token(handle, insn, level);
+#endif
+}
+
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_ngram_hash(csh ud, const uint8_t *code, size_t code_size,
+		uint64_t address, cs_hash_level level, unsigned int n, cs_ngram **ngrams)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	uint64_t *tokens, *addresses, *cache_tokens = NULL, token = 0, power, h = 0;
+	uint32_t *cache_words = NULL;
+	uint8_t *cache_kinds = NULL;
+	cs_ngram *out = NULL, *g;
+	size_t count = 0, size = 0, seen = 0;
+	unsigned int width, align, i, slot = 0;
+	cs_opt_value detail;
+	bool notext, branch, skipdata, valid;
+	cs_detail insn_detail;
+	cs_insn insn;
+#endif
+
+	if (!handle)
+		return 0;
+
+	*ngrams = NULL;
+
+#ifdef CAPSTONE_DIET
+	handle->errnum = CS_ERR_DIET;
+	return 0;
+#else
+	if (level > CS_HASH_REGS || !n) {
+		handle->errnum = CS_ERR_OPTION;
+		return 0;
+	}
+
+	handle->errnum = CS_ERR_OK;
+
+	// every instruction has a byte at least
+	if (n > code_size)
+		return 0;
+
+	tokens = HANDLE_MALLOC(handle, 2 * n * sizeof(uint64_t));
+	if (!tokens) {
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+	addresses = tokens + n;
+
+	// tokens only depend on instruction words, where these have a fixed size
+	width = insn_fixed_size(handle);
+	if (width) {
+		cache_tokens = HANDLE_MALLOC(handle, HASH_CACHE *
+				(sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint8_t)));
+		if (cache_tokens) {
+			cache_words = (uint32_t *)(cache_tokens + HASH_CACHE);
+			cache_kinds = (uint8_t *)(cache_words + HASH_CACHE);
+			// 0: empty slot, 1: valid instruction, 2: invalid
+			memset(cache_kinds, 0, HASH_CACHE);
+		}
+	}
+
+	// HASH_BASE^n, which takes the oldest token out of the hash of a window
+	power = 1;
+	for (i = 0; i < n; i++)
+		power *= HASH_BASE;
+
+	// neither text nor data is needed, and the detail only for operands
+	detail = handle->detail;
+	notext = handle->notext;
+	branch = handle->branch;
+	skipdata = handle->skipdata;
+	handle->detail = level != CS_HASH_ID ? CS_OPT_ON : CS_OPT_OFF;
+	handle->notext = true;
+	handle->branch = false;
+	handle->skipdata = false;
+	insn.detail = level != CS_HASH_ID ? &insn_detail : NULL;
+
+	align = skipdata_size(handle);
+
+	while (code_size) {
+		const uint8_t *p = code;
+		size_t left = code_size;
+		uint64_t a = address;
+		uint32_t word = 0;
+
+		if (cache_tokens && code_size >= width) {
+			memcpy(&word, code, sizeof(word));
+			slot = (word * 2654435761u) >> 20;
+			if (cache_kinds[slot] && cache_words[slot] == word) {
+				valid = cache_kinds[slot] == 1;
+				if (valid) {
+					token = cache_tokens[slot];
+					p += width;
+					left -= width;
+					a += width;
+				}
+				goto decoded;
+			}
+		}
+
+		valid = cs_disasm_iter(ud, &p, &left, &a, &insn);
+		if (valid)
+			token = insn_token(handle, &insn, level);
+
+		if (cache_tokens && code_size >= width) {
+			cache_words[slot] = word;
+			cache_kinds[slot] = valid ? 1 : 2;
+			cache_tokens[slot] = token;
+		}
+
+decoded:
+		if (!valid) {
+			// n-grams do not span data
+			seen = 0;
+			h = 0;
+			if (code_size < align)
+				break;
+			code += align;
+			code_size -= align;
+			address += align;
+			continue;
+		}
+
+		// roll the window over the new token
+		h = h * HASH_BASE + token;
+		if (seen >= n)
+			h -= tokens[seen % n] * power;
+		tokens[seen % n] = token;
+		addresses[seen % n] = address;
+		seen++;
+
+		if (seen >= n) {
+			if (count == size) {
+				size = size ? 2 * size : 256;
+				g = HANDLE_REALLOC(handle, out, size * sizeof(*out));
+				if (!g) {
+					HANDLE_FREE(handle, out);
+					out = NULL;
+					count = 0;
+					handle->errnum = CS_ERR_MEM;
+					break;
+				}
+				out = g;
+			}
+
+			g = &out[count++];
+			g->address = addresses[seen % n];
+			g->hash = hash_final(h);
+		}
+
+		code_size -= p - code;
+		code = p;
+		address = a;
+	}
+
+	handle->detail = detail;
+	handle->notext = notext;
+	handle->branch = branch;
+	handle->skipdata = skipdata;
+
+	HANDLE_FREE(handle, cache_tokens);
+	HANDLE_FREE(handle, tokens);
+
+	*ngrams = out;
+
+	return count;
+#endif
+}
+
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_ngram_free(csh ud, cs_ngram *ngrams)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || !ngrams)
+		return;
+
+	HANDLE_FREE(handle, ngrams);
+}
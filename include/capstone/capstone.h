@@ -154,12 +154,29 @@ typedef struct cs_opt_mem {
 	cs_vsnprintf_t vsnprintf;
 } cs_opt_mem;
 
+typedef void* (CAPSTONE_API *cs_handle_malloc_t)(void *user_data, size_t size);
+typedef void* (CAPSTONE_API *cs_handle_calloc_t)(void *user_data, size_t nmemb, size_t size);
+typedef void* (CAPSTONE_API *cs_handle_realloc_t)(void *user_data, void *ptr, size_t size);
+typedef void (CAPSTONE_API *cs_handle_free_t)(void *user_data, void *ptr);
+
+/// User-defined dynamic memory functions of a single handle (see cs_open_mem()).
+/// Unlike CS_OPT_MEM, these are private to the handle, so each handle can have
+/// its own arena or per-thread allocator. Like free(), @free must accept NULL.
+typedef struct cs_opt_mem_handle {
+	cs_handle_malloc_t malloc;
+	cs_handle_calloc_t calloc;
+	cs_handle_realloc_t realloc;
+	cs_handle_free_t free;
+	void *user_data;	///< passed as first argument to all functions above
+} cs_opt_mem_handle;
+
 /// Customize mnemonic for instructions with alternative name.
 /// To reset existing customized instruction to its default mnemonic,
 /// call cs_option(CS_OPT_MNEMONIC) again with the same @id and NULL value
 /// for @mnemonic.
 typedef struct cs_opt_mnem {
-	/// ID of instruction to be customized.
+	/// ID of instruction to be customized, below the *_INS_ENDING of the arch
+	/// (CS_ERR_OPTION otherwise).
 	unsigned int id;
 	/// Customized instruction mnemonic.
 	const char *mnemonic;
@@ -176,12 +193,15 @@ typedef enum cs_opt_type {
 	CS_OPT_SKIPDATA_SETUP, ///< Setup user-defined function for SKIPDATA option
 	CS_OPT_MNEMONIC, ///< Customize instruction mnemonic
 	CS_OPT_UNSIGNED, ///< print immediate operands in unsigned form
+	CS_OPT_NOTEXT, ///< Do not generate mnemonic & op_str, only instruction ID & details.
+	CS_OPT_THREADS, ///< Number of threads of cs_disasm_recursive() & cs_cfg_build(): 1 by default, 0 for one per CPU
+	CS_OPT_BRANCH, ///< Classify control transfers into cs_detail.branch, or on demand with CS_OPT_DETAIL off
 } cs_opt_type;
 
 /// Runtime option value (associated with option type above)
 typedef enum cs_opt_value {
-	CS_OPT_OFF = 0,  ///< Turn OFF an option - default for CS_OPT_DETAIL, CS_OPT_SKIPDATA, CS_OPT_UNSIGNED.
-	CS_OPT_ON = 3, ///< Turn ON an option (CS_OPT_DETAIL, CS_OPT_SKIPDATA).
+	CS_OPT_OFF = 0,  ///< Turn OFF an option - default for CS_OPT_DETAIL, CS_OPT_SKIPDATA, CS_OPT_UNSIGNED, CS_OPT_NOTEXT, CS_OPT_BRANCH.
+	CS_OPT_ON = 3, ///< Turn ON an option (CS_OPT_DETAIL, CS_OPT_SKIPDATA, CS_OPT_NOTEXT, CS_OPT_BRANCH).
 	CS_OPT_SYNTAX_DEFAULT = 0, ///< Default asm syntax (CS_OPT_SYNTAX).
 	CS_OPT_SYNTAX_INTEL, ///< X86 Intel asm syntax - default on X86 (CS_OPT_SYNTAX).
 	CS_OPT_SYNTAX_ATT,   ///< X86 ATT asm syntax (CS_OPT_SYNTAX).
@@ -280,6 +300,25 @@ typedef struct cs_opt_skipdata {
 #include "evm.h"
 #include "mos65xx.h"
 
+/// Kind of control transfer of an instruction, see cs_insn_branch_target()
+typedef enum cs_branch_type {
+	CS_BRANCH_NONE = 0,	///< No control transfer: execution goes on with the next instruction
+	CS_BRANCH_JUMP,	///< Unconditional jump to a direct target
+	CS_BRANCH_COND_JUMP,	///< Conditional jump to a direct target, or to the next instruction
+	CS_BRANCH_CALL,	///< Call of a direct target (conditional or not)
+	CS_BRANCH_INDIRECT_JUMP,	///< Jump to a target unknown statically, such as a register
+	CS_BRANCH_INDIRECT_CALL,	///< Call of a target unknown statically
+	CS_BRANCH_RET,	///< Return from a function or an exception (conditional or not)
+} cs_branch_type;
+
+/// Control transfer of an instruction, filled in with CS_OPT_BRANCH
+typedef struct cs_branch {
+	/// Absolute target of CS_BRANCH_JUMP, CS_BRANCH_COND_JUMP & CS_BRANCH_CALL, or 0
+	uint64_t target;
+	/// Kind of transfer (cs_branch_type)
+	uint8_t type;
+} cs_branch;
+
 /// NOTE: All information in cs_detail is only available when CS_OPT_DETAIL = CS_OPT_ON
 /// Initialized as memset(., 0, offsetof(cs_detail, ARCH)+sizeof(cs_ARCH))
 /// by ARCH_getInstruction in arch/ARCH/ARCHDisassembler.c
@@ -311,8 +350,28 @@ typedef struct cs_detail {
 		cs_evm evm;	    ///< Ethereum architecture
 		cs_mos65xx mos65xx;	///< MOS65XX architecture (including MOS6502)
 	};
+
+	/// bitmask of @groups with ID below 64: bit N is set for group N.
+	/// This covers all generic groups of cs_group_type.
+	uint64_t groups_mask;
+	/// bitmask of @groups with ID from 128 to 191: bit N is set for group 128 + N.
+	/// This covers all arch-specific groups of architectures numbering them from 128.
+	uint64_t arch_groups_mask;
+
+	/// Control transfer of this instruction, with its target.
+	/// This information is only valid when CS_OPT_BRANCH = CS_OPT_ON. With
+	/// CS_OPT_DETAIL = CS_OPT_OFF, there is no detail: see cs_insn_branch_target().
+	cs_branch branch;
 } cs_detail;
 
+/// Check if the instruction with detail @detail belongs to group @group_id,
+/// using cs_detail.groups_mask & cs_detail.arch_groups_mask.
+/// This is the same as cs_insn_group(), without any check on the handle.
+#define CS_DETAIL_GROUP(detail, group_id) \
+	((group_id) < 64 ? (((detail)->groups_mask >> (group_id)) & 1) : \
+	 ((group_id) >= 128 && (group_id) < 192) ? \
+	 (((detail)->arch_groups_mask >> ((group_id) - 128)) & 1) : 0)
+
 /// Detail information of disassembled instruction
 typedef struct cs_insn {
 	/// Instruction ID (basically a numeric ID for the instruction mnemonic)
@@ -378,6 +437,7 @@ typedef enum cs_err {
 	CS_ERR_X86_ATT,  ///< X86 AT&T syntax is unsupported (opt-out at compile time)
 	CS_ERR_X86_INTEL, ///< X86 Intel syntax is unsupported (opt-out at compile time)
 	CS_ERR_X86_MASM, ///< X86 Masm syntax is unsupported (opt-out at compile time)
+	CS_ERR_PATTERN,  ///< Invalid instruction pattern: cs_pattern_compile()
 } cs_err;
 
 /**
@@ -447,6 +507,61 @@ cs_err CAPSTONE_API cs_open(cs_arch arch, cs_mode mode, csh *handle);
 CAPSTONE_EXPORT
 cs_err CAPSTONE_API cs_close(csh *handle);
 
+/**
+ Same as cs_open(), but all memory of the new handle is allocated with the
+ functions in @mem rather than the global ones of CS_OPT_MEM: the handle itself,
+ its internal tables, customized mnemonics, as well as instructions & details
+ returned by cs_disasm() & cs_malloc().
+
+ NOTE: instructions of such a handle must be freed with cs_handle_free(),
+ not cs_free().
+
+ @arch: architecture type (CS_ARCH_*)
+ @mode: hardware mode. This is combined of CS_MODE_*
+ @mem: allocator of the handle, which is copied, so it can be discarded after
+   this API returns. NULL to use the global allocator, like cs_open().
+ @handle: pointer to handle, which will be updated at return time
+
+ @return CS_ERR_OK on success, or other value on failure (refer to cs_err enum
+ for detailed error).
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_open_mem(cs_arch arch, cs_mode mode,
+		const cs_opt_mem_handle *mem, csh *handle);
+
+/**
+ Same as cs_open(), but all memory of the new handle comes from a bump arena
+ owned by the handle (see cs_open_mem() for what is allocated there).
+ Allocation is only a pointer increment, and nothing is freed individually:
+ cs_close() releases the whole arena at once, and cs_arena_reset() releases
+ everything allocated after cs_open_arena() returned.
+
+ @arch: architecture type (CS_ARCH_*)
+ @mode: hardware mode. This is combined of CS_MODE_*
+ @chunk_size: size in bytes of memory blocks taken from the global allocator
+   by the arena, or 0 for a default size (64KB)
+ @handle: pointer to handle, which will be updated at return time
+
+ @return CS_ERR_OK on success, or other value on failure (refer to cs_err enum
+ for detailed error).
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_open_arena(cs_arch arch, cs_mode mode,
+		size_t chunk_size, csh *handle);
+
+/**
+ Release all memory allocated by a handle opened with cs_open_arena() since
+ cs_open_arena() returned, at once. All instructions returned by cs_disasm()
+ & cs_malloc() until now become invalid, and customized mnemonics
+ (CS_OPT_MNEMONIC) are dropped.
+
+ @handle: handle returned by cs_open_arena()
+
+ @return CS_ERR_OK on success, or CS_ERR_HANDLE if @handle has no arena.
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_arena_reset(csh handle);
+
 /**
  Set option for disassembling engine at runtime
 
@@ -549,6 +664,19 @@ size_t CAPSTONE_API cs_disasm_ex(csh handle,
 CAPSTONE_EXPORT
 void CAPSTONE_API cs_free(cs_insn *insn, size_t count);
 
+/**
+ Same as cs_free(), but with the allocator of @handle. This must be used for
+ instructions of a handle opened with cs_open_mem() or cs_open_arena(), and
+ works with any other handle as well.
+
+ @handle: handle that returned @insn
+ @insn: pointer returned by @insn argument in cs_disasm() or cs_malloc()
+ @count: number of cs_insn structures returned by cs_disasm(), or 1
+     to free memory allocated by cs_malloc().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_handle_free(csh handle, cs_insn *insn, size_t count);
+
 
 /**
  Allocate memory for 1 instruction to be used by cs_disasm_iter().
@@ -601,6 +729,555 @@ bool CAPSTONE_API cs_disasm_iter(csh handle,
 	const uint8_t **code, size_t *size,
 	uint64_t *address, cs_insn *insn);
 
+/**
+ Same as cs_disasm_iter(), but only for a handle of X86 architecture.
+ The decoder, mapper & printer are called directly rather than through the
+ callbacks of @handle, so they can be inlined with link-time optimization.
+ Only the default Intel syntax has its printer dispatched statically.
+
+ @return: true if this API successfully decode 1 instruction, or false
+ otherwise. When @handle is not X86 (or X86 is not compiled in), false is
+ returned with error code CS_ERR_ARCH.
+*/
+CAPSTONE_EXPORT
+bool CAPSTONE_API cs_disasm_iter_x86(csh handle,
+	const uint8_t **code, size_t *size,
+	uint64_t *address, cs_insn *insn);
+
+/**
+ Same as cs_disasm_iter(), but only for a handle of ARM64 architecture.
+ The decoder, mapper & printer are called directly rather than through the
+ callbacks of @handle, so they can be inlined with link-time optimization.
+
+ @return: true if this API successfully decode 1 instruction, or false
+ otherwise. When @handle is not ARM64 (or ARM64 is not compiled in), false is
+ returned with error code CS_ERR_ARCH.
+*/
+CAPSTONE_EXPORT
+bool CAPSTONE_API cs_disasm_iter_arm64(csh handle,
+	const uint8_t **code, size_t *size,
+	uint64_t *address, cs_insn *insn);
+
+/// Groups ending a block of cs_disasm_block() by default:
+/// jumps, calls, returns, interrupts & interrupt returns.
+#define CS_BLOCK_GROUPS (((uint64_t)1 << CS_GRP_JUMP) | ((uint64_t)1 << CS_GRP_CALL) | \
+		((uint64_t)1 << CS_GRP_RET) | ((uint64_t)1 << CS_GRP_INT) | ((uint64_t)1 << CS_GRP_IRET))
+
+/**
+ Disassemble binary code up to the first control transfer, such as a basic
+ block: instructions are decoded until one belongs to a group of @groups,
+ and nothing is decoded past it, but its delay slots (Mips, Sparc).
+ Decoding also stops at the end of the buffer, or at an invalid instruction
+ (SKIPDATA does not apply).
+
+ Jumps, calls & returns are also recognized from their operands, so they end
+ the block with CS_GRP_JUMP, CS_GRP_CALL or CS_GRP_RET in @groups even where
+ the arch does not put them in that group (like Mips JAL for CS_GRP_CALL).
+ This works even with CS_OPT_DETAIL off: the detail is then built internally,
+ but not returned in @insn.
+
+ @handle: handle returned by cs_open()
+ @code: buffer containing raw binary code to be disassembled.
+ @code_size: size of the above code buffer.
+ @address: address of the first byte in given raw code buffer.
+ @groups: bitmask of groups ending the block, with bit N for group N
+    (see cs_detail.groups_mask), or 0 for CS_BLOCK_GROUPS.
+ @insn: array of instructions filled in by this API.
+	   NOTE: @insn will be allocated by this function, and should be freed
+	   with cs_free() API (or cs_handle_free() for handles with their own allocator).
+ @target: if not NULL, receives the target of the last instruction when it is
+    a direct jump or call.
+ @has_target: if not NULL, set to true when @target was filled in, or false
+    otherwise (no control transfer, indirect one, return or interrupt).
+
+ @return: the number of successfully disassembled instructions,
+ or 0 if this function failed to disassemble the given code
+
+ On failure, call cs_errno() for error code.
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_disasm_block(csh handle,
+		const uint8_t *code, size_t code_size, uint64_t address,
+		uint64_t groups, cs_insn **insn, uint64_t *target, bool *has_target);
+
+/**
+ Disassemble binary code by recursive descent, rather than by linear sweep
+ like cs_disasm(): starting from each entry point, instructions are decoded
+ until an unconditional jump or a return, and the direct targets of jumps &
+ calls inside the buffer are followed too. Every address is in the output at
+ most once, and an invalid instruction ends its path (SKIPDATA does not apply).
+
+ Branches are classified from the groups & operands of instructions, so this
+ works even with CS_OPT_DETAIL off: the detail is then built internally, but
+ not returned in @insn. Delay slots (Mips, Sparc) are decoded with their branch.
+
+ With CS_OPT_THREADS, paths are followed by several threads, each with its own
+ copy of @handle. The output does not depend on the number of threads, nor on
+ the order paths are followed in, except on ARM when a path starts inside the
+ IT block of another one: instructions there depend on the path decoding them.
+
+ @handle: handle returned by cs_open()
+ @code: buffer containing raw binary code to be disassembled.
+ @code_size: size of the above code buffer.
+ @address: address of the first byte in given raw code buffer.
+ @entries: addresses to start decoding from. Those outside of the buffer
+    are ignored. With NULL (or @entry_count = 0), the start of the buffer is used.
+ @entry_count: number of addresses in @entries.
+ @insn: array of instructions filled in by this API, sorted by address.
+	   NOTE: @insn will be allocated by this function, and should be freed
+	   with cs_free() API (or cs_handle_free() for handles with their own allocator).
+
+ @return: the number of successfully disassembled instructions,
+ or 0 if this function failed to disassemble the given code
+
+ On failure, call cs_errno() for error code.
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_disasm_recursive(csh handle,
+		const uint8_t *code, size_t code_size, uint64_t address,
+		const uint64_t *entries, size_t entry_count,
+		cs_insn **insn);
+
+/// Basic block of a control flow graph (see cs_cfg_build())
+typedef struct cs_block {
+	uint64_t address;	///< address of the first instruction
+	uint32_t size;		///< size of all instructions, in bytes
+	uint32_t insn;		///< index of the first instruction in cs_cfg.insns
+	uint32_t insn_count;	///< number of instructions
+	uint32_t succ;		///< index of the first outgoing edge in cs_cfg.edges
+	uint32_t succ_count;	///< number of outgoing edges
+	uint32_t pred;		///< index of the first incoming edge in cs_cfg.preds
+	uint32_t pred_count;	///< number of incoming edges
+} cs_block;
+
+/// Type of an edge between two basic blocks
+typedef enum cs_edge_type {
+	CS_EDGE_FALLTHROUGH = 0,	///< to the next block, without a taken branch
+	CS_EDGE_JUMP,	///< unconditional jump
+	CS_EDGE_COND,	///< taken conditional branch
+	CS_EDGE_CALL,	///< call to the first block of a function
+} cs_edge_type;
+
+/// Edge between two basic blocks
+typedef struct cs_edge {
+	uint32_t from;	///< index of the source block in cs_cfg.blocks
+	uint32_t to;	///< index of the destination block in cs_cfg.blocks
+	uint8_t type;	///< cs_edge_type
+} cs_edge;
+
+/// Control flow graph, built by cs_cfg_build()
+typedef struct cs_cfg {
+	cs_insn *insns;	///< instructions sorted by address, as from cs_disasm_recursive()
+	size_t insn_count;	///< number of instructions in @insns
+	cs_block *blocks;	///< basic blocks sorted by address
+	size_t block_count;	///< number of blocks in @blocks
+	cs_edge *edges;	///< edges, grouped by source block (see cs_block.succ)
+	size_t edge_count;	///< number of edges in @edges
+	uint32_t *preds;	///< indexes of @edges, grouped by destination block (see cs_block.pred)
+} cs_cfg;
+
+/**
+ Build the control flow graph of binary code: instructions are decoded by
+ recursive descent like cs_disasm_recursive(), then split into basic blocks
+ at branch targets & after jumps or returns. Calls do not end a block, but
+ direct calls get an edge to the block of their target.
+
+ A block ending with a branch keeps its delay slots (Mips, Sparc). On ARM,
+ instructions of a Thumb IT block are predicated rather than branches, so they
+ stay in the block of the IT instruction.
+
+ Blocks, edges & predecessors live in a few flat arrays, all released by
+ cs_cfg_free().
+
+ @handle: handle returned by cs_open()
+ @code: buffer containing raw binary code to be disassembled.
+ @code_size: size of the above code buffer.
+ @address: address of the first byte in given raw code buffer.
+ @entries: addresses to start decoding from, as for cs_disasm_recursive().
+ @entry_count: number of addresses in @entries.
+ @cfg: pointer to the graph allocated by this API.
+
+ @return CS_ERR_OK on success, or other value on failure (refer to cs_err enum
+ for detailed error). Code without any valid instruction gives an empty graph.
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_cfg_build(csh handle,
+		const uint8_t *code, size_t code_size, uint64_t address,
+		const uint64_t *entries, size_t entry_count,
+		cs_cfg **cfg);
+
+/**
+ Free a control flow graph built by cs_cfg_build(), with its instructions.
+
+ @handle: handle that built @cfg.
+ @cfg: graph returned by cs_cfg_build().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_cfg_free(csh handle, cs_cfg *cfg);
+
+/// Value of cs_superset.next & cs_superset.targets without any successor
+#define CS_SUPERSET_NONE 0xffffffff
+
+/// Superset disassembly, built by cs_disasm_superset(): one instruction
+/// decoded at every offset of a buffer, in arrays indexed by offset
+typedef struct cs_superset {
+	uint64_t address;	///< address of the first byte of the buffer
+	size_t count;	///< number of offsets, which is the size of the buffer
+	uint8_t *sizes;	///< size of the instruction at each offset, or 0 where decoding fails
+	uint16_t *ids;	///< instruction ID at each offset, or 0 where decoding fails
+	uint8_t *branches;	///< control transfer of the instruction at each offset (cs_branch_type)
+	/// offset of the instruction executed next without a taken branch (or the
+	/// delay slot of a branch), or CS_SUPERSET_NONE if it is past the buffer or
+	/// if there is none, like after a return. It is not always valid itself.
+	uint32_t *next;
+	/// offset of the direct target of a jump or call, or CS_SUPERSET_NONE if
+	/// there is none, or if it is outside the buffer
+	uint32_t *targets;
+} cs_superset;
+
+/**
+ Superset disassembly: decode one instruction at every byte offset of a
+ buffer, like calling cs_disasm_iter() at each offset, but into a few compact
+ arrays, with the control transfer of each instruction & its successors.
+ This covers all the instructions any path may run into, which is useful for
+ obfuscated code & gadget search.
+
+ No text is generated, and no detail is returned, whatever the options of
+ @handle. Every offset is decoded on its own: on ARM, no instruction is
+ considered inside an IT block. With CS_OPT_THREADS, ranges of offsets are
+ decoded by several threads, each with its own copy of @handle.
+
+ @handle: handle returned by cs_open()
+ @code: buffer containing raw binary code to be disassembled.
+ @code_size: size of the above code buffer, below 4GB.
+ @address: address of the first byte in given raw code buffer.
+ @set: pointer to the superset allocated by this API, released by cs_superset_free().
+
+ @return CS_ERR_OK on success, or other value on failure (refer to cs_err enum
+ for detailed error).
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_disasm_superset(csh handle, const uint8_t *code, size_t code_size,
+		uint64_t address, cs_superset **set);
+
+/**
+ Free a superset disassembly built by cs_disasm_superset().
+
+ @handle: handle that built @set.
+ @set: superset returned by cs_disasm_superset().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_superset_free(csh handle, cs_superset *set);
+
+/// Most instructions in a gadget found by cs_gadget_find()
+#define CS_GADGET_MAX_INSNS 16
+
+/// Gadget: a sequence of instructions ending with a return or an indirect
+/// jump or call, as used by return- & jump-oriented programming
+typedef struct cs_gadget {
+	uint64_t address;	///< address of the first occurrence of this gadget
+	uint32_t count;	///< number of occurrences, with the same instruction IDs
+	uint16_t size;	///< size of the first occurrence, in bytes
+	uint8_t insn_count;	///< number of instructions, including the last one
+	uint8_t type;	///< control transfer ending the gadget (cs_branch_type)
+	/// instruction IDs, the last of which transfers control, or is in its
+	/// delay slots
+	uint16_t ids[CS_GADGET_MAX_INSNS];
+} cs_gadget;
+
+/**
+ Find the gadgets of a buffer: sequences of up to @max_insns instructions,
+ starting at any offset, running one after the other into a return or an
+ indirect jump or call (and its delay slots), without any other control
+ transfer.
+
+ Gadgets end with an encoding first screened from its bytes on X86 (ret,
+ retf, jmp & call through a register or memory), ARM & Thumb, ARM64, Mips
+ & PPC, then decoded, with the instructions before it. Other archs decode
+ every offset as a possible gadget end. Gadgets with the same sequence of
+ instruction IDs are counted as one, found at the lowest address.
+
+ With CS_OPT_THREADS, ranges of the buffer are searched by several threads,
+ each with its own copy of @handle.
+
+ @handle: handle returned by cs_open()
+ @code: buffer containing raw binary code to be searched.
+ @code_size: size of the above code buffer.
+ @address: address of the first byte in given raw code buffer.
+ @max_insns: most instructions in a gadget, up to CS_GADGET_MAX_INSNS,
+    which is also used with 0.
+ @gadgets: array of gadgets sorted by address, allocated by this API &
+    released by cs_gadget_free().
+
+ @return: the number of gadgets found, or 0 if there is none or on failure.
+ On failure, call cs_errno() for error code.
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_gadget_find(csh handle, const uint8_t *code, size_t code_size,
+		uint64_t address, unsigned int max_insns, cs_gadget **gadgets);
+
+/**
+ Free the gadgets returned by cs_gadget_find().
+
+ @handle: handle that found @gadgets.
+ @gadgets: array returned by cs_gadget_find().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_gadget_free(csh handle, cs_gadget *gadgets);
+
+/// Set of instruction patterns compiled by cs_pattern_compile()
+typedef struct cs_pattern cs_pattern;
+
+/// Match of an instruction pattern, found by cs_pattern_search()
+typedef struct cs_match {
+	uint64_t address;	///< address of the first instruction matched
+	uint32_t pattern;	///< index of the pattern matched, in the order of the source
+	uint16_t size;	///< size of the instructions matched, in bytes
+	uint16_t insn_count;	///< number of instructions matched
+} cs_match;
+
+/**
+ Compile instruction patterns for cs_pattern_search().
+
+ The source has one pattern per line, as instructions separated by ';'.
+ Text from '#' to the end of a line is a comment. An instruction is its
+ name as in cs_insn_name(), several names separated by '|', or '*' for any
+ instruction. Without operands, any operands match. Otherwise operands are
+ separated by ',', and must all be given unless the last one is "...".
+ An operand is one of:
+    *          any operand
+    reg        any register, or a register name as in cs_reg_name()
+    imm        any immediate, a number (like -1 or 0x10), or a range of
+               numbers (like 0..0xff)
+    mem        any memory operand, or [reg] for one based on register reg,
+               or [*] for any base
+    float      any floating-point operand
+ For example, "xor reg, reg; call *" or "mov|lea rax, ...; ret".
+
+ Patterns checking operands need the detail of instructions, which is built
+ during the search; patterns without operands do not.
+
+ @handle: handle returned by cs_open(), which names instructions & registers.
+ @source: patterns, as a string terminated by '\0'.
+ @pattern: pointer to the compiled patterns allocated by this API, released
+    by cs_pattern_free().
+
+ @return CS_ERR_OK on success, CS_ERR_PATTERN if the source is invalid or
+ has no pattern, or other value on failure (refer to cs_err enum for
+ detailed error).
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_pattern_compile(csh handle, const char *source, cs_pattern **pattern);
+
+/**
+ Find all matches of compiled patterns in a buffer, in one linear decoding
+ pass whatever the number of patterns: the patterns are a single automaton
+ stepped once for each instruction. Matches may overlap, and do not span
+ bytes that fail to decode, which are skipped by the alignment of the arch.
+ On fixed-width archs, instruction words seen again are not decoded again,
+ unless patterns check immediate values.
+
+ No text is generated, whatever the options of @handle.
+
+ @handle: handle that compiled @pattern.
+ @pattern: patterns returned by cs_pattern_compile().
+ @code: buffer containing raw binary code to be searched.
+ @code_size: size of the above code buffer.
+ @address: address of the first byte in given raw code buffer.
+ @matches: array of matches in the order they end, allocated by this API &
+    released by cs_match_free().
+
+ @return: the number of matches found, or 0 if there is none or on failure.
+ On failure, call cs_errno() for error code.
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_pattern_search(csh handle, const cs_pattern *pattern,
+		const uint8_t *code, size_t code_size, uint64_t address, cs_match **matches);
+
+/**
+ Free patterns compiled by cs_pattern_compile().
+
+ @handle: handle that compiled @pattern.
+ @pattern: patterns returned by cs_pattern_compile().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_pattern_free(csh handle, cs_pattern *pattern);
+
+/**
+ Free the matches returned by cs_pattern_search().
+
+ @handle: handle that found @matches.
+ @matches: array returned by cs_pattern_search().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_match_free(csh handle, cs_match *matches);
+
+/// What hashes of instructions keep, in cs_insn_hash() & cs_ngram_hash().
+/// Immediates, displacements & addresses are always left out, so that code
+/// hashes alike wherever it is loaded
+typedef enum cs_hash_level {
+	CS_HASH_ID = 0,	///< instruction ID only, which needs no detail
+	CS_HASH_OPERANDS,	///< and the kind of each operand: register, immediate, memory...
+	CS_HASH_CLASSES,	///< and the class of registers, like 32-bit general purpose or vector
+	CS_HASH_REGS,	///< and the registers themselves
+} cs_hash_level;
+
+/// Hash of consecutive instructions, found by cs_ngram_hash()
+typedef struct cs_ngram {
+	uint64_t address;	///< address of the first instruction
+	uint64_t hash;	///< hash of the instructions
+} cs_ngram;
+
+/**
+ Hash an instruction into a token normalized at some level, built from its
+ instruction ID & the operands of its detail, without any text. The low 32
+ bits of the token are a 32-bit token as good as the whole one.
+
+ @handle: handle returned by cs_open().
+ @insn: instruction, with its detail unless @level is CS_HASH_ID.
+ @level: what the token keeps of @insn.
+
+ @return: the token of @insn, or 0 on failure. On failure, call cs_errno()
+ for error code: CS_ERR_DETAIL if @insn has no detail.
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+uint64_t CAPSTONE_API cs_insn_hash(csh handle, const cs_insn *insn, cs_hash_level level);
+
+/**
+ Hash every run of @n consecutive instructions of a buffer, as decoded by a
+ linear pass, with a hash rolled over the tokens of cs_insn_hash(). Runs do
+ not span bytes that fail to decode, which are skipped by the alignment of
+ the arch.
+
+ Neither text nor, at CS_HASH_ID, detail is generated, whatever the options
+ of @handle. On fixed-width archs, instruction words seen again are not
+ decoded again.
+
+ @handle: handle returned by cs_open().
+ @code: buffer containing raw binary code to be hashed.
+ @code_size: size of the above code buffer.
+ @address: address of the first byte in given raw code buffer.
+ @level: what the hashes keep of instructions.
+ @n: number of instructions of each run, at least 1.
+ @ngrams: array of hashes in the order of the runs, allocated by this API &
+    released by cs_ngram_free().
+
+ @return: the number of hashes, or 0 if there is none or on failure.
+ On failure, call cs_errno() for error code.
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_ngram_hash(csh handle, const uint8_t *code, size_t code_size,
+		uint64_t address, cs_hash_level level, unsigned int n, cs_ngram **ngrams);
+
+/**
+ Free the hashes returned by cs_ngram_hash().
+
+ @handle: handle that computed @ngrams.
+ @ngrams: array returned by cs_ngram_hash().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_ngram_free(csh handle, cs_ngram *ngrams);
+
+/// Kind of a cross-reference, found by cs_xref_build()
+typedef enum cs_xref_type {
+	CS_XREF_JUMP = 0,	///< code to code: direct jump or branch, conditional or not
+	CS_XREF_CALL,	///< code to code: direct call
+	CS_XREF_READ,	///< code to data: memory read
+	CS_XREF_WRITE,	///< code to data: memory written, or read & written
+	CS_XREF_ADDRESS,	///< code to data: address computed without access (LEA, ADR, ADRP+ADD)
+} cs_xref_type;
+
+/// Cross-reference from an instruction to an address
+typedef struct cs_xref {
+	uint64_t from;	///< address of the instruction
+	uint64_t to;	///< address referenced
+	uint8_t type;	///< cs_xref_type
+} cs_xref;
+
+/// Index of cross-references, built by cs_xref_build()
+typedef struct cs_xrefs {
+	cs_xref *refs;	///< references sorted by source, then destination
+	size_t count;	///< number of references in @refs
+	uint32_t *by_to;	///< indexes of @refs sorted by destination, then source
+} cs_xrefs;
+
+/**
+ Build the index of cross-references of decoded instructions: targets of
+ direct jumps & calls, and addresses of data referenced by them, with no text
+ involved. Data references are found on:
+    X86: RIP-relative memory operands (x86.disp plus the size of the
+         instruction), and absolute ones outside of 16-bit mode.
+    ARM: loads & stores relative to PC, and ADR (or ADD/SUB from PC), in the
+         mode of @handle.
+    ARM64: ADR, literal loads, and ADRP completed by an ADD or a load/store
+         on the same register, up to 8 instructions further.
+ Other archs only have references of jumps & calls.
+
+ With CS_OPT_THREADS, chunks of instructions are scanned by several threads.
+ The index does not depend on the number of threads.
+
+ @handle: handle that decoded @insn, with the detail option ON.
+ @insn: array of instructions, as from cs_disasm() or cs_disasm_recursive().
+ @count: number of instructions in @insn.
+ @xrefs: pointer to the index allocated by this API, whose arrays are all
+    released by cs_xref_free().
+
+ @return CS_ERR_OK on success, or other value on failure (refer to cs_err enum
+ for detailed error).
+ NOTE: this API is irrelevant in "diet" mode, and fails with CS_ERR_DIET.
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_xref_build(csh handle, const cs_insn *insn, size_t count,
+		cs_xrefs **xrefs);
+
+/**
+ Find the cross-references from instructions at addresses [@begin, @end).
+
+ @xrefs: index returned by cs_xref_build().
+ @begin: first address of the range.
+ @end: address past the range.
+ @first: receives the index of the first reference found in @xrefs->refs.
+
+ @return: the number of references found, which follow each other in
+ @xrefs->refs from @first on.
+*/
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_xref_from(const cs_xrefs *xrefs, uint64_t begin, uint64_t end,
+		size_t *first);
+
+/**
+ Find the cross-references to addresses [@begin, @end).
+
+ @xrefs: index returned by cs_xref_build().
+ @begin: first address of the range.
+ @end: address past the range.
+ @first: receives the index of the first reference found in @xrefs->by_to.
+
+ @return: the number of references found, whose indexes in @xrefs->refs
+ follow each other in @xrefs->by_to from @first on.
+*/
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_xref_to(const cs_xrefs *xrefs, uint64_t begin, uint64_t end,
+		size_t *first);
+
+/**
+ Free an index of cross-references built by cs_xref_build().
+
+ @handle: handle that built @xrefs.
+ @xrefs: index returned by cs_xref_build().
+*/
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_xref_free(csh handle, cs_xrefs *xrefs);
+
 /**
  Return friendly name of register in a string.
  Find the instruction id from header file of corresponding architecture (arm.h for ARM,
@@ -647,6 +1324,80 @@ const char * CAPSTONE_API cs_insn_name(csh handle, unsigned int insn_id);
 CAPSTONE_EXPORT
 const char * CAPSTONE_API cs_group_name(csh handle, unsigned int group_id);
 
+/**
+ Return register id from its friendly name, as returned by cs_reg_name().
+ Names depend on the current mode & syntax of the handle, just like with
+ cs_reg_name().
+
+ WARN: when in 'diet' mode, this API is irrelevant because engine does not
+ store register name.
+
+ @handle: handle returned by cs_open()
+ @name: name of the register (case-sensitive)
+
+ @return: id of the register, or 0 (the invalid register) if @name is unknown.
+*/
+CAPSTONE_EXPORT
+unsigned int CAPSTONE_API cs_reg_id(csh handle, const char *name);
+
+/**
+ Return instruction id from its friendly name, as returned by cs_insn_name().
+
+ WARN: when in 'diet' mode, this API is irrelevant because the engine does not
+ store instruction name.
+
+ @handle: handle returned by cs_open()
+ @name: name of the instruction (case-sensitive)
+
+ @return: id of the instruction, or 0 (the invalid instruction) if @name is unknown.
+*/
+CAPSTONE_EXPORT
+unsigned int CAPSTONE_API cs_insn_id(csh handle, const char *name);
+
+/**
+ Return group id from its friendly name, as returned by cs_group_name().
+
+ WARN: when in 'diet' mode, this API is irrelevant because the engine does not
+ store group name.
+
+ @handle: handle returned by cs_open()
+ @name: name of the group (case-sensitive)
+
+ @return: id of the group, or 0 (the invalid group) if @name is unknown.
+*/
+CAPSTONE_EXPORT
+unsigned int CAPSTONE_API cs_group_id(csh handle, const char *name);
+
+/**
+ Classify the control transfer of a disassembled instruction, and find its
+ absolute target, in the same way for all architectures. For example, the
+ target of a relative x86 jump is found without looking at its operands.
+
+ With CS_OPT_BRANCH on, this simply returns @insn->detail->branch, which was
+ filled in while decoding. Otherwise, the transfer is found from the detail.
+
+ With CS_OPT_BRANCH on but detail option OFF, instructions have no detail, so
+ @insn is decoded again from its bytes, in the current mode of @handle. On
+ archs where only some instruction IDs transfer control, this is skipped for
+ IDs already known not to. On ARM, the instruction is decoded out of any IT
+ block, so a branch in an IT block is only found conditional with detail ON.
+
+ NOTE: this API is only valid when either CS_OPT_BRANCH or the detail option is ON.
+
+ WARN: when in 'diet' mode, this API is irrelevant because the engine does not
+ build any detail, and it fails with CS_ERR_DIET.
+
+ @handle: handle returned by cs_open()
+ @insn: disassembled instruction structure received from cs_disasm() or cs_disasm_iter()
+ @target: if not NULL, receives the absolute target of a direct jump or call,
+    or 0 for other instructions.
+
+ @return: the kind of control transfer (cs_branch_type), or CS_BRANCH_NONE
+ on failure. On failure, call cs_errno() for error code.
+*/
+CAPSTONE_EXPORT
+cs_branch_type CAPSTONE_API cs_insn_branch_target(csh handle, const cs_insn *insn, uint64_t *target);
+
 /**
  Check if a disassembled instruction belong to a particular group.
  Find the group id from header file of corresponding architecture (arm.h for ARM, x86.h for X86, ...)
@@ -763,6 +1514,37 @@ cs_err CAPSTONE_API cs_regs_access(csh handle, const cs_insn *insn,
 		cs_regs regs_read, uint8_t *regs_read_count,
 		cs_regs regs_write, uint8_t *regs_write_count);
 
+/// Type of bitmap to keep a set of registers: register R is bit (R % 64)
+/// of word (R / 64). This is large enough for registers of all architectures.
+typedef uint64_t cs_regs_mask[8];
+
+/// Check if register @reg is in the register bitmap @mask
+#define CS_REGS_MASK_HAS(mask, reg) (((mask)[(reg) >> 6] >> ((reg) & 63)) & 1)
+
+/**
+ Retrieve all the registers accessed by an instruction, either explicitly or
+ implicitly, as bitmaps. Unlike cs_regs_access(), the result has no order, and
+ is cheap to combine for dataflow analysis.
+
+ WARN: when in 'diet' mode, this API is irrelevant because engine does not
+ store registers.
+
+ @handle: handle returned by cs_open()
+ @insn: disassembled instruction structure returned from cs_disasm() or cs_disasm_iter()
+ @regs_read: on return, bitmap of all registers read by instruction.
+ @regs_write: on return, bitmap of all registers written by instruction.
+ @fold_aliases: if true, also mark the registers overlapping with any accessed
+	register, i.e. its sub-registers & super-registers (for example, writing
+	to EAX also marks AL, AH, AX and RAX). This is ignored for architectures
+	without register aliasing info.
+
+ @return CS_ERR_OK on success, or other value on failure (refer to cs_err enum
+ for detailed error).
+*/
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_regs_access_mask(csh handle, const cs_insn *insn,
+		cs_regs_mask regs_read, cs_regs_mask regs_write, bool fold_aliases);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,749 @@
+/* Capstone Disassembly Engine */
+/* Instruction patterns, compiled into a bit-parallel automaton */
+
+#if defined(CAPSTONE_HAS_OSXKERNEL)
+#include <libkern/libkern.h>
+#else
+#include <string.h>
+#endif
+
+#include "cs_priv.h"
+#include "utils.h"
+
+#ifndef CAPSTONE_DIET
+
+// most operands checked by an instruction of a pattern
+#define PATTERN_OPS 8
+// most alternative IDs of an instruction of a pattern (mov|xor)
+#define PATTERN_ALTS 8
+// most instructions in a pattern
+#define PATTERN_INSNS 64
+// longest name of an instruction or register
+#define PATTERN_NAME 32
+
+// instruction words whose states are cached on fixed-width archs
+#define PATTERN_CACHE 4096
+// most 64-bit words of a set of states with a cache
+#define PATTERN_CACHE_WORDS 4
+
+// operand of an instruction of a pattern
+typedef struct pattern_op {
+	uint8_t type;	// CS_OP_REG, CS_OP_IMM, CS_OP_MEM, CS_OP_FP, or CS_OP_INVALID for any
+	bool range;	// immediate within [@lo, @hi]
+	unsigned int reg;	// register, or base register of memory, or 0 for any
+	int64_t lo, hi;
+} pattern_op;
+
+// instruction of a pattern. instructions alike are the same term, shared by
+// all the patterns having them
+typedef struct pattern_term {
+	uint16_t ids[PATTERN_ALTS];	// instruction IDs, where @id_count is 0 for any
+	uint8_t id_count;
+	uint8_t op_count;	// operands checked
+	bool rest;	// more operands may follow the ones checked
+	pattern_op ops[PATTERN_OPS];
+} pattern_term;
+
+// a set of patterns is a nondeterministic automaton with one state for each
+// instruction of each pattern, simulated on bits: an instruction moves
+// every state to the next one of its pattern, if the term of that one matches.
+// states of a pattern are consecutive bits, so this is a shift of all states,
+// masked by the states of the terms matching the instruction
+struct cs_pattern {
+	unsigned int count;	// patterns
+	unsigned int states;	// states, which are all instructions of all patterns
+	unsigned int words;	// 64-bit words of a set of states
+	unsigned int max_insns;	// instructions of the longest pattern
+	bool detail;	// some term checks operands
+	bool addressed;	// some term checks immediates, which may depend on the address
+
+	pattern_term *terms;
+	unsigned int term_count;
+
+	// all arrays below live in one allocation
+	uint64_t *masks;	// states of each term, @words for each
+	uint64_t *first;	// first state of each pattern
+	uint64_t *last;	// last state of each pattern
+	uint32_t *pattern_of;	// pattern of each state
+	uint32_t *lengths;	// instructions of each pattern
+
+	// terms of instruction ID i are id_terms[by_id[i] .. by_id[i + 1]], for
+	// IDs below @max_id. terms of any instruction are in @any_terms
+	unsigned int max_id;
+	uint32_t *by_id;
+	uint32_t *id_terms;
+	uint32_t *any_terms;
+	unsigned int any_count;
+};
+
+// source being compiled
+typedef struct pattern_parser {
+	cs_struct *handle;
+	const char *p;
+	pattern_term *terms;
+	unsigned int term_count, term_size;
+	uint32_t *state_term;	// term of each state
+	unsigned int states, state_size;
+	uint32_t *lengths;	// instructions of each pattern
+	unsigned int count, count_size;
+} pattern_parser;
+
+static bool grow(cs_struct *handle, void **array, unsigned int *size, unsigned int count,
+		size_t item)
+{
+	void *a;
+	unsigned int n;
+
+	if (count < *size)
+		return true;
+
+	n = *size ? 2 * *size : 16;
+	a = HANDLE_REALLOC(handle, *array, n * item);
+	if (!a)
+		return false;
+
+	*array = a;
+	*size = n;
+	return true;
+}
+
+static void skip_space(pattern_parser *s)
+{
+	while (*s->p == ' ' || *s->p == '\t' || *s->p == '\r')
+		s->p++;
+}
+
+// end of an instruction of a pattern
+static bool term_end(char c)
+{
+	return c == ';' || c == '\n' || c == '#' || c == '\0';
+}
+
+static bool name_char(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+		(c >= '0' && c <= '9') || c == '_' || c == '.';
+}
+
+// read a name into @name, in lower case. return false if there is none
+static bool parse_name(pattern_parser *s, char *name)
+{
+	unsigned int n = 0;
+
+	while (name_char(*s->p)) {
+		if (n == PATTERN_NAME - 1)
+			return false;
+		name[n++] = (*s->p >= 'A' && *s->p <= 'Z') ? *s->p - 'A' + 'a' : *s->p;
+		s->p++;
+	}
+	name[n] = '\0';
+
+	return n != 0;
+}
+
+static bool parse_number(pattern_parser *s, int64_t *value)
+{
+	bool negative = false;
+	uint64_t v = 0;
+	unsigned int digits = 0, d;
+
+	if (*s->p == '-') {
+		negative = true;
+		s->p++;
+	}
+
+	if (s->p[0] == '0' && (s->p[1] == 'x' || s->p[1] == 'X')) {
+		for (s->p += 2;; s->p++, digits++) {
+			if (*s->p >= '0' && *s->p <= '9')
+				d = *s->p - '0';
+			else if (*s->p >= 'a' && *s->p <= 'f')
+				d = *s->p - 'a' + 10;
+			else if (*s->p >= 'A' && *s->p <= 'F')
+				d = *s->p - 'A' + 10;
+			else
+				break;
+			v = v * 16 + d;
+		}
+	} else {
+		for (; *s->p >= '0' && *s->p <= '9'; s->p++, digits++)
+			v = v * 10 + (*s->p - '0');
+	}
+
+	*value = negative ? -(int64_t)v : (int64_t)v;
+	return digits != 0;
+}
+
+static bool parse_op(pattern_parser *s, pattern_op *op)
+{
+	char name[PATTERN_NAME];
+
+	if (*s->p == '*') {
+		s->p++;
+		return true;
+	}
+
+	// memory, with its base register
+	if (*s->p == '[') {
+		s->p++;
+		skip_space(s);
+		op->type = CS_OP_MEM;
+		if (*s->p == '*')
+			s->p++;
+		else if (!parse_name(s, name) ||
+				!(op->reg = cs_reg_id((csh)(uintptr_t)s->handle, name)))
+			return false;
+		skip_space(s);
+		return *s->p++ == ']';
+	}
+
+	// immediate, or range of immediates
+	if (*s->p == '-' || (*s->p >= '0' && *s->p <= '9')) {
+		op->type = CS_OP_IMM;
+		op->range = true;
+		if (!parse_number(s, &op->lo))
+			return false;
+		op->hi = op->lo;
+		if (s->p[0] == '.' && s->p[1] == '.') {
+			s->p += 2;
+			if (!parse_number(s, &op->hi) || op->hi < op->lo)
+				return false;
+		}
+		return true;
+	}
+
+	if (!parse_name(s, name))
+		return false;
+
+	if (!strcmp(name, "reg"))
+		op->type = CS_OP_REG;
+	else if (!strcmp(name, "imm"))
+		op->type = CS_OP_IMM;
+	else if (!strcmp(name, "mem"))
+		op->type = CS_OP_MEM;
+	else if (!strcmp(name, "float"))
+		op->type = CS_OP_FP;
+	else {
+		op->type = CS_OP_REG;
+		op->reg = cs_reg_id((csh)(uintptr_t)s->handle, name);
+		return op->reg != 0;
+	}
+
+	return true;
+}
+
+// parse an instruction of a pattern into @t
+static bool parse_term(pattern_parser *s, pattern_term *t)
+{
+	char name[PATTERN_NAME];
+
+	memset(t, 0, sizeof(*t));
+
+	skip_space(s);
+	if (*s->p == '*')
+		s->p++;
+	else {
+		for (;;) {
+			if (t->id_count == PATTERN_ALTS || !parse_name(s, name))
+				return false;
+			t->ids[t->id_count] = (uint16_t)cs_insn_id((csh)(uintptr_t)s->handle, name);
+			if (!t->ids[t->id_count++])
+				return false;
+			if (*s->p != '|')
+				break;
+			s->p++;
+		}
+	}
+
+	skip_space(s);
+	// without operands, any operands match
+	if (term_end(*s->p)) {
+		t->rest = true;
+		return true;
+	}
+
+	for (;;) {
+		skip_space(s);
+		if (s->p[0] == '.' && s->p[1] == '.' && s->p[2] == '.') {
+			s->p += 3;
+			t->rest = true;
+			skip_space(s);
+			return term_end(*s->p);
+		}
+
+		if (t->op_count == PATTERN_OPS || !parse_op(s, &t->ops[t->op_count++]))
+			return false;
+
+		skip_space(s);
+		if (term_end(*s->p))
+			return true;
+		if (*s->p++ != ',')
+			return false;
+	}
+}
+
+// add the state of term @t, shared with the same term of other patterns
+static bool add_state(pattern_parser *s, const pattern_term *t)
+{
+	unsigned int i;
+
+	for (i = 0; i < s->term_count; i++) {
+		if (!memcmp(&s->terms[i], t, sizeof(*t)))
+			break;
+	}
+
+	if (i == s->term_count) {
+		if (!grow(s->handle, (void **)&s->terms, &s->term_size, s->term_count, sizeof(*t)))
+			return false;
+		// copied with its padding, for memcmp()
+		memcpy(&s->terms[s->term_count++], t, sizeof(*t));
+	}
+
+	if (!grow(s->handle, (void **)&s->state_term, &s->state_size, s->states, sizeof(uint32_t)))
+		return false;
+	s->state_term[s->states++] = i;
+
+	return true;
+}
+
+// parse all patterns of the source. return CS_ERR_PATTERN on syntax errors
+static cs_err parse_patterns(pattern_parser *s)
+{
+	pattern_term t;
+	unsigned int first;
+
+	for (;;) {
+		skip_space(s);
+		if (*s->p == '#') {
+			while (*s->p != '\n' && *s->p != '\0')
+				s->p++;
+		}
+		if (*s->p == '\0')
+			return CS_ERR_OK;
+		if (*s->p == '\n') {
+			s->p++;
+			continue;
+		}
+
+		// a pattern per line, with instructions separated by ';'
+		first = s->states;
+		for (;;) {
+			if (!parse_term(s, &t) || s->states - first == PATTERN_INSNS)
+				return CS_ERR_PATTERN;
+			if (!add_state(s, &t))
+				return CS_ERR_MEM;
+			if (*s->p != ';')
+				break;
+			s->p++;
+		}
+
+		if (!grow(s->handle, (void **)&s->lengths, &s->count_size, s->count, sizeof(uint32_t)))
+			return CS_ERR_MEM;
+		s->lengths[s->count++] = s->states - first;
+	}
+}
+
+// build the automaton of the patterns parsed by @s into @g
+static bool build(pattern_parser *s, cs_pattern *g)
+{
+	unsigned int i, j, n = 0, st, w;
+
+	g->count = s->count;
+	g->states = s->states;
+	g->words = (s->states + 63) / 64;
+	g->terms = s->terms;
+	g->term_count = s->term_count;
+
+	for (i = 0; i < s->term_count; i++) {
+		const pattern_term *t = &s->terms[i];
+
+		if (t->op_count)
+			g->detail = true;
+		for (j = 0; j < t->op_count; j++) {
+			if (t->ops[j].range)
+				g->addressed = true;
+		}
+		for (j = 0; j < t->id_count; j++) {
+			if (t->ids[j] >= g->max_id)
+				g->max_id = t->ids[j] + 1;
+			n++;
+		}
+		if (!t->id_count)
+			g->any_count++;
+	}
+
+	w = g->words;
+	g->masks = HANDLE_CALLOC(s->handle, 1, (s->term_count + 2) * w * sizeof(uint64_t) +
+			(s->states + s->count + g->max_id + 1 + n + g->any_count) * sizeof(uint32_t));
+	if (!g->masks)
+		return false;
+
+	g->first = g->masks + s->term_count * w;
+	g->last = g->first + w;
+	g->pattern_of = (uint32_t *)(g->last + w);
+	g->lengths = g->pattern_of + s->states;
+	g->by_id = g->lengths + s->count;
+	g->id_terms = g->by_id + g->max_id + 1;
+	g->any_terms = g->id_terms + n;
+
+	for (i = 0, st = 0; i < s->count; i++) {
+		g->lengths[i] = s->lengths[i];
+		if (s->lengths[i] > g->max_insns)
+			g->max_insns = s->lengths[i];
+
+		g->first[st / 64] |= (uint64_t)1 << (st % 64);
+		for (j = 0; j < s->lengths[i]; j++, st++) {
+			g->pattern_of[st] = i;
+			g->masks[s->state_term[st] * w + st / 64] |= (uint64_t)1 << (st % 64);
+		}
+		g->last[(st - 1) / 64] |= (uint64_t)1 << ((st - 1) % 64);
+	}
+
+	// terms by ID: count them, then place them
+	for (i = 0; i < s->term_count; i++) {
+		for (j = 0; j < s->terms[i].id_count; j++)
+			g->by_id[s->terms[i].ids[j] + 1]++;
+	}
+	for (i = 0; i < g->max_id; i++)
+		g->by_id[i + 1] += g->by_id[i];
+
+	// by_id[id] moves past the terms of the ID while placing them, so it is
+	// shifted back after
+	for (i = 0, n = 0; i < s->term_count; i++) {
+		for (j = 0; j < s->terms[i].id_count; j++)
+			g->id_terms[g->by_id[s->terms[i].ids[j]]++] = i;
+		if (!s->terms[i].id_count)
+			g->any_terms[n++] = i;
+	}
+	for (i = g->max_id; i > 0; i--)
+		g->by_id[i] = g->by_id[i - 1];
+	g->by_id[0] = 0;
+
+	return true;
+}
+
+static bool term_match(const pattern_term *t, const detail_op *ops, unsigned int count)
+{
+	unsigned int i;
+
+	if (count < t->op_count || (!t->rest && count != t->op_count))
+		return false;
+
+	for (i = 0; i < t->op_count; i++) {
+		const pattern_op *o = &t->ops[i];
+
+		if (o->type == CS_OP_INVALID)
+			continue;
+		if (ops[i].type != o->type || (o->reg && ops[i].reg != o->reg))
+			return false;
+		if (o->range && (ops[i].imm < o->lo || ops[i].imm > o->hi))
+			return false;
+	}
+
+	return true;
+}
+
+// OR the states of all terms matching @insn into @mask
+static void insn_states(cs_struct *handle, const cs_pattern *g, const cs_insn *insn,
+		uint64_t *mask)
+{
+	detail_op ops[PATTERN_OPS];
+	unsigned int count = 0, i, k, n, w;
+	const uint32_t *terms;
+	bool loaded = false;
+
+	memset(mask, 0, g->words * sizeof(uint64_t));
+
+	// terms of this ID, then terms of any instruction
+	for (k = 0; k < 2; k++) {
+		if (k == 0) {
+			if (insn->id >= g->max_id)
+				continue;
+			terms = g->id_terms + g->by_id[insn->id];
+			n = g->by_id[insn->id + 1] - g->by_id[insn->id];
+		} else {
+			terms = g->any_terms;
+			n = g->any_count;
+		}
+
+		for (i = 0; i < n; i++) {
+			const pattern_term *t = &g->terms[terms[i]];
+			const uint64_t *m = g->masks + terms[i] * g->words;
+
+			// operands are only converted for terms checking them
+			if (!t->rest || t->op_count) {
+				if (!loaded) {
+					count = detail_operands(handle->arch, insn->detail, ops, PATTERN_OPS);
+					loaded = true;
+				}
+				if (!term_match(t, ops, count))
+					continue;
+			}
+
+			for (w = 0; w < g->words; w++)
+				mask[w] |= m[w];
+		}
+	}
+}
+#endif
+
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_pattern_compile(csh ud, const char *source, cs_pattern **pattern)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	pattern_parser s;
+	cs_pattern *g;
+	cs_err err;
+#endif
+
+	if (!handle)
+		return CS_ERR_HANDLE;
+
+	*pattern = NULL;
+
+#ifdef CAPSTONE_DIET
+	// names of instructions & registers are needed
+	handle->errnum = CS_ERR_DIET;
+	return CS_ERR_DIET;
+#else
+	memset(&s, 0, sizeof(s));
+	s.handle = handle;
+	s.p = source;
+
+	err = parse_patterns(&s);
+	if (!err && !s.count)
+		err = CS_ERR_PATTERN;
+
+	g = NULL;
+	if (!err) {
+		g = HANDLE_CALLOC(handle, 1, sizeof(*g));
+		if (!g || !build(&s, g))
+			err = CS_ERR_MEM;
+	}
+
+	HANDLE_FREE(handle, s.state_term);
+	HANDLE_FREE(handle, s.lengths);
+
+	if (err) {
+		HANDLE_FREE(handle, g);
+		HANDLE_FREE(handle, s.terms);
+		handle->errnum = err;
+		return err;
+	}
+
+	*pattern = g;
+	handle->errnum = CS_ERR_OK;
+
+	return CS_ERR_OK;
+#endif
+}
+
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_pattern_search(csh ud, const cs_pattern *pattern,
+		const uint8_t *code, size_t code_size, uint64_t address, cs_match **matches)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	const cs_pattern *g = pattern;
+	uint64_t ring[PATTERN_INSNS], *states, *mask, *cache_masks = NULL, bits;
+	uint32_t *cache_words = NULL;
+	uint8_t *cache_kinds = NULL;
+	cs_match *out = NULL, *m;
+	size_t count = 0, size = 0, n = 0;
+	unsigned int width, align, w, b, slot = 0;
+	cs_opt_value detail;
+	bool notext, branch, skipdata, valid, active = false;
+	cs_detail insn_detail;
+	cs_insn insn;
+#endif
+
+	if (!handle)
+		return 0;
+
+	*matches = NULL;
+
+#ifdef CAPSTONE_DIET
+	handle->errnum = CS_ERR_DIET;
+	return 0;
+#else
+	handle->errnum = CS_ERR_OK;
+
+	states = HANDLE_MALLOC(handle, 2 * g->words * sizeof(uint64_t));
+	if (!states) {
+		handle->errnum = CS_ERR_MEM;
+		return 0;
+	}
+	mask = states + g->words;
+
+	// on fixed-width archs, the states of an instruction only depend on its
+	// word, unless immediates (which may be addresses) are checked: words
+	// seen again skip the decoder
+	width = insn_fixed_size(handle);
+	if (width && !g->addressed && g->words <= PATTERN_CACHE_WORDS) {
+		cache_masks = HANDLE_MALLOC(handle, PATTERN_CACHE * g->words * sizeof(uint64_t) +
+				PATTERN_CACHE * (sizeof(uint32_t) + sizeof(uint8_t)));
+		if (cache_masks) {
+			cache_words = (uint32_t *)(cache_masks + PATTERN_CACHE * g->words);
+			cache_kinds = (uint8_t *)(cache_words + PATTERN_CACHE);
+			// 0: empty slot, 1: valid instruction, 2: invalid
+			memset(cache_kinds, 0, PATTERN_CACHE);
+		}
+	}
+
+	// neither text nor data is needed, and the detail only to check operands
+	detail = handle->detail;
+	notext = handle->notext;
+	branch = handle->branch;
+	skipdata = handle->skipdata;
+	handle->detail = g->detail ? CS_OPT_ON : CS_OPT_OFF;
+	handle->notext = true;
+	handle->branch = false;
+	handle->skipdata = false;
+	insn.detail = g->detail ? &insn_detail : NULL;
+
+	align = skipdata_size(handle);
+	memset(states, 0, g->words * sizeof(uint64_t));
+
+	while (code_size) {
+		const uint8_t *p = code;
+		size_t left = code_size;
+		uint64_t a = address;
+		uint32_t word = 0;
+
+		if (cache_masks && code_size >= width) {
+			memcpy(&word, code, sizeof(word));
+			slot = (word * 2654435761u) >> 20;
+			if (cache_kinds[slot] && cache_words[slot] == word) {
+				valid = cache_kinds[slot] == 1;
+				if (valid) {
+					memcpy(mask, cache_masks + slot * g->words, g->words * sizeof(uint64_t));
+					p += width;
+					left -= width;
+					a += width;
+					insn.size = (uint16_t)width;
+				}
+				goto decoded;
+			}
+		}
+
+		valid = cs_disasm_iter(ud, &p, &left, &a, &insn);
+		if (valid)
+			insn_states(handle, g, &insn, mask);
+
+		if (cache_masks && code_size >= width) {
+			cache_words[slot] = word;
+			cache_kinds[slot] = valid ? 1 : 2;
+			if (valid)
+				memcpy(cache_masks + slot * g->words, mask, g->words * sizeof(uint64_t));
+		}
+
+decoded:
+		if (!valid) {
+			// matches do not span data
+			if (active)
+				memset(states, 0, g->words * sizeof(uint64_t));
+			active = false;
+			n = 0;
+			if (code_size < align)
+				break;
+			code += align;
+			code_size -= align;
+			address += align;
+			continue;
+		}
+
+		ring[n++ % PATTERN_INSNS] = address;
+
+		// every state moves to the next one, and the first ones start again
+		bits = 0;
+		for (w = 0; w < g->words; w++) {
+			uint64_t s = states[w], next = ((s << 1) | (bits >> 63) | g->first[w]) & mask[w];
+
+			bits = s;
+			states[w] = next;
+		}
+
+		// patterns matched: their last state is set
+		active = false;
+		for (w = 0; w < g->words; w++) {
+			if (!states[w])
+				continue;
+			active = true;
+
+			for (bits = states[w] & g->last[w], b = 0; bits; bits >>= 1, b++) {
+				unsigned int pat, len;
+
+				if (!(bits & 1))
+					continue;
+
+				pat = g->pattern_of[w * 64 + b];
+				len = g->lengths[pat];
+				if (len > n)
+					continue;
+
+				if (count == size) {
+					size = size ? 2 * size : 64;
+					m = HANDLE_REALLOC(handle, out, size * sizeof(*out));
+					if (!m) {
+						HANDLE_FREE(handle, out);
+						out = NULL;
+						count = 0;
+						handle->errnum = CS_ERR_MEM;
+						goto done;
+					}
+					out = m;
+				}
+
+				m = &out[count++];
+				m->address = ring[(n - len) % PATTERN_INSNS];
+				m->pattern = pat;
+				m->size = (uint16_t)(a - m->address);
+				m->insn_count = (uint16_t)len;
+			}
+		}
+
+		code_size -= p - code;
+		code = p;
+		address = a;
+	}
+
+done:
+	handle->detail = detail;
+	handle->notext = notext;
+	handle->branch = branch;
+	handle->skipdata = skipdata;
+
+	HANDLE_FREE(handle, cache_masks);
+	HANDLE_FREE(handle, states);
+
+	*matches = out;
+
+	return count;
+#endif
+}
+
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_pattern_free(csh ud, cs_pattern *pattern)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || !pattern)
+		return;
+
+#ifndef CAPSTONE_DIET
+	HANDLE_FREE(handle, pattern->terms);
+	HANDLE_FREE(handle, pattern->masks);
+#endif
+	HANDLE_FREE(handle, pattern);
+}
+
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_match_free(csh ud, cs_match *matches)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || !matches)
+		return;
+
+	HANDLE_FREE(handle, matches);
+}
@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+# Capstone Disassembly Engine
+# Reader of the printInstruction() tables of a <ARCH>GenAsmWriter.inc, shared by
+# the tools generating detail tables from them (x86_mem_size.py, detail_ops.py).
+#
+# For every opcode, AsmWriter.program() returns the commands run by
+# printInstruction(), in order: ('txt', text) for literal text, starting with
+# the mnemonic, or (method, arg...) for a call of a print method, without its
+# MI, O & MRI arguments.
+
+import re
+
+
+def _array(src, name):
+    m = re.search(r'static const uint\d+_t %s\[\] = \{(.*?)\};' % name, src, re.S)
+    if not m:
+        return None, None
+    vals = []
+    names = []
+    for line in m.group(1).split('\n'):
+        mm = re.match(r'\s*(\d+)U,\s*// (\S+)', line)
+        if mm:
+            vals.append(int(mm.group(1)))
+            names.append(mm.group(2))
+    return vals, names
+
+
+def _unescape(s):
+    return bytes(s, 'latin1').decode('unicode_escape')
+
+
+def _commands(text):
+    cmds = []
+    for l in text.split('\n'):
+        l = l.strip()
+        if l.startswith('//') or not l or l == 'break;':
+            continue
+        if l == 'return;':
+            cmds.append(('ret',))
+            continue
+        m = re.match(r'SStream_concat0\(O, "(.*)"\);$', l)
+        if m:
+            cmds.append(('txt', _unescape(m.group(1))))
+            continue
+        m = re.match(r'(\w+)\((.*)\);$', l)
+        if not m:
+            raise Exception('unknown command: ' + l)
+        args = [a.strip() for a in m.group(2).split(',')]
+        cmds.append((m.group(1),) + tuple(a for a in args if a not in ('MI', 'O', 'MRI')))
+    return cmds
+
+
+class AsmWriter(object):
+    def __init__(self, fname):
+        self.src = src = open(fname).read()
+
+        op1, self.names = _array(src, 'OpInfo')
+        op2, _ = _array(src, 'OpInfo2')
+        if not op2:
+            op2 = [0] * len(op1)
+        self.bits = [(b << 32) | a for a, b in zip(op1, op2)]
+
+        # strings of printInstruction(), with the mnemonics
+        m = re.search(r'static (?:const )?char AsmStrs\[\] = \{(.*?)\};', src, re.S)
+        self.asm = bytearray()
+        for tok in re.findall(r"'(\\.|[^'])'|(\d+)", re.sub(r'/\*.*?\*/', '', m.group(1))):
+            if tok[0]:
+                self.asm += _unescape(tok[0]).encode('latin1')
+            else:
+                self.asm.append(int(tok[1]))
+        self.mnemonic_mask = int(re.search(r'AsmStrs\+\(Bits & (\d+)\)-1', src).group(1))
+
+        body = src[src.index('Emit the opcode for the instruction'):]
+        body = body[:body.index('getRegisterName')]
+
+        # each fragment is a switch or an if/else on some bits of the opcode info
+        self.frags = []
+        for m in re.finditer(r'  // Fragment \d+ encoded into \d+ bits for \d+ unique commands\.\n'
+                r'(.*?)(?=\n  // Fragment |\n\}\n)', body, re.S):
+            text = m.group(1)
+            sw = re.search(r'switch \(\(Bits >> (\d+)\) & (\d+)\) \{', text)
+            if sw:
+                cases = {}
+                for cm in re.finditer(r'\n  case (\d+):\n(.*?)(?=\n  case |\n  \}\n|\n  \}$|\Z)',
+                        text[sw.end():], re.S):
+                    cases[int(cm.group(1))] = _commands(cm.group(2))
+                self.frags.append((int(sw.group(1)), int(sw.group(2)), cases))
+                continue
+            iff = re.search(r'if \(\(Bits >> (\d+)\) & 1\) \{(.*?)\n  \} else \{(.*?)\n  \}', text, re.S)
+            if iff:
+                self.frags.append((int(iff.group(1)), 1,
+                        {1: _commands(iff.group(2)), 0: _commands(iff.group(3))}))
+                continue
+            raise Exception('unknown fragment: ' + text[:200])
+
+    def literal(self, offset):
+        return self.asm[offset:self.asm.index(0, offset)].decode('latin1')
+
+    # commands of opcode @i, or None if it has none
+    def program(self, i):
+        bits = self.bits[i]
+        if not bits:
+            return None
+        prog = [('txt', self.literal((bits & self.mnemonic_mask) - 1))]
+        for shift, mask, cases in self.frags:
+            for c in cases[(bits >> shift) & mask]:
+                if c[0] == 'ret':
+                    return prog
+                prog.append(c)
+        return prog
@@ -0,0 +1,75 @@
+/* Capstone Disassembler Engine */
+/* Compare cs_disasm_iter() with its arch-specialized versions */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+#define X86_CODE64 "\x55\x48\x8b\x05\xb8\x13\x00\x00\x48\x89\xe5\x48\x83\xec\x20\x89\x7d\xfc\x48\x89\x75\xf0\x8b\x45\xfc\x83\xc0\x01\x0f\xaf\xc0\x89\x45\xec\x48\x8d\x3d\x00\x00\x00\x00\xe8\x00\x00\x00\x00\xf3\x0f\x10\x45\xe4\xf3\x0f\x59\xc1\x66\x0f\xef\xc0\x48\x63\xd0\x48\x8b\x0c\xd5\x40\x10\x00\x00\x74\x12\x48\x83\xc4\x20\x5d\xc3"
+#define ARM64_CODE "\x09\x00\x38\xd5\xbf\x40\x00\xd5\x0c\x05\x13\xd5\x20\x50\x02\x0e\x20\xe4\x3d\x0f\x00\x18\xa0\x5f\xa2\x00\xae\x9e\x9f\x37\x03\xd5\xbf\x33\x03\xd5\xdf\x3f\x03\xd5\x21\x7c\x02\x9b\x21\x7c\x00\x53\x00\x40\x21\x4b\xe1\x0b\x40\xb9\x20\x04\x81\xda\x20\x08\x02\x8b\x10\x5b\xe8\x3c\xfd\x7b\xbf\xa9\xfd\x03\x00\x91\xc0\x03\x5f\xd6"
+
+typedef bool (*iter_t)(csh handle, const uint8_t **code, size_t *size,
+		uint64_t *address, cs_insn *insn);
+
+static double bench(csh handle, iter_t iter, const char *buf, size_t len, int maxcount)
+{
+	const uint8_t *code;
+	uint64_t address;
+	size_t size;
+	cs_insn *insn;
+	clock_t start;
+	int i;
+
+	insn = cs_malloc(handle);
+	start = clock();
+	for (i = 0; i < maxcount;) {
+		code = (const uint8_t *)buf;
+		address = 0x1000;
+		size = len;
+		while (iter(handle, &code, &size, &address, insn))
+			i++;
+	}
+	cs_free(insn, 1);
+
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void test(cs_arch arch, cs_mode mode, const char *name, iter_t iter,
+		const char *code, size_t size)
+{
+	static const cs_opt_value details[] = { CS_OPT_OFF, CS_OPT_ON };
+	int maxcount = 5000000;
+	csh handle;
+	cs_err err;
+	int i;
+
+	err = cs_open(arch, mode, &handle);
+	if (err) {
+		printf("Failed on cs_open() with error returned: %u\n", err);
+		return;
+	}
+
+	for (i = 0; i < 2; i++) {
+		cs_option(handle, CS_OPT_DETAIL, details[i]);
+		printf("%s (detail %s):\n", name, details[i] == CS_OPT_ON ? "on" : "off");
+		printf("\tcs_disasm_iter() time used: %f\n",
+				bench(handle, cs_disasm_iter, code, size, maxcount));
+		printf("\tspecialized time used: %f\n",
+				bench(handle, iter, code, size, maxcount));
+	}
+
+	cs_close(&handle);
+}
+
+int main()
+{
+	test(CS_ARCH_X86, CS_MODE_64, "X86 64", cs_disasm_iter_x86,
+			X86_CODE64, sizeof(X86_CODE64) - 1);
+	test(CS_ARCH_ARM64, CS_MODE_ARM, "ARM64", cs_disasm_iter_arm64,
+			ARM64_CODE, sizeof(ARM64_CODE) - 1);
+
+	return 0;
+}
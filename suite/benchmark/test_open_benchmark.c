@@ -0,0 +1,97 @@
+/* Capstone Disassembler Engine */
+/* Cold-start latency: cs_open(), first instruction & cs_close() per arch */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+#define HANDLES 1000
+#define ROUNDS 20
+
+static struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	const char *code;
+	size_t size;
+	const char *comment;
+} platforms[] = {
+	{ CS_ARCH_X86, CS_MODE_64, "\x55\x48\x8b\x05\xb8\x13\x00\x00", 8, "X86 64" },
+	{ CS_ARCH_ARM, CS_MODE_ARM, "\xED\xFF\xFF\xEB", 4, "ARM" },
+	{ CS_ARCH_ARM, CS_MODE_THUMB, "\x70\x47", 2, "THUMB" },
+	{ CS_ARCH_ARM64, CS_MODE_ARM, "\x21\x7c\x02\x9b", 4, "ARM64" },
+	{ CS_ARCH_MIPS, CS_MODE_MIPS32 | CS_MODE_BIG_ENDIAN, "\x0C\x10\x00\x97", 4, "MIPS-32 (Big-endian)" },
+	{ CS_ARCH_PPC, CS_MODE_BIG_ENDIAN, "\x80\x20\x00\x00", 4, "PPC-64" },
+	{ CS_ARCH_SPARC, CS_MODE_BIG_ENDIAN, "\x80\xa0\x40\x02", 4, "Sparc" },
+	{ CS_ARCH_SYSZ, 0, "\xed\x00\x00\x00\x00\x1a", 6, "SystemZ" },
+	{ CS_ARCH_XCORE, 0, "\xfe\x0f", 2, "XCore" },
+	{ CS_ARCH_M68K, CS_MODE_BIG_ENDIAN | CS_MODE_M68K_040, "\x4c\x00\x54\x04", 4, "M68K" },
+	{ CS_ARCH_TMS320C64X, 0, "\x01\xac\x88\x40", 4, "TMS320C64x" },
+	{ CS_ARCH_M680X, CS_MODE_M680X_6809, "\x06\x10", 2, "M680X_6809" },
+	{ CS_ARCH_EVM, 0, "\x60\x61", 2, "EVM" },
+	{ CS_ARCH_MOS65XX, 0, "\x0d\x34\x12", 3, "MOS65XX" },
+};
+
+// microseconds per handle
+static double usec(clock_t c)
+{
+	return (double)c * 1000000 / CLOCKS_PER_SEC / HANDLES / ROUNDS;
+}
+
+static void test(struct platform *p, cs_opt_value detail)
+{
+	static csh handles[HANDLES];
+	clock_t t_open = 0, t_insn = 0, t_close = 0, start;
+	cs_insn *insn;
+	int i, r;
+
+	for (r = 0; r < ROUNDS; r++) {
+		start = clock();
+		for (i = 0; i < HANDLES; i++) {
+			if (cs_open(p->arch, p->mode, &handles[i])) {
+				printf("%s: failed on cs_open()\n", p->comment);
+				exit(1);
+			}
+		}
+		t_open += clock() - start;
+
+		start = clock();
+		for (i = 0; i < HANDLES; i++) {
+			const uint8_t *code = (const uint8_t *)p->code;
+			size_t size = p->size;
+			uint64_t address = 0x1000;
+
+			cs_option(handles[i], CS_OPT_DETAIL, detail);
+			insn = cs_malloc(handles[i]);
+			cs_disasm_iter(handles[i], &code, &size, &address, insn);
+			cs_free(insn, 1);
+		}
+		t_insn += clock() - start;
+
+		start = clock();
+		for (i = 0; i < HANDLES; i++)
+			cs_close(&handles[i]);
+		t_close += clock() - start;
+	}
+
+	printf("%-22s detail %-3s  open: %7.3f us  first insn: %7.3f us  close: %7.3f us\n",
+			p->comment, detail == CS_OPT_ON ? "on" : "off",
+			usec(t_open), usec(t_insn), usec(t_close));
+}
+
+int main()
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(platforms) / sizeof(platforms[0]); i++) {
+		if (!cs_support(platforms[i].arch))
+			continue;
+
+		test(&platforms[i], CS_OPT_OFF);
+		test(&platforms[i], CS_OPT_ON);
+	}
+
+	return 0;
+}
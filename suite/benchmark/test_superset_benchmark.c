@@ -0,0 +1,110 @@
+/* Capstone Disassembler Engine */
+/* Compare cs_disasm_superset() with cs_disasm_iter() at every offset */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+#define X86_CODE64 "\x55\x48\x8b\x05\xb8\x13\x00\x00\x48\x89\xe5\x48\x83\xec\x20\x89\x7d\xfc\x48\x89\x75\xf0\x8b\x45\xfc\x83\xc0\x01\x0f\xaf\xc0\x89\x45\xec\x48\x8d\x3d\x00\x00\x00\x00\xe8\x00\x00\x00\x00\xf3\x0f\x10\x45\xe4\xf3\x0f\x59\xc1\x66\x0f\xef\xc0\x48\x63\xd0\x48\x8b\x0c\xd5\x40\x10\x00\x00\x74\x12\x48\x83\xc4\x20\x5d\xc3"
+
+#define BUF_SIZE (1024 * 1024)
+#define ROUNDS 4
+
+// wall-clock time, as threads add up in clock()
+static double now(void)
+{
+	struct timespec ts;
+
+	timespec_get(&ts, TIME_UTC);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// decode at every offset, with the branch of each instruction like a superset
+static double bench_naive(csh handle, const uint8_t *buf, size_t len)
+{
+	const uint8_t *code;
+	uint64_t address, target;
+	size_t size, offset;
+	cs_insn *insn;
+	double start;
+	int i;
+
+	insn = cs_malloc(handle);
+	start = now();
+	for (i = 0; i < ROUNDS; i++) {
+		for (offset = 0; offset < len; offset++) {
+			code = buf + offset;
+			size = len - offset;
+			address = 0x1000 + offset;
+			if (cs_disasm_iter(handle, &code, &size, &address, insn))
+				cs_insn_branch_target(handle, insn, &target);
+		}
+	}
+	cs_free(insn, 1);
+
+	return now() - start;
+}
+
+static double bench_superset(csh handle, const uint8_t *buf, size_t len)
+{
+	cs_superset *set;
+	double start;
+	int i;
+
+	start = now();
+	for (i = 0; i < ROUNDS; i++) {
+		if (cs_disasm_superset(handle, buf, len, 0x1000, &set) != CS_ERR_OK) {
+			printf("Failed on cs_disasm_superset() with error returned: %u\n",
+					cs_errno(handle));
+			return 0;
+		}
+		cs_superset_free(handle, set);
+	}
+
+	return now() - start;
+}
+
+int main()
+{
+	static const unsigned int threads[] = { 1, 0 };
+	uint8_t *buf;
+	csh handle;
+	cs_err err;
+	size_t i;
+
+	// code with some noise, like in obfuscated binaries
+	buf = malloc(BUF_SIZE);
+	srand(1);
+	for (i = 0; i < BUF_SIZE; i++) {
+		buf[i] = (i % 1024 < 768) ? X86_CODE64[i % (sizeof(X86_CODE64) - 1)] :
+			(uint8_t)rand();
+	}
+
+	err = cs_open(CS_ARCH_X86, CS_MODE_64, &handle);
+	if (err) {
+		printf("Failed on cs_open() with error returned: %u\n", err);
+		free(buf);
+		return 1;
+	}
+
+	printf("X86 64, %d x %d offsets:\n", ROUNDS, BUF_SIZE);
+
+	cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+	printf("\tcs_disasm_iter() time used: %f\n", bench_naive(handle, buf, BUF_SIZE));
+	cs_option(handle, CS_OPT_DETAIL, CS_OPT_OFF);
+
+	for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		cs_option(handle, CS_OPT_THREADS, threads[i]);
+		printf("\tcs_disasm_superset() (threads %s) time used: %f\n",
+				threads[i] ? "1" : "per CPU", bench_superset(handle, buf, BUF_SIZE));
+	}
+
+	cs_close(&handle);
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,326 @@
+#!/usr/bin/env python
+# Capstone Disassembly Engine
+# This tool generates the detail operand programs of ARM (ARMGenDetailOps.inc)
+# and AArch64 (AArch64GenDetailOps.inc), which let <ARCH>_fill_detail() build
+# the detail of an instruction without printing it, from the printInstruction()
+# tables of <ARCH>GenAsmWriter.inc:
+#   ./detail_ops.py ../arch/ARM > ../arch/ARM/ARMGenDetailOps.inc
+#   ./detail_ops.py ../arch/AArch64 > ../arch/AArch64/AArch64GenDetailOps.inc
+#
+# ARM also reads the instruction IDs of ARMMappingInsn.inc, and the mnemonics
+# which update the flags from ARMInstPrinter.c.
+
+import os
+import re
+import sys
+
+from asmwriter import AsmWriter
+
+ARM_SIMPLE = {
+    'printOperand': 'OPERAND',
+    'printPredicateOperand': 'PRED',
+    'printMandatoryPredicateOperand': 'MANDPRED',
+    'printSBitModifierOperand': 'SBIT',
+    'printNoHashImmediate': 'NOHASHIMM',
+    'printPImmediate': 'PIMM',
+    'printCImmediate': 'CIMM',
+    'printCoprocOptionImm': 'COPROCOPT',
+    'printRegisterList': 'REGLIST',
+    'printVectorIndex': 'VINDEX',
+    'printAddrMode6Operand': 'AM6',
+    'printAddrMode7Operand': 'AM7',
+    'printAddrMode6OffsetOperand': 'AM6OFFSET',
+    'printAddrMode2Operand': 'AM2',
+    'printAddrMode2OffsetOperand': 'AM2OFFSET',
+    'printAddrMode3Operand': 'AM3',
+    'printAddrMode3OffsetOperand': 'AM3OFFSET',
+    'printAddrMode5Operand': 'AM5',
+    'printAddrModeTBB': 'TBB',
+    'printAddrModeTBH': 'TBH',
+    'printAddrModeImm12Operand': 'IMM12',
+    'printT2AddrModeImm8Operand': 'T2IMM8',
+    'printT2AddrModeImm8s4Operand': 'T2IMM8',
+    'printT2AddrModeImm0_1020s4Operand': 'T2IMM0_1020S4',
+    'printT2AddrModeImm8OffsetOperand': 'T2IMM8OFFSET',
+    'printT2AddrModeImm8s4OffsetOperand': 'T2IMM8OFFSET',
+    'printT2AddrModeSoRegOperand': 'T2SOREG',
+    'printThumbAddrModeRROperand': 'THUMBRR',
+    'printThumbLdrLabelOperand': 'THUMBLDRLABEL',
+    'printPostIdxImm8Operand': 'POSTIDXIMM8',
+    'printPostIdxRegOperand': 'POSTIDXREG',
+    'printPostIdxImm8s4Operand': 'POSTIDXIMM8S4',
+    'printSORegRegOperand': 'SOREGREG',
+    'printSORegImmOperand': 'SOREGIMM',
+    'printT2SOOperand': 'T2SO',
+    'printModImmOperand': 'MODIMM',
+    'printNEONModImmOperand': 'NEONMODIMM',
+    'printFPImmOperand': 'FPIMM',
+    'printImmPlusOneOperand': 'IMMPLUSONE',
+    'printRotImmOperand': 'ROTIMM',
+    'printShiftImmOperand': 'SHIFTIMM',
+    'printPKHLSLShiftImm': 'PKHLSL',
+    'printPKHASRShiftImm': 'PKHASR',
+    'printBitfieldInvMaskImmOperand': 'BFINVMASK',
+    'printThumbS4ImmOperand': 'THUMBS4IMM',
+    'printThumbSRImm': 'THUMBSRIMM',
+    'printGPRPairOperand': 'GPRPAIR',
+    'printSetendOperand': 'SETEND',
+    'printCPSIMod': 'CPSIMOD',
+    'printCPSIFlag': 'CPSIFLAG',
+    'printMSRMaskOperand': 'MSRMASK',
+    'printBankedRegOperand': 'BANKEDREG',
+    'printMemBOption': 'MEMB',
+}
+
+# methods sharing a step, with its parameter
+ARM_PARAM = {
+    'printThumbAddrModeImm5S1Operand': ('THUMBIMM5S', '1'),
+    'printThumbAddrModeImm5S2Operand': ('THUMBIMM5S', '2'),
+    'printThumbAddrModeImm5S4Operand': ('THUMBIMM5S', '4'),
+    'printThumbAddrModeSPOperand': ('THUMBIMM5S', '4'),
+    'printFBits16': ('FBITS', '16'),
+    'printFBits32': ('FBITS', '32'),
+    # number of registers | register stride << 4
+    'printVectorListOne': ('VLIST', '0x11'),
+    'printVectorListOneAllLanes': ('VLIST', '0x11'),
+    'printVectorListThree': ('VLIST', '0x13'),
+    'printVectorListThreeAllLanes': ('VLIST', '0x13'),
+    'printVectorListFour': ('VLIST', '0x14'),
+    'printVectorListFourAllLanes': ('VLIST', '0x14'),
+    'printVectorListThreeSpaced': ('VLIST', '0x23'),
+    'printVectorListThreeSpacedAllLanes': ('VLIST', '0x23'),
+    'printVectorListFourSpaced': ('VLIST', '0x24'),
+    'printVectorListFourSpacedAllLanes': ('VLIST', '0x24'),
+    'printVectorListTwo': ('VLIST_DPAIR', '1'),
+    'printVectorListTwoAllLanes': ('VLIST_DPAIR', '1'),
+    'printVectorListTwoSpaced': ('VLIST_DPAIR', '2'),
+    'printVectorListTwoSpacedAllLanes': ('VLIST_DPAIR', '2'),
+}
+
+# methods which add nothing to the detail
+ARM_SKIP = ('printThumbITMask', 'printInstSyncBOption')
+
+AARCH64_SIMPLE = {
+    'printOperand': 'OPERAND',
+    'printHexImm': 'HEXIMM',
+    'printVRegOperand': 'VREG',
+    'printSysCROperand': 'SYSCR',
+    'printAddSubImm': 'ADDSUBIMM',
+    'printLogicalImm32': 'LOGICALIMM32',
+    'printLogicalImm64': 'LOGICALIMM64',
+    'printShifter': 'SHIFTER',
+    'printShiftedRegister': 'SHIFTEDREG',
+    'printArithExtend': 'ARITHEXTEND',
+    'printExtendedRegister': 'EXTENDEDREG',
+    'printCondCode': 'CONDCODE',
+    'printInverseCondCode': 'INVCONDCODE',
+    'printPrefetchOp': 'PREFETCH',
+    'printFPImmOperand': 'FPIMM',
+    'printVectorIndex': 'VINDEX',
+    'printAlignedLabel': 'ALIGNEDLABEL',
+    'printAdrpLabel': 'ADRPLABEL',
+    'printBarrierOption': 'BARRIER',
+    'printMRSSystemRegister': 'MRS',
+    'printMSRSystemRegister': 'MSR',
+    'printSystemPStateField': 'PSTATE',
+    'printSIMDType10Operand': 'SIMDTYPE10',
+}
+
+AARCH64_VAS = {
+    ('16', 'b'): 'ARM64_VAS_16B',
+    ('8', 'b'): 'ARM64_VAS_8B',
+    ('4', 'h'): 'ARM64_VAS_4H',
+    ('8', 'h'): 'ARM64_VAS_8H',
+    ('2', 's'): 'ARM64_VAS_2S',
+    ('4', 's'): 'ARM64_VAS_4S',
+    ('1', 'd'): 'ARM64_VAS_1D',
+    ('2', 'd'): 'ARM64_VAS_2D',
+    ('1', 'q'): 'ARM64_VAS_1Q',
+}
+
+AARCH64_VESS = {
+    'b': 'ARM64_VESS_B',
+    'h': 'ARM64_VESS_H',
+    's': 'ARM64_VESS_S',
+    'd': 'ARM64_VESS_D',
+}
+
+
+# detail step (kind, operand, parameter) of a print command
+def arm_step(c):
+    f, a = c[0], c[1:]
+    if f in ARM_SIMPLE:
+        return (ARM_SIMPLE[f], a[0], '0')
+    if f in ARM_PARAM:
+        return (ARM_PARAM[f][0], a[0], ARM_PARAM[f][1])
+    if f == 'printAdrLabelOperand':
+        return ('ADRLABEL', a[0], a[1])
+    if f == 'set_mem_access':
+        return ('MEM_BEGIN' if a[0] == 'true' else 'MEM_END', '0', '0')
+    if f == 'op_addImm':
+        return ('IMM', '0', a[0])
+    if f == 'ARM_addReg':
+        return ('REG', '0', a[0])
+    if f == 'ARM_addUserMode':
+        return ('USERMODE', '0', '0')
+    if f == 'ARM_addVectorDataType':
+        return ('VDT', '0', a[0])
+    if f == 'ARM_addVectorDataSize':
+        return ('VDS', '0', a[0])
+    raise Exception('unknown print method: %s' % (c, ))
+
+
+def aarch64_step(c):
+    f, a = c[0], c[1:]
+    if f in AARCH64_SIMPLE:
+        return (AARCH64_SIMPLE[f], a[0], '0')
+    if f == 'printPostIncOperand2':
+        return ('POSTINC', a[0], a[1])
+    if f == 'printMemExtend':
+        return ('MEMEXTEND_' + a[1].strip("'").upper(), a[0], a[2])
+    if f == 'printImmScale':
+        return ('IMMSCALE', a[0], a[1])
+    if f == 'printUImm12Offset2':
+        return ('UIMM12OFFSET', a[0], a[1])
+    if f == 'printTypedVectorList':
+        lanes, kind = a[1], a[2].strip("'")
+        if lanes == '0':
+            return ('VLIST_VESS', a[0], AARCH64_VESS[kind])
+        return ('VLIST_VAS', a[0], AARCH64_VAS[(lanes, kind)])
+    if f == 'set_mem_access':
+        return ('MEM_BEGIN' if a[0] == 'true' else 'MEM_END', '0', '0')
+    if f == 'arm64_op_addVectorArrSpecifier':
+        return ('VAS', '0', a[0])
+    if f == 'arm64_op_addVectorElementSizeSpecifier':
+        return ('VESS', '0', a[0])
+    if f == 'arm64_op_addImm':
+        return ('IMM', '0', a[0])
+    if f == 'arm64_op_addFP' and a[0] == '0.0':
+        return ('FP_ZERO', '0', '0')
+    raise Exception('unknown print method: %s' % (c, ))
+
+
+# programs of ARM, which also tell the writeback and the flags update,
+# as the printer does from the text it prints
+def arm_programs(w, path):
+    ids = dict(re.findall(r'\{\s*ARM_(\w+), (ARM_INS_\w+),',
+            open(os.path.join(path, 'ARMMappingInsn.inc')).read()))
+    upd = dict(re.findall(r'\{ (ARM_INS_\w+), "(\w+)" \}',
+            open(os.path.join(path, 'ARMInstPrinter.c')).read()))
+
+    for i, name in enumerate(w.names):
+        p = w.program(i)
+        if p is None:
+            yield name, None
+            continue
+
+        steps = [arm_step(c) for c in p if c[0] != 'txt' and c[0] not in ARM_SKIP]
+        if '!' in ''.join(c[1] for c in p if c[0] == 'txt'):
+            steps.insert(0, ('WRITEBACK', '0', '0'))
+
+        # static mnemonic: the literal text up to the first printed operand
+        prefix = ''
+        for c in p:
+            if c[0] != 'txt':
+                break
+            prefix += c[1]
+        mnem = upd.get(ids.get(name))
+        if mnem:
+            if prefix.startswith(mnem):
+                steps.append(('UPDATE_FLAGS', '0', '0'))
+            elif mnem.startswith(prefix):
+                # the S bit sets the flag itself, and condition codes never start with 's'
+                nxt = [c for c in p if c[0] != 'txt'][0]
+                assert nxt[0] in ('printSBitModifierOperand', 'printPredicateOperand'), (name, p)
+
+        yield name, steps
+
+
+def aarch64_programs(w):
+    for i, name in enumerate(w.names):
+        p = w.program(i)
+        if p is None:
+            yield name, None
+        else:
+            yield name, [aarch64_step(c) for c in p if c[0] != 'txt']
+
+
+# steps of the printCustomAliasOperand() methods, by PrintMethodIdx
+def aarch64_alias_ops(w):
+    m = re.search(r'static void printCustomAliasOperand\(.*?switch \(PrintMethodIdx\) \{(.*?)\n  \}\n\}',
+            w.src, re.S)
+    alias = []
+    for cm in re.finditer(r'case (\d+):\n\s*(\w+)\((.*?)\);', m.group(1)):
+        args = [a.strip() for a in cm.group(3).split(',')]
+        args = [a for a in args if a not in ('MI', 'OS', 'MRI')]
+        # the operand is given by the alias
+        args[0] = '0'
+        assert int(cm.group(1)) == len(alias)
+        s = aarch64_step((cm.group(2), ) + tuple(args))
+        alias.append((s[0], s[2], cm.group(2)))
+    return alias
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("Syntax: %s <arch/ARM | arch/AArch64>" % sys.argv[0])
+        sys.exit(1)
+
+    path = sys.argv[1]
+    arch = os.path.basename(os.path.normpath(path))
+    w = AsmWriter(os.path.join(path, arch + 'GenAsmWriter.inc'))
+    if arch == 'ARM':
+        programs = arm_programs(w, path)
+        op_type = 'arm_detail_op'
+    elif arch == 'AArch64':
+        programs = aarch64_programs(w)
+        op_type = 'aarch64_detail_op'
+    else:
+        print("Unsupported architecture: %s" % arch)
+        sys.exit(1)
+
+    # same programs are shared by all their opcodes, each ended by END
+    offsets = {}
+    order = []
+    size = 0
+    index = []
+    for name, steps in [('', [])] + list(programs):
+        if steps is None:
+            index.append((0, name))
+            continue
+        steps = tuple(steps) + (('END', '0', '0'), )
+        if steps not in offsets:
+            offsets[steps] = size
+            order.append(steps)
+            size += len(steps)
+        if name:
+            index.append((offsets[steps], name))
+
+    print("/* Capstone Disassembly Engine, http://www.capstone-engine.org */")
+    print("/* This is auto-gen data for Capstone disassembly engine (www.capstone-engine.org) */")
+    print("")
+    print("// operand programs replayed by %s_fill_detail(), one per printInstruction() layout" % arch)
+    print("// (see suite/detail_ops.py)")
+    print("static const %s detail_ops[] = {" % op_type)
+    for steps in order:
+        print("\t/* %d */ %s" % (offsets[steps],
+                ' '.join('{ %s_DOP_%s, %s, %s },' % ((arch, ) + s) for s in steps)))
+    print("};")
+    print("")
+    print("// index into detail_ops[] of each opcode")
+    print("static const uint16_t detail_op_idx[] = {")
+    for v, name in index:
+        print("\t%d,\t// %s" % (v, name))
+    print("};")
+
+    if arch == 'AArch64':
+        print("")
+        print("// detail steps of printCustomAliasOperand() methods, by PrintMethodIdx")
+        print("static const aarch64_detail_op alias_ops[] = {")
+        for kind, param, method in aarch64_alias_ops(w):
+            print("\t{ AArch64_DOP_%s, 0, %s },\t// %s" % (kind, param, method))
+        print("};")
+
+
+if __name__ == '__main__':
+    main()
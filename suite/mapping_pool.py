@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+# Capstone Disassembly Engine
+# This tool compacts the instruction mapping tables (insn_map in utils.h).
+# Lists of implicit registers & groups are moved into deduplicated pools,
+# and every row only keeps offsets & counts into those pools.
+#
+# Run it on tables in the old inline form, as produced by the table generators:
+#   ./mapping_pool.py <pool.inc> <table file>...
+# Example:
+#   ./mapping_pool.py ../arch/X86/X86MappingInsnPool.inc \
+#       ../arch/X86/X86MappingInsn.inc ../arch/X86/X86MappingInsn_reduce.inc ../arch/X86/X86Mapping.c
+#
+# All table files given share the same pool, which is written to <pool.inc>.
+
+import re
+import sys
+
+ROW = re.compile(r'(\{\s*[A-Za-z0-9_]+\s*,\s*[A-Za-z0-9_]+\s*,[ \t]*(?://[^\n]*)?\s*#ifndef CAPSTONE_DIET\s*)'
+        r'\{([^}]*)\}\s*,\s*\{([^}]*)\}\s*,\s*\{([^}]*)\}\s*,\s*([^,\s]+)\s*,\s*([^,\s]+)(\s*#endif\s*\})', re.S)
+
+
+def parse_list(text):
+    items = []
+    for t in text.split(','):
+        t = t.strip()
+        if t == '0':
+            break
+        if t:
+            items.append(t)
+    return tuple(items)
+
+
+class Pool:
+    def __init__(self):
+        self.items = []
+        self.offsets = {}
+
+    def add(self, lst):
+        self.offsets[lst] = None
+
+    def build(self):
+        # longest lists first, so shorter ones can reuse a part of them
+        for lst in sorted(self.offsets, key=lambda l: (-len(l), l)):
+            if not lst:
+                self.offsets[lst] = 0
+                continue
+            self.offsets[lst] = self.find(lst)
+
+    def find(self, lst):
+        n = len(lst)
+        for i in range(len(self.items) - n + 1):
+            if tuple(self.items[i:i + n]) == lst:
+                return i
+        # append, overlapping with the tail of the pool if possible
+        for k in range(min(n - 1, len(self.items)), 0, -1):
+            if tuple(self.items[-k:]) == lst[:k]:
+                off = len(self.items) - k
+                self.items.extend(lst[k:])
+                return off
+        off = len(self.items)
+        self.items.extend(lst)
+        return off
+
+    def emit(self, name, ctype):
+        out = 'static const %s %s[] = {\n' % (ctype, name)
+        if not self.items:
+            return out + '\t0\n};\n'
+        for i in range(0, len(self.items), 4):
+            out += '\t/* %d */ %s,\n' % (i, ', '.join(self.items[i:i + 4]))
+        return out + '};\n'
+
+
+def main():
+    if len(sys.argv) < 3:
+        print('Syntax: %s <pool.inc> <table file>...' % sys.argv[0])
+        sys.exit(1)
+
+    regs = Pool()
+    groups = Pool()
+    sources = {}
+
+    for fname in sys.argv[2:]:
+        src = open(fname).read()
+        sources[fname] = src
+        for m in ROW.finditer(src):
+            regs.add(parse_list(m.group(2)))
+            regs.add(parse_list(m.group(3)))
+            groups.add(parse_list(m.group(4)))
+
+    regs.build()
+    groups.build()
+
+    def convert(m):
+        use = parse_list(m.group(2))
+        mod = parse_list(m.group(3))
+        grp = parse_list(m.group(4))
+        return '%s%d, %d, %d, %d, %d, %d, %s, %s%s' % (m.group(1),
+                regs.offsets[use], regs.offsets[mod], groups.offsets[grp],
+                len(use), len(mod), len(grp), m.group(5), m.group(6), m.group(7))
+
+    for fname, src in sources.items():
+        open(fname, 'w').write(ROW.sub(convert, src))
+
+    f = open(sys.argv[1], 'w')
+    f.write('// This is auto-gen data for Capstone disassembly engine (www.capstone-engine.org)\n')
+    f.write('// Implicit registers & groups of instructions, shared by insns[] (see suite/mapping_pool.py)\n\n')
+    f.write(regs.emit('insn_regs', 'uint16_t'))
+    f.write('\n')
+    f.write(groups.emit('insn_groups', 'uint8_t'))
+    f.close()
+
+
+if __name__ == '__main__':
+    main()
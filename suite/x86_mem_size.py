@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+# Capstone Disassembly Engine
+# This tool generates the size of the memory operand of X86 instructions
+# (X86MemSize.inc), for those whose memory operand is printed by LLVM with a
+# sized print method, from the printInstruction() tables of X86GenAsmWriter1.inc:
+#   ./x86_mem_size.py ../arch/X86/X86GenAsmWriter1.inc > ../arch/X86/X86MemSize.inc
+#   ./x86_mem_size.py ../arch/X86/X86GenAsmWriter1_reduce.inc > ../arch/X86/X86MemSize_reduce.inc
+
+import re
+import sys
+
+from asmwriter import AsmWriter
+
+# sizes which the print method does not tell
+SPECIAL = {
+    'FBLDm': 10,
+    'FBSTPm': 10,
+    'FLDENVm': 0,
+    'FSTENVm': 0,
+}
+
+# LEA prints its address with printanymem
+LEA = {
+    'LEA16r': 2,
+    'LEA32r': 4,
+    'LEA64_32r': 4,
+    'LEA64r': 8,
+}
+
+
+# size of the first memory operand printed by @prog, or 0
+def mem_size(name, prog):
+    for cmd in prog:
+        m = re.match(r'print[if](\d+)mem$', cmd[0])
+        if m:
+            return SPECIAL.get(name, int(m.group(1)) // 8)
+        if cmd[0] == 'printanymem':
+            return LEA.get(name, 0)
+        if cmd[0] == 'printopaquemem' or re.match(r'print(SrcIdx|DstIdx|MemOffs)', cmd[0]):
+            return 0
+    return 0
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("Syntax: %s <X86GenAsmWriter1.inc>" % sys.argv[0])
+        sys.exit(1)
+
+    w = AsmWriter(sys.argv[1])
+
+    print("// This is auto-gen data for Capstone disassembly engine (www.capstone-engine.org)")
+    print("// Size of the memory operand of X86, sorted by internal opcode (see suite/x86_mem_size.py)")
+    print("")
+    for i, name in enumerate(w.names):
+        prog = w.program(i)
+        if not prog:
+            continue
+        size = mem_size(name, prog)
+        if size:
+            print("{%d, X86_%s}," % (size, name))
+
+
+if __name__ == '__main__':
+    main()
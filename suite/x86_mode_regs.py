@@ -0,0 +1,137 @@
+#!/usr/bin/env python
+# Capstone Disassembly Engine
+# This tool splits the pool of implicit registers of X86 (X86MappingInsnPool.inc)
+# into one pool per mode: insn_regs_16[], insn_regs_32[] & insn_regs_64[].
+# All pools have the same layout, so a row of insns[] is valid for every mode,
+# and registers that depend on the mode (like stack & string registers) are
+# resolved here rather than when disassembling.
+#
+# Run it on tables already compacted by mapping_pool.py:
+#   ./x86_mode_regs.py ../arch/X86/X86MappingInsnPool.inc \
+#       ../arch/X86/X86MappingInsn.inc ../arch/X86/X86MappingInsn_reduce.inc
+
+import re
+import sys
+
+from mapping_pool import Pool
+
+ROW = re.compile(r'(\{\s*(X86_\w+)\s*,\s*(X86_INS_\w+)\s*,\s*#ifndef CAPSTONE_DIET\s*)'
+        r'(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\w+)\s*,\s*(\w+)(\s*#endif\s*\})', re.S)
+
+MODES = (16, 32, 64)
+
+
+def reg(name):
+    return 'X86_REG_' + name
+
+
+def replace(lst, r1, r2):
+    # replace the first r1 with r2
+    if reg(r1) in lst:
+        lst[lst.index(reg(r1))] = reg(r2)
+
+
+def fixup(opcode, ins, use, mod, mode):
+    use = list(use)
+    mod = list(mod)
+
+    # regs_write[] of these depends on mode
+    if opcode == 'X86_RDTSC' and mode != 64:
+        mod = [reg('EAX'), reg('EDX')]
+    elif opcode == 'X86_RDTSCP' and mode != 64:
+        mod = [reg('EAX'), reg('ECX'), reg('EDX')]
+
+    si = {16: 'SI', 32: 'ESI', 64: 'RSI'}[mode]
+    di = {16: 'DI', 32: 'EDI', 64: 'RDI'}[mode]
+    cx = {16: 'CX', 32: 'ECX', 64: 'RCX'}[mode]
+    sp = {16: 'SP', 32: 'ESP', 64: 'RSP'}[mode]
+
+    if ins in ('X86_INS_LOOP', 'X86_INS_LOOPE', 'X86_INS_LOOPNE'):
+        use = [reg(cx)]
+        mod = [reg(cx)]
+        # LOOPE & LOOPNE also read EFLAGS
+        if ins != 'X86_INS_LOOP':
+            use.append(reg('EFLAGS'))
+    elif ins in ('X86_INS_LODSB', 'X86_INS_LODSD', 'X86_INS_LODSQ', 'X86_INS_LODSW'):
+        replace(use, 'ESI', si)
+        replace(mod, 'ESI', si)
+    elif ins in ('X86_INS_SCASB', 'X86_INS_SCASW', 'X86_INS_SCASQ',
+            'X86_INS_STOSB', 'X86_INS_STOSD', 'X86_INS_STOSQ', 'X86_INS_STOSW'):
+        replace(use, 'EDI', di)
+        replace(mod, 'EDI', di)
+    elif ins in ('X86_INS_CMPSB', 'X86_INS_CMPSD', 'X86_INS_CMPSQ', 'X86_INS_CMPSW',
+            'X86_INS_MOVSB', 'X86_INS_MOVSW', 'X86_INS_MOVSD', 'X86_INS_MOVSQ'):
+        replace(use, 'EDI', di)
+        replace(mod, 'EDI', di)
+        replace(use, 'ESI', si)
+        replace(mod, 'ESI', si)
+    elif ins == 'X86_INS_RET':
+        use = [reg(sp)]
+        mod = [reg(sp)]
+
+    return use, mod
+
+
+def read_pool(src, name):
+    body = src[src.index(' %s[] = {' % name):]
+    body = body[body.index('{') + 1:body.index('};')]
+    body = re.sub(r'/\*.*?\*/', '', body)
+    return [t.strip() for t in body.split(',') if t.strip()]
+
+
+def main():
+    if len(sys.argv) < 3:
+        print('Syntax: %s <pool.inc> <table file>...' % sys.argv[0])
+        sys.exit(1)
+
+    pool_src = open(sys.argv[1]).read()
+    regs = read_pool(pool_src, 'insn_regs')
+    groups = pool_src[pool_src.index('static const uint8_t insn_groups[]'):]
+
+    pool = Pool()
+    sources = {}
+    lists = {}
+
+    for fname in sys.argv[2:]:
+        src = open(fname).read()
+        sources[fname] = src
+        for m in ROW.finditer(src):
+            use = regs[int(m.group(4)):int(m.group(4)) + int(m.group(7))]
+            mod = regs[int(m.group(5)):int(m.group(5)) + int(m.group(8))]
+            per_mode = [fixup(m.group(2), m.group(3), use, mod, mode) for mode in MODES]
+            # each item of the pool is a register for every mode
+            u = tuple(zip(*[p[0] for p in per_mode]))
+            d = tuple(zip(*[p[1] for p in per_mode]))
+            if len(u) != len(per_mode[0][0]) or len(d) != len(per_mode[0][1]) or \
+                    any(len(p[0]) != len(u) or len(p[1]) != len(d) for p in per_mode):
+                sys.exit('%s: number of registers depends on mode' % m.group(2))
+            lists[m.group(2)] = (u, d)
+            pool.add(u)
+            pool.add(d)
+
+    pool.build()
+
+    def convert(m):
+        u, d = lists[m.group(2)]
+        return '%s%d, %d, %s, %d, %d, %s, %s, %s%s' % (m.group(1),
+                pool.offsets[u], pool.offsets[d], m.group(6), len(u), len(d),
+                m.group(9), m.group(10), m.group(11), m.group(12))
+
+    for fname, src in sources.items():
+        open(fname, 'w').write(ROW.sub(convert, src))
+
+    f = open(sys.argv[1], 'w')
+    f.write('// This is auto-gen data for Capstone disassembly engine (www.capstone-engine.org)\n')
+    f.write('// Implicit registers & groups of instructions, shared by insns[] (see suite/mapping_pool.py)\n')
+    f.write('// Implicit registers have one pool per mode, with the same layout (see suite/x86_mode_regs.py)\n\n')
+    for i, mode in enumerate(MODES):
+        p = Pool()
+        p.items = [item[i] for item in pool.items]
+        f.write(p.emit('insn_regs_%d' % mode, 'uint16_t'))
+        f.write('\n')
+    f.write(groups)
+    f.close()
+
+
+if __name__ == '__main__':
+    main()
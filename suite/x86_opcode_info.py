@@ -0,0 +1,117 @@
+#!/usr/bin/env python
+# Capstone Disassembly Engine
+# This tool generates the per-opcode info table of X86 (X86OpcodeInfo.inc),
+# which is indexed directly by internal opcode.
+# Every row keeps the size of the immediate operand, and an index into a small
+# table of accumulator registers embedded in the asm strings by LLVM.
+#
+# Inputs are arch/X86/X86ImmSize.inc, with rows "{enc_size, size, X86_xxx},"
+# generated by autogen_x86imm.py, and arch/X86/X86InsnRegs.inc, which defines
+# the lists of registers insn_regs_att[], insn_regs_intel[] & insn_regs_intel2[]:
+#   ./x86_opcode_info.py ../arch/X86/X86GenInstrInfo.inc ../arch/X86/X86ImmSize.inc ../arch/X86/X86InsnRegs.inc > ../arch/X86/X86OpcodeInfo.inc
+#   ./x86_opcode_info.py ../arch/X86/X86GenInstrInfo_reduce.inc ../arch/X86/X86ImmSize.inc ../arch/X86/X86InsnRegs.inc reduce > ../arch/X86/X86OpcodeInfo_reduce.inc
+# With "reduce", rows under "#ifndef CAPSTONE_X86_REDUCE" are skipped.
+
+import re
+import sys
+
+
+def opcodes(fname):
+    src = open(fname).read()
+    end = int(re.search(r'X86_INSTRUCTION_LIST_END\s*=\s*(\d+)', src).group(1))
+    ops = {}
+    for m in re.finditer(r'^\s*X86_(\w+)\s*=\s*(\d+),', src, re.M):
+        # opcodes out of the list (like ENDBR of reduce mode) have no info
+        if int(m.group(2)) < end:
+            ops['X86_' + m.group(1)] = int(m.group(2))
+    return ops
+
+
+def strip_reduce(src):
+    # drop "#ifndef CAPSTONE_X86_REDUCE ... #endif" blocks
+    return re.sub(r'#ifndef CAPSTONE_X86_REDUCE.*?#endif', '', src, flags=re.S)
+
+
+def table(src, name):
+    i = src.index(' %s[] = {' % name)
+    return src[i:src.index('};', i)]
+
+
+def rows(text):
+    out = []
+    for m in re.finditer(r'\{\s*(X86_\w+)\s*,([^}]*)\}', text):
+        out.append([m.group(1)] + [f.strip() for f in m.group(2).split(',') if f.strip()])
+    return out
+
+
+def main():
+    if len(sys.argv) < 4:
+        print('Syntax: %s <X86GenInstrInfo.inc> <X86ImmSize.inc> <X86InsnRegs.inc> [reduce]' % sys.argv[0])
+        sys.exit(1)
+
+    ops = opcodes(sys.argv[1])
+    reduce = len(sys.argv) > 4 and sys.argv[4] == 'reduce'
+    regs_src = open(sys.argv[3]).read()
+    if reduce:
+        regs_src = strip_reduce(regs_src)
+
+    names = [None] * (max(ops.values()) + 1)
+    for n, v in ops.items():
+        names[v] = n
+
+    imm = {}
+    for m in re.finditer(r'\{(\d+),\s*(\d+),\s*(X86_\w+)\}', open(sys.argv[2]).read()):
+        imm[m.group(3)] = (int(m.group(2)), int(m.group(1)))
+
+    # registers per opcode: [intel, intel_access, att, att_access, reg1, access1, reg2, access2]
+    regs = {}
+
+    def entry(op):
+        return regs.setdefault(op, ['0'] * 8)
+
+    # tables are searched for the first match, so keep the first row of an opcode
+    seen = set()
+    for r in rows(table(regs_src, 'insn_regs_intel')):
+        if r[0] not in seen:
+            seen.add(r[0])
+            entry(r[0])[0:2] = [r[1], r[2] if len(r) > 2 else '0']
+    seen = set()
+    for r in rows(table(regs_src, 'insn_regs_att')):
+        if r[0] not in seen:
+            seen.add(r[0])
+            entry(r[0])[2:4] = [r[1], r[2] if len(r) > 2 else '0']
+    seen = set()
+    for r in rows(table(regs_src, 'insn_regs_intel2')):
+        if r[0] not in seen:
+            seen.add(r[0])
+            entry(r[0])[4:8] = [r[1], r[3], r[2], r[4]]
+
+    for op in list(imm) + list(regs):
+        if op not in ops:
+            sys.stderr.write('warning: unknown opcode %s\n' % op)
+
+    pool = [('0',) * 8]
+    index = {pool[0]: 0}
+    for op in sorted(regs, key=lambda o: ops[o]):
+        t = tuple(regs[op])
+        if t not in index:
+            index[t] = len(pool)
+            pool.append(t)
+
+    print('// This is auto-gen data for Capstone disassembly engine (www.capstone-engine.org)')
+    print('// Per-opcode info of X86, indexed by internal opcode (see suite/x86_opcode_info.py)')
+    print('')
+    print('static const x86_opcode_regs opcode_regs[] = {')
+    for t in pool:
+        print('\t{ %s },' % ', '.join(t))
+    print('};')
+    print('')
+    print('static const x86_opcode_info opcode_info[] = {')
+    for n in names:
+        size, enc = imm.get(n, (0, 0))
+        print('\t{ %d, %d, %d },\t// %s' % (size, enc, index[tuple(regs[n])] if n in regs else 0, n))
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,261 @@
+/* Capstone Disassembler Engine */
+/* Blocks decoded by cs_disasm_block(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	// groups ending the block, or 0 for CS_BLOCK_GROUPS
+	uint64_t groups;
+	const char *comment;
+	// one line per instruction: "address mnemonic operands", then the target
+	const char *expected;
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+static void print_block(cs_insn *insn, size_t count, uint64_t target, bool has_target,
+		char *result, size_t size)
+{
+	size_t j, len = 0;
+
+	result[0] = '\0';
+	for (j = 0; j < count; j++)
+		len += snprintf(result + len, size - len, "0x%" PRIx64 " %s %s\n",
+				insn[j].address, insn[j].mnemonic, insn[j].op_str);
+
+	if (has_target)
+		snprintf(result + len, size - len, "target: 0x%" PRIx64 "\n", target);
+	else
+		snprintf(result + len, size - len, "target: none\n");
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// push rbp; mov rbp, rsp; call 0x1019; nop; ret
+#define X86_CODE64 "\x55\x48\x89\xe5\xe8\x10\x00\x00\x00\x90\xc3"
+// nop; int 0x80; nop
+#define X86_CODE64_INT "\x90\xcd\x80\x90"
+// nop; iretq; nop
+#define X86_CODE64_IRET "\x90\x48\xcf\x90"
+// nop; jmp rax; nop
+#define X86_CODE64_JMP "\x90\xff\xe0\x90"
+// nop; nop; nop
+#define X86_CODE64_NOP "\x90\x90\x90"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// nop; bl #0x100c; nop
+#define ARM64_CODE "\x1f\x20\x03\xd5\x02\x00\x00\x94\x1f\x20\x03\xd5"
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+// nop; b 0x1010; addiu $v0, $zero, 1; (data)
+#define MIPS_CODE "\x00\x00\x00\x00\x10\x00\x00\x02\x24\x02\x00\x01\xff\xff\xff\xff"
+// jal 0x1000; nop; nop
+#define MIPS_CODE_JAL "\x0c\x00\x04\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			0,
+			"X86 64 (Intel syntax)",
+			"0x1000 push rbp\n"
+			"0x1001 mov rbp, rsp\n"
+			"0x1004 call 0x1019\n"
+			"target: 0x1019\n",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			(uint64_t)1 << CS_GRP_RET,
+			"X86 64 (Intel syntax), ending on returns only",
+			"0x1000 push rbp\n"
+			"0x1001 mov rbp, rsp\n"
+			"0x1004 call 0x1019\n"
+			"0x1009 nop \n"
+			"0x100a ret \n"
+			"target: none\n",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64_INT,
+			sizeof(X86_CODE64_INT) - 1,
+			0,
+			"X86 64 (Intel syntax), ending on an interrupt",
+			"0x1000 nop \n"
+			"0x1001 int 0x80\n"
+			"target: none\n",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64_IRET,
+			sizeof(X86_CODE64_IRET) - 1,
+			0,
+			"X86 64 (Intel syntax), ending on an interrupt return",
+			"0x1000 nop \n"
+			"0x1001 iretq \n"
+			"target: none\n",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64_JMP,
+			sizeof(X86_CODE64_JMP) - 1,
+			0,
+			"X86 64 (Intel syntax), ending on an indirect jump",
+			"0x1000 nop \n"
+			"0x1001 jmp rax\n"
+			"target: none\n",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64_NOP,
+			sizeof(X86_CODE64_NOP) - 1,
+			0,
+			"X86 64 (Intel syntax), ending with the code",
+			"0x1000 nop \n"
+			"0x1001 nop \n"
+			"0x1002 nop \n"
+			"target: none\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			0,
+			"ARM-64",
+			"0x1000 nop \n"
+			"0x1004 bl #0x100c\n"
+			"target: 0x100c\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			(unsigned char *)MIPS_CODE,
+			sizeof(MIPS_CODE) - 1,
+			0,
+			"MIPS-32 (Big-endian), with a delay slot",
+			"0x1000 nop \n"
+			"0x1004 b 0x1010\n"
+			"0x1008 addiu $v0, $zero, 1\n"
+			"target: 0x1010\n",
+		},
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			(unsigned char *)MIPS_CODE_JAL,
+			sizeof(MIPS_CODE_JAL) - 1,
+			// JAL is not in the call group of Mips
+			(uint64_t)1 << CS_GRP_CALL,
+			"MIPS-32 (Big-endian), ending on calls only",
+			"0x1000 jal 0x1000\n"
+			"0x1004 nop \n"
+			"target: 0x1000\n",
+		},
+#endif
+	};
+
+	csh handle;
+	uint64_t address = 0x1000;
+	uint64_t target;
+	bool has_target;
+	cs_insn *insn;
+	char result[1024];
+	size_t count, j;
+	cs_err err;
+	int i, detail;
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		// the same block is decoded with & without the detail
+		for (detail = 0; detail < 2; detail++) {
+			cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+
+			count = cs_disasm_block(handle, platforms[i].code, platforms[i].size,
+					address, platforms[i].groups, &insn, &target, &has_target);
+			if (!count) {
+				printf("ERROR: cs_disasm_block() failed with: %s\n",
+						cs_strerror(cs_errno(handle)));
+				abort();
+			}
+
+			print_block(insn, count, target, has_target, result, sizeof(result));
+			if (!detail)
+				printf("Instructions:\n%s", result);
+
+			if (strcmp(result, platforms[i].expected)) {
+				printf("ERROR: block with CS_OPT_DETAIL %s:\n%s",
+						detail ? "on" : "off", result);
+				printf("expected:\n%s", platforms[i].expected);
+				abort();
+			}
+
+			for (j = 0; j < count; j++) {
+				if ((insn[j].detail != NULL) != detail) {
+					printf("ERROR: detail of 0x%" PRIx64 " does not follow CS_OPT_DETAIL\n",
+							insn[j].address);
+					abort();
+				}
+			}
+
+			cs_free(insn, count);
+		}
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_disasm_block() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
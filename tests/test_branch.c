@@ -0,0 +1,324 @@
+/* Capstone Disassembler Engine */
+/* Control transfers of cs_insn_branch_target(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+#define RANDOM_SIZE (16 * 1024)
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	const char *comment;
+	// one line per instruction: "address type target"
+	const char *expected;
+};
+
+static const char *branch_names[] = {
+	"none", "jump", "cond_jump", "call", "indirect_jump", "indirect_call", "ret",
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// random bytes, the same on every run
+static void random_code(unsigned char *buf, size_t size)
+{
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+// print the transfers of @insn to @result, one line per instruction
+static void print_branches(csh handle, cs_insn *insn, size_t count,
+		char *result, size_t size)
+{
+	size_t j, len = 0;
+	uint64_t target;
+	cs_branch_type type;
+
+	result[0] = '\0';
+	for (j = 0; j < count; j++) {
+		type = cs_insn_branch_target(handle, &insn[j], &target);
+		if (cs_errno(handle) != CS_ERR_OK) {
+			printf("ERROR: cs_insn_branch_target() failed with: %s\n",
+					cs_strerror(cs_errno(handle)));
+			abort();
+		}
+
+		len += snprintf(result + len, size - len, "0x%" PRIx64 " %s 0x%" PRIx64 "\n",
+				insn[j].address, branch_names[type], target);
+	}
+}
+
+// CS_OPT_BRANCH alone must not give instructions any detail
+static void check_no_detail(const char *what, cs_insn *insn, size_t count)
+{
+	size_t j;
+
+	for (j = 0; j < count; j++) {
+		if (insn[j].detail) {
+			printf("ERROR: %s: detail of 0x%" PRIx64 " is not NULL\n",
+					what, insn[j].address);
+			abort();
+		}
+	}
+}
+
+// with @all false, @result may miss some lines of @expected
+static void check(const char *what, const char *result, const char *expected, bool all)
+{
+	const char *line, *end;
+	char buf[64];
+	bool ok = !strcmp(result, expected);
+
+	for (line = result; !all && *line; line = end + 1) {
+		end = strchr(line, '\n');
+		snprintf(buf, sizeof(buf), "%.*s", (int)(end - line + 1), line);
+		ok = strstr(expected, buf) != NULL;
+		if (!ok)
+			break;
+	}
+
+	if (!ok) {
+		printf("ERROR: %s:\n%s", what, result);
+		printf("expected:\n%s", expected);
+		abort();
+	}
+}
+
+// transfers found by @handle with CS_OPT_BRANCH but without the detail must be
+// those found by @ref from the detail, on every instruction of @code
+static void check_random(csh handle, csh ref, const unsigned char *code, size_t size)
+{
+	cs_insn *insn, *insn2;
+	size_t count, count2, j;
+	uint64_t target, target2;
+	cs_branch_type type, type2;
+
+	count = cs_disasm(handle, code, size, 0x1000, 0, &insn);
+	count2 = cs_disasm(ref, code, size, 0x1000, 0, &insn2);
+	if (count != count2) {
+		printf("ERROR: %u instructions without the detail, %u with it\n",
+				(unsigned int)count, (unsigned int)count2);
+		abort();
+	}
+
+	check_no_detail("random code with CS_OPT_BRANCH", insn, count);
+	for (j = 0; j < count; j++) {
+		// data of CS_OPT_SKIPDATA
+		if (!insn2[j].id)
+			continue;
+
+		type = cs_insn_branch_target(handle, &insn[j], &target);
+		type2 = cs_insn_branch_target(ref, &insn2[j], &target2);
+		if (type != type2 || target != target2) {
+			printf("ERROR: 0x%" PRIx64 " %s %s: %s 0x%" PRIx64 " without the detail, "
+					"%s 0x%" PRIx64 " with it\n", insn2[j].address,
+					insn2[j].mnemonic, insn2[j].op_str, branch_names[type], target,
+					branch_names[type2], target2);
+			abort();
+		}
+	}
+
+	printf("Same branches as the detail for %u instructions\n", (unsigned int)count);
+
+	cs_free(insn, count);
+	cs_free(insn2, count2);
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// call 0x1015; je 0x100b; jmp 0x1007; jmp rax; call rax; ret; nop
+#define X86_CODE64 "\xe8\x10\x00\x00\x00\x74\x04\xeb\xfe\xff\xe0\xff\xd0\xc3\x90"
+#endif
+#ifdef CAPSTONE_HAS_ARM
+// bl 0x1010; beq 0x1000; blx r3; bx lr; b 0x1010
+#define ARM_CODE "\x02\x00\x00\xeb\xfd\xff\xff\x0a\x33\xff\x2f\xe1\x1e\xff\x2f\xe1\xfe\xff\xff\xea"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// bl 0x1010; b.eq 0x1000; br x1; blr x2; ret; b 0x1014
+#define ARM64_CODE "\x04\x00\x00\x94\xe0\xff\xff\x54\x20\x00\x1f\xd6\x40\x00\x3f\xd6\xc0\x03\x5f\xd6\x00\x00\x00\x14"
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+// beq $a0, $a1, 0x1010; nop; jal 0x2000; nop; jr $ra; nop
+#define MIPS_CODE "\x10\x85\x00\x03\x00\x00\x00\x00\x0c\x00\x08\x00\x00\x00\x00\x00\x03\xe0\x00\x08\x00\x00\x00\x00"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			"X86 64 (Intel syntax)",
+			"0x1000 call 0x1015\n"
+			"0x1005 cond_jump 0x100b\n"
+			"0x1007 jump 0x1007\n"
+			"0x1009 indirect_jump 0x0\n"
+			"0x100b indirect_call 0x0\n"
+			"0x100d ret 0x0\n"
+			"0x100e none 0x0\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_ARM,
+			(unsigned char *)ARM_CODE,
+			sizeof(ARM_CODE) - 1,
+			"ARM",
+			"0x1000 call 0x1010\n"
+			"0x1004 cond_jump 0x1000\n"
+			"0x1008 indirect_call 0x0\n"
+			"0x100c ret 0x0\n"
+			"0x1010 jump 0x1010\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			"ARM-64",
+			"0x1000 call 0x1010\n"
+			"0x1004 cond_jump 0x1000\n"
+			"0x1008 indirect_jump 0x0\n"
+			"0x100c indirect_call 0x0\n"
+			"0x1010 ret 0x0\n"
+			"0x1014 jump 0x1014\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			(unsigned char *)MIPS_CODE,
+			sizeof(MIPS_CODE) - 1,
+			"MIPS-32 (Big-endian)",
+			"0x1000 cond_jump 0x1010\n"
+			"0x1004 none 0x0\n"
+			"0x1008 call 0x2000\n"
+			"0x100c none 0x0\n"
+			"0x1010 ret 0x0\n"
+			"0x1014 none 0x0\n",
+		},
+#endif
+	};
+
+	csh handle, ref;
+	uint64_t address = 0x1000, next;
+	const uint8_t *code;
+	unsigned char *random;
+	cs_insn *insn;
+	char result[1024];
+	size_t count, size, len;
+	cs_err err;
+	int i;
+
+	random = malloc(RANDOM_SIZE);
+	random_code(random, RANDOM_SIZE);
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		// transfers found from the detail
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+		count = cs_disasm(handle, platforms[i].code, platforms[i].size, address, 0, &insn);
+		print_branches(handle, insn, count, result, sizeof(result));
+		printf("Branches:\n%s", result);
+		check("branches with detail", result, platforms[i].expected, true);
+		cs_free(insn, count);
+
+		// classified while decoding, into the detail
+		cs_option(handle, CS_OPT_BRANCH, CS_OPT_ON);
+		count = cs_disasm(handle, platforms[i].code, platforms[i].size, address, 0, &insn);
+		print_branches(handle, insn, count, result, sizeof(result));
+		check("branches of cs_detail", result, platforms[i].expected, true);
+		cs_free(insn, count);
+
+		// the same without the detail, which is then not built at all
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_OFF);
+		count = cs_disasm(handle, platforms[i].code, platforms[i].size, address, 0, &insn);
+		check_no_detail("cs_disasm() with CS_OPT_BRANCH", insn, count);
+		print_branches(handle, insn, count, result, sizeof(result));
+		check("branches with CS_OPT_BRANCH", result, platforms[i].expected, true);
+		cs_free(insn, count);
+
+		// one at a time, in an instruction allocated with CS_OPT_BRANCH on
+		insn = cs_malloc(handle);
+		code = platforms[i].code;
+		size = platforms[i].size;
+		next = address;
+		len = 0;
+		while (cs_disasm_iter(handle, &code, &size, &next, insn)) {
+			check_no_detail("cs_disasm_iter() with CS_OPT_BRANCH", insn, 1);
+			print_branches(handle, insn, 1, result + len, sizeof(result) - len);
+			len += strlen(result + len);
+		}
+		check("branches with cs_disasm_iter()", result, platforms[i].expected, true);
+		cs_free(insn, 1);
+
+		// and by the recursive descent, which skips unreachable code
+		count = cs_disasm_recursive(handle, platforms[i].code, platforms[i].size,
+				address, NULL, 0, &insn);
+		check_no_detail("cs_disasm_recursive() with CS_OPT_BRANCH", insn, count);
+		print_branches(handle, insn, count, result, sizeof(result));
+		check("branches with cs_disasm_recursive()", result, platforms[i].expected, false);
+		cs_free(insn, count);
+
+		cs_open(platforms[i].arch, platforms[i].mode, &ref);
+		cs_option(ref, CS_OPT_DETAIL, CS_OPT_ON);
+		cs_option(ref, CS_OPT_SKIPDATA, CS_OPT_ON);
+		cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
+		check_random(handle, ref, random, RANDOM_SIZE);
+
+		printf("\n");
+
+		cs_close(&ref);
+		cs_close(&handle);
+	}
+
+	free(random);
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_insn_branch_target() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
@@ -0,0 +1,231 @@
+/* Capstone Disassembler Engine */
+/* Basic blocks & edges built by cs_cfg_build(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	const char *comment;
+	// one line per block: "index address: insn; insn; ... -> index type, ..."
+	const char *expected;
+};
+
+static const char *edge_names[] = {
+	"fallthrough", "jump", "cond", "call",
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// blocks must cover all instructions in order, and every edge must be listed
+// once in the predecessors of its destination
+static void check_graph(cs_cfg *cfg)
+{
+	size_t b, insn = 0;
+	uint32_t e, p, found;
+
+	for (b = 0; b < cfg->block_count; b++) {
+		cs_block *block = &cfg->blocks[b];
+
+		if (block->insn != insn || cfg->insns[block->insn].address != block->address) {
+			printf("ERROR: block %u does not follow the previous one\n", (unsigned int)b);
+			abort();
+		}
+		insn += block->insn_count;
+
+		for (e = block->succ; e < block->succ + block->succ_count; e++) {
+			cs_block *to = &cfg->blocks[cfg->edges[e].to];
+
+			found = 0;
+			for (p = to->pred; p < to->pred + to->pred_count; p++)
+				found += cfg->preds[p] == e;
+
+			if (cfg->edges[e].from != b || found != 1) {
+				printf("ERROR: edge %u of block %u is not a predecessor of its destination\n",
+						e, (unsigned int)b);
+				abort();
+			}
+		}
+	}
+
+	if (insn != cfg->insn_count) {
+		printf("ERROR: blocks cover %u of %u instructions\n",
+				(unsigned int)insn, (unsigned int)cfg->insn_count);
+		abort();
+	}
+}
+
+static void print_graph(cs_cfg *cfg, char *result, size_t size)
+{
+	size_t b, len = 0;
+	uint32_t i;
+
+	result[0] = '\0';
+	for (b = 0; b < cfg->block_count; b++) {
+		cs_block *block = &cfg->blocks[b];
+
+		len += snprintf(result + len, size - len, "%u 0x%" PRIx64 ":",
+				(unsigned int)b, block->address);
+		for (i = 0; i < block->insn_count; i++) {
+			cs_insn *insn = &cfg->insns[block->insn + i];
+
+			len += snprintf(result + len, size - len, "%s %s%s%s", i ? ";" : "",
+					insn->mnemonic, insn->op_str[0] ? " " : "", insn->op_str);
+		}
+
+		len += snprintf(result + len, size - len, " ->");
+		for (i = 0; i < block->succ_count; i++) {
+			cs_edge *edge = &cfg->edges[block->succ + i];
+
+			len += snprintf(result + len, size - len, "%s %u %s", i ? "," : "",
+					edge->to, edge_names[edge->type]);
+		}
+		len += snprintf(result + len, size - len, "\n");
+	}
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// test rax, rax; je 0x100c; mov eax, 1; jmp 0x1011; mov eax, 2;
+// dec eax; jne 0x1011; call 0x101b; ret; ret
+#define X86_CODE64 "\x48\x85\xc0\x74\x07\xb8\x01\x00\x00\x00\xeb\x05\xb8\x02\x00\x00\x00\xff\xc8\x75\xfc\xe8\x01\x00\x00\x00\xc3\xc3"
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+// beq $a0, $a1, 0x1014; addiu $v0, $zero, 2; addiu $v0, $zero, 1; jr $ra; nop; jr $ra; nop
+#define MIPS_CODE "\x10\x85\x00\x04\x24\x02\x00\x02\x24\x02\x00\x01\x03\xe0\x00\x08\x00\x00\x00\x00\x03\xe0\x00\x08\x00\x00\x00\x00"
+#endif
+#ifdef CAPSTONE_HAS_ARM
+// cmp r0, #0; ite eq; moveq r0, #1; movne r0, #2; bx lr
+#define THUMB_CODE "\x00\x28\x0c\xbf\x01\x20\x02\x20\x70\x47"
+// it eq; beq #0x1006; nop; bx lr
+#define THUMB_CODE2 "\x08\xbf\x00\xe0\x00\xbf\x70\x47"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			"X86 64 (Intel syntax)",
+			"0 0x1000: test rax, rax; je 0x100c -> 2 cond, 1 fallthrough\n"
+			"1 0x1005: mov eax, 1; jmp 0x1011 -> 3 jump\n"
+			"2 0x100c: mov eax, 2 -> 3 fallthrough\n"
+			"3 0x1011: dec eax; jne 0x1011 -> 3 cond, 4 fallthrough\n"
+			"4 0x1015: call 0x101b; ret -> 5 call\n"
+			"5 0x101b: ret ->\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			(unsigned char *)MIPS_CODE,
+			sizeof(MIPS_CODE) - 1,
+			"MIPS-32 (Big-endian), with delay slots",
+			"0 0x1000: beq $a0, $a1, 0x1014; addiu $v0, $zero, 2 -> 2 cond, 1 fallthrough\n"
+			"1 0x1008: addiu $v0, $zero, 1; jr $ra; nop ->\n"
+			"2 0x1014: jr $ra; nop ->\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_THUMB,
+			(unsigned char *)THUMB_CODE,
+			sizeof(THUMB_CODE) - 1,
+			"Thumb, with an IT block",
+			"0 0x1000: cmp r0, #0; ite eq; moveq r0, #1; movne r0, #2; bx lr ->\n",
+		},
+		{
+			CS_ARCH_ARM,
+			CS_MODE_THUMB,
+			(unsigned char *)THUMB_CODE2,
+			sizeof(THUMB_CODE2) - 1,
+			"Thumb, with a branch ending an IT block",
+			"0 0x1000: it eq; beq #0x1006 -> 2 cond, 1 fallthrough\n"
+			"1 0x1004: nop -> 2 fallthrough\n"
+			"2 0x1006: bx lr ->\n",
+		},
+#endif
+	};
+
+	csh handle;
+	uint64_t address = 0x1000;
+	cs_cfg *cfg;
+	char result[1024];
+	cs_err err;
+	int i, detail;
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		// the same graph is built with & without the detail
+		for (detail = 0; detail < 2; detail++) {
+			cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+
+			err = cs_cfg_build(handle, platforms[i].code, platforms[i].size,
+					address, NULL, 0, &cfg);
+			if (err) {
+				printf("ERROR: cs_cfg_build() failed with: %s\n", cs_strerror(err));
+				abort();
+			}
+
+			check_graph(cfg);
+			print_graph(cfg, result, sizeof(result));
+			if (!detail)
+				printf("Blocks:\n%s", result);
+
+			if (strcmp(result, platforms[i].expected)) {
+				printf("ERROR: blocks with CS_OPT_DETAIL %s:\n%s",
+						detail ? "on" : "off", result);
+				printf("expected:\n%s", platforms[i].expected);
+				abort();
+			}
+
+			cs_cfg_free(handle, cfg);
+		}
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_cfg_build() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
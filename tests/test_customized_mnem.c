@@ -49,6 +49,13 @@ static void test()
 	cs_opt_mnem my_mnem = { X86_INS_JNE, "jnz" };
 	// Set .mnemonic to NULL to reset to default mnemonic
 	cs_opt_mnem default_mnem = { X86_INS_JNE, NULL };
+	// IDs of no X86 instruction
+	cs_opt_mnem bad_mnem[] = {
+		{ X86_INS_ENDING, "bad" },
+		{ 100000000, "bad" },
+		{ 0xffffffff, "bad" },
+	};
+	int i;
 
 	err = cs_open(CS_ARCH_X86, CS_MODE_32, &handle);
 	if (err) {
@@ -74,6 +81,19 @@ static void test()
 	// 3. Now print out the instruction in default setup.
 	print_insn(handle);
 
+	// IDs past the instructions of the arch are rejected
+	printf("\nCustomize invalid instruction IDs\n");
+	for (i = 0; i < sizeof(bad_mnem) / sizeof(bad_mnem[0]); i++) {
+		err = cs_option(handle, CS_OPT_MNEMONIC, (size_t)&bad_mnem[i]);
+		if (err != CS_ERR_OPTION) {
+			printf("ERROR: instruction ID %u accepted with error %u\n", bad_mnem[i].id, err);
+			abort();
+		}
+	}
+
+	// 4. The instruction keeps its default mnemonic.
+	print_insn(handle);
+
 	// Done
 	cs_close(&handle);
 }
@@ -0,0 +1,167 @@
+/* Capstone Disassembler Engine */
+/* Gadgets found by cs_gadget_find(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	unsigned int max_insns;
+	const char *comment;
+	// one line per gadget: "address count size insn;insn;..."
+	const char *expected;
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// pop rax; pop rbx; ret; pop rbx; ret; pop rcx; jmp rcx
+#define X86_CODE64 "\x58\x5b\xc3\x5b\xc3\x59\xff\xe1"
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+// addiu $sp, $sp, 8; jr $ra; nop
+#define MIPS_CODE "\x27\xbd\x00\x08\x03\xe0\x00\x08\x00\x00\x00\x00"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// mov x0, x1; ret; ldr x1, [sp], #0x10; br x1
+#define ARM64_CODE "\xe0\x03\x01\xaa\xc0\x03\x5f\xd6\xe1\x07\x41\xf8\x20\x00\x1f\xd6"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			3,
+			"X86 64 (Intel syntax)",
+			"0x1000 1 3 pop;pop;ret\n"
+			"0x1001 2 2 pop;ret\n"
+			"0x1002 2 1 ret\n"
+			"0x1005 1 3 pop;jmp\n"
+			"0x1006 1 2 jmp\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			(unsigned char *)MIPS_CODE,
+			sizeof(MIPS_CODE) - 1,
+			3,
+			"MIPS-32 (Big-endian), with delay slot",
+			"0x1000 1 12 addiu;jr;nop\n"
+			"0x1004 1 8 jr;nop\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			2,
+			"ARM-64",
+			"0x1000 1 8 mov;ret\n"
+			"0x1004 1 4 ret\n"
+			"0x1008 1 8 ldr;br\n"
+			"0x100c 1 4 br\n",
+		},
+#endif
+	};
+
+	csh handle;
+	uint64_t address = 0x1000;
+	cs_gadget *gadgets;
+	char result[1024];
+	size_t count, len, j;
+	cs_err err;
+	int i;
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		count = cs_gadget_find(handle, platforms[i].code, platforms[i].size,
+				address, platforms[i].max_insns, &gadgets);
+		if (cs_errno(handle) != CS_ERR_OK) {
+			printf("ERROR: cs_gadget_find() failed with: %s\n",
+					cs_strerror(cs_errno(handle)));
+			abort();
+		}
+
+		len = 0;
+		result[0] = '\0';
+		printf("Gadgets:\n");
+		for (j = 0; j < count; j++) {
+			cs_gadget *g = &gadgets[j];
+			unsigned int k;
+
+			len += snprintf(result + len, sizeof(result) - len,
+					"0x%" PRIx64 " %u %u ", g->address, g->count, g->size);
+			for (k = 0; k < g->insn_count; k++)
+				len += snprintf(result + len, sizeof(result) - len, "%s%s",
+						k ? ";" : "", cs_insn_name(handle, g->ids[k]));
+			len += snprintf(result + len, sizeof(result) - len, "\n");
+
+			// IDs are cleared past the instructions of each gadget
+			for (; k < CS_GADGET_MAX_INSNS; k++) {
+				if (g->ids[k]) {
+					printf("ERROR: stale instruction ID in gadget at 0x%" PRIx64 "\n",
+							g->address);
+					abort();
+				}
+			}
+		}
+		printf("%s", result);
+
+		if (strcmp(result, platforms[i].expected)) {
+			printf("ERROR: expected gadgets:\n%s", platforms[i].expected);
+			abort();
+		}
+
+		cs_gadget_free(handle, gadgets);
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_gadget_find() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
@@ -0,0 +1,210 @@
+/* Capstone Disassembler Engine */
+/* Groups tested by CS_DETAIL_GROUP(), checked against known results & cs_insn_group() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	const char *comment;
+	// one line per instruction: "mnemonic operands: group group ..."
+	const char *expected;
+};
+
+// size of the random code checked against cs_insn_group()
+#define RANDOM_SIZE (16 * 1024)
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static void random_code(unsigned char *buf, size_t size)
+{
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+// CS_DETAIL_GROUP() & cs_insn_group() must agree with the list of groups
+static void check_groups(csh handle, const unsigned char *code, size_t size)
+{
+	cs_insn *insn;
+	size_t count, j;
+	unsigned int group, k;
+	bool in;
+
+	count = cs_disasm(handle, code, size, 0x1000, 0, &insn);
+	for (j = 0; j < count; j++) {
+		cs_detail *detail = insn[j].detail;
+
+		if (!detail)
+			continue;
+
+		for (group = 0; group < 256; group++) {
+			in = false;
+			for (k = 0; k < detail->groups_count; k++)
+				in |= detail->groups[k] == group;
+
+			if (in != cs_insn_group(handle, &insn[j], group) ||
+					in != (bool)CS_DETAIL_GROUP(detail, group)) {
+				printf("ERROR: wrong group %u at 0x%" PRIx64 ": %s\t%s\n",
+						group, insn[j].address, insn[j].mnemonic, insn[j].op_str);
+				abort();
+			}
+		}
+	}
+
+	printf("Same groups as cs_insn_group() for %u instructions\n", (unsigned int)count);
+
+	cs_free(insn, count);
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// call 0x1005; ret; int 0x80; jmp rax; je 0x100c
+#define X86_CODE64 "\xe8\x00\x00\x00\x00\xc3\xcd\x80\xff\xe0\x74\x00"
+#endif
+#ifdef CAPSTONE_HAS_ARM
+// bx lr; vadd.f64 d0, d0, d11; bl #0x1010
+#define ARM_CODE "\x1e\xff\x2f\xe1\x0b\x0b\x30\xee\x00\x00\x00\xeb"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// bl #0x1000; orr v0.16b, v0.16b, v1.16b; ret
+#define ARM64_CODE "\x00\x00\x00\x94\x00\x1c\xa1\x4e\xc0\x03\x5f\xd6"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			"X86 64 (Intel syntax)",
+			"call 0x1005: call mode64\n"
+			"ret : ret mode64\n"
+			"int 0x80: int\n"
+			"jmp rax: jump mode64\n"
+			"je 0x100c: jump\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_ARM,
+			(unsigned char *)ARM_CODE,
+			sizeof(ARM_CODE) - 1,
+			"ARM",
+			"bx lr: jump v4t arm\n"
+			"vadd.f64 d0, d0, d11: vfp2 dpvfp\n"
+			"bl #0x1010: jump call branch_relative arm\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			"ARM-64",
+			"bl #0x1000: jump branch_relative\n"
+			"orr v0.16b, v0.16b, v1.16b: neon\n"
+			"ret : return\n",
+		},
+#endif
+	};
+
+	csh handle;
+	uint64_t address = 0x1000;
+	cs_insn *insn;
+	unsigned char *random;
+	char result[1024];
+	size_t count, len, j;
+	unsigned int group;
+	cs_err err;
+	int i;
+
+	random = malloc(RANDOM_SIZE);
+	random_code(random, RANDOM_SIZE);
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		count = cs_disasm(handle, platforms[i].code, platforms[i].size, address, 0, &insn);
+		len = 0;
+		result[0] = '\0';
+		for (j = 0; j < count; j++) {
+			len += snprintf(result + len, sizeof(result) - len, "%s %s:",
+					insn[j].mnemonic, insn[j].op_str);
+			for (group = 0; group < 256; group++) {
+				if (CS_DETAIL_GROUP(insn[j].detail, group))
+					len += snprintf(result + len, sizeof(result) - len, " %s",
+							cs_group_name(handle, group));
+			}
+			len += snprintf(result + len, sizeof(result) - len, "\n");
+		}
+		printf("%s", result);
+
+		if (strcmp(result, platforms[i].expected)) {
+			printf("ERROR: expected groups:\n%s", platforms[i].expected);
+			abort();
+		}
+
+		cs_free(insn, count);
+
+		cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
+		check_groups(handle, random, RANDOM_SIZE);
+
+		// the detail built without printing has the same masks
+		cs_option(handle, CS_OPT_NOTEXT, CS_OPT_ON);
+		check_groups(handle, random, RANDOM_SIZE);
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+
+	free(random);
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("CS_DETAIL_GROUP() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
@@ -0,0 +1,258 @@
+/* Capstone Disassembler Engine */
+/* Tokens of cs_insn_hash() & hashes of cs_ngram_hash(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+// two instructions hashed alike or not at some level
+struct pair {
+	unsigned char *code;
+	size_t size;
+	unsigned char *code2;
+	size_t size2;
+	cs_hash_level level;
+	bool same;
+};
+
+// size of the random code hashed with & without the detail
+#define RANDOM_SIZE (16 * 1024)
+
+static const char *level_names[] = {
+	"id", "operands", "classes", "regs",
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static void random_code(unsigned char *buf, size_t size)
+{
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+static uint64_t hash_insn(csh handle, unsigned char *code, size_t size, cs_hash_level level,
+		char *text, size_t text_size)
+{
+	cs_insn *insn;
+	uint64_t hash;
+
+	if (cs_disasm(handle, code, size, 0x1000, 1, &insn) != 1) {
+		printf("ERROR: failed to disassemble the instruction\n");
+		abort();
+	}
+
+	snprintf(text, text_size, "%s %s", insn->mnemonic, insn->op_str);
+	hash = cs_insn_hash(handle, insn, level);
+	if (!hash) {
+		printf("ERROR: cs_insn_hash() failed with: %s\n", cs_strerror(cs_errno(handle)));
+		abort();
+	}
+
+	cs_free(insn, 1);
+
+	return hash;
+}
+
+static void test_insn()
+{
+#ifdef CAPSTONE_HAS_X86
+	struct pair pairs[] = {
+		// mov rax, 5 / mov rax, 7: immediates are left out
+		{ (unsigned char *)"\x48\xc7\xc0\x05\x00\x00\x00", 7,
+			(unsigned char *)"\x48\xc7\xc0\x07\x00\x00\x00", 7, CS_HASH_REGS, true },
+		// call 0x1005 / call 0x12564417: addresses are left out
+		{ (unsigned char *)"\xe8\x00\x00\x00\x00", 5,
+			(unsigned char *)"\xe8\x12\x34\x56\x12", 5, CS_HASH_REGS, true },
+		// mov rax, rbx / mov rcx, rdx
+		{ (unsigned char *)"\x48\x89\xd8", 3,
+			(unsigned char *)"\x48\x89\xd1", 3, CS_HASH_CLASSES, true },
+		{ (unsigned char *)"\x48\x89\xd8", 3,
+			(unsigned char *)"\x48\x89\xd1", 3, CS_HASH_REGS, false },
+		// mov rax, rbx / mov eax, ebx
+		{ (unsigned char *)"\x48\x89\xd8", 3,
+			(unsigned char *)"\x89\xd8", 2, CS_HASH_OPERANDS, true },
+		{ (unsigned char *)"\x48\x89\xd8", 3,
+			(unsigned char *)"\x89\xd8", 2, CS_HASH_CLASSES, false },
+		// mov rax, rbx / mov rax, 5
+		{ (unsigned char *)"\x48\x89\xd8", 3,
+			(unsigned char *)"\x48\xc7\xc0\x05\x00\x00\x00", 7, CS_HASH_ID, true },
+		{ (unsigned char *)"\x48\x89\xd8", 3,
+			(unsigned char *)"\x48\xc7\xc0\x05\x00\x00\x00", 7, CS_HASH_OPERANDS, false },
+		// mov rax, [rbx + 8] / mov rcx, [rbx + 0x10]: displacements are left out
+		{ (unsigned char *)"\x48\x8b\x43\x08", 4,
+			(unsigned char *)"\x48\x8b\x4b\x10", 4, CS_HASH_CLASSES, true },
+		// push rbx / push r12
+		{ (unsigned char *)"\x53", 1,
+			(unsigned char *)"\x41\x54", 2, CS_HASH_CLASSES, true },
+		// mov rax, rbx / add rax, rbx
+		{ (unsigned char *)"\x48\x89\xd8", 3,
+			(unsigned char *)"\x48\x01\xd8", 3, CS_HASH_ID, false },
+	};
+
+	csh handle;
+	cs_insn *insn;
+	char text[64], text2[64];
+	uint64_t hash, hash2;
+	cs_ngram *ngrams;
+	int i;
+
+	printf("****************\n");
+	printf("Platform: X86 64 (Intel syntax), tokens\n");
+
+	cs_open(CS_ARCH_X86, CS_MODE_64, &handle);
+	cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+
+	for (i = 0; i < sizeof(pairs)/sizeof(pairs[0]); i++) {
+		hash = hash_insn(handle, pairs[i].code, pairs[i].size, pairs[i].level,
+				text, sizeof(text));
+		hash2 = hash_insn(handle, pairs[i].code2, pairs[i].size2, pairs[i].level,
+				text2, sizeof(text2));
+		printf("%s / %s: %s at %s\n", text, text2,
+				hash == hash2 ? "same" : "different", level_names[pairs[i].level]);
+
+		if ((hash == hash2) != pairs[i].same) {
+			printf("ERROR: expected %s\n", pairs[i].same ? "same" : "different");
+			abort();
+		}
+	}
+
+	// only CS_HASH_ID works without the detail
+	cs_option(handle, CS_OPT_DETAIL, CS_OPT_OFF);
+	cs_disasm(handle, (unsigned char *)"\x48\x89\xd8", 3, 0x1000, 1, &insn);
+	if (!cs_insn_hash(handle, insn, CS_HASH_ID) ||
+			cs_insn_hash(handle, insn, CS_HASH_CLASSES) ||
+			cs_errno(handle) != CS_ERR_DETAIL) {
+		printf("ERROR: cs_insn_hash() without the detail\n");
+		abort();
+	}
+	cs_free(insn, 1);
+
+	// runs have at least one instruction
+	if (cs_ngram_hash(handle, (unsigned char *)"\x90", 1, 0x1000, CS_HASH_ID, 0, &ngrams) ||
+			cs_errno(handle) != CS_ERR_OPTION) {
+		printf("ERROR: cs_ngram_hash() of 0 instructions\n");
+		abort();
+	}
+
+	printf("\n");
+
+	cs_close(&handle);
+#endif
+}
+
+// hashes of runs at different addresses must be the same if their
+// instructions are, and different otherwise
+static void test_ngram()
+{
+#ifdef CAPSTONE_HAS_X86
+// mov rax, rbx; add rax, 5; call 0x110c; xor rax, rax;
+// mov rax, rbx; add rax, 7; call 0x221b
+#define X86_CODE64 "\x48\x89\xd8\x48\x83\xc0\x05\xe8\x00\x01\x00\x00\x48\x31\xc0" \
+	"\x48\x89\xd8\x48\x83\xc0\x07\xe8\x00\x02\x00\x00"
+// one line per run: "address index", with the index of the first run of the same hash
+#define X86_NGRAMS \
+	"0x1000 0\n" \
+	"0x1003 1\n" \
+	"0x1007 2\n" \
+	"0x100c 3\n" \
+	"0x100f 0\n"
+#endif
+
+#ifdef CAPSTONE_HAS_X86
+	csh handle;
+	cs_ngram *ngrams, *ngrams2;
+	unsigned char *random;
+	char result[1024];
+	size_t count, count2, len, j, k;
+	int level;
+
+	printf("****************\n");
+	printf("Platform: X86 64 (Intel syntax), runs of 3 instructions\n");
+
+	cs_open(CS_ARCH_X86, CS_MODE_64, &handle);
+
+	print_string_hex((unsigned char *)X86_CODE64, sizeof(X86_CODE64) - 1);
+
+	for (level = CS_HASH_ID; level <= CS_HASH_REGS; level++) {
+		count = cs_ngram_hash(handle, (unsigned char *)X86_CODE64, sizeof(X86_CODE64) - 1,
+				0x1000, (cs_hash_level)level, 3, &ngrams);
+
+		len = 0;
+		result[0] = '\0';
+		for (j = 0; j < count; j++) {
+			for (k = 0; ngrams[k].hash != ngrams[j].hash; k++)
+				;
+			len += snprintf(result + len, sizeof(result) - len, "0x%" PRIx64 " %u\n",
+					ngrams[j].address, (unsigned int)k);
+		}
+		printf("Runs at %s:\n%s", level_names[level], result);
+
+		if (strcmp(result, X86_NGRAMS)) {
+			printf("ERROR: expected runs:\n%s", X86_NGRAMS);
+			abort();
+		}
+
+		cs_ngram_free(handle, ngrams);
+	}
+
+	// the detail of the handle does not change hashes
+	random = malloc(RANDOM_SIZE);
+	random_code(random, RANDOM_SIZE);
+
+	for (level = CS_HASH_ID; level <= CS_HASH_REGS; level++) {
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_OFF);
+		count = cs_ngram_hash(handle, random, RANDOM_SIZE, 0x1000,
+				(cs_hash_level)level, 5, &ngrams);
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+		count2 = cs_ngram_hash(handle, random, RANDOM_SIZE, 0x1000,
+				(cs_hash_level)level, 5, &ngrams2);
+
+		if (!count || count != count2 || memcmp(ngrams, ngrams2, count * sizeof(cs_ngram))) {
+			printf("ERROR: runs of random code at %s depend on the detail\n",
+					level_names[level]);
+			abort();
+		}
+
+		cs_ngram_free(handle, ngrams);
+		cs_ngram_free(handle, ngrams2);
+	}
+
+	printf("Same %u runs of random code with & without the detail\n", (unsigned int)count);
+
+	printf("\n");
+
+	free(random);
+	cs_close(&handle);
+#endif
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_insn_hash() & cs_ngram_hash() are not available in diet mode\n");
+		return 0;
+	}
+
+	test_insn();
+	test_ngram();
+
+	return 0;
+}
@@ -0,0 +1,243 @@
+/* Capstone Disassembler Engine */
+/* Memory of handles opened with cs_open_mem() & cs_open_arena(), checked for leaks */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	const char *comment;
+};
+
+// size of the random code disassembled by each handle
+#define RANDOM_SIZE (8 * 1024)
+
+// blocks allocated & not freed yet
+struct counter {
+	long live;
+	long total;
+};
+
+// blocks of the global allocator (CS_OPT_MEM)
+static struct counter global;
+
+static void *CAPSTONE_API count_malloc(void *user_data, size_t size)
+{
+	struct counter *c = (struct counter *)user_data;
+
+	c->live++;
+	c->total++;
+	return malloc(size);
+}
+
+static void *CAPSTONE_API count_calloc(void *user_data, size_t nmemb, size_t size)
+{
+	struct counter *c = (struct counter *)user_data;
+
+	c->live++;
+	c->total++;
+	return calloc(nmemb, size);
+}
+
+static void *CAPSTONE_API count_realloc(void *user_data, void *ptr, size_t size)
+{
+	struct counter *c = (struct counter *)user_data;
+
+	if (!ptr) {
+		c->live++;
+		c->total++;
+	}
+	return realloc(ptr, size);
+}
+
+static void CAPSTONE_API count_free(void *user_data, void *ptr)
+{
+	struct counter *c = (struct counter *)user_data;
+
+	if (ptr)
+		c->live--;
+	free(ptr);
+}
+
+static void *global_malloc(size_t size)
+{
+	return count_malloc(&global, size);
+}
+
+static void *global_calloc(size_t nmemb, size_t size)
+{
+	return count_calloc(&global, nmemb, size);
+}
+
+static void *global_realloc(void *ptr, size_t size)
+{
+	return count_realloc(&global, ptr, size);
+}
+
+static void global_free(void *ptr)
+{
+	count_free(&global, ptr);
+}
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static void random_code(unsigned char *buf, size_t size)
+{
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+// use all APIs allocating memory in @handle. return the instruction count
+static size_t run(csh handle, const unsigned char *code, size_t size, bool detail)
+{
+	cs_opt_mnem mnem = { 1, "foo" };
+	cs_insn *insn, *one;
+	const uint8_t *p = code;
+	size_t count, left = 256;
+	uint64_t address = 0x1000;
+
+	cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+	cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
+	cs_option(handle, CS_OPT_MNEMONIC, (size_t)&mnem);
+
+	count = cs_disasm(handle, code, size, 0x1000, 0, &insn);
+
+	one = cs_malloc(handle);
+	while (cs_disasm_iter(handle, &p, &left, &address, one))
+		;
+
+	cs_reg_id(handle, "r0");
+	cs_insn_id(handle, "nop");
+
+	cs_handle_free(handle, one, 1);
+	cs_handle_free(handle, insn, count);
+
+	return count;
+}
+
+static void test()
+{
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{ CS_ARCH_X86, CS_MODE_64, "X86 64 (Intel syntax)" },
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{ CS_ARCH_ARM, CS_MODE_THUMB, "Thumb" },
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{ CS_ARCH_ARM64, CS_MODE_ARM, "ARM-64" },
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{ CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN), "MIPS-32 (Big-endian)" },
+#endif
+#ifdef CAPSTONE_HAS_PPC
+		{ CS_ARCH_PPC, CS_MODE_BIG_ENDIAN, "PPC-64" },
+#endif
+	};
+
+	struct counter counter;
+	cs_opt_mem_handle mem = {
+		count_malloc, count_calloc, count_realloc, count_free, &counter,
+	};
+	csh handle;
+	unsigned char *random;
+	size_t count, count2;
+	long live;
+	cs_err err;
+	int i, k;
+
+	random = malloc(RANDOM_SIZE);
+	random_code(random, RANDOM_SIZE);
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+
+		// all memory of the handle comes from its own allocator
+		memset(&counter, 0, sizeof(counter));
+		live = global.live;
+		err = cs_open_mem(platforms[i].arch, platforms[i].mode, &mem, &handle);
+		if (err) {
+			printf("Failed on cs_open_mem() with error returned: %u\n", err);
+			abort();
+		}
+		count = run(handle, random, RANDOM_SIZE, true);
+		run(handle, random, RANDOM_SIZE, false);
+		cs_close(&handle);
+
+		printf("cs_open_mem(): %ld blocks allocated, %ld leaked, %ld from the global allocator\n",
+				counter.total, counter.live, global.live - live);
+		if (!counter.total || counter.live || global.live != live) {
+			printf("ERROR: memory of cs_open_mem() handle leaked\n");
+			abort();
+		}
+
+		// the arena gives back what it took after each reset, then all at cs_close()
+		err = cs_open_arena(platforms[i].arch, platforms[i].mode, 4096, &handle);
+		if (err) {
+			printf("Failed on cs_open_arena() with error returned: %u\n", err);
+			abort();
+		}
+		live = global.live;
+		for (k = 0; k < 4; k++) {
+			count2 = run(handle, random, RANDOM_SIZE, k & 1);
+			if (count2 != count) {
+				printf("ERROR: %u instructions after cs_arena_reset(), instead of %u\n",
+						(unsigned int)count2, (unsigned int)count);
+				abort();
+			}
+
+			err = cs_arena_reset(handle);
+			if (err || global.live != live) {
+				printf("ERROR: cs_arena_reset() kept %ld blocks, error %u\n",
+						global.live - live, err);
+				abort();
+			}
+		}
+		cs_close(&handle);
+
+		printf("cs_open_arena(): %ld blocks left after cs_close()\n", global.live);
+		if (global.live) {
+			printf("ERROR: memory of cs_open_arena() handle leaked\n");
+			abort();
+		}
+
+		printf("\n");
+	}
+
+	// handles without an arena cannot be reset
+	cs_open(CS_ARCH_X86, CS_MODE_64, &handle);
+	err = cs_arena_reset(handle);
+	if (err != CS_ERR_HANDLE) {
+		printf("ERROR: cs_arena_reset() without an arena returned %u\n", err);
+		abort();
+	}
+	cs_close(&handle);
+
+	free(random);
+}
+
+int main()
+{
+	cs_opt_mem mem;
+
+	mem.malloc = global_malloc;
+	mem.calloc = global_calloc;
+	mem.realloc = global_realloc;
+	mem.free = global_free;
+	mem.vsnprintf = vsnprintf;
+	cs_option(0, CS_OPT_MEM, (size_t)&mem);
+
+	test();
+
+	return 0;
+}
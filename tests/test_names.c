@@ -0,0 +1,173 @@
+/* Capstone Disassembler Engine */
+/* Names mapped back to IDs by cs_reg_id(), cs_insn_id() & cs_group_id() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	cs_opt_value syntax;
+	const char *comment;
+};
+
+// IDs above all registers, instructions & groups of any architecture
+#define MAX_ID 4096
+
+struct kind {
+	const char *name;
+	const char *(*id_name)(csh handle, unsigned int id);
+	unsigned int (*name_id)(csh handle, const char *name);
+};
+
+static struct kind kinds[] = {
+	{ "registers", cs_reg_name, cs_reg_id },
+	{ "instructions", cs_insn_name, cs_insn_id },
+	{ "groups", cs_group_name, cs_group_id },
+};
+
+// every name must map back to its ID, or to a lower ID of the same name
+static void check_round_trip(csh handle, struct kind *kind)
+{
+	unsigned int id, id2, count = 0;
+	const char *name;
+
+	for (id = 1; id < MAX_ID; id++) {
+		name = kind->id_name(handle, id);
+		if (!name)
+			continue;
+
+		count++;
+		id2 = kind->name_id(handle, name);
+		if (!id2 || id2 > id || strcmp(kind->id_name(handle, id2), name)) {
+			printf("ERROR: name \"%s\" of %u maps back to %u\n", name, id, id2);
+			abort();
+		}
+	}
+
+	printf("%u %s map back to their ID\n", count, kind->name);
+}
+
+static void check_id(csh handle, struct kind *kind, const char *name, unsigned int expected)
+{
+	unsigned int id = kind->name_id(handle, name);
+
+	if (id != expected) {
+		printf("ERROR: \"%s\" maps to %u, instead of %u\n", name, id, expected);
+		abort();
+	}
+}
+
+static void test()
+{
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{ CS_ARCH_X86, CS_MODE_16, CS_OPT_SYNTAX_DEFAULT, "X86 16bit (Intel syntax)" },
+		{ CS_ARCH_X86, CS_MODE_32, CS_OPT_SYNTAX_ATT, "X86 32 (AT&T syntax)" },
+		{ CS_ARCH_X86, CS_MODE_64, CS_OPT_SYNTAX_DEFAULT, "X86 64 (Intel syntax)" },
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{ CS_ARCH_ARM, CS_MODE_ARM, CS_OPT_SYNTAX_DEFAULT, "ARM" },
+		{ CS_ARCH_ARM, CS_MODE_ARM, CS_OPT_SYNTAX_NOREGNAME, "ARM (register names as numbers)" },
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{ CS_ARCH_ARM64, CS_MODE_ARM, CS_OPT_SYNTAX_DEFAULT, "ARM-64" },
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{ CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN), CS_OPT_SYNTAX_DEFAULT, "MIPS-32 (Big-endian)" },
+#endif
+#ifdef CAPSTONE_HAS_PPC
+		{ CS_ARCH_PPC, CS_MODE_BIG_ENDIAN, CS_OPT_SYNTAX_DEFAULT, "PPC-64" },
+#endif
+#ifdef CAPSTONE_HAS_SPARC
+		{ CS_ARCH_SPARC, CS_MODE_BIG_ENDIAN, CS_OPT_SYNTAX_DEFAULT, "Sparc" },
+#endif
+#ifdef CAPSTONE_HAS_SYSZ
+		{ CS_ARCH_SYSZ, (cs_mode)0, CS_OPT_SYNTAX_DEFAULT, "SystemZ" },
+#endif
+#ifdef CAPSTONE_HAS_XCORE
+		{ CS_ARCH_XCORE, (cs_mode)0, CS_OPT_SYNTAX_DEFAULT, "XCore" },
+#endif
+#ifdef CAPSTONE_HAS_M68K
+		{ CS_ARCH_M68K, (cs_mode)(CS_MODE_BIG_ENDIAN | CS_MODE_M68K_040), CS_OPT_SYNTAX_DEFAULT, "M68K" },
+#endif
+#ifdef CAPSTONE_HAS_TMS320C64X
+		{ CS_ARCH_TMS320C64X, (cs_mode)0, CS_OPT_SYNTAX_DEFAULT, "TMS320C64x" },
+#endif
+#ifdef CAPSTONE_HAS_M680X
+		{ CS_ARCH_M680X, (cs_mode)CS_MODE_M680X_6809, CS_OPT_SYNTAX_DEFAULT, "M680X_M6809" },
+#endif
+#ifdef CAPSTONE_HAS_EVM
+		{ CS_ARCH_EVM, (cs_mode)0, CS_OPT_SYNTAX_DEFAULT, "EVM" },
+#endif
+#ifdef CAPSTONE_HAS_MOS65XX
+		{ CS_ARCH_MOS65XX, (cs_mode)0, CS_OPT_SYNTAX_DEFAULT, "MOS65XX" },
+#endif
+	};
+
+	csh handle;
+	cs_err err;
+	int i, k;
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		if (platforms[i].syntax)
+			cs_option(handle, CS_OPT_SYNTAX, platforms[i].syntax);
+
+		for (k = 0; k < sizeof(kinds)/sizeof(kinds[0]); k++) {
+			check_round_trip(handle, &kinds[k]);
+
+			// unknown names have the invalid ID
+			check_id(handle, &kinds[k], "", 0);
+			check_id(handle, &kinds[k], "no_such_name", 0);
+		}
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+
+#ifdef CAPSTONE_HAS_X86
+	cs_open(CS_ARCH_X86, CS_MODE_64, &handle);
+	check_id(handle, &kinds[0], "rax", X86_REG_RAX);
+	// names are case-sensitive
+	check_id(handle, &kinds[0], "RAX", 0);
+	check_id(handle, &kinds[1], "mov", X86_INS_MOV);
+	check_id(handle, &kinds[2], "jump", X86_GRP_JUMP);
+	check_id(handle, &kinds[2], "mode64", X86_GRP_MODE64);
+	cs_close(&handle);
+#endif
+#ifdef CAPSTONE_HAS_ARM
+	// names follow the syntax of the handle
+	cs_open(CS_ARCH_ARM, CS_MODE_ARM, &handle);
+	check_id(handle, &kinds[0], "sb", ARM_REG_R9);
+	check_id(handle, &kinds[0], "r9", 0);
+	cs_option(handle, CS_OPT_SYNTAX, CS_OPT_SYNTAX_NOREGNAME);
+	check_id(handle, &kinds[0], "sb", 0);
+	check_id(handle, &kinds[0], "r9", ARM_REG_R9);
+	cs_close(&handle);
+#endif
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_reg_id(), cs_insn_id() & cs_group_id() are not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
@@ -0,0 +1,243 @@
+/* Capstone Disassembler Engine */
+/* Detail built with CS_OPT_NOTEXT, checked against the detail of the printer */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	cs_opt_value syntax;
+	// bytes of cs_detail cleared by the decoder, up to the end of the arch detail
+	size_t detail_size;
+	const char *comment;
+};
+
+// size of the random code disassembled after the code of each platform
+#define RANDOM_SIZE (64 * 1024)
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static void random_code(unsigned char *buf, size_t size)
+{
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+// disassemble @code both ways, and compare the instructions. return their count
+static size_t compare(csh printer, csh notext, struct platform *p,
+		const unsigned char *code, size_t size)
+{
+	cs_insn *insn, *insn2;
+	size_t count, count2, j;
+
+	count = cs_disasm(printer, code, size, 0x1000, 0, &insn);
+	count2 = cs_disasm(notext, code, size, 0x1000, 0, &insn2);
+	if (count != count2) {
+		printf("ERROR: %u instructions with CS_OPT_NOTEXT, instead of %u\n",
+				(unsigned int)count2, (unsigned int)count);
+		abort();
+	}
+
+	for (j = 0; j < count; j++) {
+		cs_detail *d = insn[j].detail, *d2 = insn2[j].detail;
+
+		// skipped data has no detail
+		if (insn[j].id != insn2[j].id || insn[j].size != insn2[j].size ||
+				(d == NULL) != (d2 == NULL) ||
+				(d && (insn2[j].mnemonic[0] || insn2[j].op_str[0] ||
+				memcmp(d, d2, p->detail_size) ||
+				d->groups_mask != d2->groups_mask ||
+				d->arch_groups_mask != d2->arch_groups_mask))) {
+			printf("ERROR: different detail with CS_OPT_NOTEXT at 0x%" PRIx64 ": %s\t%s\n",
+					insn[j].address, insn[j].mnemonic, insn[j].op_str);
+			abort();
+		}
+	}
+
+	cs_free(insn, count);
+	cs_free(insn2, count2);
+
+	return count;
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+#define X86_CODE16 "\x8d\x4c\x32\x08\x01\xd8\x81\xc6\x34\x12\x00\x00\x05\x23\x01\x00\x00\x36\x8b\x84\x91\x23\x01\x00\x00\x41\x8d\x84\x39\x89\x67\x00\x00\x8d\x87\x89\x67\x00\x00\xb4\xc6\x66\xe9\xb8\x00\x00\x00\x67\xff\xa0\x23\x01\x00\x00\x66\xe8\xcb\x00\x00\x00\x74\xfc"
+#define X86_CODE32 "\x8d\x4c\x32\x08\x01\xd8\x81\xc6\x34\x12\x00\x00\x05\x23\x01\x00\x00\x36\x8b\x84\x91\x23\x01\x00\x00\x41\x8d\x84\x39\x89\x67\x00\x00\x8d\x87\x89\x67\x00\x00\xb4\xc6\xe9\xea\xbe\xad\xde\xff\xa0\x23\x01\x00\x00\xe8\xdf\xbe\xad\xde\x74\xff"
+#define X86_CODE64 "\x55\x48\x8b\x05\xb8\x13\x00\x00\xe9\xea\xbe\xad\xde\xff\x25\x23\x01\x00\x00\xe8\xdf\xbe\xad\xde\x74\xff"
+#define X86_DETAIL_SIZE (offsetof(cs_detail, x86) + sizeof(cs_x86))
+#endif
+#ifdef CAPSTONE_HAS_ARM
+#define ARM_CODE "\x86\x48\x60\xf4\x4d\x0f\xe2\xf4\xED\xFF\xFF\xEB\x04\xe0\x2d\xe5\x00\x00\x00\x00\xe0\x83\x22\xe5\xf1\x02\x03\x0e\x00\x00\xa0\xe3\x02\x30\xc1\xe7\x00\x00\x53\xe3\x00\x02\x01\xf1\x05\x40\xd0\xe8\xf4\x80\x00\x00"
+#define THUMB_CODE "\x60\xf9\x1f\x04\xe0\xf9\x4f\x07\x70\x47\x00\xf0\x10\xe8\xeb\x46\x83\xb0\xc9\x68\x1f\xb1\x30\xbf\xaf\xf3\x20\x84\x52\xf8\x23\xf0"
+#define THUMB_CODE2 "\x4f\xf0\x00\x01\xbd\xe8\x00\x88\xd1\xe8\x00\xf0\x18\xbf\xad\xbf\xf3\xff\x0b\x0c\x86\xf3\x00\x89\x80\xf3\x00\x8c\x4f\xfa\x99\xf6\xd0\xff\xa2\x01"
+#define ARM_DETAIL_SIZE (offsetof(cs_detail, arm) + sizeof(cs_arm))
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+#define ARM64_CODE "\x09\x00\x38\xd5\xbf\x40\x00\xd5\x0c\x05\x13\xd5\x20\x50\x02\x0e\x20\xe4\x3d\x0f\x00\x18\xa0\x5f\xa2\x00\xae\x9e\x9f\x37\x03\xd5\xbf\x33\x03\xd5\xdf\x3f\x03\xd5\x21\x7c\x02\x9b\x21\x7c\x00\x53\x00\x40\x21\x4b\xe1\x0b\x40\xb9\x20\x04\x81\xda\x20\x08\x02\x8b\x10\x5b\xe8\x3c"
+#define ARM64_DETAIL_SIZE (offsetof(cs_detail, arm64) + sizeof(cs_arm64))
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_16,
+			(unsigned char *)X86_CODE16,
+			sizeof(X86_CODE16) - 1,
+			CS_OPT_SYNTAX_DEFAULT,
+			X86_DETAIL_SIZE,
+			"X86 16bit (Intel syntax)",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_32,
+			(unsigned char *)X86_CODE32,
+			sizeof(X86_CODE32) - 1,
+			CS_OPT_SYNTAX_ATT,
+			X86_DETAIL_SIZE,
+			"X86 32 (AT&T syntax)",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_32,
+			(unsigned char *)X86_CODE32,
+			sizeof(X86_CODE32) - 1,
+			CS_OPT_SYNTAX_DEFAULT,
+			X86_DETAIL_SIZE,
+			"X86 32 (Intel syntax)",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			CS_OPT_SYNTAX_DEFAULT,
+			X86_DETAIL_SIZE,
+			"X86 64 (Intel syntax)",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_ARM,
+			(unsigned char *)ARM_CODE,
+			sizeof(ARM_CODE) - 1,
+			CS_OPT_SYNTAX_DEFAULT,
+			ARM_DETAIL_SIZE,
+			"ARM",
+		},
+		{
+			CS_ARCH_ARM,
+			CS_MODE_THUMB,
+			(unsigned char *)THUMB_CODE,
+			sizeof(THUMB_CODE) - 1,
+			CS_OPT_SYNTAX_DEFAULT,
+			ARM_DETAIL_SIZE,
+			"Thumb",
+		},
+		{
+			CS_ARCH_ARM,
+			CS_MODE_THUMB,
+			(unsigned char *)THUMB_CODE2,
+			sizeof(THUMB_CODE2) - 1,
+			CS_OPT_SYNTAX_NOREGNAME,
+			ARM_DETAIL_SIZE,
+			"Thumb-2 (register names as numbers)",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			CS_OPT_SYNTAX_DEFAULT,
+			ARM64_DETAIL_SIZE,
+			"ARM-64",
+		},
+#endif
+	};
+
+	csh printer, notext;
+	unsigned char *random;
+	size_t count;
+	cs_err err;
+	int i;
+
+	random = malloc(RANDOM_SIZE);
+	random_code(random, RANDOM_SIZE);
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &printer);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+		cs_open(platforms[i].arch, platforms[i].mode, &notext);
+
+		if (platforms[i].syntax) {
+			cs_option(printer, CS_OPT_SYNTAX, platforms[i].syntax);
+			cs_option(notext, CS_OPT_SYNTAX, platforms[i].syntax);
+		}
+		cs_option(printer, CS_OPT_DETAIL, CS_OPT_ON);
+		cs_option(notext, CS_OPT_DETAIL, CS_OPT_ON);
+		cs_option(notext, CS_OPT_NOTEXT, CS_OPT_ON);
+		// go on past invalid code
+		cs_option(printer, CS_OPT_SKIPDATA, CS_OPT_ON);
+		cs_option(notext, CS_OPT_SKIPDATA, CS_OPT_ON);
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		count = compare(printer, notext, &platforms[i], platforms[i].code, platforms[i].size);
+		printf("Same detail for %u instructions\n", (unsigned int)count);
+
+		count = compare(printer, notext, &platforms[i], random, RANDOM_SIZE);
+		printf("Same detail for %u instructions of random code\n", (unsigned int)count);
+
+		printf("\n");
+
+		cs_close(&printer);
+		cs_close(&notext);
+	}
+
+	free(random);
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("CS_OPT_NOTEXT is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
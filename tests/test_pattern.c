@@ -0,0 +1,219 @@
+/* Capstone Disassembler Engine */
+/* Matches found by cs_pattern_search(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	const char *comment;
+	// patterns searched in the code
+	const char *source;
+	// one line per match: "address pattern size count"
+	const char *expected;
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+static void print_matches(cs_match *matches, size_t count, char *result, size_t size)
+{
+	size_t j, len = 0;
+
+	result[0] = '\0';
+	for (j = 0; j < count; j++)
+		len += snprintf(result + len, size - len, "0x%" PRIx64 " %u %u %u\n",
+				matches[j].address, matches[j].pattern, matches[j].size,
+				matches[j].insn_count);
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// xor rax, rax; call 0x1008; mov rax, rbx; ret; lea rax, [rbx + 8]; ret; push 0x10; ret
+#define X86_CODE64 "\x48\x31\xc0\xe8\x00\x00\x00\x00\x48\x89\xd8\xc3\x48\x8d\x43\x08\xc3\x6a\x10\xc3"
+#define X86_PATTERNS \
+	"xor reg, reg; call *\n" \
+	"# comments & blank lines are no patterns\n" \
+	"\n" \
+	"mov|lea rax, ...; ret\n" \
+	"lea rax, [rbx]  # memory based on rbx\n" \
+	"push 0..0xff; ret\n" \
+	"mov rax, mem\n"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// movz x0, #0x1; ret; nop; (data); nop; nop
+#define ARM64_CODE "\x20\x00\x80\xd2\xc0\x03\x5f\xd6\x1f\x20\x03\xd5\xff\xff\xff\xff\x1f\x20\x03\xd5\x1f\x20\x03\xd5"
+#define ARM64_PATTERNS \
+	"movz x0, 1; ret\n" \
+	"nop; nop\n" \
+	"*\n"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			"X86 64 (Intel syntax)",
+			X86_PATTERNS,
+			"0x1000 0 8 2\n"
+			"0x1008 1 4 2\n"
+			"0x100c 2 4 1\n"
+			"0x100c 1 5 2\n"
+			"0x1011 3 3 2\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			"ARM-64",
+			ARM64_PATTERNS,
+			"0x1000 2 4 1\n"
+			"0x1000 0 8 2\n"
+			"0x1004 2 4 1\n"
+			"0x1008 2 4 1\n"
+			"0x1010 2 4 1\n"
+			"0x1010 1 8 2\n"
+			"0x1014 2 4 1\n",
+		},
+#endif
+	};
+
+	csh handle;
+	uint64_t address = 0x1000;
+	cs_pattern *pattern;
+	cs_match *matches;
+	char result[1024];
+	size_t count;
+	cs_err err;
+	int i, detail;
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+		printf("Patterns:\n%s", platforms[i].source);
+
+		err = cs_pattern_compile(handle, platforms[i].source, &pattern);
+		if (err) {
+			printf("ERROR: cs_pattern_compile() failed with: %s\n", cs_strerror(err));
+			abort();
+		}
+
+		// the same matches are found with & without the detail
+		for (detail = 0; detail < 2; detail++) {
+			cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+
+			count = cs_pattern_search(handle, pattern, platforms[i].code, platforms[i].size,
+					address, &matches);
+			if (cs_errno(handle) != CS_ERR_OK) {
+				printf("ERROR: cs_pattern_search() failed with: %s\n",
+						cs_strerror(cs_errno(handle)));
+				abort();
+			}
+
+			print_matches(matches, count, result, sizeof(result));
+			if (!detail)
+				printf("Matches:\n%s", result);
+
+			if (strcmp(result, platforms[i].expected)) {
+				printf("ERROR: matches with CS_OPT_DETAIL %s:\n%s",
+						detail ? "on" : "off", result);
+				printf("expected:\n%s", platforms[i].expected);
+				abort();
+			}
+
+			cs_match_free(handle, matches);
+		}
+
+		cs_pattern_free(handle, pattern);
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+}
+
+// invalid sources fail with CS_ERR_PATTERN
+static void test_errors()
+{
+	static const char *sources[] = {
+		"",
+		"# no pattern\n\n",
+		"no_such_insn",
+		"mov no_such_reg",
+		"mov rax,",
+		"mov rax rbx",
+		"mov ..., rax",
+		"mov rax;",
+		"mov;;ret",
+		"mov|",
+		"|mov",
+		"mov [rax",
+		"mov [no_such_reg]",
+		"mov 0x",
+		"mov 1..",
+		"mov 5..1",
+	};
+
+	csh handle;
+	cs_pattern *pattern;
+	cs_err err;
+	int i;
+
+	printf("****************\n");
+	printf("Invalid patterns\n");
+
+#ifdef CAPSTONE_HAS_X86
+	cs_open(CS_ARCH_X86, CS_MODE_64, &handle);
+	for (i = 0; i < sizeof(sources)/sizeof(sources[0]); i++) {
+		err = cs_pattern_compile(handle, sources[i], &pattern);
+		if (err != CS_ERR_PATTERN) {
+			printf("ERROR: \"%s\" compiled with error %u\n", sources[i], err);
+			abort();
+		}
+	}
+	printf("%u sources rejected\n", i);
+	cs_close(&handle);
+#endif
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_pattern_compile() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+	test_errors();
+
+	return 0;
+}
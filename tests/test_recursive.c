@@ -0,0 +1,398 @@
+/* Capstone Disassembler Engine */
+/* Instructions reached by cs_disasm_recursive(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	// entry points, or none for the start of the code
+	uint64_t entries[2];
+	size_t entry_count;
+	const char *comment;
+	// one line per instruction: "address mnemonic operands"
+	const char *expected;
+};
+
+// random code, disassembled with several threads
+struct threads_platform {
+	cs_arch arch;
+	cs_mode mode;
+	// bytes of cs_detail cleared by the decoder, up to the end of the arch detail
+	size_t detail_size;
+	const char *comment;
+};
+
+// size of the random code, and number of entry points in it
+#define RANDOM_SIZE (256 * 1024)
+#define RANDOM_ENTRIES 256
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static uint32_t random_code(unsigned char *buf, size_t size, uint32_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+
+	return seed;
+}
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+static void print_insns(cs_insn *insn, size_t count, char *result, size_t size)
+{
+	size_t j, len = 0;
+
+	result[0] = '\0';
+	for (j = 0; j < count; j++)
+		len += snprintf(result + len, size - len, "0x%" PRIx64 " %s %s\n",
+				insn[j].address, insn[j].mnemonic, insn[j].op_str);
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// je 0x1006; jmp 0x100c; (data); call 0x100e; ret; (data); nop; ret; ret
+#define X86_CODE64 "\x74\x04\xeb\x08\xff\xff\xe8\x03\x00\x00\x00\xc3\xff\xff\x90\xc3\xc3"
+#endif
+#ifdef CAPSTONE_HAS_ARM
+// b #0x100c; (data); (data); bl #0x1014; bx lr; pop {pc}
+#define ARM_CODE "\x01\x00\x00\xea\xff\xff\xff\xff\x00\x00\x00\x00\x00\x00\x00\xeb\x1e\xff\x2f\xe1\x04\xf0\x9d\xe4"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// b #0x1008; (data); cbz x0, #0x100c; ret; ret
+#define ARM64_CODE "\x02\x00\x00\x14\xff\xff\xff\xff\x20\x00\x00\xb4\xc0\x03\x5f\xd6\xc0\x03\x5f\xd6"
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+// beq $a0, $a1, 0x1014; nop; jal 0x1018; nop; jr $ra; addiu $v0, $zero, 1; jr $ra; nop; (data)
+#define MIPS_CODE "\x10\x85\x00\x04\x00\x00\x00\x00\x0c\x00\x04\x06\x00\x00\x00\x00\x03\xe0\x00\x08\x24\x02\x00\x01\x03\xe0\x00\x08\x00\x00\x00\x00\xff\xff\xff\xff"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			{ 0 },
+			0,
+			"X86 64 (Intel syntax)",
+			"0x1000 je 0x1006\n"
+			"0x1002 jmp 0x100c\n"
+			"0x1006 call 0x100e\n"
+			"0x100b ret \n"
+			"0x100e nop \n"
+			"0x100f ret \n",
+		},
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			// the second entry is outside of the code
+			{ 0x1010, 0x2000 },
+			2,
+			"X86 64 (Intel syntax), from given entries",
+			"0x1010 ret \n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_ARM,
+			(unsigned char *)ARM_CODE,
+			sizeof(ARM_CODE) - 1,
+			{ 0 },
+			0,
+			"ARM",
+			"0x1000 b #0x100c\n"
+			"0x100c bl #0x1014\n"
+			"0x1010 bx lr\n"
+			"0x1014 pop {pc}\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			{ 0 },
+			0,
+			"ARM-64",
+			"0x1000 b #0x1008\n"
+			"0x1008 cbz x0, #0x100c\n"
+			"0x100c ret \n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			(unsigned char *)MIPS_CODE,
+			sizeof(MIPS_CODE) - 1,
+			{ 0 },
+			0,
+			"MIPS-32 (Big-endian), with delay slots",
+			"0x1000 beq $a0, $a1, 0x1014\n"
+			"0x1004 nop \n"
+			"0x1008 jal 0x1018\n"
+			"0x100c nop \n"
+			"0x1010 jr $ra\n"
+			"0x1014 addiu $v0, $zero, 1\n"
+			"0x1018 jr $ra\n"
+			"0x101c nop \n",
+		},
+#endif
+	};
+
+	csh handle;
+	uint64_t address = 0x1000;
+	cs_insn *insn;
+	char result[1024];
+	size_t count, j;
+	cs_err err;
+	int i, detail;
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		// the same instructions are reached with & without the detail
+		for (detail = 0; detail < 2; detail++) {
+			cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+
+			count = cs_disasm_recursive(handle, platforms[i].code, platforms[i].size,
+					address, platforms[i].entry_count ? platforms[i].entries : NULL,
+					platforms[i].entry_count, &insn);
+			if (cs_errno(handle) != CS_ERR_OK) {
+				printf("ERROR: cs_disasm_recursive() failed with: %s\n",
+						cs_strerror(cs_errno(handle)));
+				abort();
+			}
+
+			print_insns(insn, count, result, sizeof(result));
+			if (!detail)
+				printf("Instructions:\n%s", result);
+
+			if (strcmp(result, platforms[i].expected)) {
+				printf("ERROR: instructions with CS_OPT_DETAIL %s:\n%s",
+						detail ? "on" : "off", result);
+				printf("expected:\n%s", platforms[i].expected);
+				abort();
+			}
+
+			for (j = 0; j < count; j++) {
+				if ((insn[j].detail != NULL) != detail) {
+					printf("ERROR: detail of 0x%" PRIx64 " does not follow CS_OPT_DETAIL\n",
+							insn[j].address);
+					abort();
+				}
+			}
+
+			cs_free(insn, count);
+		}
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+}
+
+static bool same_insns(struct threads_platform *p, cs_insn *insn, size_t count,
+		cs_insn *insn2, size_t count2)
+{
+	size_t j;
+
+	if (count != count2)
+		return false;
+
+	for (j = 0; j < count; j++) {
+		cs_detail *d = insn[j].detail, *d2 = insn2[j].detail;
+
+		if (insn[j].address != insn2[j].address || insn[j].id != insn2[j].id ||
+				insn[j].size != insn2[j].size ||
+				memcmp(insn[j].bytes, insn2[j].bytes, insn[j].size) ||
+				strcmp(insn[j].mnemonic, insn2[j].mnemonic) ||
+				strcmp(insn[j].op_str, insn2[j].op_str) ||
+				(d == NULL) != (d2 == NULL))
+			return false;
+
+		if (d && (memcmp(d, d2, p->detail_size) ||
+					d->groups_mask != d2->groups_mask ||
+					d->arch_groups_mask != d2->arch_groups_mask))
+			return false;
+	}
+
+	return true;
+}
+
+static bool same_cfg(struct threads_platform *p, cs_cfg *cfg, cs_cfg *cfg2)
+{
+	size_t j;
+
+	if (!same_insns(p, cfg->insns, cfg->insn_count, cfg2->insns, cfg2->insn_count) ||
+			cfg->block_count != cfg2->block_count ||
+			cfg->edge_count != cfg2->edge_count ||
+			memcmp(cfg->blocks, cfg2->blocks, cfg->block_count * sizeof(cs_block)) ||
+			memcmp(cfg->preds, cfg2->preds, cfg->edge_count * sizeof(cfg->preds[0])))
+		return false;
+
+	for (j = 0; j < cfg->edge_count; j++) {
+		if (cfg->edges[j].from != cfg2->edges[j].from ||
+				cfg->edges[j].to != cfg2->edges[j].to ||
+				cfg->edges[j].type != cfg2->edges[j].type)
+			return false;
+	}
+
+	return true;
+}
+
+// the output must not depend on CS_OPT_THREADS
+static void test_threads()
+{
+	struct threads_platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			offsetof(cs_detail, x86) + sizeof(cs_x86),
+			"X86 64 (Intel syntax)",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			offsetof(cs_detail, arm64) + sizeof(cs_arm64),
+			"ARM-64",
+		},
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			offsetof(cs_detail, mips) + sizeof(cs_mips),
+			"MIPS-32 (Big-endian)",
+		},
+#endif
+	};
+
+	// threads of each run: the default, several, then one per CPU
+	static const unsigned int threads[] = { 1, 4, 0 };
+
+	csh handle;
+	uint64_t address = 0x10000;
+	uint64_t entries[RANDOM_ENTRIES];
+	unsigned char *random;
+	uint32_t seed;
+	cs_insn *insn, *insn2;
+	size_t count, count2;
+	cs_cfg *cfg, *cfg2;
+	cs_err err;
+	int i, j, t, detail;
+
+	random = malloc(RANDOM_SIZE);
+	seed = random_code(random, RANDOM_SIZE, 0x12345678);
+	for (j = 0; j < RANDOM_ENTRIES; j++) {
+		seed = seed * 1103515245 + 12345;
+		entries[j] = address + (seed >> 8) % RANDOM_SIZE;
+	}
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s, random code\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		for (detail = 0; detail < 2; detail++) {
+			cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+
+			cs_option(handle, CS_OPT_THREADS, threads[0]);
+			count = cs_disasm_recursive(handle, random, RANDOM_SIZE, address,
+					entries, RANDOM_ENTRIES, &insn);
+			err = cs_cfg_build(handle, random, RANDOM_SIZE, address,
+					entries, RANDOM_ENTRIES, &cfg);
+			if (!count || err) {
+				printf("ERROR: random code failed with: %s\n", cs_strerror(cs_errno(handle)));
+				abort();
+			}
+
+			for (t = 1; t < sizeof(threads)/sizeof(threads[0]); t++) {
+				cs_option(handle, CS_OPT_THREADS, threads[t]);
+
+				count2 = cs_disasm_recursive(handle, random, RANDOM_SIZE, address,
+						entries, RANDOM_ENTRIES, &insn2);
+				if (!same_insns(&platforms[i], insn, count, insn2, count2)) {
+					printf("ERROR: cs_disasm_recursive() with %u threads differs\n", threads[t]);
+					abort();
+				}
+				cs_free(insn2, count2);
+
+				err = cs_cfg_build(handle, random, RANDOM_SIZE, address,
+						entries, RANDOM_ENTRIES, &cfg2);
+				if (err || !same_cfg(&platforms[i], cfg, cfg2)) {
+					printf("ERROR: cs_cfg_build() with %u threads differs\n", threads[t]);
+					abort();
+				}
+				cs_cfg_free(handle, cfg2);
+			}
+
+			printf("Same %u instructions & %u blocks with 1, 4 & all threads, CS_OPT_DETAIL %s\n",
+					(unsigned int)count, (unsigned int)cfg->block_count, detail ? "on" : "off");
+
+			cs_free(insn, count);
+			cs_cfg_free(handle, cfg);
+		}
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+
+	free(random);
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_disasm_recursive() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+	test_threads();
+
+	return 0;
+}
@@ -0,0 +1,261 @@
+/* Capstone Disassembler Engine */
+/* Register bitmaps of cs_regs_access_mask(), checked against known results & cs_regs_access() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	const char *comment;
+	// per instruction: registers read & written, then the same with aliases folded
+	const char *expected;
+};
+
+// size of the random code checked against cs_regs_access()
+#define RANDOM_SIZE (16 * 1024)
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static void random_code(unsigned char *buf, size_t size)
+{
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+static size_t print_mask(csh handle, const char *what, cs_regs_mask mask,
+		char *result, size_t size)
+{
+	size_t len;
+	unsigned int r;
+
+	len = snprintf(result, size, "\t%s:", what);
+	for (r = 1; r < 64 * 8; r++) {
+		if (CS_REGS_MASK_HAS(mask, r))
+			len += snprintf(result + len, size - len, " %s", cs_reg_name(handle, r));
+	}
+	len += snprintf(result + len, size - len, "\n");
+
+	return len;
+}
+
+// the bitmaps must hold the registers of cs_regs_access(), and nothing else
+static void check_regs_access(csh handle, const unsigned char *code, size_t size)
+{
+	cs_insn *insn;
+	size_t count, j;
+	cs_regs regs_read, regs_write;
+	uint8_t read_count, write_count, k;
+	cs_regs_mask mask_read, mask_write, expect_read, expect_write;
+
+	count = cs_disasm(handle, code, size, 0x1000, 0, &insn);
+	for (j = 0; j < count; j++) {
+		if (!insn[j].detail)
+			continue;
+
+		if (cs_regs_access(handle, &insn[j], regs_read, &read_count,
+					regs_write, &write_count))
+			continue;
+
+		memset(expect_read, 0, sizeof(expect_read));
+		memset(expect_write, 0, sizeof(expect_write));
+		for (k = 0; k < read_count; k++)
+			expect_read[regs_read[k] >> 6] |= 1ULL << (regs_read[k] & 63);
+		for (k = 0; k < write_count; k++)
+			expect_write[regs_write[k] >> 6] |= 1ULL << (regs_write[k] & 63);
+
+		cs_regs_access_mask(handle, &insn[j], mask_read, mask_write, false);
+		if (memcmp(mask_read, expect_read, sizeof(mask_read)) ||
+				memcmp(mask_write, expect_write, sizeof(mask_write))) {
+			printf("ERROR: registers differ from cs_regs_access() at 0x%" PRIx64 ": %s\t%s\n",
+					insn[j].address, insn[j].mnemonic, insn[j].op_str);
+			abort();
+		}
+	}
+
+	printf("Same registers as cs_regs_access() for %u instructions\n", (unsigned int)count);
+
+	cs_free(insn, count);
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// mov al, ah; mov rax, qword ptr [rcx + rbx]; add ax, cx
+#define X86_CODE64 "\x88\xe0\x48\x8b\x04\x19\x66\x01\xc8"
+#endif
+#ifdef CAPSTONE_HAS_ARM
+// str r0, [sp, #-4]!; vadd.f64 d0, d0, d11
+#define ARM_CODE "\x04\x00\x2d\xe5\x0b\x0b\x30\xee"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// add w0, w1, #1; orr v0.16b, v0.16b, v1.16b; ldr s0, [x0]
+#define ARM64_CODE "\x20\x04\x00\x11\x00\x1c\xa1\x4e\x00\x00\x40\xbd"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			"X86 64 (Intel syntax)",
+			"mov al, ah\n"
+			"\tread: ah\n"
+			"\twrite: al\n"
+			"\tread (folded): ah ax eax rax\n"
+			"\twrite (folded): al ax eax rax\n"
+			"mov rax, qword ptr [rcx + rbx]\n"
+			"\tread: rbx rcx\n"
+			"\twrite: rax\n"
+			"\tread (folded): bh bl bx ch cl cx ebx ecx rbx rcx\n"
+			"\twrite (folded): ah al ax eax rax\n"
+			"add ax, cx\n"
+			"\tread: ax cx\n"
+			"\twrite: ax rflags\n"
+			"\tread (folded): ah al ax ch cl cx eax ecx rax rcx\n"
+			"\twrite (folded): ah al ax eax rflags rax\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_ARM,
+			(unsigned char *)ARM_CODE,
+			sizeof(ARM_CODE) - 1,
+			"ARM",
+			"str r0, [sp, #-4]!\n"
+			"\tread: sp r0\n"
+			"\twrite: sp\n"
+			"\tread (folded): sp r0\n"
+			"\twrite (folded): sp\n"
+			"vadd.f64 d0, d0, d11\n"
+			"\tread: d0 d11\n"
+			"\twrite: d0\n"
+			"\tread (folded): d0 d11 q0 q5 s0 s1 s22 s23\n"
+			"\twrite (folded): d0 q0 s0 s1\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			"ARM-64",
+			"add w0, w1, #1\n"
+			"\tread: w1\n"
+			"\twrite: w0\n"
+			"\tread (folded): w1 x1\n"
+			"\twrite (folded): w0 x0\n"
+			"orr v0.16b, v0.16b, v1.16b\n"
+			"\tread: v0 v1\n"
+			"\twrite: v0\n"
+			"\tread (folded): b0 b1 d0 d1 h0 h1 q0 q1 s0 s1 v0 v1\n"
+			"\twrite (folded): b0 d0 h0 q0 s0 v0\n"
+			"ldr s0, [x0]\n"
+			"\tread: x0\n"
+			"\twrite: s0\n"
+			"\tread (folded): w0 x0\n"
+			"\twrite (folded): b0 d0 h0 q0 s0 v0\n",
+		},
+#endif
+	};
+
+	csh handle;
+	uint64_t address = 0x1000;
+	cs_insn *insn;
+	cs_regs_mask regs_read, regs_write;
+	unsigned char *random;
+	char result[2048];
+	size_t count, len, j;
+	cs_err err;
+	int i;
+
+	random = malloc(RANDOM_SIZE);
+	random_code(random, RANDOM_SIZE);
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		count = cs_disasm(handle, platforms[i].code, platforms[i].size, address, 0, &insn);
+		len = 0;
+		for (j = 0; j < count; j++) {
+			len += snprintf(result + len, sizeof(result) - len, "%s %s\n",
+					insn[j].mnemonic, insn[j].op_str);
+
+			err = cs_regs_access_mask(handle, &insn[j], regs_read, regs_write, false);
+			if (err) {
+				printf("ERROR: cs_regs_access_mask() failed with: %s\n", cs_strerror(err));
+				abort();
+			}
+			len += print_mask(handle, "read", regs_read, result + len, sizeof(result) - len);
+			len += print_mask(handle, "write", regs_write, result + len, sizeof(result) - len);
+
+			cs_regs_access_mask(handle, &insn[j], regs_read, regs_write, true);
+			len += print_mask(handle, "read (folded)", regs_read, result + len, sizeof(result) - len);
+			len += print_mask(handle, "write (folded)", regs_write, result + len, sizeof(result) - len);
+		}
+		printf("%s", result);
+
+		if (strcmp(result, platforms[i].expected)) {
+			printf("ERROR: expected registers:\n%s", platforms[i].expected);
+			abort();
+		}
+
+		cs_free(insn, count);
+
+		cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
+		check_regs_access(handle, random, RANDOM_SIZE);
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+
+	free(random);
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_regs_access_mask() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
@@ -0,0 +1,332 @@
+/* Capstone Disassembler Engine */
+/* Superset built by cs_disasm_superset(), checked against known results & cs_disasm_iter() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	const char *comment;
+	// one line per offset: "offset: instruction size branch, next offset, target offset"
+	const char *expected;
+};
+
+// size of the random code checked against cs_disasm_iter()
+#define RANDOM_SIZE (16 * 1024)
+
+static const char *branch_names[] = {
+	"none", "jump", "cond", "call", "indirect-jump", "indirect-call", "ret",
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static void random_code(unsigned char *buf, size_t size)
+{
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+static int print_offset(char *result, size_t size, uint32_t offset)
+{
+	if (offset == CS_SUPERSET_NONE)
+		return snprintf(result, size, " none");
+
+	return snprintf(result, size, " %u", offset);
+}
+
+static void print_superset(csh handle, cs_superset *set, char *result, size_t size)
+{
+	size_t o, len = 0;
+
+	result[0] = '\0';
+	for (o = 0; o < set->count; o++) {
+		if (!set->sizes[o]) {
+			len += snprintf(result + len, size - len, "%u: invalid\n", (unsigned int)o);
+			continue;
+		}
+
+		len += snprintf(result + len, size - len, "%u: %s %u %s,", (unsigned int)o,
+				cs_insn_name(handle, set->ids[o]), set->sizes[o],
+				branch_names[set->branches[o]]);
+		len += print_offset(result + len, size - len, set->next[o]);
+		len += snprintf(result + len, size - len, ",");
+		len += print_offset(result + len, size - len, set->targets[o]);
+		len += snprintf(result + len, size - len, "\n");
+	}
+}
+
+// every offset must have the instruction decoded there by cs_disasm_iter()
+// with @ref, a handle with the detail for cs_insn_branch_target()
+static void check_offsets(csh handle, csh ref, const unsigned char *code, size_t size)
+{
+	cs_superset *set;
+	cs_insn *insn;
+	const uint8_t *p;
+	size_t left, o;
+	uint64_t address, target;
+	uint32_t offset;
+	uint8_t insn_size;
+	uint16_t id;
+	int branch;
+	cs_err err;
+
+	err = cs_disasm_superset(handle, code, size, 0x1000, &set);
+	if (err) {
+		printf("ERROR: cs_disasm_superset() failed with: %s\n", cs_strerror(err));
+		abort();
+	}
+
+	insn = cs_malloc(ref);
+	for (o = 0; o < size; o++) {
+		p = code + o;
+		left = size - o;
+		address = 0x1000 + o;
+		insn_size = 0;
+		id = 0;
+		branch = CS_BRANCH_NONE;
+		offset = CS_SUPERSET_NONE;
+
+		if (cs_disasm_iter(ref, &p, &left, &address, insn)) {
+			insn_size = insn->size;
+			id = insn->id;
+			target = 0;
+			branch = cs_insn_branch_target(ref, insn, &target);
+			// only direct targets inside the buffer are kept
+			if (target && target >= 0x1000 && target - 0x1000 < size &&
+					(branch == CS_BRANCH_JUMP || branch == CS_BRANCH_COND_JUMP ||
+					 branch == CS_BRANCH_CALL))
+				offset = (uint32_t)(target - 0x1000);
+		}
+
+		if (set->sizes[o] != insn_size || set->ids[o] != id ||
+				set->branches[o] != branch || set->targets[o] != offset) {
+			printf("ERROR: offset %u is %s, size %u, branch %u, target %x instead of "
+					"%s, size %u, branch %u, target %x\n", (unsigned int)o,
+					cs_insn_name(handle, set->ids[o]), set->sizes[o],
+					set->branches[o], set->targets[o],
+					cs_insn_name(handle, id), insn_size, branch, offset);
+			abort();
+		}
+	}
+
+	printf("Same instructions as cs_disasm_iter() at %u offsets\n", (unsigned int)size);
+
+	cs_free(insn, 1);
+	cs_superset_free(handle, set);
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// je 0x1005; nop; jmp 0x1000; ret
+#define X86_CODE64 "\x74\x03\x90\xeb\xfb\xc3"
+#endif
+#ifdef CAPSTONE_HAS_ARM
+// b #0x1008; bx lr; bl #0x1000
+#define ARM_CODE "\x00\x00\x00\xea\x1e\xff\x2f\xe1\xfc\xff\xff\xeb"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// cbz x0, #0x1008; ret; bl #0x1000
+#define ARM64_CODE "\x40\x00\x00\xb4\xc0\x03\x5f\xd6\xfe\xff\xff\x97"
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+// b 0x100c; nop; jr $ra; nop
+#define MIPS_CODE "\x10\x00\x00\x02\x00\x00\x00\x00\x03\xe0\x00\x08\x00\x00\x00\x00"
+#endif
+#ifdef CAPSTONE_HAS_PPC
+// bl 0x1008; blr; b 0x1000
+#define PPC_CODE "\x48\x00\x00\x09\x4e\x80\x00\x20\x4b\xff\xff\xf8"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			"X86 64 (Intel syntax)",
+			"0: je 2 cond, 2, 5\n"
+			"1: invalid\n"
+			"2: nop 1 none, 3, none\n"
+			"3: jmp 2 jump, none, 0\n"
+			"4: sti 1 none, 5, none\n"
+			"5: ret 1 ret, none, none\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_ARM,
+			(unsigned char *)ARM_CODE,
+			sizeof(ARM_CODE) - 1,
+			"ARM",
+			"0: b 4 jump, none, 8\n"
+			"1: cdp 4 none, 5, none\n"
+			"2: invalid\n"
+			"3: svc 4 none, 7, none\n"
+			"4: bx 4 ret, none, none\n"
+			"5: stc2l 4 none, 9, none\n"
+			"6: invalid\n"
+			"7: invalid\n"
+			"8: bl 4 call, none, 0\n"
+			"9: invalid\n"
+			"10: invalid\n"
+			"11: invalid\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			"ARM-64",
+			"0: cbz 4 cond, 4, 8\n"
+			"1: invalid\n"
+			"2: invalid\n"
+			"3: invalid\n"
+			"4: ret 4 ret, none, none\n"
+			"5: invalid\n"
+			"6: invalid\n"
+			"7: invalid\n"
+			"8: bl 4 call, none, 0\n"
+			"9: invalid\n"
+			"10: invalid\n"
+			"11: invalid\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_MIPS
+		{
+			CS_ARCH_MIPS,
+			(cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+			(unsigned char *)MIPS_CODE,
+			sizeof(MIPS_CODE) - 1,
+			"MIPS-32 (Big-endian), with delay slots",
+			"0: b 4 jump, 4, 12\n"
+			"1: sll 4 none, 5, none\n"
+			"2: sll 4 none, 6, none\n"
+			"3: invalid\n"
+			"4: nop 4 none, 8, none\n"
+			"5: sra 4 none, 9, none\n"
+			"6: invalid\n"
+			"7: sll 4 none, 11, none\n"
+			"8: jr 4 ret, 12, none\n"
+			"9: sc 4 none, 13, none\n"
+			"10: sll 4 none, 14, none\n"
+			"11: j 4 jump, 15, none\n"
+			"12: nop 4 none, none, none\n"
+			"13: invalid\n"
+			"14: invalid\n"
+			"15: invalid\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_PPC
+		{
+			CS_ARCH_PPC,
+			CS_MODE_BIG_ENDIAN,
+			(unsigned char *)PPC_CODE,
+			sizeof(PPC_CODE) - 1,
+			"PPC-64",
+			"0: bl 4 call, 4, 8\n"
+			"1: invalid\n"
+			"2: invalid\n"
+			"3: tdi 4 none, 7, none\n"
+			"4: blr 4 ret, none, none\n"
+			"5: lwz 4 none, 9, none\n"
+			"6: invalid\n"
+			"7: subfic 4 none, 11, none\n"
+			"8: b 4 jump, none, 0\n"
+			"9: invalid\n"
+			"10: invalid\n"
+			"11: invalid\n",
+		},
+#endif
+	};
+
+	csh handle, ref;
+	cs_superset *set;
+	unsigned char *random;
+	char result[2048];
+	cs_err err;
+	int i;
+
+	random = malloc(RANDOM_SIZE);
+	random_code(random, RANDOM_SIZE);
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		err = cs_disasm_superset(handle, platforms[i].code, platforms[i].size, 0x1000, &set);
+		if (err) {
+			printf("ERROR: cs_disasm_superset() failed with: %s\n", cs_strerror(err));
+			abort();
+		}
+
+		print_superset(handle, set, result, sizeof(result));
+		printf("Offsets:\n%s", result);
+		cs_superset_free(handle, set);
+
+		if (strcmp(result, platforms[i].expected)) {
+			printf("ERROR: expected offsets:\n%s", platforms[i].expected);
+			abort();
+		}
+
+		cs_open(platforms[i].arch, platforms[i].mode, &ref);
+		cs_option(ref, CS_OPT_DETAIL, CS_OPT_ON);
+
+		// the detail does not change the superset
+		check_offsets(handle, ref, random, RANDOM_SIZE);
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+		check_offsets(handle, ref, random, RANDOM_SIZE);
+
+		printf("\n");
+
+		cs_close(&ref);
+		cs_close(&handle);
+	}
+
+	free(random);
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_disasm_superset() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+
+	return 0;
+}
@@ -0,0 +1,362 @@
+/* Capstone Disassembler Engine */
+/* Cross-references indexed by cs_xref_build(), checked against known results */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <capstone/platform.h>
+#include <capstone/capstone.h>
+
+struct platform {
+	cs_arch arch;
+	cs_mode mode;
+	unsigned char *code;
+	size_t size;
+	uint64_t address;
+	const char *comment;
+	// one line per reference: "from -> to type"
+	const char *expected;
+};
+
+// random code, indexed with several threads
+struct random_platform {
+	cs_arch arch;
+	cs_mode mode;
+	const char *comment;
+};
+
+// size of the random code, and number of ranges looked up in its index
+#define RANDOM_SIZE (64 * 1024)
+#define RANDOM_RANGES 256
+
+static const char *xref_names[] = {
+	"jump", "call", "read", "write", "address",
+};
+
+static void print_string_hex(unsigned char *str, size_t len)
+{
+	unsigned char *c;
+
+	printf("Code: ");
+	for (c = str; c < str + len; c++) {
+		printf("0x%02x ", *c & 0xff);
+	}
+	printf("\n");
+}
+
+// fill @buf with a fixed pseudo-random sequence, so runs are reproducible
+static uint32_t random_code(unsigned char *buf, size_t size, uint32_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (unsigned char)(seed >> 16);
+	}
+
+	return seed;
+}
+
+static void print_xrefs(cs_xrefs *xrefs, char *result, size_t size)
+{
+	size_t j, len = 0;
+
+	result[0] = '\0';
+	for (j = 0; j < xrefs->count; j++)
+		len += snprintf(result + len, size - len, "0x%" PRIx64 " -> 0x%" PRIx64 " %s\n",
+				xrefs->refs[j].from, xrefs->refs[j].to,
+				xref_names[xrefs->refs[j].type]);
+}
+
+static void test()
+{
+#ifdef CAPSTONE_HAS_X86
+// lea rax, [rip + 0x10]; call 0x100c; mov dword ptr [rip + 0x20], eax;
+// jmp qword ptr [rip + 0x30]; jne 0x1016; mov eax, dword ptr [0x601040]
+#define X86_CODE64 "\x48\x8d\x05\x10\x00\x00\x00\xe8\x00\x00\x00\x00\x89\x05\x20\x00\x00\x00" \
+	"\xff\x25\x30\x00\x00\x00\x75\xfc\x8b\x04\x25\x40\x10\x60\x00"
+#endif
+#ifdef CAPSTONE_HAS_ARM
+// ldr r0, [pc, #8]; ldr r0, [pc, #-8]; add r0, pc, #0x10; sub r0, pc, #0x10; bl #0x1010
+#define ARM_CODE "\x08\x00\x9f\xe5\x08\x00\x1f\xe5\x10\x00\x8f\xe2\x10\x00\x4f\xe2\xfe\xff\xff\xeb"
+// ldr r0, [pc, #8]; adr r0, #8; ldr.w r0, [pc, #-0x8]; subw r0, pc, #8
+#define THUMB_CODE "\x02\x48\x02\xa0\x5f\xf8\x08\x00\xaf\xf2\x08\x00"
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+// adrp x0, #0x401000; add x0, x0, #0x10; ldr x1, [x0, #8]; adr x2, #0x401030;
+// ldr x3, #0x40101c; ldr w4, #0x401020; mov x0, sp; adrp x1, #0x405000;
+// ldr x2, [x1, #0x10]; str x3, [x1, #0x18]
+#define ARM64_CODE "\x00\x00\x00\x90\x00\x40\x00\x91\x01\x04\x40\xf9\x02\x01\x00\x10" \
+	"\x43\x00\x00\x58\x44\x00\x00\x18\xe0\x03\x00\x91\x21\x00\x00\x90" \
+	"\x22\x08\x40\xf9\x23\x0c\x00\xf9"
+#endif
+
+	struct platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{
+			CS_ARCH_X86,
+			CS_MODE_64,
+			(unsigned char *)X86_CODE64,
+			sizeof(X86_CODE64) - 1,
+			0x1000,
+			"X86 64 (Intel syntax)",
+			"0x1000 -> 0x1017 address\n"
+			"0x1007 -> 0x100c call\n"
+			"0x100c -> 0x1032 write\n"
+			"0x1012 -> 0x1048 read\n"
+			"0x1018 -> 0x1016 jump\n"
+			"0x101a -> 0x601040 read\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{
+			CS_ARCH_ARM,
+			CS_MODE_ARM,
+			(unsigned char *)ARM_CODE,
+			sizeof(ARM_CODE) - 1,
+			0x1000,
+			"ARM",
+			"0x1000 -> 0x1010 read\n"
+			"0x1004 -> 0x1004 read\n"
+			"0x1008 -> 0x1020 address\n"
+			"0x100c -> 0x1004 address\n"
+			"0x1010 -> 0x1010 call\n",
+		},
+		{
+			CS_ARCH_ARM,
+			CS_MODE_THUMB,
+			(unsigned char *)THUMB_CODE,
+			sizeof(THUMB_CODE) - 1,
+			// PC is aligned down to 4 bytes
+			0x1002,
+			"Thumb-2",
+			"0x1002 -> 0x100c read\n"
+			"0x1004 -> 0x1010 address\n"
+			"0x1006 -> 0x1000 read\n"
+			"0x100a -> 0x1004 address\n",
+		},
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{
+			CS_ARCH_ARM64,
+			CS_MODE_ARM,
+			(unsigned char *)ARM64_CODE,
+			sizeof(ARM64_CODE) - 1,
+			0x401004,
+			"ARM-64",
+			"0x401008 -> 0x401010 address\n"
+			"0x401010 -> 0x401030 address\n"
+			"0x401014 -> 0x40101c read\n"
+			"0x401018 -> 0x401020 read\n"
+			"0x401024 -> 0x405010 read\n"
+			"0x401028 -> 0x405018 write\n",
+		},
+#endif
+	};
+
+	csh handle;
+	cs_insn *insn;
+	cs_xrefs *xrefs;
+	char result[1024];
+	size_t count;
+	cs_err err;
+	int i;
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		print_string_hex(platforms[i].code, platforms[i].size);
+
+		// the detail is needed to find references
+		count = cs_disasm(handle, platforms[i].code, platforms[i].size,
+				platforms[i].address, 0, &insn);
+		err = cs_xref_build(handle, insn, count, &xrefs);
+		if (err != CS_ERR_DETAIL) {
+			printf("ERROR: cs_xref_build() without the detail returned %u\n", err);
+			abort();
+		}
+		cs_free(insn, count);
+
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+		count = cs_disasm(handle, platforms[i].code, platforms[i].size,
+				platforms[i].address, 0, &insn);
+		err = cs_xref_build(handle, insn, count, &xrefs);
+		if (err) {
+			printf("ERROR: cs_xref_build() failed with: %s\n", cs_strerror(err));
+			abort();
+		}
+
+		print_xrefs(xrefs, result, sizeof(result));
+		printf("References:\n%s", result);
+
+		if (strcmp(result, platforms[i].expected)) {
+			printf("ERROR: expected references:\n%s", platforms[i].expected);
+			abort();
+		}
+
+		cs_xref_free(handle, xrefs);
+		cs_free(insn, count);
+
+		printf("\n");
+
+		cs_close(&handle);
+	}
+}
+
+// ranges found by cs_xref_from() & cs_xref_to() must hold all references in them
+static void check_ranges(cs_xrefs *xrefs, uint64_t begin, uint64_t end)
+{
+	size_t first, found, expected, j;
+	cs_xref *ref, *prev;
+
+	found = cs_xref_from(xrefs, begin, end, &first);
+	expected = 0;
+	for (j = 0; j < xrefs->count; j++)
+		expected += xrefs->refs[j].from >= begin && xrefs->refs[j].from < end;
+	for (j = first; j < first + found; j++) {
+		if (xrefs->refs[j].from < begin || xrefs->refs[j].from >= end)
+			break;
+	}
+	if (found != expected || j != first + found) {
+		printf("ERROR: cs_xref_from() of [0x%" PRIx64 ", 0x%" PRIx64 ") found %u of %u\n",
+				begin, end, (unsigned int)found, (unsigned int)expected);
+		abort();
+	}
+
+	found = cs_xref_to(xrefs, begin, end, &first);
+	expected = 0;
+	for (j = 0; j < xrefs->count; j++)
+		expected += xrefs->refs[j].to >= begin && xrefs->refs[j].to < end;
+	for (j = first; j < first + found; j++) {
+		ref = &xrefs->refs[xrefs->by_to[j]];
+		if (ref->to < begin || ref->to >= end)
+			break;
+	}
+	if (found != expected || j != first + found) {
+		printf("ERROR: cs_xref_to() of [0x%" PRIx64 ", 0x%" PRIx64 ") found %u of %u\n",
+				begin, end, (unsigned int)found, (unsigned int)expected);
+		abort();
+	}
+
+	for (j = 1; j < xrefs->count; j++) {
+		prev = &xrefs->refs[xrefs->by_to[j - 1]];
+		ref = &xrefs->refs[xrefs->by_to[j]];
+		if (prev->to > ref->to || (prev->to == ref->to && prev->from > ref->from)) {
+			printf("ERROR: references to 0x%" PRIx64 " are out of order\n", ref->to);
+			abort();
+		}
+	}
+}
+
+// the index must not depend on CS_OPT_THREADS
+static void test_random()
+{
+	struct random_platform platforms[] = {
+#ifdef CAPSTONE_HAS_X86
+		{ CS_ARCH_X86, CS_MODE_64, "X86 64 (Intel syntax)" },
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		{ CS_ARCH_ARM, CS_MODE_ARM, "ARM" },
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		{ CS_ARCH_ARM64, CS_MODE_ARM, "ARM-64" },
+#endif
+	};
+
+	// threads of each run: the default, several, then one per CPU
+	static const unsigned int threads[] = { 1, 4, 0 };
+
+	csh handle;
+	uint64_t address = 0x100000, begin;
+	unsigned char *random;
+	uint32_t seed;
+	cs_insn *insn;
+	cs_xrefs *xrefs, *xrefs2;
+	size_t count;
+	cs_err err;
+	int i, j, t;
+
+	random = malloc(RANDOM_SIZE);
+	seed = random_code(random, RANDOM_SIZE, 0x12345678);
+
+	for (i = 0; i < sizeof(platforms)/sizeof(platforms[0]); i++) {
+		printf("****************\n");
+		printf("Platform: %s, random code\n", platforms[i].comment);
+		err = cs_open(platforms[i].arch, platforms[i].mode, &handle);
+		if (err) {
+			printf("Failed on cs_open() with error returned: %u\n", err);
+			abort();
+		}
+
+		cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+		cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
+		count = cs_disasm(handle, random, RANDOM_SIZE, address, 0, &insn);
+
+		cs_option(handle, CS_OPT_THREADS, threads[0]);
+		err = cs_xref_build(handle, insn, count, &xrefs);
+		if (err || !xrefs->count) {
+			printf("ERROR: cs_xref_build() failed with: %s\n", cs_strerror(err));
+			abort();
+		}
+
+		for (t = 1; t < sizeof(threads)/sizeof(threads[0]); t++) {
+			cs_option(handle, CS_OPT_THREADS, threads[t]);
+			err = cs_xref_build(handle, insn, count, &xrefs2);
+			if (err || xrefs->count != xrefs2->count ||
+					memcmp(xrefs->by_to, xrefs2->by_to, xrefs->count * sizeof(uint32_t))) {
+				printf("ERROR: cs_xref_build() with %u threads differs\n", threads[t]);
+				abort();
+			}
+
+			for (j = 0; j < xrefs->count; j++) {
+				if (xrefs->refs[j].from != xrefs2->refs[j].from ||
+						xrefs->refs[j].to != xrefs2->refs[j].to ||
+						xrefs->refs[j].type != xrefs2->refs[j].type) {
+					printf("ERROR: cs_xref_build() with %u threads differs\n", threads[t]);
+					abort();
+				}
+			}
+
+			cs_xref_free(handle, xrefs2);
+		}
+
+		printf("Same %u references with 1, 4 & all threads\n", (unsigned int)xrefs->count);
+
+		for (j = 0; j < RANDOM_RANGES; j++) {
+			seed = seed * 1103515245 + 12345;
+			begin = address + (seed >> 8) % RANDOM_SIZE;
+			check_ranges(xrefs, begin, begin + (seed & 0xfff));
+		}
+		check_ranges(xrefs, 0, (uint64_t)-1);
+
+		printf("Same references as a linear search in %u ranges\n", RANDOM_RANGES + 1);
+
+		printf("\n");
+
+		cs_xref_free(handle, xrefs);
+		cs_free(insn, count);
+		cs_close(&handle);
+	}
+
+	free(random);
+}
+
+int main()
+{
+	if (cs_support(CS_SUPPORT_DIET)) {
+		printf("cs_xref_build() is not available in diet mode\n");
+		return 0;
+	}
+
+	test();
+	test_random();
+
+	return 0;
+}
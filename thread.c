@@ -0,0 +1,108 @@
+/* Capstone Disassembly Engine */
+/* Threads, locks & atomic operations behind parallel traversals */
+
+#include "thread.h"
+
+#ifdef CAPSTONE_HAS_THREADS
+
+#ifndef _WIN32
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static DWORD WINAPI thread_main(LPVOID arg)
+#else
+static void *thread_main(void *arg)
+#endif
+{
+	cs_thread *thread = (cs_thread *)arg;
+
+	thread->func(thread->arg);
+
+	return 0;
+}
+
+bool Thread_start(cs_thread *thread, void (*func)(void *arg), void *arg)
+{
+	thread->func = func;
+	thread->arg = arg;
+
+#ifdef _WIN32
+	thread->handle = CreateThread(NULL, 0, thread_main, thread, 0, NULL);
+	return thread->handle != NULL;
+#else
+	return pthread_create(&thread->handle, NULL, thread_main, thread) == 0;
+#endif
+}
+
+void Thread_join(cs_thread *thread)
+{
+#ifdef _WIN32
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+}
+
+void Thread_yield(void)
+{
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+unsigned int Thread_cpus(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return n > 0 ? (unsigned int)n : 1;
+#endif
+}
+
+void Mutex_init(cs_mutex *mutex)
+{
+#ifdef _WIN32
+	InitializeCriticalSection(mutex);
+#else
+	pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+void Mutex_lock(cs_mutex *mutex)
+{
+#ifdef _WIN32
+	EnterCriticalSection(mutex);
+#else
+	pthread_mutex_lock(mutex);
+#endif
+}
+
+void Mutex_unlock(cs_mutex *mutex)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(mutex);
+#else
+	pthread_mutex_unlock(mutex);
+#endif
+}
+
+void Mutex_destroy(cs_mutex *mutex)
+{
+#ifdef _WIN32
+	DeleteCriticalSection(mutex);
+#else
+	pthread_mutex_destroy(mutex);
+#endif
+}
+
+#endif
@@ -0,0 +1,84 @@
+/* Capstone Disassembly Engine */
+/* Threads, locks & atomic operations behind parallel traversals */
+
+#ifndef CS_THREAD_H
+#define CS_THREAD_H
+
+#include "cs_priv.h"
+
+#ifdef CAPSTONE_HAS_THREADS
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+typedef struct cs_thread {
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+	void (*func)(void *arg);
+	void *arg;
+} cs_thread;
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION cs_mutex;
+#else
+typedef pthread_mutex_t cs_mutex;
+#endif
+
+// run @func(@arg) in a new thread. return false on failure
+bool Thread_start(cs_thread *thread, void (*func)(void *arg), void *arg);
+
+// wait until @thread finishes
+void Thread_join(cs_thread *thread);
+
+// let other threads run, while waiting for work
+void Thread_yield(void);
+
+// number of CPUs online, at least 1
+unsigned int Thread_cpus(void);
+
+void Mutex_init(cs_mutex *mutex);
+void Mutex_lock(cs_mutex *mutex);
+void Mutex_unlock(cs_mutex *mutex);
+void Mutex_destroy(cs_mutex *mutex);
+
+#ifdef _MSC_VER
+#include <intrin.h>
+// set bits @v in byte *@p, and return its old value
+#define ATOMIC_OR8(p, v) ((uint8_t)_InterlockedOr8((volatile char *)(p), (char)(v)))
+#define ATOMIC_LOAD8(p) (*(volatile uint8_t *)(p))
+// add @v to counter *@p, and return its new value
+#define ATOMIC_ADD(p, v) (_InterlockedExchangeAdd((volatile long *)(p), (long)(v)) + (v))
+#define ATOMIC_LOAD(p) (*(volatile long *)(p))
+#else
+// bits of bitmaps only order themselves, while counters order everything
+#define ATOMIC_OR8(p, v) __atomic_fetch_or((p), (uint8_t)(v), __ATOMIC_RELAXED)
+#define ATOMIC_LOAD8(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define ATOMIC_ADD(p, v) __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#endif
+
+#else
+
+// single-threaded builds, where the atomic operations are plain ones
+#define ATOMIC_OR8(p, v) atomic_or8((p), (uint8_t)(v))
+#define ATOMIC_LOAD8(p) (*(p))
+#define ATOMIC_ADD(p, v) (*(p) += (v))
+#define ATOMIC_LOAD(p) (*(p))
+
+static inline uint8_t atomic_or8(uint8_t *p, uint8_t v)
+{
+	uint8_t old = *p;
+
+	*p |= v;
+	return old;
+}
+
+#endif
+
+#endif
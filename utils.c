@@ -12,13 +12,15 @@
 #include "utils.h"
 
 // create a cache for fast id lookup
-static unsigned short *make_id2insn(const insn_map *insns, unsigned int size)
+static unsigned short *make_id2insn(cs_struct *h, const insn_map *insns, unsigned int size)
 {
 	// NOTE: assume that the max id is always put at the end of insns array
 	unsigned short max_id = insns[size - 1].id;
 	unsigned short i;
 
-	unsigned short *cache = (unsigned short *)cs_mem_calloc(max_id + 1, sizeof(*cache));
+	unsigned short *cache = (unsigned short *)HANDLE_CALLOC(h, max_id + 1, sizeof(*cache));
+	if (!cache)
+		return NULL;
 
 	for (i = 1; i < size; i++)
 		cache[insns[i].id] = i;
@@ -26,17 +28,20 @@ static unsigned short *make_id2insn(const insn_map *insns, unsigned int size)
 	return cache;
 }
 
-// look for @id in @insns, given its size in @max. first time call will update @cache.
+// look for @id in @insns, given its size in @max. first time call will update h->insn_cache.
 // return 0 if not found
-unsigned short insn_find(const insn_map *insns, unsigned int max, unsigned int id, unsigned short **cache)
+unsigned short insn_find(cs_struct *h, const insn_map *insns, unsigned int max, unsigned int id)
 {
 	if (id > insns[max - 1].id)
 		return 0;
 
-	if (*cache == NULL)
-		*cache = make_id2insn(insns, max);
+	if (h->insn_cache == NULL) {
+		h->insn_cache = make_id2insn(h, insns, max);
+		if (h->insn_cache == NULL)
+			return 0;
+	}
 
-	return (*cache)[id];
+	return h->insn_cache[id];
 }
 
 int name2id(const name_map* map, int max, const char *name)
@@ -57,6 +62,21 @@ const char *id2name(const name_map* map, int max, const unsigned int id)
 {
 	int i;
 
+	if (max <= 0)
+		return NULL;
+
+	// maps are sorted by ID, and normally have no holes: generic IDs start
+	// at index 0, and arch-specific IDs run up to the last entry. so the
+	// entry is found straight away, with the scan below only as fallback
+	if (id < (unsigned int)max && map[id].id == id)
+		return map[id].name;
+
+	if (id <= map[max - 1].id && map[max - 1].id - id < (unsigned int)max) {
+		i = max - 1 - (int)(map[max - 1].id - id);
+		if (map[i].id == id)
+			return map[i].name;
+	}
+
 	for (i = 0; i < max; i++) {
 		if (map[i].id == id) {
 			return map[i].name;
@@ -67,28 +87,563 @@ const char *id2name(const name_map* map, int max, const unsigned int id)
 	return NULL;
 }
 
-// count number of positive members in a list.
-// NOTE: list must be guaranteed to end in 0
-unsigned int count_positive(const uint16_t *list)
+#ifndef CAPSTONE_DIET
+// FNV-1a
+static unsigned int name_hash(const char *name)
 {
-	unsigned int c;
+	unsigned int h = 2166136261u;
 
-	for (c = 0; list[c] > 0; c++);
+	while (*name) {
+		h ^= (unsigned char)*name++;
+		h *= 16777619u;
+	}
 
-	return c;
+	return h;
+}
+
+bool name_index_build(cs_struct *h, cs_name_index *index, GetName_t get_name, unsigned int max)
+{
+	csh handle = (csh)h;
+	unsigned int id, count = 0, size = 8;
+
+	for (id = 1; id < max; id++) {
+		if (get_name(handle, id))
+			count++;
+	}
+
+	// keep the load factor at 1/2 at most
+	while (size < 2 * count)
+		size *= 2;
+
+	index->slots = HANDLE_CALLOC(h, size, sizeof(*index->slots));
+	if (!index->slots)
+		return false;
+
+	index->size = size;
+
+	for (id = 1; id < max; id++) {
+		const char *name = get_name(handle, id);
+		unsigned int i;
+
+		if (!name)
+			continue;
+
+		// linear probing, skipping names already indexed with a lower ID
+		for (i = name_hash(name) & (size - 1); index->slots[i]; i = (i + 1) & (size - 1)) {
+			if (!strcmp(get_name(handle, index->slots[i]), name))
+				break;
+		}
+
+		if (!index->slots[i])
+			index->slots[i] = id;
+	}
+
+	return true;
+}
+
+unsigned int name_index_find(cs_struct *h, const cs_name_index *index, GetName_t get_name, const char *name)
+{
+	csh handle = (csh)h;
+	unsigned int i;
+
+	for (i = name_hash(name) & (index->size - 1); index->slots[i]; i = (i + 1) & (index->size - 1)) {
+		if (!strcmp(get_name(handle, index->slots[i]), name))
+			return index->slots[i];
+	}
+
+	// nothing match
+	return 0;
+}
+
+void name_index_free(cs_struct *h, cs_name_index *index)
+{
+	HANDLE_FREE(h, index->slots);
+	index->slots = NULL;
+	index->size = 0;
+}
+
+void map_implicit_detail(cs_detail *detail, const insn_map *m,
+		const uint16_t *regs, const uint8_t *groups)
+{
+	memcpy(detail->regs_read, regs + m->regs_use, m->regs_use_count * sizeof(regs[0]));
+	detail->regs_read_count = m->regs_use_count;
+
+	memcpy(detail->regs_write, regs + m->regs_mod, m->regs_mod_count * sizeof(regs[0]));
+	detail->regs_write_count = m->regs_mod_count;
+
+	memcpy(detail->groups, groups + m->groups, m->groups_count * sizeof(groups[0]));
+	detail->groups_count = m->groups_count;
+}
+
+static void set_op(detail_op *op, uint8_t type, unsigned int reg, unsigned int index,
+		int64_t imm)
+{
+	op->type = type;
+	op->access = 0;
+	op->reg = reg;
+	op->index = index;
+	op->imm = imm;
+}
+
+unsigned int detail_operands(cs_arch arch, const cs_detail *detail, detail_op *ops,
+		unsigned int max)
+{
+	unsigned int count, i;
+
+	switch (arch) {
+		default:
+			return 0;
+
+		case CS_ARCH_ARM:
+			count = detail->arm.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_arm_op *op = &detail->arm.operands[i];
+
+				switch (op->type) {
+					default:
+						set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+						break;
+					case ARM_OP_REG:
+					case ARM_OP_SYSREG:
+						set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+						break;
+					case ARM_OP_IMM:
+					case ARM_OP_CIMM:
+					case ARM_OP_PIMM:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+						break;
+					case ARM_OP_MEM:
+						set_op(&ops[i], CS_OP_MEM, op->mem.base, op->mem.index, op->mem.disp);
+						break;
+					case ARM_OP_FP:
+						set_op(&ops[i], CS_OP_FP, 0, 0, 0);
+						break;
+				}
+				ops[i].access = op->access;
+			}
+			return count;
+
+		case CS_ARCH_ARM64:
+			count = detail->arm64.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_arm64_op *op = &detail->arm64.operands[i];
+
+				switch (op->type) {
+					default:
+						set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+						break;
+					case ARM64_OP_REG:
+					case ARM64_OP_REG_MRS:
+					case ARM64_OP_REG_MSR:
+						set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+						break;
+					case ARM64_OP_IMM:
+					case ARM64_OP_CIMM:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+						break;
+					case ARM64_OP_MEM:
+						set_op(&ops[i], CS_OP_MEM, op->mem.base, op->mem.index, op->mem.disp);
+						break;
+					case ARM64_OP_FP:
+						set_op(&ops[i], CS_OP_FP, 0, 0, 0);
+						break;
+				}
+				ops[i].access = op->access;
+			}
+			return count;
+
+		case CS_ARCH_X86:
+			count = detail->x86.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_x86_op *op = &detail->x86.operands[i];
+
+				switch (op->type) {
+					default:
+						set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+						break;
+					case X86_OP_REG:
+						set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+						break;
+					case X86_OP_IMM:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+						break;
+					case X86_OP_MEM:
+						set_op(&ops[i], CS_OP_MEM, op->mem.base, op->mem.index, op->mem.disp);
+						break;
+				}
+				ops[i].access = op->access;
+			}
+			return count;
+
+		case CS_ARCH_MIPS:
+			count = detail->mips.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_mips_op *op = &detail->mips.operands[i];
+
+				if (op->type == MIPS_OP_REG)
+					set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+				else if (op->type == MIPS_OP_IMM)
+					set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+				else if (op->type == MIPS_OP_MEM)
+					set_op(&ops[i], CS_OP_MEM, op->mem.base, 0, op->mem.disp);
+				else
+					set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+			}
+			return count;
+
+		case CS_ARCH_PPC:
+			count = detail->ppc.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_ppc_op *op = &detail->ppc.operands[i];
+
+				if (op->type == PPC_OP_REG)
+					set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+				else if (op->type == PPC_OP_CRX)
+					set_op(&ops[i], CS_OP_REG, op->crx.reg, 0, 0);
+				else if (op->type == PPC_OP_IMM)
+					set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+				else if (op->type == PPC_OP_MEM)
+					set_op(&ops[i], CS_OP_MEM, op->mem.base, 0, op->mem.disp);
+				else
+					set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+			}
+			return count;
+
+		case CS_ARCH_SPARC:
+			count = detail->sparc.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_sparc_op *op = &detail->sparc.operands[i];
+
+				if (op->type == SPARC_OP_REG)
+					set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+				else if (op->type == SPARC_OP_IMM)
+					set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+				else if (op->type == SPARC_OP_MEM)
+					set_op(&ops[i], CS_OP_MEM, op->mem.base, op->mem.index, op->mem.disp);
+				else
+					set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+			}
+			return count;
+
+		case CS_ARCH_SYSZ:
+			count = detail->sysz.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_sysz_op *op = &detail->sysz.operands[i];
+
+				if (op->type == SYSZ_OP_REG || op->type == SYSZ_OP_ACREG)
+					set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+				else if (op->type == SYSZ_OP_IMM)
+					set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+				else if (op->type == SYSZ_OP_MEM)
+					set_op(&ops[i], CS_OP_MEM, op->mem.base, op->mem.index, op->mem.disp);
+				else
+					set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+			}
+			return count;
+
+		case CS_ARCH_XCORE:
+			count = detail->xcore.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_xcore_op *op = &detail->xcore.operands[i];
+
+				if (op->type == XCORE_OP_REG)
+					set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+				else if (op->type == XCORE_OP_IMM)
+					set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+				else if (op->type == XCORE_OP_MEM)
+					set_op(&ops[i], CS_OP_MEM, op->mem.base, op->mem.index, op->mem.disp);
+				else
+					set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+			}
+			return count;
+
+		case CS_ARCH_M68K:
+			count = detail->m68k.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_m68k_op *op = &detail->m68k.operands[i];
+
+				switch (op->type) {
+					default:
+						set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+						break;
+					case M68K_OP_REG:
+						set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+						break;
+					case M68K_OP_REG_PAIR:
+						set_op(&ops[i], CS_OP_REG, op->reg_pair.reg_0, 0, 0);
+						break;
+					case M68K_OP_IMM:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, (int64_t)op->imm);
+						break;
+					case M68K_OP_BR_DISP:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, op->br_disp.disp);
+						break;
+					case M68K_OP_MEM:
+						set_op(&ops[i], CS_OP_MEM, op->mem.base_reg, op->mem.index_reg,
+								op->mem.disp);
+						break;
+					case M68K_OP_FP_SINGLE:
+					case M68K_OP_FP_DOUBLE:
+						set_op(&ops[i], CS_OP_FP, 0, 0, 0);
+						break;
+				}
+			}
+			return count;
+
+		case CS_ARCH_TMS320C64X:
+			count = detail->tms320c64x.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_tms320c64x_op *op = &detail->tms320c64x.operands[i];
+
+				if (op->type == TMS320C64X_OP_REG || op->type == TMS320C64X_OP_REGPAIR)
+					set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+				else if (op->type == TMS320C64X_OP_IMM)
+					set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+				else if (op->type == TMS320C64X_OP_MEM)
+					set_op(&ops[i], CS_OP_MEM, op->mem.base, 0, op->mem.disp);
+				else
+					set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+			}
+			return count;
+
+		case CS_ARCH_M680X:
+			count = detail->m680x.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_m680x_op *op = &detail->m680x.operands[i];
+
+				switch (op->type) {
+					default:
+						set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+						break;
+					case M680X_OP_REGISTER:
+						set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+						break;
+					case M680X_OP_IMMEDIATE:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+						break;
+					case M680X_OP_CONSTANT:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, op->const_val);
+						break;
+					case M680X_OP_RELATIVE:
+						set_op(&ops[i], CS_OP_IMM, 0, 0, op->rel.address);
+						break;
+					case M680X_OP_INDEXED:
+						set_op(&ops[i], CS_OP_MEM, op->idx.base_reg, op->idx.offset_reg,
+								op->idx.offset);
+						break;
+					case M680X_OP_EXTENDED:
+						set_op(&ops[i], CS_OP_MEM, 0, 0, op->ext.address);
+						break;
+					case M680X_OP_DIRECT:
+						set_op(&ops[i], CS_OP_MEM, 0, 0, op->direct_addr);
+						break;
+				}
+				ops[i].access = op->access;
+			}
+			return count;
+
+		case CS_ARCH_MOS65XX:
+			count = detail->mos65xx.op_count;
+			for (i = 0; i < count && i < max; i++) {
+				const cs_mos65xx_op *op = &detail->mos65xx.operands[i];
+
+				if (op->type == MOS65XX_OP_REG)
+					set_op(&ops[i], CS_OP_REG, op->reg, 0, 0);
+				else if (op->type == MOS65XX_OP_IMM)
+					set_op(&ops[i], CS_OP_IMM, 0, 0, op->imm);
+				else if (op->type == MOS65XX_OP_MEM)
+					set_op(&ops[i], CS_OP_MEM, 0, 0, op->mem);
+				else
+					set_op(&ops[i], CS_OP_INVALID, 0, 0, 0);
+			}
+			return count;
+	}
+}
+#endif
+
+void map_groups_mask(cs_detail *detail)
+{
+	uint64_t mask = 0, arch_mask = 0;
+	uint8_t i;
+
+	for (i = 0; i < detail->groups_count; i++) {
+		unsigned int group = detail->groups[i];
+
+		if (group < 64)
+			mask |= (uint64_t)1 << group;
+		else if (group >= 128 && group < 192)
+			arch_mask |= (uint64_t)1 << (group - 128);
+	}
+
+	detail->groups_mask = mask;
+	detail->arch_groups_mask = arch_mask;
 }
 
-// count number of positive members in a list.
-// NOTE: list must be guaranteed to end in 0
-unsigned int count_positive8(const unsigned char *list)
+// memory of arena blocks is aligned on ARENA_ALIGN bytes
+#define ARENA_ALIGN 16
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+// every block starts with its size, so it can be copied by arena_realloc()
+#define ARENA_HEADER ARENA_ROUND(sizeof(size_t))
+
+// memory taken from the global allocator, where blocks are carved from
+typedef struct cs_arena_chunk {
+	struct cs_arena_chunk *next;	// chunk allocated before this one
+	size_t size;	// bytes available for blocks
+	size_t used;	// bytes already given to blocks
+} cs_arena_chunk;
+
+#define CHUNK_DATA(c) ((uint8_t *)(c) + ARENA_ROUND(sizeof(cs_arena_chunk)))
+
+struct cs_arena {
+	cs_arena_chunk *chunks;	// newest chunk first
+	size_t chunk_size;	// minimum size of a chunk
+	cs_arena_chunk *mark;	// newest chunk at the time of arena_mark()
+	size_t mark_used;	// bytes used in @mark at the time of arena_mark()
+	uint8_t *last;	// last block allocated, which can grow in place, or NULL
+};
+
+cs_arena *arena_new(size_t chunk_size)
 {
-	unsigned int c;
+	cs_arena *arena = cs_mem_calloc(1, sizeof(*arena));
+
+	if (arena)
+		arena->chunk_size = chunk_size ? chunk_size : 64 * 1024;
+
+	return arena;
+}
+
+static cs_arena_chunk *arena_grow(cs_arena *arena, size_t need)
+{
+	size_t size = need > arena->chunk_size ? need : arena->chunk_size;
+	cs_arena_chunk *c = cs_mem_malloc(ARENA_ROUND(sizeof(*c)) + size);
+
+	if (!c)
+		return NULL;
 
-	for (c = 0; list[c] > 0; c++);
+	c->next = arena->chunks;
+	c->size = size;
+	c->used = 0;
+	arena->chunks = c;
 
 	return c;
 }
 
+void * CAPSTONE_API arena_malloc(void *user_data, size_t size)
+{
+	cs_arena *arena = (cs_arena *)user_data;
+	cs_arena_chunk *c = arena->chunks;
+	size_t need = ARENA_HEADER + ARENA_ROUND(size);
+	uint8_t *block;
+
+	if (need < size)
+		// overflow
+		return NULL;
+
+	if (!c || c->size - c->used < need) {
+		c = arena_grow(arena, need);
+		if (!c)
+			return NULL;
+	}
+
+	block = CHUNK_DATA(c) + c->used;
+	*(size_t *)block = size;
+	c->used += need;
+	arena->last = block + ARENA_HEADER;
+
+	return arena->last;
+}
+
+void * CAPSTONE_API arena_calloc(void *user_data, size_t nmemb, size_t size)
+{
+	void *p;
+
+	if (size && nmemb > (size_t)-1 / size)
+		// overflow
+		return NULL;
+
+	p = arena_malloc(user_data, nmemb * size);
+	if (p)
+		memset(p, 0, nmemb * size);
+
+	return p;
+}
+
+void * CAPSTONE_API arena_realloc(void *user_data, void *ptr, size_t size)
+{
+	cs_arena *arena = (cs_arena *)user_data;
+	uint8_t *block = (uint8_t *)ptr;
+	size_t old_size;
+	void *p;
+
+	if (!block)
+		return arena_malloc(user_data, size);
+
+	old_size = *(size_t *)(block - ARENA_HEADER);
+
+	// the last block can grow (or shrink) in place
+	if (block == arena->last) {
+		cs_arena_chunk *c = arena->chunks;
+		size_t offset = (size_t)(block - CHUNK_DATA(c));
+
+		if (ARENA_ROUND(size) >= size && c->size - offset >= ARENA_ROUND(size)) {
+			*(size_t *)(block - ARENA_HEADER) = size;
+			c->used = offset + ARENA_ROUND(size);
+			return block;
+		}
+	}
+
+	if (size <= old_size) {
+		*(size_t *)(block - ARENA_HEADER) = size;
+		return block;
+	}
+
+	p = arena_malloc(user_data, size);
+	if (p)
+		memcpy(p, block, old_size);
+
+	return p;
+}
+
+void CAPSTONE_API arena_free(void *user_data, void *ptr)
+{
+	cs_arena *arena = (cs_arena *)user_data;
+
+	// only the last block can be given back, others wait for arena_reset()
+	if (ptr && ptr == arena->last) {
+		arena->chunks->used = (size_t)(arena->last - ARENA_HEADER - CHUNK_DATA(arena->chunks));
+		arena->last = NULL;
+	}
+}
+
+void arena_mark(cs_arena *arena)
+{
+	arena->mark = arena->chunks;
+	arena->mark_used = arena->chunks ? arena->chunks->used : 0;
+	// blocks before the mark must not grow over it
+	arena->last = NULL;
+}
+
+void arena_reset(cs_arena *arena)
+{
+	while (arena->chunks != arena->mark) {
+		cs_arena_chunk *next = arena->chunks->next;
+		cs_mem_free(arena->chunks);
+		arena->chunks = next;
+	}
+
+	if (arena->chunks)
+		arena->chunks->used = arena->mark_used;
+
+	arena->last = NULL;
+}
+
+void arena_destroy(cs_arena *arena)
+{
+	arena->mark = NULL;
+	arena_reset(arena);
+	cs_mem_free(arena);
+}
+
 char *cs_strdup(const char *str)
 {
 	size_t len = strlen(str)+ 1;
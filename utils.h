@@ -20,17 +20,22 @@ typedef struct insn_map {
 	unsigned short id;
 	unsigned short mapid;
 #ifndef CAPSTONE_DIET
-	uint16_t regs_use[12]; // list of implicit registers used by this instruction
-	uint16_t regs_mod[20]; // list of implicit registers modified by this instruction
-	unsigned char groups[8]; // list of group this instruction belong to
+	// implicit registers & groups are kept in per-arch pools shared by all
+	// instructions (insn_regs[] & insn_groups[], see suite/mapping_pool.py)
+	uint16_t regs_use;	// offset of implicit registers used by this instruction
+	uint16_t regs_mod;	// offset of implicit registers modified by this instruction
+	uint16_t groups;	// offset of groups this instruction belong to
+	uint8_t regs_use_count;
+	uint8_t regs_mod_count;
+	uint8_t groups_count;
 	bool branch;	// branch instruction?
 	bool indirect_branch;	// indirect branch instruction?
 #endif
 } insn_map;
 
-// look for @id in @m, given its size in @max. first time call will update @cache.
+// look for @id in @m, given its size in @max. first time call will update h->insn_cache.
 // return 0 if not found
-unsigned short insn_find(const insn_map *m, unsigned int max, unsigned int id, unsigned short **cache);
+unsigned short insn_find(cs_struct *h, const insn_map *m, unsigned int max, unsigned int id);
 
 // map id to string
 typedef struct name_map {
@@ -46,18 +51,78 @@ int name2id(const name_map* map, int max, const char *name);
 // return NULL if not found
 const char *id2name(const name_map* map, int max, const unsigned int id);
 
-// count number of positive members in a list.
-// NOTE: list must be guaranteed to end in 0
-unsigned int count_positive(const uint16_t *list);
-unsigned int count_positive8(const unsigned char *list);
+#ifndef CAPSTONE_DIET
+// index names of IDs [1, @max) returned by @get_name into @index.
+// when several IDs share a name, the lowest ID wins.
+// return false on out of memory
+bool name_index_build(cs_struct *h, cs_name_index *index, GetName_t get_name, unsigned int max);
+
+// find ID of @name in @index, built with the same @get_name
+// return 0 if not found
+unsigned int name_index_find(cs_struct *h, const cs_name_index *index, GetName_t get_name, const char *name);
+
+void name_index_free(cs_struct *h, cs_name_index *index);
+
+// copy implicit registers & groups of mapping entry @m into @detail,
+// given the arch's pools of registers @regs & groups @groups
+void map_implicit_detail(cs_detail *detail, const insn_map *m,
+		const uint16_t *regs, const uint8_t *groups);
+
+// operand of the detail of any arch, in one form for pattern search & hashing
+typedef struct detail_op {
+	uint8_t type;	// CS_OP_REG, CS_OP_IMM, CS_OP_MEM, CS_OP_FP, or CS_OP_INVALID for other kinds
+	uint8_t access;	// cs_ac_type, or 0 where the arch does not tell
+	unsigned int reg;	// register, or base register of memory
+	unsigned int index;	// index register of memory
+	int64_t imm;	// immediate, or displacement (or address) of memory
+} detail_op;
+
+// convert the first operands of @detail on @arch, up to @max, into @ops.
+// return the number of operands of @detail
+unsigned int detail_operands(cs_arch arch, const cs_detail *detail, detail_op *ops,
+		unsigned int max);
+#endif
+
+// compute groups_mask & arch_groups_mask of @detail from its list of groups
+void map_groups_mask(cs_detail *detail);
 
 #define ARR_SIZE(a) (sizeof(a)/sizeof(a[0]))
 #define MATRIX_SIZE(a) (sizeof(a[0])/sizeof(a[0][0]))
 
 char *cs_strdup(const char *str);
 
+// bump allocator behind cs_open_arena(): blocks are carved from chunks taken
+// from the global allocator, and freed all at once by arena_reset()
+typedef struct cs_arena cs_arena;
+
+// @chunk_size: minimum size of chunks, or 0 for a default size
+cs_arena *arena_new(size_t chunk_size);
+
+// allocator functions, to be used in cs_opt_mem_handle with the arena as user_data
+void * CAPSTONE_API arena_malloc(void *arena, size_t size);
+void * CAPSTONE_API arena_calloc(void *arena, size_t nmemb, size_t size);
+void * CAPSTONE_API arena_realloc(void *arena, void *ptr, size_t size);
+// only the last block allocated is reclaimed, others stay until arena_reset()
+void CAPSTONE_API arena_free(void *arena, void *ptr);
+
+// remember the current state of @arena, to be restored by arena_reset()
+void arena_mark(cs_arena *arena);
+
+// free all blocks allocated since arena_mark(), or all blocks without a mark
+void arena_reset(cs_arena *arena);
+
+// free all memory of @arena, including itself
+void arena_destroy(cs_arena *arena);
+
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
 
+// bytes skipped over data by CS_OPT_SKIPDATA, which is the alignment of
+// instructions on the arch of @handle. in cs.c
+uint8_t skipdata_size(cs_struct *handle);
+
+// size of all instructions of the arch of @handle, or 0 if it varies. in cs.c
+unsigned int insn_fixed_size(cs_struct *handle);
+
 // we need this since Windows doesn't have snprintf()
 int cs_snprintf(char *buffer, size_t size, const char *fmt, ...);
 
@@ -68,5 +133,8 @@ bool arr_exist8(unsigned char *arr, unsigned char max, unsigned int id);
 
 bool arr_exist(uint16_t *arr, unsigned char max, unsigned int id);
 
+// add register @reg to register bitmap @mask (see cs_regs_mask)
+#define REGS_MASK_SET(mask, reg) ((mask)[(reg) >> 6] |= (uint64_t)1 << ((reg) & 63))
+
 #endif
 
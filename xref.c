@@ -0,0 +1,617 @@
+/* Capstone Disassembly Engine */
+/* Cross-references of decoded instructions */
+
+#if defined(CAPSTONE_HAS_OSXKERNEL)
+#include <libkern/libkern.h>
+#else
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "cs_priv.h"
+#include "utils.h"
+#include "flow.h"
+#include "thread.h"
+
+#ifndef CAPSTONE_DIET
+
+// instructions scanned at once by a thread of cs_xref_build()
+#define XREF_CHUNK 4096
+// most references from an instruction: a branch target & an address
+#define XREF_INSN_MAX 2
+// instructions after an AArch64 ADRP where its page is still completed by an
+// ADD or a load/store. chunks start scanning that far back, so that pairs
+// across chunks are found whatever the number of threads
+#define XREF_PAGE_WINDOW 8
+// ADRP pages tracked at once
+#define XREF_PAGES 4
+
+// page loaded into a register by an AArch64 ADRP
+typedef struct xref_page {
+	unsigned int reg;	// register holding the page, or 0 for none
+	size_t index;	// instruction loading it
+	uint64_t page;
+} xref_page;
+
+// scan of consecutive instructions
+typedef struct xref_scan {
+	cs_struct *handle;
+	const cs_insn *insns;
+	cs_xref *out;	// references found
+	uint32_t count;
+	bool emit;	// references are kept, rather than only pages tracked
+	xref_page pages[XREF_PAGES];
+} xref_scan;
+
+// state of a cross-reference scan, shared by all its threads
+typedef struct xref_state {
+	cs_struct *handle;
+	const cs_insn *insns;
+	size_t count;
+	cs_xref *found;	// XREF_INSN_MAX slots for each instruction
+	uint32_t *counts;	// references found in each chunk
+	long chunk;	// next chunk to scan
+} xref_state;
+
+// thread of a cross-reference scan
+typedef struct xref_part {
+	xref_state *state;
+#ifdef CAPSTONE_HAS_THREADS
+	cs_thread thread;
+	bool started;
+#endif
+} xref_part;
+
+// key of the order of references by destination
+typedef struct xref_key {
+	uint64_t to;
+	uint32_t index;
+} xref_key;
+
+static void xref_add(xref_scan *s, const cs_insn *insn, uint64_t to, uint8_t type)
+{
+	cs_xref *x;
+
+	if (!s->emit)
+		return;
+
+	x = &s->out[s->count++];
+	// padding too, so that indexes alike are the same bytes
+	memset(x, 0, sizeof(*x));
+	x->from = insn->address;
+	x->to = to;
+	x->type = type;
+}
+
+// kind of a reference by a memory operand with @access
+static uint8_t mem_type(uint8_t access)
+{
+	return (access & CS_AC_WRITE) ? CS_XREF_WRITE : CS_XREF_READ;
+}
+
+#ifdef CAPSTONE_HAS_X86
+static void x86_refs(xref_scan *s, const cs_insn *insn)
+{
+	const cs_x86 *x86 = &insn->detail->x86;
+	uint64_t to;
+	int i;
+
+	for (i = 0; i < x86->op_count; i++) {
+		const cs_x86_op *op = &x86->operands[i];
+
+		if (op->type != X86_OP_MEM || op->mem.index != X86_REG_INVALID)
+			continue;
+
+		if (op->mem.base == X86_REG_RIP)
+			// relative to the next instruction
+			to = insn->address + insn->size + op->mem.disp;
+		else if (op->mem.base == X86_REG_INVALID &&
+				op->mem.segment == X86_REG_INVALID &&
+				!(s->handle->mode & CS_MODE_16))
+			// absolute, outside of segmented 16-bit code
+			to = (s->handle->mode & CS_MODE_64) ? (uint64_t)op->mem.disp :
+				(uint32_t)op->mem.disp;
+		else
+			continue;
+
+		xref_add(s, insn, to, insn->id == X86_INS_LEA ? CS_XREF_ADDRESS :
+				mem_type(op->access));
+		return;
+	}
+}
+#endif
+
+#ifdef CAPSTONE_HAS_ARM
+static void arm_refs(xref_scan *s, const cs_insn *insn)
+{
+	const cs_arm *arm = &insn->detail->arm;
+	const cs_arm_op *op = arm->operands;
+	uint64_t pc;
+	int i;
+
+	// PC reads as the instruction after the next one, word-aligned in Thumb
+	if (s->handle->mode & CS_MODE_THUMB)
+		pc = (insn->address + 4) & ~(uint64_t)3;
+	else
+		pc = insn->address + 8;
+
+	switch (insn->id) {
+		default:
+			break;
+		case ARM_INS_ADR:
+			if (arm->op_count == 2 && op[1].type == ARM_OP_IMM)
+				xref_add(s, insn, pc + op[1].imm, CS_XREF_ADDRESS);
+			return;
+		case ARM_INS_ADD:
+		case ARM_INS_ADDW:
+		case ARM_INS_SUB:
+		case ARM_INS_SUBW:
+			// the other forms of ADR, unless they write PC
+			if (arm->op_count == 3 && op[0].type == ARM_OP_REG &&
+					op[0].reg != ARM_REG_PC && op[1].type == ARM_OP_REG &&
+					op[1].reg == ARM_REG_PC && op[2].type == ARM_OP_IMM) {
+				if (insn->id == ARM_INS_ADD || insn->id == ARM_INS_ADDW)
+					xref_add(s, insn, pc + op[2].imm, CS_XREF_ADDRESS);
+				else
+					xref_add(s, insn, pc - op[2].imm, CS_XREF_ADDRESS);
+			}
+			return;
+	}
+
+	for (i = 0; i < arm->op_count; i++) {
+		if (op[i].type == ARM_OP_MEM && op[i].mem.base == ARM_REG_PC &&
+				op[i].mem.index == ARM_REG_INVALID) {
+			xref_add(s, insn, pc + op[i].mem.disp, mem_type(op[i].access));
+			return;
+		}
+	}
+}
+#endif
+
+#ifdef CAPSTONE_HAS_ARM64
+// 64-bit register of @reg, so that writing w0 loses the page of x0
+static unsigned int arm64_xreg(unsigned int reg)
+{
+	if (reg >= ARM64_REG_W0 && reg <= ARM64_REG_W28)
+		return reg - ARM64_REG_W0 + ARM64_REG_X0;
+	if (reg == ARM64_REG_W29)
+		return ARM64_REG_X29;
+	if (reg == ARM64_REG_W30)
+		return ARM64_REG_X30;
+
+	return reg;
+}
+
+static xref_page *page_of(xref_scan *s, unsigned int reg, size_t index)
+{
+	int i;
+
+	for (i = 0; i < XREF_PAGES; i++) {
+		if (s->pages[i].reg == reg && index - s->pages[i].index <= XREF_PAGE_WINDOW)
+			return &s->pages[i];
+	}
+
+	return NULL;
+}
+
+// register @reg of instruction @index holds @page from now on
+static void page_set(xref_scan *s, unsigned int reg, size_t index, uint64_t page)
+{
+	xref_page *p = NULL;
+	int i;
+
+	// the slot of the same register, else a free or expired one, else the oldest
+	for (i = 0; i < XREF_PAGES && !p; i++) {
+		if (s->pages[i].reg == reg)
+			p = &s->pages[i];
+	}
+	for (i = 0; i < XREF_PAGES && !p; i++) {
+		if (!s->pages[i].reg || index - s->pages[i].index > XREF_PAGE_WINDOW)
+			p = &s->pages[i];
+	}
+	if (!p) {
+		p = &s->pages[0];
+		for (i = 1; i < XREF_PAGES; i++) {
+			if (s->pages[i].index < p->index)
+				p = &s->pages[i];
+		}
+	}
+
+	p->reg = reg;
+	p->index = index;
+	p->page = page;
+}
+
+static void page_clear(xref_scan *s, unsigned int reg)
+{
+	int i;
+
+	for (i = 0; i < XREF_PAGES; i++) {
+		if (s->pages[i].reg == reg)
+			s->pages[i].reg = 0;
+	}
+}
+
+static void arm64_refs(xref_scan *s, size_t index)
+{
+	const cs_insn *insn = &s->insns[index];
+	const cs_arm64 *arm64 = &insn->detail->arm64;
+	const cs_arm64_op *op = arm64->operands;
+	unsigned int page_reg = 0;
+	uint64_t page = 0, imm;
+	bool addressed = false;
+	xref_page *p;
+	int i;
+
+	switch (insn->id) {
+		default:
+			break;
+		case ARM64_INS_ADRP:
+			// only a reference once completed by the low bits of the address
+			if (arm64->op_count == 2 && op[1].type == ARM64_OP_IMM) {
+				page_reg = op[0].reg;
+				page = op[1].imm;
+			}
+			addressed = true;
+			break;
+		case ARM64_INS_ADR:
+			if (arm64->op_count == 2 && op[1].type == ARM64_OP_IMM)
+				xref_add(s, insn, op[1].imm, CS_XREF_ADDRESS);
+			addressed = true;
+			break;
+		case ARM64_INS_ADD:
+			if (arm64->op_count == 3 && op[1].type == ARM64_OP_REG &&
+					op[2].type == ARM64_OP_IMM &&
+					(p = page_of(s, op[1].reg, index))) {
+				imm = op[2].imm;
+				if (op[2].shift.type == ARM64_SFT_LSL)
+					imm <<= op[2].shift.value;
+				xref_add(s, insn, p->page + imm, CS_XREF_ADDRESS);
+			}
+			addressed = true;
+			break;
+		case ARM64_INS_LDR:
+		case ARM64_INS_LDRSW:
+		case ARM64_INS_PRFM:
+			// literal loads
+			if (arm64->op_count == 2 && op[1].type == ARM64_OP_IMM) {
+				xref_add(s, insn, op[1].imm, CS_XREF_READ);
+				addressed = true;
+			}
+			break;
+	}
+
+	for (i = 0; i < arm64->op_count && !addressed; i++) {
+		if (op[i].type == ARM64_OP_MEM && op[i].mem.index == ARM64_REG_INVALID &&
+				(p = page_of(s, op[i].mem.base, index))) {
+			xref_add(s, insn, p->page + op[i].mem.disp, mem_type(op[i].access));
+			addressed = true;
+		}
+	}
+
+	// registers written lose their page
+	for (i = 0; i < arm64->op_count; i++) {
+		if (op[i].type == ARM64_OP_REG && (op[i].access & CS_AC_WRITE))
+			page_clear(s, arm64_xreg(op[i].reg));
+		else if (op[i].type == ARM64_OP_MEM && arm64->writeback)
+			page_clear(s, op[i].mem.base);
+	}
+
+	if (page_reg)
+		page_set(s, page_reg, index, page);
+}
+#endif
+
+// find the references of instruction @index
+static void xref_insn(xref_scan *s, size_t index)
+{
+	const cs_insn *insn = &s->insns[index];
+	cs_flow flow;
+
+	// pages do not carry over gaps between instructions, nor data
+	if ((index && insn->address != insn[-1].address + insn[-1].size) ||
+			!insn->id || !insn->detail) {
+		memset(s->pages, 0, sizeof(s->pages));
+		if (!insn->id || !insn->detail)
+			return;
+	}
+
+	Flow_get(s->handle, insn, &flow);
+	if ((flow.type == FLOW_JUMP || flow.type == FLOW_CALL) &&
+			!(flow.flags & FLOW_INDIRECT))
+		xref_add(s, insn, flow.target, flow.type == FLOW_CALL ?
+				CS_XREF_CALL : CS_XREF_JUMP);
+
+	switch (s->handle->arch) {
+		default:
+			break;
+#ifdef CAPSTONE_HAS_X86
+		case CS_ARCH_X86:
+			x86_refs(s, insn);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_ARM
+		case CS_ARCH_ARM:
+			arm_refs(s, insn);
+			break;
+#endif
+#ifdef CAPSTONE_HAS_ARM64
+		case CS_ARCH_ARM64:
+			arm64_refs(s, index);
+			break;
+#endif
+	}
+
+	// pages are not followed across transfers
+	if (flow.type != FLOW_NONE)
+		memset(s->pages, 0, sizeof(s->pages));
+}
+
+static void xref_thread(void *arg)
+{
+	xref_part *p = (xref_part *)arg;
+	xref_state *st = p->state;
+	xref_scan s;
+	size_t c, start, end, i;
+
+	s.handle = st->handle;
+	s.insns = st->insns;
+
+	// chunks go to whichever thread is free first
+	for (;;) {
+		c = (size_t)(ATOMIC_ADD(&st->chunk, 1) - 1);
+		start = c * XREF_CHUNK;
+		if (start >= st->count)
+			break;
+
+		end = MIN(start + XREF_CHUNK, st->count);
+		s.out = st->found + start * XREF_INSN_MAX;
+		s.count = 0;
+		memset(s.pages, 0, sizeof(s.pages));
+
+		// instructions before the chunk only load pages
+		s.emit = false;
+		for (i = start > XREF_PAGE_WINDOW ? start - XREF_PAGE_WINDOW : 0; i < start; i++)
+			xref_insn(&s, i);
+
+		s.emit = true;
+		for (i = start; i < end; i++)
+			xref_insn(&s, i);
+
+		st->counts[c] = s.count;
+	}
+}
+
+static int xref_cmp(const void *a, const void *b)
+{
+	const cs_xref *x = (const cs_xref *)a, *y = (const cs_xref *)b;
+
+	if (x->from != y->from)
+		return x->from < y->from ? -1 : 1;
+	if (x->to != y->to)
+		return x->to < y->to ? -1 : 1;
+
+	return (int)x->type - (int)y->type;
+}
+
+static int key_cmp(const void *a, const void *b)
+{
+	const xref_key *x = (const xref_key *)a, *y = (const xref_key *)b;
+
+	if (x->to != y->to)
+		return x->to < y->to ? -1 : 1;
+
+	return x->index < y->index ? -1 : x->index > y->index;
+}
+#endif
+
+CAPSTONE_EXPORT
+cs_err CAPSTONE_API cs_xref_build(csh ud, const cs_insn *insn, size_t count,
+		cs_xrefs **xrefs)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+#ifndef CAPSTONE_DIET
+	xref_state st;
+	xref_part *parts;
+	xref_key *keys;
+	cs_xrefs *g;
+	size_t chunks, n = 0, c, i;
+	unsigned int threads = 1, t;
+#endif
+
+	if (!handle)
+		return CS_ERR_HANDLE;
+
+	*xrefs = NULL;
+
+#ifdef CAPSTONE_DIET
+	handle->errnum = CS_ERR_DIET;
+	return CS_ERR_DIET;
+#else
+	if (!handle->detail) {
+		handle->errnum = CS_ERR_DETAIL;
+		return CS_ERR_DETAIL;
+	}
+
+	handle->errnum = CS_ERR_OK;
+
+	// references are indexed in 32 bits
+	if (count >= UINT32_MAX / XREF_INSN_MAX) {
+		handle->errnum = CS_ERR_MEM;
+		return CS_ERR_MEM;
+	}
+
+	chunks = (count + XREF_CHUNK - 1) / XREF_CHUNK;
+
+	// each instruction has its slots, so that threads never allocate
+	st.found = HANDLE_MALLOC(handle, count * XREF_INSN_MAX * sizeof(cs_xref) +
+			chunks * sizeof(uint32_t) + 1);
+	if (!st.found) {
+		handle->errnum = CS_ERR_MEM;
+		return CS_ERR_MEM;
+	}
+	st.counts = (uint32_t *)(st.found + count * XREF_INSN_MAX);
+	st.handle = handle;
+	st.insns = insn;
+	st.count = count;
+	st.chunk = 0;
+
+#ifdef CAPSTONE_HAS_THREADS
+	threads = handle->threads ? handle->threads : Thread_cpus();
+	// no more threads than chunks
+	if (threads > chunks)
+		threads = chunks ? (unsigned int)chunks : 1;
+#endif
+
+	parts = HANDLE_CALLOC(handle, threads, sizeof(*parts));
+	if (!parts) {
+		HANDLE_FREE(handle, st.found);
+		handle->errnum = CS_ERR_MEM;
+		return CS_ERR_MEM;
+	}
+
+	for (t = 0; t < threads; t++)
+		parts[t].state = &st;
+
+#ifdef CAPSTONE_HAS_THREADS
+	for (t = 1; t < threads; t++)
+		parts[t].started = Thread_start(&parts[t].thread, xref_thread, &parts[t]);
+#endif
+
+	// chunks of a thread failing to start are scanned by the others
+	xref_thread(&parts[0]);
+
+#ifdef CAPSTONE_HAS_THREADS
+	for (t = 1; t < threads; t++) {
+		if (parts[t].started)
+			Thread_join(&parts[t].thread);
+	}
+#endif
+
+	HANDLE_FREE(handle, parts);
+
+	for (c = 0; c < chunks; c++)
+		n += st.counts[c];
+
+	// both orders live in the allocation of the index
+	g = HANDLE_MALLOC(handle, sizeof(*g) + n * (sizeof(cs_xref) + sizeof(uint32_t)));
+	keys = HANDLE_MALLOC(handle, n * sizeof(*keys) + 1);
+	if (!g || !keys) {
+		HANDLE_FREE(handle, g);
+		HANDLE_FREE(handle, keys);
+		HANDLE_FREE(handle, st.found);
+		handle->errnum = CS_ERR_MEM;
+		return CS_ERR_MEM;
+	}
+
+	g->count = n;
+	g->refs = (cs_xref *)(g + 1);
+	g->by_to = (uint32_t *)(g->refs + n);
+
+	// chunks in order keep the order of instructions
+	for (c = 0, n = 0; c < chunks; c++) {
+		memcpy(g->refs + n, st.found + c * XREF_CHUNK * XREF_INSN_MAX,
+				st.counts[c] * sizeof(cs_xref));
+		n += st.counts[c];
+	}
+	HANDLE_FREE(handle, st.found);
+
+	// which are sorted by address already, unless given otherwise
+	for (i = 1; i < n; i++) {
+		if (xref_cmp(&g->refs[i - 1], &g->refs[i]) > 0) {
+			qsort(g->refs, n, sizeof(cs_xref), xref_cmp);
+			break;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		keys[i].to = g->refs[i].to;
+		keys[i].index = (uint32_t)i;
+	}
+	qsort(keys, n, sizeof(*keys), key_cmp);
+	for (i = 0; i < n; i++)
+		g->by_to[i] = keys[i].index;
+	HANDLE_FREE(handle, keys);
+
+	*xrefs = g;
+
+	return CS_ERR_OK;
+#endif
+}
+
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_xref_from(const cs_xrefs *xrefs, uint64_t begin, uint64_t end,
+		size_t *first)
+{
+	size_t lo = 0, hi, mid, start;
+
+	*first = 0;
+	if (!xrefs || begin >= end)
+		return 0;
+
+	// first reference from @begin on, then from @end on
+	for (hi = xrefs->count; lo < hi;) {
+		mid = lo + (hi - lo) / 2;
+		if (xrefs->refs[mid].from < begin)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	start = lo;
+
+	for (hi = xrefs->count; lo < hi;) {
+		mid = lo + (hi - lo) / 2;
+		if (xrefs->refs[mid].from < end)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*first = start;
+
+	return lo - start;
+}
+
+CAPSTONE_EXPORT
+size_t CAPSTONE_API cs_xref_to(const cs_xrefs *xrefs, uint64_t begin, uint64_t end,
+		size_t *first)
+{
+	size_t lo = 0, hi, mid, start;
+
+	*first = 0;
+	if (!xrefs || begin >= end)
+		return 0;
+
+	for (hi = xrefs->count; lo < hi;) {
+		mid = lo + (hi - lo) / 2;
+		if (xrefs->refs[xrefs->by_to[mid]].to < begin)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	start = lo;
+
+	for (hi = xrefs->count; lo < hi;) {
+		mid = lo + (hi - lo) / 2;
+		if (xrefs->refs[xrefs->by_to[mid]].to < end)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*first = start;
+
+	return lo - start;
+}
+
+CAPSTONE_EXPORT
+void CAPSTONE_API cs_xref_free(csh ud, cs_xrefs *xrefs)
+{
+	struct cs_struct *handle = (struct cs_struct *)(uintptr_t)ud;
+
+	if (!handle || !xrefs)
+		return;
+
+	// arrays live in the allocation of @xrefs
+	HANDLE_FREE(handle, xrefs);
+}